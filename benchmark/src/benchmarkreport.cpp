@@ -0,0 +1,230 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "benchmarkreport.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QStringList>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace {
+    // Returns the sample at the given fraction of the sorted samples
+    double percentile(const QVector<double>& sorted, double fraction);
+
+    // Time and memory grow when performance regresses
+    bool isCost(const QString& unit);
+}
+
+BenchmarkReport::BenchmarkReport()
+{
+}
+
+void BenchmarkReport::setProperty(const QString& name, const QJsonValue& value)
+{
+    properties_.insert(name, value);
+}
+
+void BenchmarkReport::addSample(const QString& name, double value, const QString& unit)
+{
+    Metric& metric = metrics_[name];
+    metric.unit = unit;
+    metric.samples.push_back(value);
+}
+
+QJsonObject BenchmarkReport::toJson() const
+{
+    QJsonObject metrics;
+
+    for(auto it = metrics_.begin(); it != metrics_.end(); ++it)
+    {
+        QVector<double> sorted = it->samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0;
+        for(double sample : sorted)
+        {
+            sum += sample;
+        }
+
+        QJsonObject metric;
+        metric.insert("unit", it->unit);
+        metric.insert("samples", sorted.count());
+        metric.insert("mean", sum / sorted.count());
+        metric.insert("min", sorted.first());
+        metric.insert("max", sorted.last());
+        metric.insert("median", percentile(sorted, 0.5));
+        metric.insert("p95", percentile(sorted, 0.95));
+
+        metrics.insert(it.key(), metric);
+    }
+
+    QJsonObject report = properties_;
+    report.insert("metrics", metrics);
+
+    return report;
+}
+
+bool BenchmarkReport::save(const QString& fileName) const
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName;
+        return false;
+    }
+
+    return file.write(QJsonDocument(toJson()).toJson()) != -1;
+}
+
+bool BenchmarkReport::load(const QString& fileName, QJsonObject& report)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if(!document.isObject())
+    {
+        qWarning() << __FUNCTION__ << fileName << error.errorString();
+        return false;
+    }
+
+    report = document.object();
+    return true;
+}
+
+int BenchmarkReport::compare(const QJsonObject& base, const QJsonObject& current, double threshold, QTextStream& out)
+{
+    // Runs are only comparable with the same settings
+    for(const QString& key : QStringList() << "scene" << "frames" << "timestep" << "width" << "height" << "attributes")
+    {
+        if(base[key] != current[key])
+        {
+            out << "warning: " << key << " differs between the runs" << endl;
+        }
+    }
+
+    const QJsonObject baseMetrics = base["metrics"].toObject();
+    const QJsonObject currentMetrics = current["metrics"].toObject();
+
+    // Absolute differences below this are timer noise even when relatively large
+    const double noiseFloor = 0.05;
+    int regressions = 0;
+
+    for(auto it = baseMetrics.begin(); it != baseMetrics.end(); ++it)
+    {
+        if(!currentMetrics.contains(it.key()))
+        {
+            out << "missing: " << it.key() << endl;
+            continue;
+        }
+
+        const QJsonObject baseMetric = it.value().toObject();
+        const QJsonObject currentMetric = currentMetrics[it.key()].toObject();
+
+        const QString unit = baseMetric["unit"].toString();
+        const double before = baseMetric["mean"].toDouble();
+        const double after = currentMetric["mean"].toDouble();
+
+        if(isCost(unit))
+        {
+            const double change = before > 0 ? (after - before) / before : 0;
+            const char* verdict = "";
+
+            if(change > threshold && after - before > noiseFloor)
+            {
+                verdict = "REGRESSION";
+                ++regressions;
+            }
+
+            else if(change < -threshold)
+            {
+                verdict = "improvement";
+            }
+
+            out << it.key() << ": " << before << " -> " << after << " " << unit
+                << " (" << (change >= 0 ? "+" : "") << change * 100 << "%) " << verdict << endl;
+        }
+
+        else if(before != after)
+        {
+            out << it.key() << ": " << before << " -> " << after << " changed" << endl;
+        }
+    }
+
+    out << regressions << " regressions over " << threshold * 100 << "% threshold" << endl;
+    return regressions;
+}
+
+int BenchmarkReport::write(const QString& fileName, const QString& baseline, double threshold) const
+{
+    if(!fileName.isEmpty())
+    {
+        if(!save(fileName))
+        {
+            return 2;
+        }
+    }
+
+    // The comparison is written to stdout instead of the report
+    else if(baseline.isEmpty())
+    {
+        QTextStream(stdout) << QJsonDocument(toJson()).toJson();
+    }
+
+    if(baseline.isEmpty())
+    {
+        return 0;
+    }
+
+    QJsonObject base;
+    if(!load(baseline, base))
+    {
+        return 2;
+    }
+
+    QTextStream out(stdout);
+    return compare(base, toJson(), threshold, out) > 0 ? 1 : 0;
+}
+
+int BenchmarkReport::compareFiles(const QStringList& files, double threshold)
+{
+    QTextStream out(stdout);
+
+    if(files.count() != 2)
+    {
+        out << "--compare requires the base and current report files" << endl;
+        return 2;
+    }
+
+    QJsonObject base, current;
+    if(!load(files[0], base) || !load(files[1], current))
+    {
+        return 2;
+    }
+
+    return compare(base, current, threshold, out) > 0 ? 1 : 0;
+}
+
+namespace {
+    double percentile(const QVector<double>& sorted, double fraction)
+    {
+        int index = static_cast<int>(fraction * (sorted.count() - 1) + 0.5);
+        return sorted.at(index);
+    }
+
+    bool isCost(const QString& unit)
+    {
+        return unit == "ms" || unit == "ns" || unit == "MB" || unit == "KB" || unit == "bytes" || unit == "allocs";
+    }
+}
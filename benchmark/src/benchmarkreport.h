@@ -0,0 +1,61 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : BenchmarkReport collects per-frame samples of a benchmark run and writes
+//             them as JSON. Two reports can be compared to find regressions.
+//
+
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QJsonObject>
+
+class QTextStream;
+class QStringList;
+
+class BenchmarkReport
+{
+public:
+    BenchmarkReport();
+
+    // Run settings and environment written to the report as is
+    void setProperty(const QString& name, const QJsonValue& value);
+
+    // Adds a sample of the named metric.
+    void addSample(const QString& name, double value, const QString& unit);
+
+    // Metrics are summarised as mean, min, max, median and 95th percentile.
+    QJsonObject toJson() const;
+
+    // postcondition: false if the file couldn't be written
+    bool save(const QString& fileName) const;
+
+    // Compares the metric means of two reports. Metrics measured in time or memory are regressed
+    // when current exceeds base by more than the relative threshold and 0.05 units. Other metrics,
+    // eg. counts, are listed when they differ. Returns the number of regressions.
+    static int compare(const QJsonObject& base, const QJsonObject& current, double threshold, QTextStream& out);
+
+    // postcondition: false if the file couldn't be read or parsed
+    static bool load(const QString& fileName, QJsonObject& report);
+
+    // Saves the report, or writes it to stdout when neither a file nor a baseline is given, and compares
+    // it against the baseline report if one is given. Returns the exit code: 1 on regressions, 2 on errors.
+    int write(const QString& fileName, const QString& baseline, double threshold) const;
+
+    // Compares the base and current report files. Returns the exit code like write.
+    static int compareFiles(const QStringList& files, double threshold);
+
+private:
+    struct Metric
+    {
+        QString unit;
+        QVector<double> samples;
+    };
+
+    QJsonObject properties_;
+    QMap<QString, Metric> metrics_;
+};
+
+#endif // BENCHMARKREPORT_H
@@ -0,0 +1,251 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "benchmarkrunner.h"
+
+#include "inputscript.h"
+#include "benchmarkreport.h"
+#include "heapcounter.h"
+
+#include "common.h"
+#include "gpucounters.h"
+#include "assetfile.h"
+#include "qmlpresenter.h"
+#include "renderercontext.h"
+#include "scenefactory.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSurfaceFormat>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QStringList>
+#include <QMap>
+#include <QPair>
+#include <QDebug>
+
+using namespace Engine::Ui;
+
+BenchmarkRunner::BenchmarkRunner(SceneFactory& factory)
+    : factory_(factory)
+{
+}
+
+bool BenchmarkRunner::run(const Settings& settings, InputScript& script, BenchmarkReport& report)
+{
+    if(!factory_.sceneTypes().contains(settings.scene))
+    {
+        qWarning() << __FUNCTION__ << "Unknown scene" << settings.scene << "- available:" << factory_.sceneTypes();
+        return false;
+    }
+
+    QSurfaceFormat format;
+    format.setVersion(4, 2);
+    format.setSamples(1);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+
+    RendererContext context(format);
+    if(!context.createContext(nullptr))
+    {
+        return false;
+    }
+
+    // Nothing presents the render target, so the frame fences are deleted here
+    QObject::connect(&context, &RendererContext::renderTargetUpdated, [] (void* sync) {
+        gl->glDeleteSync(static_cast<GLsync>(sync));
+    });
+
+    QmlPresenter presenter(true);
+    presenter.setContext(&context);
+    presenter.setSceneFactory(&factory_);
+    presenter.setFixedTimestep(settings.timestep);
+
+    // Values aren't cleared with the watch list, since the pending loads are only reported
+    // when they change.
+    Values values;
+
+    QObject::connect(&presenter, &QmlPresenter::watchValue, [&values] (QString name, qreal value, QString unit) {
+        // Top materials change between reports, they are written as a property instead
+        if(!name.startsWith("Top material"))
+        {
+            values[name] = qMakePair(value, unit);
+        }
+    });
+
+    presenter.initialize();
+    presenter.viewSizeChanged(settings.size);
+    presenter.setScene(settings.scene);
+
+    report.setProperty("scene", settings.scene);
+    report.setProperty("width", settings.size.width());
+    report.setProperty("height", settings.size.height());
+    report.setProperty("frames", settings.frames);
+    report.setProperty("warmupFrames", settings.warmupFrames);
+    report.setProperty("timestep", static_cast<int>(settings.timestep));
+    report.setProperty("attributes", QJsonObject::fromVariantMap(settings.attributes));
+    report.setProperty("glVendor", reinterpret_cast<const char*>(gl->glGetString(GL_VENDOR)));
+    report.setProperty("glRenderer", reinterpret_cast<const char*>(gl->glGetString(GL_RENDERER)));
+    report.setProperty("glVersion", reinterpret_cast<const char*>(gl->glGetString(GL_VERSION)));
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    // The first frame creates the renderer and the scene, attributes need both
+    presenter.renderScene();
+
+    for(auto it = settings.attributes.begin(); it != settings.attributes.end(); ++it)
+    {
+        presenter.generalAttributeChanged(it.key(), it.value());
+    }
+
+    // Render until the asynchronously loaded resources have been initialised
+    int loadFrames = renderUntilLoaded(presenter, values, settings.loadTimeout);
+    if(loadFrames < 0)
+    {
+        return false;
+    }
+
+    report.setProperty("loadTime", static_cast<double>(loadTimer.elapsed()));
+    report.setProperty("loadFrames", loadFrames + 1);
+
+    const Engine::AssetFile::Stats assetStats = Engine::AssetFile::stats();
+    report.setProperty("archiveReads", assetStats.archiveReads);
+    report.setProperty("fileReads", assetStats.fileReads);
+
+    if(!settings.switchScene.isEmpty())
+    {
+        report.setProperty("switchScene", settings.switchScene);
+        return runSwitches(presenter, settings, values, report);
+    }
+
+    for(int frame = 0; frame < settings.warmupFrames; ++frame)
+    {
+        QCoreApplication::processEvents();
+        presenter.renderScene();
+    }
+
+    // Histograms only cover the measured frames
+    presenter.resetStatistics();
+
+    if(!settings.traceFile.isEmpty())
+    {
+        presenter.beginTrace(settings.traceFile);
+    }
+
+    for(int frame = 0; frame < settings.frames; ++frame)
+    {
+        script.apply(frame, *presenter.inputListener());
+        QCoreApplication::processEvents();
+
+        QElapsedTimer frameTimer;
+        frameTimer.start();
+
+        const quint64 allocations = HeapCounter::allocations();
+
+        presenter.renderScene();
+        report.addSample("Render scene time", frameTimer.nsecsElapsed() * 10e-7, "ms");
+
+        // Includes the profiling reports, so the steady state isn't necessarily zero
+        report.addSample("Heap allocations", static_cast<double>(HeapCounter::allocations() - allocations), "allocs");
+
+        for(auto it = values.begin(); it != values.end(); ++it)
+        {
+            report.addSample(it.key(), it->first, it->second);
+        }
+    }
+
+    presenter.endTrace();
+
+    // Materials drawing the most primitives in the measured frames, per frame
+    QJsonArray materials;
+    for(const GpuCounters::Item& item : GpuCounters::topItems(GpuCounters::PRIMITIVES, 10))
+    {
+        QJsonObject material;
+        material["name"] = item.name;
+        material["primitives"] = static_cast<double>(item.counts[GpuCounters::PRIMITIVES]) / settings.frames;
+        material["drawCalls"] = static_cast<double>(item.counts[GpuCounters::DRAW_CALLS]) / settings.frames;
+        material["textureBinds"] = static_cast<double>(item.counts[GpuCounters::TEXTURE_BINDS]) / settings.frames;
+        material["uniformUploads"] = static_cast<double>(item.counts[GpuCounters::UNIFORM_UPLOADS]) / settings.frames;
+
+        materials.append(material);
+    }
+
+    report.setProperty("topMaterials", materials);
+
+    if(!settings.histogramFile.isEmpty())
+    {
+        return presenter.dumpStatistics(settings.histogramFile);
+    }
+
+    return true;
+}
+
+int BenchmarkRunner::renderUntilLoaded(QmlPresenter& presenter, const Values& values, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int frames = 0;
+
+    do
+    {
+        if(timer.elapsed() > timeout * 1000)
+        {
+            qWarning() << __FUNCTION__ << "Scene resources didn't load in" << timeout << "seconds";
+            return -1;
+        }
+
+        QCoreApplication::processEvents();
+        presenter.renderScene();
+        ++frames;
+    }
+    while(values.value("Pending loads").first > 0);
+
+    return frames;
+}
+
+bool BenchmarkRunner::runSwitches(QmlPresenter& presenter, const Settings& settings, const Values& values,
+    BenchmarkReport& report)
+{
+    if(!factory_.sceneTypes().contains(settings.switchScene))
+    {
+        qWarning() << __FUNCTION__ << "Unknown scene" << settings.switchScene;
+        return false;
+    }
+
+    const QString scenes[] = { settings.switchScene, settings.scene };
+
+    // The first round trip loads both scenes
+    const int coldSwitches = 2;
+
+    for(int i = 0; i < coldSwitches + settings.frames; ++i)
+    {
+        const qreal hits = values.value("Resource cache hits").first;
+        const qreal misses = values.value("Resource cache misses").first;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        presenter.setScene(scenes[i % 2]);
+
+        const int frames = renderUntilLoaded(presenter, values, settings.loadTimeout);
+        if(frames < 0)
+        {
+            return false;
+        }
+
+        if(i >= coldSwitches)
+        {
+            report.addSample("Scene switch time", timer.nsecsElapsed() * 10e-7, "ms");
+            report.addSample("Scene switch frames", frames, "");
+            report.addSample("Scene switch cache hits", values.value("Resource cache hits").first - hits, "");
+            report.addSample("Scene switch cache misses", values.value("Resource cache misses").first - misses, "");
+            report.addSample("Retained CPU memory", values.value("Retained CPU memory").first, "MB");
+            report.addSample("Retained GPU memory", values.value("Retained GPU memory").first, "MB");
+        }
+    }
+
+    return true;
+}
\ No newline at end of file
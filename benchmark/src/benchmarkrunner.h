@@ -0,0 +1,69 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : BenchmarkRunner renders a scene headlessly through QmlPresenter using an
+//             offscreen context. Scene updates use a fixed time step and the camera follows
+//             an input script, so runs on the same machine are comparable.
+//
+
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <QString>
+#include <QSize>
+#include <QVariantMap>
+#include <QMap>
+#include <QPair>
+
+namespace Engine { namespace Ui {
+    class SceneFactory;
+    class QmlPresenter;
+}}
+
+class InputScript;
+class BenchmarkReport;
+
+class BenchmarkRunner
+{
+public:
+    struct Settings
+    {
+        QString scene;
+        QSize size;
+        int frames;
+        int warmupFrames;
+        unsigned int timestep;      // Milliseconds per scene update
+        int loadTimeout;            // Seconds to wait for the scene resources
+        QVariantMap attributes;     // General attributes, eg. "deferred rendering"
+        QString traceFile;          // Chrome trace of the measured frames, not written if empty
+        QString histogramFile;      // Frame, stage and load time histograms, not written if empty
+        QString switchScene;        // If set, the frames are switches between the two scenes
+    };
+
+    explicit BenchmarkRunner(Engine::Ui::SceneFactory& factory);
+
+    // Loads the scene, renders the warmup frames and samples the presenter's profiling
+    // values on every measured frame.
+    // postcondition: false if the context couldn't be created or the scene didn't load
+    bool run(const Settings& settings, InputScript& script, BenchmarkReport& report);
+
+private:
+    Engine::Ui::SceneFactory& factory_;
+
+    // Latest value and unit of every profiling value
+    typedef QMap<QString, QPair<qreal, QString>> Values;
+
+    // Renders until the pending loads have finished and returns the number of frames,
+    // or -1 if the loads didn't finish in timeout seconds.
+    int renderUntilLoaded(Engine::Ui::QmlPresenter& presenter, const Values& values, int timeout);
+
+    // Switches back and forth between the scenes, and samples the time and cache use of
+    // every switch until the scene has loaded. The first round trip isn't measured, so
+    // every measured switch returns to a scene which has been loaded before.
+    bool runSwitches(Engine::Ui::QmlPresenter& presenter, const Settings& settings, const Values& values,
+        BenchmarkReport& report);
+
+    BenchmarkRunner(const BenchmarkRunner&);
+    BenchmarkRunner& operator=(const BenchmarkRunner&);
+};
+
+#endif // BENCHMARKRUNNER_H
@@ -0,0 +1,84 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "heapcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<quint64> allocationCount(0);
+    std::atomic<quint64> allocationBytes(0);
+
+    void* countedAllocate(std::size_t size);
+}
+
+quint64 HeapCounter::allocations()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+quint64 HeapCounter::allocatedBytes()
+{
+    return allocationBytes.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+    void* ptr = countedAllocate(size);
+    if(ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) throw()
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
+
+namespace {
+    void* countedAllocate(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+        // Zero sized allocations have to return unique pointers
+        return std::malloc(size > 0 ? size : 1);
+    }
+}
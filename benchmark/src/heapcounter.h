@@ -0,0 +1,26 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : HeapCounter counts calls to the global operator new of the benchmark executable,
+//             which replaces it. Engine and common are linked statically and count; Qt's own
+//             allocations go through its DLLs and malloc and are not seen.
+//
+
+#ifndef HEAPCOUNTER_H
+#define HEAPCOUNTER_H
+
+#include <QtGlobal>
+
+class HeapCounter
+{
+public:
+    // Number of operator new calls since startup, on all threads.
+    static quint64 allocations();
+
+    // Bytes requested from operator new since startup. Freed memory is not subtracted.
+    static quint64 allocatedBytes();
+
+private:
+    HeapCounter();
+};
+
+#endif // HEAPCOUNTER_H
@@ -0,0 +1,201 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "inputscript.h"
+
+#include "inputeventlistener.h"
+#include "inputstate.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QKeySequence>
+#include <QDebug>
+
+using namespace Engine::Ui;
+
+namespace {
+    // Returns 0 if the key name is not recognised
+    int keyCode(const QString& name);
+}
+
+InputScript::InputScript()
+{
+}
+
+bool InputScript::load(const QString& fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if(!document.isArray())
+    {
+        qWarning() << __FUNCTION__ << fileName << error.errorString();
+        return false;
+    }
+
+    events_.clear();
+
+    for(const QJsonValue& value : document.array())
+    {
+        QJsonObject object = value.toObject();
+        int frame = static_cast<int>(object["frame"].toDouble());
+        int frames = static_cast<int>(object["frames"].toDouble());
+
+        if(object.contains("key"))
+        {
+            int key = keyCode(object["key"].toString());
+            if(key == 0)
+            {
+                qWarning() << __FUNCTION__ << "Unknown key" << object["key"].toString();
+                return false;
+            }
+
+            if(frames > 0)
+            {
+                addKey(frame, frames, key);
+            }
+
+            else
+            {
+                Event event = { frame, 0, key, object["down"].toBool(true), QPoint(), 0 };
+                events_.push_back(event);
+            }
+        }
+
+        else
+        {
+            QJsonArray mouse = object["mouse"].toArray();
+            QPoint move(static_cast<int>(mouse.at(0).toDouble()), static_cast<int>(mouse.at(1).toDouble()));
+
+            Event event = { frame, qMax(1, frames), 0, false, move, static_cast<int>(object["wheel"].toDouble()) };
+            events_.push_back(event);
+        }
+    }
+
+    return true;
+}
+
+void InputScript::setDefault()
+{
+    events_.clear();
+
+    // Looking around requires the right mouse button
+    Event look = { 0, 0, InputState::KEY_MOUSE_RIGHT, true, QPoint(), 0 };
+    events_.push_back(look);
+
+    addMouse(0, 120, QPoint(6, 0));
+    addKey(120, 180, Qt::Key_W);
+    addMouse(300, 120, QPoint(-8, 1));
+    addKey(420, 180, Qt::Key_D);
+    addKey(420, 180, Qt::Key_S);
+
+    Event release = { 600, 0, InputState::KEY_MOUSE_RIGHT, false, QPoint(), 0 };
+    events_.push_back(release);
+}
+
+void InputScript::apply(int frame, InputEventListener& listener)
+{
+    for(const Event& event : events_)
+    {
+        if(event.key != 0)
+        {
+            if(event.frame != frame)
+            {
+                continue;
+            }
+
+            if(event.key == InputState::KEY_MOUSE_LEFT || event.key == InputState::KEY_MOUSE_RIGHT)
+            {
+                Qt::MouseButton button = event.key == InputState::KEY_MOUSE_LEFT ? Qt::LeftButton : Qt::RightButton;
+
+                if(event.down)
+                {
+                    listener.mousePressEvent(QMouseEvent(QEvent::MouseButtonPress, mousePos_, button, button, Qt::NoModifier));
+                }
+
+                else
+                {
+                    listener.mouseReleaseEvent(QMouseEvent(QEvent::MouseButtonRelease, mousePos_, button, Qt::NoButton, Qt::NoModifier));
+                }
+            }
+
+            else if(event.down)
+            {
+                listener.keyPressEvent(QKeyEvent(QEvent::KeyPress, event.key, Qt::NoModifier));
+            }
+
+            else
+            {
+                listener.keyReleaseEvent(QKeyEvent(QEvent::KeyRelease, event.key, Qt::NoModifier));
+            }
+        }
+
+        else if(frame >= event.frame && frame < event.frame + event.frames)
+        {
+            if(!event.mouse.isNull())
+            {
+                mousePos_ += event.mouse;
+                listener.mouseMoveEvent(QMouseEvent(QEvent::MouseMove, mousePos_, Qt::NoButton, Qt::NoButton, Qt::NoModifier));
+            }
+
+            if(event.wheel != 0)
+            {
+                listener.wheelEvent(QWheelEvent(mousePos_, event.wheel * 120, Qt::NoButton, Qt::NoModifier));
+            }
+        }
+    }
+}
+
+int InputScript::length() const
+{
+    int last = 0;
+    for(const Event& event : events_)
+    {
+        last = qMax(last, event.frame + qMax(1, event.frames));
+    }
+
+    return last;
+}
+
+void InputScript::addKey(int frame, int frames, int key)
+{
+    Event press = { frame, 0, key, true, QPoint(), 0 };
+    Event release = { frame + frames, 0, key, false, QPoint(), 0 };
+
+    events_.push_back(press);
+    events_.push_back(release);
+}
+
+void InputScript::addMouse(int frame, int frames, const QPoint& move)
+{
+    Event event = { frame, frames, 0, false, move, 0 };
+    events_.push_back(event);
+}
+
+namespace {
+    int keyCode(const QString& name)
+    {
+        if(name == "MouseLeft")
+        {
+            return InputState::KEY_MOUSE_LEFT;
+        }
+
+        else if(name == "MouseRight")
+        {
+            return InputState::KEY_MOUSE_RIGHT;
+        }
+
+        QKeySequence sequence(name);
+        return sequence.isEmpty() ? 0 : sequence[0];
+    }
+}
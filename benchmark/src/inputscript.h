@@ -0,0 +1,60 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : InputScript replays timed key and mouse events to an InputEventListener,
+//             so that every benchmark run follows the same camera path.
+//
+
+#ifndef INPUTSCRIPT_H
+#define INPUTSCRIPT_H
+
+#include <QString>
+#include <QVector>
+#include <QPoint>
+
+namespace Engine { namespace Ui {
+    class InputEventListener;
+}}
+
+class InputScript
+{
+public:
+    InputScript();
+
+    // Reads the events from a JSON array, eg.
+    // [ { "frame": 0, "key": "MouseRight", "down": true },
+    //   { "frame": 0, "frames": 120, "key": "W" },
+    //   { "frame": 120, "frames": 90, "mouse": [ 4, 0 ] } ]
+    // Keys are Qt key names without the Key_ prefix, or MouseLeft and MouseRight.
+    // A key with a duration is released after the given frames. Mouse moves and wheel
+    // steps are applied on every frame of the duration.
+    // postcondition: false if the file couldn't be read or parsed
+    bool load(const QString& fileName);
+
+    // Default path: look around, fly forward, turn and strafe back.
+    void setDefault();
+
+    // Applies the events of the given frame.
+    void apply(int frame, Engine::Ui::InputEventListener& listener);
+
+    // Frame after the last event
+    int length() const;
+
+private:
+    struct Event
+    {
+        int frame;
+        int frames;
+        int key;
+        bool down;
+        QPoint mouse;
+        int wheel;
+    };
+
+    QVector<Event> events_;
+    QPoint mousePos_;
+
+    void addKey(int frame, int frames, int key);
+    void addMouse(int frame, int frames, const QPoint& move);
+};
+
+#endif // INPUTSCRIPT_H
@@ -0,0 +1,203 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Headless benchmark for the demo scenes. Writes the profiling values of
+//             a run as JSON, or compares two runs and fails on regressions. A run can also
+//             be compared against a baseline report directly with --baseline.
+//
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+#include "scenefactory.h"
+#include "benchmarkrunner.h"
+#include "benchmarkreport.h"
+#include "inputscript.h"
+#include "mathbenchmark.h"
+#include "prefabbenchmark.h"
+#include "microbenchmark.h"
+#include "pagecache.h"
+#include "assetfile.h"
+
+// Demo scenes
+#include "basicscene.h"
+#include "sponzascene.h"
+#include "lightscene.h"
+#include "gameoflife.h"
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders a scene offscreen and reports per-frame profiling values.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("base current", "Reports to compare with --compare.");
+
+    QCommandLineOption sceneOption("scene", "Scene to render.", "name", "Sponza");
+    QCommandLineOption framesOption("frames", "Measured frames, defaults to the script length.", "count");
+    QCommandLineOption warmupOption("warmup", "Frames rendered before measuring.", "count", "60");
+    QCommandLineOption timestepOption("timestep", "Scene update time step.", "ms", "16");
+    QCommandLineOption sizeOption("size", "Render target size.", "WxH", "1280x720");
+    QCommandLineOption scriptOption("script", "Input script replacing the default camera path.", "file");
+    QCommandLineOption setOption("set", "General attribute, eg. \"deferred rendering=false\".", "name=value");
+    QCommandLineOption seedOption("seed", "Random seed of the scenes.", "seed", "1");
+    QCommandLineOption gridOption("grid", "Game of life grid size.", "WxH", "512x128");
+    QCommandLineOption timeoutOption("load-timeout", "Seconds to wait for the scene to load.", "seconds", "300");
+    QCommandLineOption outputOption("output", "Report file, written to stdout if not given.", "file");
+    QCommandLineOption traceOption("trace", "Writes the measured frames as Chrome trace JSON.", "file");
+    QCommandLineOption histogramOption("histograms", "Writes frame, stage and load time histograms as JSON.", "file");
+    QCommandLineOption mathOption("math", "Times the math types instead of rendering, --frames gives the repetitions.");
+    QCommandLineOption switchOption("ping-pong", "Switches between --scene and this scene instead of rendering frames, --frames gives the switches.", "name");
+    QCommandLineOption prefabOption("prefab", "Times spawning prefab instances and clones, --frames gives the repetitions.");
+    QCommandLineOption microOption("micro", "Times engine hot paths with fixed fixtures instead of rendering, --frames gives the repetitions.");
+    QCommandLineOption filterOption("filter", "Runs only the --micro cases whose name contains the text.", "text");
+    QCommandLineOption archiveOption("archive", "Mounts an asset archive, can be given more than once.", "file");
+    QCommandLineOption dropCacheOption("drop-cache", "Evicts the file or directory from the file cache before loading.", "path");
+    QCommandLineOption compareOption("compare", "Compares two reports instead of running.");
+    QCommandLineOption baselineOption("baseline", "Compares the run against a report and fails on regressions.", "file");
+    QCommandLineOption thresholdOption("threshold", "Regression threshold for --compare and --baseline.", "percent", "5");
+
+    parser.addOptions(QList<QCommandLineOption>() << sceneOption << framesOption << warmupOption
+        << timestepOption << sizeOption << scriptOption << setOption << seedOption << gridOption << timeoutOption
+        << outputOption << traceOption << histogramOption << switchOption << mathOption << prefabOption << microOption << filterOption
+        << archiveOption << dropCacheOption << compareOption << baselineOption << thresholdOption);
+
+    parser.process(app);
+
+    const double threshold = parser.value(thresholdOption).toDouble() / 100;
+
+    if(parser.isSet(compareOption))
+    {
+        return BenchmarkReport::compareFiles(parser.positionalArguments(), threshold);
+    }
+
+    if(parser.isSet(mathOption))
+    {
+        BenchmarkReport report;
+        MathBenchmark benchmark;
+        benchmark.run(parser.isSet(framesOption) ? parser.value(framesOption).toInt() : 100, report);
+
+        return report.write(parser.value(outputOption), parser.value(baselineOption), threshold);
+    }
+
+    if(parser.isSet(prefabOption))
+    {
+        BenchmarkReport report;
+        PrefabBenchmark benchmark;
+
+        if(!benchmark.run(parser.isSet(framesOption) ? parser.value(framesOption).toInt() : 20, report))
+        {
+            return 2;
+        }
+
+        return report.write(parser.value(outputOption), parser.value(baselineOption), threshold);
+    }
+
+    if(parser.isSet(microOption))
+    {
+        BenchmarkReport report;
+        MicroBenchmark benchmark;
+
+        if(!benchmark.run(parser.isSet(framesOption) ? parser.value(framesOption).toInt() : 20,
+            parser.value(filterOption), report))
+        {
+            return 2;
+        }
+
+        return report.write(parser.value(outputOption), parser.value(baselineOption), threshold);
+    }
+
+    InputScript script;
+    if(parser.isSet(scriptOption))
+    {
+        if(!script.load(parser.value(scriptOption)))
+        {
+            return 2;
+        }
+    }
+
+    else
+    {
+        script.setDefault();
+    }
+
+    BenchmarkRunner::Settings settings;
+    settings.scene = parser.value(sceneOption);
+    settings.switchScene = parser.value(switchOption);
+    settings.frames = parser.isSet(framesOption) ? parser.value(framesOption).toInt()
+        : settings.switchScene.isEmpty() ? script.length() : 10;
+    settings.warmupFrames = parser.value(warmupOption).toInt();
+    settings.timestep = parser.value(timestepOption).toUInt();
+    settings.loadTimeout = parser.value(timeoutOption).toInt();
+    settings.traceFile = parser.value(traceOption);
+    settings.histogramFile = parser.value(histogramOption);
+
+    QStringList size = parser.value(sizeOption).split('x');
+    settings.size = size.count() == 2 ? QSize(size[0].toInt(), size[1].toInt()) : QSize();
+
+    if(settings.frames < 1 || settings.size.isEmpty())
+    {
+        qWarning() << "Invalid frame count or render target size";
+        return 2;
+    }
+
+    // Attribute values are passed as strings, QVariant converts them as the UI values would be
+    for(const QString& attribute : parser.values(setOption))
+    {
+        int separator = attribute.indexOf('=');
+        if(separator < 1)
+        {
+            qWarning() << "Invalid attribute" << attribute;
+            return 2;
+        }
+
+        settings.attributes.insert(attribute.left(separator).toLower(), attribute.mid(separator + 1));
+    }
+
+    // Cold start: archives are mapped only after their pages have been evicted
+    for(const QString& path : parser.values(dropCacheOption))
+    {
+        if(!PageCache::evict(path))
+        {
+            return 2;
+        }
+    }
+
+    for(const QString& archive : parser.values(archiveOption))
+    {
+        if(!Engine::AssetFile::mount(archive))
+        {
+            return 2;
+        }
+    }
+
+    GameOfLife::setRandomSeed(parser.value(seedOption).toUInt());
+
+    QStringList grid = parser.value(gridOption).split('x');
+    if(grid.count() != 2 || grid[0].toInt() < 1 || grid[1].toInt() < 1)
+    {
+        qWarning() << "Invalid grid size" << parser.value(gridOption);
+        return 2;
+    }
+
+    GameOfLife::setGridSize(QSize(grid[0].toInt(), grid[1].toInt()));
+
+    // Register scene types
+    Engine::Ui::SceneFactory factory;
+
+    factory.registerScene<BasicScene>("Shittyboxes");
+    factory.registerScene<SponzaScene>("Sponza");
+    factory.registerScene<LightScene>("Lights");
+    factory.registerScene<GameOfLife>("Game of life");
+
+    BenchmarkReport report;
+    BenchmarkRunner runner(factory);
+
+    if(!runner.run(settings, script, report))
+    {
+        return 2;
+    }
+
+    return report.write(parser.value(outputOption), parser.value(baselineOption), threshold);
+}
@@ -0,0 +1,213 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "mathbenchmark.h"
+
+#include "benchmarkreport.h"
+
+#include <QElapsedTimer>
+
+namespace {
+    // Linear congruential generator, qrand would change the scenes' random state
+    float random(unsigned int& state, float min, float max);
+}
+
+MathBenchmark::MathBenchmark()
+    : sink_(0)
+{
+    unsigned int state = 1;
+
+    for(int i = 0; i < FIXTURES; ++i)
+    {
+        QVector3D axis(random(state, -1, 1), random(state, -1, 1), random(state, -1, 1) + 2.0f);
+
+        QMatrix4x4 matrix;
+        matrix.translate(random(state, -100, 100), random(state, -100, 100), random(state, -100, 100));
+        matrix.rotate(random(state, 0, 360), axis.normalized());
+        matrix.scale(random(state, 0.5f, 2.0f));
+
+        QQuaternion quaternion(random(state, -1, 1), random(state, -1, 1), random(state, -1, 1), random(state, -1, 1));
+        QVector3D center(random(state, -10, 10), random(state, -10, 10), random(state, -10, 10));
+        QVector3D extent(random(state, 0.1f, 5), random(state, 0.1f, 5), random(state, 0.1f, 5));
+
+        matrices_.push_back(matrix);
+        quaternions_.push_back(quaternion);
+        centers_.push_back(center);
+        extents_.push_back(extent);
+
+        simdMatrices_.push_back(Simd::Mat4::fromQt(matrix));
+        simdQuaternions_.push_back(Simd::Quat::fromQt(quaternion));
+        simdCenters_.push_back(Simd::Vec4::fromQt(center, 1.0f));
+        simdExtents_.push_back(Simd::Vec4::fromQt(extent, 0.0f));
+    }
+}
+
+void MathBenchmark::run(int repetitions, BenchmarkReport& report)
+{
+    struct Case
+    {
+        const char* name;
+        double (MathBenchmark::*function)();
+    };
+
+    const Case cases[] = {
+        { "Matrix multiply Qt", &MathBenchmark::multiplyQt },
+        { "Matrix multiply SIMD", &MathBenchmark::multiplySimd },
+        { "AABB transform Qt", &MathBenchmark::transformBoxQt },
+        { "AABB transform SIMD", &MathBenchmark::transformBoxSimd },
+        { "Quaternion normalize Qt", &MathBenchmark::normalizeQt },
+        { "Quaternion normalize SIMD", &MathBenchmark::normalizeSimd }
+    };
+
+    for(const Case& item : cases)
+    {
+        // Warms up the caches
+        (this->*item.function)();
+
+        for(int i = 0; i < repetitions; ++i)
+        {
+            report.addSample(item.name, (this->*item.function)(), "ns");
+        }
+    }
+
+    // Keeps the results from being optimised away
+    report.setProperty("mathChecksum", sink_);
+}
+
+double MathBenchmark::multiplyQt()
+{
+    const QMatrix4x4* matrices = matrices_.constData();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QMatrix4x4 result;
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 1; i < FIXTURES; ++i)
+        {
+            result = matrices[i - 1] * matrices[i];
+            sink_ += result(0, 3);
+        }
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * (FIXTURES - 1));
+}
+
+double MathBenchmark::multiplySimd()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 1; i < FIXTURES; ++i)
+        {
+            const Simd::Mat4 result = simdMatrices_[i - 1] * simdMatrices_[i];
+            sink_ += result.m[3][0];
+        }
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * (FIXTURES - 1));
+}
+
+double MathBenchmark::transformBoxQt()
+{
+    const QMatrix4x4* matrices = matrices_.constData();
+    const QVector3D* centers = centers_.constData();
+    const QVector3D* extents = extents_.constData();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 0; i < FIXTURES; ++i)
+        {
+            const QMatrix4x4& matrix = matrices[i];
+            const QVector3D& center = centers[i];
+            const QVector3D& extent = extents[i];
+
+            // Encloses the eight transformed corners
+            QVector3D min = matrix * (center - extent);
+            QVector3D max = min;
+
+            for(int corner = 1; corner < 8; ++corner)
+            {
+                QVector3D offset(corner & 1 ? extent.x() : -extent.x(),
+                    corner & 2 ? extent.y() : -extent.y(),
+                    corner & 4 ? extent.z() : -extent.z());
+
+                QVector3D point = matrix * (center + offset);
+                min = QVector3D(qMin(min.x(), point.x()), qMin(min.y(), point.y()), qMin(min.z(), point.z()));
+                max = QVector3D(qMax(max.x(), point.x()), qMax(max.y(), point.y()), qMax(max.z(), point.z()));
+            }
+
+            sink_ += max.x() - min.x();
+        }
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * FIXTURES);
+}
+
+double MathBenchmark::transformBoxSimd()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Simd::Vec4 center, extent;
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 0; i < FIXTURES; ++i)
+        {
+            Simd::transformBox(simdMatrices_[i], simdCenters_[i], simdExtents_[i], center, extent);
+            sink_ += 2.0f * extent.x();
+        }
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * FIXTURES);
+}
+
+double MathBenchmark::normalizeQt()
+{
+    const QQuaternion* quaternions = quaternions_.constData();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 0; i < FIXTURES; ++i)
+        {
+            sink_ += quaternions[i].normalized().x();
+        }
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * FIXTURES);
+}
+
+double MathBenchmark::normalizeSimd()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 0; i < FIXTURES; ++i)
+        {
+            sink_ += simdQuaternions_[i].normalized().v[0];
+        }
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * FIXTURES);
+}
+
+namespace {
+    float random(unsigned int& state, float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * static_cast<float>(state >> 8) / static_cast<float>(1 << 24);
+    }
+}
@@ -0,0 +1,57 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : MathBenchmark times matrix multiplication, bounding box transformation and quaternion
+//             normalisation with the Qt types and the aligned Simd types. Every repetition is
+//             added to the report as a sample, so math runs can be compared like scene runs.
+//
+
+#ifndef MATHBENCHMARK_H
+#define MATHBENCHMARK_H
+
+#include "simdmath.h"
+
+#include <QMatrix4x4>
+#include <QQuaternion>
+#include <QVector>
+
+#include <vector>
+
+class BenchmarkReport;
+
+class MathBenchmark
+{
+public:
+    // Fixtures are generated from a fixed seed, so every run uses the same data.
+    MathBenchmark();
+
+    // Samples are nanoseconds per operation.
+    void run(int repetitions, BenchmarkReport& report);
+
+private:
+    enum { FIXTURES = 1024, ITERATIONS = 64 };
+
+    QVector<QMatrix4x4> matrices_;
+    QVector<QQuaternion> quaternions_;
+    QVector<QVector3D> centers_;
+    QVector<QVector3D> extents_;
+
+    // Allocations are 16 byte aligned on x64
+    std::vector<Simd::Mat4> simdMatrices_;
+    std::vector<Simd::Quat> simdQuaternions_;
+    std::vector<Simd::Vec4> simdCenters_;
+    std::vector<Simd::Vec4> simdExtents_;
+
+    float sink_;
+
+    double multiplyQt();
+    double multiplySimd();
+    double transformBoxQt();
+    double transformBoxSimd();
+    double normalizeQt();
+    double normalizeSimd();
+
+    MathBenchmark(const MathBenchmark&);
+    MathBenchmark& operator=(const MathBenchmark&);
+};
+
+#endif // MATHBENCHMARK_H
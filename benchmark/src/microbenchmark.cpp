@@ -0,0 +1,732 @@
+//
+//  Author   : Matti Määttä
+//  Summary  :
+//
+
+#include "microbenchmark.h"
+
+#include "benchmarkreport.h"
+
+#include "frustum.h"
+#include "renderqueue.h"
+#include "renderitemsorter.h"
+#include "shaderpreprocessor.h"
+#include "texture2dresource.h"
+#include "framearena.h"
+#include "mathelp.h"
+#include "common.h"
+
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QSurfaceFormat>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QImage>
+#include <QFile>
+#include <QtEndian>
+#include <QDebug>
+
+#include <assimp/scene.h>
+#include <gli/gli.hpp>
+
+#include <functional>
+#include <cstring>
+
+using namespace Engine;
+
+namespace {
+    // Linear congruential generator, qrand would change the scenes' random state
+    float random(unsigned int& state, float min, float max);
+
+    // Defines of the shader fixture, enabling every other include
+    ShaderData::DefineMap shaderDefines(int includes);
+
+    // Returns a 1x1 texture of the given value.
+    Material::TexturePtr createTexture(unsigned char value);
+
+    // Writes a single level DXT texture of random blocks.
+    bool writeDDS(const QString& fileName, const QByteArray& fourCC, int blockSize, int size, unsigned int& state);
+
+    // Creates the context, makes it current on the surface and sets the global function object.
+    bool createContext(QOpenGLContext& context, QOffscreenSurface& surface);
+}
+
+MicroBenchmark::MicroBenchmark()
+    : seed_(1), sink_(0), scene_(nullptr)
+{
+    createScene();
+    createBoxes();
+    createHierarchies();
+    createQueueItems();
+
+    // Imported meshes are also the vertex sets of the bounding box case
+    NodeImport::importMeshes(meshes_, scene_->mMeshes, scene_->mNumMeshes);
+}
+
+MicroBenchmark::~MicroBenchmark()
+{
+    delete scene_;
+}
+
+bool MicroBenchmark::run(int repetitions, const QString& filter, BenchmarkReport& report)
+{
+    if(!dir_.isValid() || !writeShaders() || !writeTextures())
+    {
+        qWarning() << __FUNCTION__ << "Failed to write fixtures to" << dir_.path();
+        return false;
+    }
+
+    auto measure = [&] (const QString& name, const std::function<double()>& function, const QString& unit)
+    {
+        if(!name.contains(filter, Qt::CaseInsensitive))
+        {
+            return;
+        }
+
+        // Warms up the caches
+        if(function() < 0)
+        {
+            qWarning() << "MicroBenchmark::run" << "Skipping" << name;
+            return;
+        }
+
+        for(int i = 0; i < repetitions; ++i)
+        {
+            report.addSample(name, function(), unit);
+        }
+    };
+
+    struct Case
+    {
+        const char* name;
+        double (MicroBenchmark::*function)();
+        const char* unit;
+    };
+
+    const Case cases[] = {
+        { "AABB resize", &MicroBenchmark::resizeBoxes, "ns" },
+        { "Frustum test", &MicroBenchmark::frustumQt, "ns" },
+        { "Frustum test SIMD", &MicroBenchmark::frustumSimd, "ns" },
+        { "Propagate deep hierarchy", &MicroBenchmark::propagateDeep, "ns" },
+        { "Propagate wide hierarchy", &MicroBenchmark::propagateWide, "ns" },
+        { "Shader preprocess cold", &MicroBenchmark::preprocessCold, "ns" },
+        { "Shader preprocess cached", &MicroBenchmark::preprocessCached, "ns" },
+        { "Import meshes", &MicroBenchmark::importMeshes, "ms" }
+    };
+
+    for(const Case& item : cases)
+    {
+        measure(item.name, std::bind(item.function, this), item.unit);
+    }
+
+    struct TextureCase
+    {
+        const char* name;
+        const char* file;
+        TextureConversion conversion;
+    };
+
+    const TextureCase textures[] = {
+        { "Texture decode PNG", "texture.png", TC_RGBA },
+        { "Texture decode PNG grayscale", "texture.png", TC_GRAYSCALE },
+        { "Texture decode JPEG", "texture.jpg", TC_SRGBA },
+        { "Texture decode BMP", "texture.bmp", TC_RGBA },
+        { "Texture decode DXT1", "texture_dxt1.dds", TC_SRGBA },
+        { "Texture decode DXT5", "texture_dxt5.dds", TC_RGBA }
+    };
+
+    for(const TextureCase& item : textures)
+    {
+        measure(item.name, std::bind(&MicroBenchmark::decodeTexture, this,
+            dir_.path() + "/" + item.file, item.conversion), "ms");
+    }
+
+    // Renderables create vertex arrays and materials upload their textures, which needs a context,
+    // eg. Mesa llvmpipe. The other cases don't touch OpenGL.
+    const QStringList queueCases = QStringList() << "Render queue fill" << "Render queue sort";
+
+    if(!queueCases.filter(filter, Qt::CaseInsensitive).isEmpty())
+    {
+        QSurfaceFormat format;
+        format.setVersion(4, 2);
+        format.setProfile(QSurfaceFormat::CoreProfile);
+
+        QOffscreenSurface surface;
+        surface.setFormat(format);
+        surface.create();
+
+        QOpenGLContext context;
+        context.setFormat(format);
+
+        if(createContext(context, surface))
+        {
+            createQueueFixtures();
+
+            measure(queueCases[0], std::bind(&MicroBenchmark::fillQueue, this), "ns");
+            measure(queueCases[1], std::bind(&MicroBenchmark::sortQueue, this), "ns");
+
+            // Released while the context exists
+            releaseQueueFixtures();
+            context.doneCurrent();
+        }
+
+        else
+        {
+            qWarning() << __FUNCTION__ << "No OpenGL context, skipping the render queue cases";
+        }
+
+        gl = nullptr;
+    }
+
+    report.setProperty("microFilter", filter);
+
+    // Keeps the results from being optimised away
+    report.setProperty("microChecksum", sink_);
+
+    return true;
+}
+
+double MicroBenchmark::resizeBoxes()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 vertices = 0;
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(const NodeImport::IndexMesh& mesh : meshes_)
+        {
+            AABB box(mesh.vertices.first(), mesh.vertices.first());
+            for(const QVector3D& vertex : mesh.vertices)
+            {
+                box.resize(vertex);
+            }
+
+            sink_ += box.width();
+            vertices += mesh.vertices.count();
+        }
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / vertices;
+}
+
+double MicroBenchmark::frustumQt()
+{
+    const AABB* boxes = boxes_.constData();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int visible = 0;
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 0; i < BOXES; ++i)
+        {
+            visible += isInsideFrustum(boxes[i], viewProjection_) ? 1 : 0;
+        }
+    }
+
+    sink_ += visible;
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * BOXES);
+}
+
+double MicroBenchmark::frustumSimd()
+{
+    const AABB* boxes = boxes_.constData();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int visible = 0;
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        for(int i = 0; i < BOXES; ++i)
+        {
+            visible += isInsideFrustum(boxes[i], simdViewProjection_) ? 1 : 0;
+        }
+    }
+
+    sink_ += visible;
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * BOXES);
+}
+
+double MicroBenchmark::propagateDeep()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        // Moving the root dirties every node below it
+        deepRoot_.rotate(1.0f, UNIT_Y);
+        deepRoot_.propagate();
+
+        sink_ += deepRoot_.getChild(0)->transformation()(0, 3);
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * HIERARCHY_NODES);
+}
+
+double MicroBenchmark::propagateWide()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        wideRoot_.rotate(1.0f, UNIT_Y);
+        wideRoot_.propagate();
+
+        sink_ += wideRoot_.getChild(0)->transformation()(0, 3);
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (ITERATIONS * HIERARCHY_NODES);
+}
+
+double MicroBenchmark::fillQueue()
+{
+    RenderQueue queue;
+    qint64 elapsed = 0;
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        // Queues are refilled every frame
+        FrameArena::endFrame();
+        queue.clear();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for(int i = 0; i < QUEUE_ITEMS; ++i)
+        {
+            queue.setModelView(modelViews_.constData() + i);
+            queue.addNode(materials_[itemMaterials_[i]].get(), renderables_[itemRenderables_[i]].get());
+        }
+
+        elapsed += timer.nsecsElapsed();
+        sink_ += queue.count();
+    }
+
+    return static_cast<double>(elapsed) / (ITERATIONS * QUEUE_ITEMS);
+}
+
+double MicroBenchmark::sortQueue()
+{
+    RenderQueue queue;
+    qint64 elapsed = 0;
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        FrameArena::endFrame();
+        queue.clear();
+
+        for(int i = 0; i < QUEUE_ITEMS; ++i)
+        {
+            queue.setModelView(modelViews_.constData() + i);
+            queue.addNode(materials_[itemMaterials_[i]].get(), renderables_[itemRenderables_[i]].get());
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        queue.sort(RenderItemSorter());
+
+        elapsed += timer.nsecsElapsed();
+        sink_ += queue.count();
+    }
+
+    return static_cast<double>(elapsed) / (ITERATIONS * QUEUE_ITEMS);
+}
+
+double MicroBenchmark::preprocessCold()
+{
+    const QString fileName = dir_.path() + "/main.frag";
+    const ShaderData::DefineMap defines = shaderDefines(SHADER_INCLUDES);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        // Every file is read and tokenised again
+        ShaderPreprocessor::clearCache();
+
+        ShaderPreprocessor preprocessor(defines);
+        QByteArray output;
+
+        if(!preprocessor.process(fileName, output))
+        {
+            return -1;
+        }
+
+        sink_ += output.size();
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / ITERATIONS;
+}
+
+double MicroBenchmark::preprocessCached()
+{
+    const QString fileName = dir_.path() + "/main.frag";
+    const ShaderData::DefineMap defines = shaderDefines(SHADER_INCLUDES);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        ShaderPreprocessor preprocessor(defines);
+        QByteArray output;
+
+        if(!preprocessor.process(fileName, output))
+        {
+            return -1;
+        }
+
+        sink_ += output.size();
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / ITERATIONS;
+}
+
+double MicroBenchmark::importMeshes()
+{
+    QVector<NodeImport::IndexMesh> meshes;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < ITERATIONS; ++n)
+    {
+        NodeImport::importMeshes(meshes, scene_->mMeshes, scene_->mNumMeshes);
+        sink_ += meshes.count();
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (1000000.0 * ITERATIONS);
+}
+
+double MicroBenchmark::decodeTexture(const QString& fileName, TextureConversion conversion)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int n = 0; n < TEXTURE_ITERATIONS; ++n)
+    {
+        gli::texture2D* texture = loadTexture(fileName, conversion);
+        if(texture == nullptr)
+        {
+            return -1;
+        }
+
+        sink_ += texture->size();
+        delete texture;
+    }
+
+    return static_cast<double>(timer.nsecsElapsed()) / (1000000.0 * TEXTURE_ITERATIONS);
+}
+
+void MicroBenchmark::createScene()
+{
+    scene_ = new aiScene();
+    scene_->mNumMeshes = MESHES;
+    scene_->mMeshes = new aiMesh*[MESHES];
+
+    for(int i = 0; i < MESHES; ++i)
+    {
+        aiMesh* mesh = new aiMesh();
+        mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+        mesh->mMaterialIndex = i % 4;
+
+        mesh->mNumVertices = MESH_VERTICES;
+        mesh->mVertices = new aiVector3D[MESH_VERTICES];
+        mesh->mNormals = new aiVector3D[MESH_VERTICES];
+        mesh->mTextureCoords[0] = new aiVector3D[MESH_VERTICES];
+        mesh->mNumUVComponents[0] = 2;
+
+        // Half of the meshes are bump mapped
+        if(i % 2 == 0)
+        {
+            mesh->mTangents = new aiVector3D[MESH_VERTICES];
+            mesh->mBitangents = new aiVector3D[MESH_VERTICES];
+        }
+
+        const aiVector3D center(random(seed_, -100, 100), random(seed_, 0, 20), random(seed_, -100, 100));
+
+        for(int v = 0; v < MESH_VERTICES; ++v)
+        {
+            mesh->mVertices[v] = center + aiVector3D(random(seed_, -5, 5), random(seed_, -5, 5), random(seed_, -5, 5));
+            mesh->mNormals[v] = aiVector3D(0, 1, 0);
+            mesh->mTextureCoords[0][v] = aiVector3D(random(seed_, 0, 1), random(seed_, 0, 1), 0);
+
+            if(mesh->mTangents != nullptr)
+            {
+                mesh->mTangents[v] = aiVector3D(1, 0, 0);
+                mesh->mBitangents[v] = aiVector3D(0, 0, 1);
+            }
+        }
+
+        // Two triangles per vertex like a closed surface, sharing nearby vertices
+        mesh->mNumFaces = 2 * MESH_VERTICES;
+        mesh->mFaces = new aiFace[mesh->mNumFaces];
+
+        for(unsigned int f = 0; f < mesh->mNumFaces; ++f)
+        {
+            aiFace& face = mesh->mFaces[f];
+            face.mNumIndices = 3;
+            face.mIndices = new unsigned int[3];
+
+            for(unsigned int k = 0; k < 3; ++k)
+            {
+                face.mIndices[k] = (f / 2 + k * (1 + f % 2)) % MESH_VERTICES;
+            }
+        }
+
+        scene_->mMeshes[i] = mesh;
+    }
+}
+
+void MicroBenchmark::createBoxes()
+{
+    // Boxes spread around the camera, some in view
+    for(int i = 0; i < BOXES; ++i)
+    {
+        QVector3D center(random(seed_, -200, 200), random(seed_, -10, 30), random(seed_, -200, 200));
+        QVector3D extent(random(seed_, 0.5f, 10), random(seed_, 0.5f, 10), random(seed_, 0.5f, 10));
+
+        boxes_.push_back(AABB(center - extent, center + extent));
+    }
+
+    viewProjection_.perspective(60.0f, 16.0f / 9.0f, 0.5f, 300.0f);
+    viewProjection_.lookAt(QVector3D(0, 10, 0), QVector3D(1, 8, 1), UNIT_Y);
+
+    simdViewProjection_ = Simd::Mat4::fromQt(viewProjection_);
+}
+
+void MicroBenchmark::createHierarchies()
+{
+    for(int chain = 0; chain < HIERARCHY_NODES / HIERARCHY_DEPTH; ++chain)
+    {
+        Graph::SceneNode* node = &deepRoot_;
+
+        for(int i = 0; i < HIERARCHY_DEPTH; ++i)
+        {
+            node = node->createChild();
+            node->setPosition(QVector3D(random(seed_, -1, 1), random(seed_, -1, 1), random(seed_, -1, 1)));
+            node->rotate(random(seed_, 0, 30), UNIT_Y);
+        }
+    }
+
+    for(int i = 0; i < HIERARCHY_NODES; ++i)
+    {
+        Graph::SceneNode* node = wideRoot_.createChild();
+        node->setPosition(QVector3D(random(seed_, -100, 100), random(seed_, -100, 100), random(seed_, -100, 100)));
+        node->rotate(random(seed_, 0, 360), UNIT_Y);
+    }
+
+    deepRoot_.propagate();
+    wideRoot_.propagate();
+}
+
+void MicroBenchmark::createQueueItems()
+{
+    for(int i = 0; i < QUEUE_ITEMS; ++i)
+    {
+        QMatrix4x4 modelView;
+        modelView.translate(random(seed_, -100, 100), random(seed_, -100, 100), random(seed_, -100, 100));
+
+        modelViews_.push_back(modelView);
+        itemRenderables_.push_back(static_cast<int>(random(seed_, 0, QUEUE_RENDERABLES)) % QUEUE_RENDERABLES);
+        itemMaterials_.push_back(static_cast<int>(random(seed_, 0, QUEUE_MATERIALS)) % QUEUE_MATERIALS);
+    }
+}
+
+void MicroBenchmark::createQueueFixtures()
+{
+    QVector<QVector3D> vertices, normals, tangents;
+    QVector<QVector2D> uvs;
+    QVector<unsigned int> indices;
+
+    vertices << QVector3D(0, 0, 0) << QVector3D(1, 0, 0) << QVector3D(0, 1, 0);
+    normals << UNIT_Z << UNIT_Z << UNIT_Z;
+    tangents << UNIT_X << UNIT_X << UNIT_X;
+    uvs << QVector2D(0, 0) << QVector2D(1, 0) << QVector2D(0, 1);
+    indices << 0 << 1 << 2;
+
+    for(int i = 0; i < QUEUE_RENDERABLES; ++i)
+    {
+        Renderable::Mesh::Ptr mesh = std::make_shared<Renderable::Mesh>();
+        mesh->initMesh(vertices, normals, i % 2 == 0 ? tangents : QVector<QVector3D>(), uvs, indices);
+
+        renderables_.push_back(mesh);
+    }
+
+    // Materials share textures, so the sorter has groups to find
+    QVector<Material::TexturePtr> textures;
+    for(int i = 0; i < QUEUE_TEXTURES; ++i)
+    {
+        textures.push_back(createTexture(static_cast<unsigned char>(i * 8)));
+    }
+
+    unsigned int state = 1;
+    for(int i = 0; i < QUEUE_MATERIALS; ++i)
+    {
+        Material::Ptr material = std::make_shared<Material>();
+        material->setTexture(Material::TEXTURE_DIFFUSE, textures[static_cast<int>(random(state, 0, QUEUE_TEXTURES)) % QUEUE_TEXTURES]);
+
+        if(i % 3 == 0)
+        {
+            material->setTexture(Material::TEXTURE_NORMALS, textures[static_cast<int>(random(state, 0, QUEUE_TEXTURES)) % QUEUE_TEXTURES]);
+        }
+
+        if(i % 16 == 0)
+        {
+            material->setAmbientColor(QVector3D(1, 1, 1));
+        }
+
+        materials_.push_back(material);
+    }
+}
+
+void MicroBenchmark::releaseQueueFixtures()
+{
+    materials_.clear();
+    renderables_.clear();
+}
+
+bool MicroBenchmark::writeShaders()
+{
+    // Included files each hold a few functions behind a define
+    QByteArray main = "#version 420\n\n#define SAMPLES <>\n#define LIGHT_TYPE <>\n\n";
+
+    for(int i = 0; i < SHADER_INCLUDES; ++i)
+    {
+        QByteArray include = QString("#ifdef FEATURE%1\n").arg(i).toLatin1();
+
+        for(int function = 0; function < 8; ++function)
+        {
+            include += QString("vec4 feature%1_%2(vec4 value)\n{\n    return value * %3;\n}\n\n")
+                .arg(i).arg(function).arg(function + 1).toLatin1();
+        }
+
+        include += "#endif\n";
+
+        QFile file(dir_.path() + QString("/include%1.glsl").arg(i));
+        if(!file.open(QIODevice::WriteOnly) || file.write(include) != include.size())
+        {
+            return false;
+        }
+
+        main += QString("#include \"include%1.glsl\"\n").arg(i).toLatin1();
+    }
+
+    main += "\nout vec4 color;\n\nvoid main()\n{\n    color = vec4(0.0);\n";
+
+    for(int line = 0; line < 64; ++line)
+    {
+        main += QString("    color += vec4(%1.0) / float(SAMPLES * LIGHT_TYPE);\n").arg(line).toLatin1();
+    }
+
+    main += "#ifdef SHADOW\n    color *= 0.5;\n#else\n    color *= 2.0;\n#endif\n}\n";
+
+    QFile file(dir_.path() + "/main.frag");
+    return file.open(QIODevice::WriteOnly) && file.write(main) == main.size();
+}
+
+bool MicroBenchmark::writeTextures()
+{
+    unsigned int state = 1;
+
+    // Gradient with some noise, so the compressed formats don't degenerate
+    QImage image(TEXTURE_SIZE, TEXTURE_SIZE, QImage::Format_ARGB32);
+    for(int y = 0; y < TEXTURE_SIZE; ++y)
+    {
+        for(int x = 0; x < TEXTURE_SIZE; ++x)
+        {
+            const int noise = static_cast<int>(random(state, 0, 32));
+            image.setPixel(x, y, qRgba((x / 2 + noise) & 0xFF, (y / 2 + noise) & 0xFF, ((x + y) / 4) & 0xFF, 255));
+        }
+    }
+
+    return image.save(dir_.path() + "/texture.png", "PNG")
+        && image.save(dir_.path() + "/texture.jpg", "JPG", 90)
+        && image.save(dir_.path() + "/texture.bmp", "BMP")
+        && writeDDS(dir_.path() + "/texture_dxt1.dds", "DXT1", 8, TEXTURE_SIZE, state)
+        && writeDDS(dir_.path() + "/texture_dxt5.dds", "DXT5", 16, TEXTURE_SIZE, state);
+}
+
+namespace {
+    float random(unsigned int& state, float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * static_cast<float>(state >> 8) / static_cast<float>(1 << 24);
+    }
+
+    ShaderData::DefineMap shaderDefines(int includes)
+    {
+        ShaderData::DefineMap defines;
+        defines.insert("SAMPLES", 4);
+        defines.insert("LIGHT_TYPE", 1);
+        defines.insert("SHADOW", 1);
+
+        for(int i = 0; i < includes; i += 2)
+        {
+            defines.insert(QString("FEATURE%1").arg(i), 1);
+        }
+
+        return defines;
+    }
+
+    Material::TexturePtr createTexture(unsigned char value)
+    {
+        gli::texture2D* image = new gli::texture2D(1, gli::format::RGBA8_UNORM, gli::texture2D::dimensions_type(1, 1));
+        std::memset(image->data(), value, image->size());
+
+        std::shared_ptr<TextureData> data = std::make_shared<TextureData>();
+        data->setTexture(image);
+
+        std::shared_ptr<Texture2DResource> resource = std::make_shared<Texture2DResource>();
+        if(!resource->initialiseFromData(data))
+        {
+            return nullptr;
+        }
+
+        return resource;
+    }
+
+    bool writeDDS(const QString& fileName, const QByteArray& fourCC, int blockSize, int size, unsigned int& state)
+    {
+        // Only the fields read by loadTexture are filled
+        QByteArray data(128, 0);
+        uchar* header = reinterpret_cast<uchar*>(data.data());
+
+        std::memcpy(header, "DDS ", 4);
+        qToLittleEndian<quint32>(124, header + 4);
+        qToLittleEndian<quint32>(size, header + 12);
+        qToLittleEndian<quint32>(size, header + 16);
+        qToLittleEndian<quint32>(32, header + 76);
+        qToLittleEndian<quint32>(0x4, header + 80);
+        std::memcpy(header + 84, fourCC.constData(), 4);
+
+        const int blocks = (size / 4) * (size / 4);
+        data.reserve(data.size() + blocks * blockSize);
+
+        for(int i = 0; i < blocks * blockSize; ++i)
+        {
+            data.append(static_cast<char>(random(state, 0, 256)));
+        }
+
+        QFile file(fileName);
+        return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+    }
+
+    bool createContext(QOpenGLContext& context, QOffscreenSurface& surface)
+    {
+        if(!surface.isValid() || !context.create() || !context.makeCurrent(&surface))
+        {
+            return false;
+        }
+
+        gl = context.versionFunctions<QOPENGL_FUNCTIONS>();
+        return gl != nullptr && gl->initializeOpenGLFunctions();
+    }
+}
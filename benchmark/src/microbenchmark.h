@@ -0,0 +1,113 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : MicroBenchmark times engine hot paths in isolation: bounding box growth over imported
+//             vertices, frustum tests, scene graph propagation, render queue filling and sorting,
+//             shader preprocessing, texture decoding and mesh importing. Only the render queue cases
+//             need an OpenGL context; the rest run without one. Every repetition is added to the
+//             report as a sample, so runs can be compared with --compare or --baseline.
+//
+
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+#include "graph/scenenode.h"
+#include "scene/nodeimport.h"
+#include "textureloader.h"
+#include "renderable/mesh.h"
+#include "material.h"
+#include "aabb.h"
+#include "simdmath.h"
+
+#include <QTemporaryDir>
+#include <QMatrix4x4>
+#include <QVector>
+#include <QString>
+
+#include <memory>
+
+struct aiScene;
+class BenchmarkReport;
+
+class MicroBenchmark
+{
+public:
+    // Fixtures are generated from a fixed seed, so every run uses the same data.
+    // Shader and texture fixtures are written to a temporary directory.
+    MicroBenchmark();
+    ~MicroBenchmark();
+
+    // Runs the cases whose name contains filter, or all cases if filter is empty.
+    // Render queue cases are skipped with a warning if an OpenGL context can't be created.
+    // postcondition: false if the fixtures couldn't be written
+    bool run(int repetitions, const QString& filter, BenchmarkReport& report);
+
+private:
+    enum
+    {
+        MESHES = 32,
+        MESH_VERTICES = 4096,
+        BOXES = 4096,
+        HIERARCHY_NODES = 4096,
+        HIERARCHY_DEPTH = 256,
+        QUEUE_ITEMS = 4096,
+        QUEUE_RENDERABLES = 64,
+        QUEUE_MATERIALS = 128,
+        QUEUE_TEXTURES = 32,
+        SHADER_INCLUDES = 8,
+        TEXTURE_SIZE = 512,
+        ITERATIONS = 16,
+        TEXTURE_ITERATIONS = 4
+    };
+
+    QTemporaryDir dir_;
+    unsigned int seed_;
+    float sink_;
+
+    aiScene* scene_;
+    QVector<Engine::NodeImport::IndexMesh> meshes_;
+
+    QVector<Engine::AABB> boxes_;
+    QMatrix4x4 viewProjection_;
+    Simd::Mat4 simdViewProjection_;
+
+    // Chains of HIERARCHY_DEPTH nodes, and a root with all nodes as its children
+    Engine::Graph::SceneNode deepRoot_;
+    Engine::Graph::SceneNode wideRoot_;
+
+    // Queued items pick their renderable and material by index
+    QVector<QMatrix4x4> modelViews_;
+    QVector<int> itemRenderables_;
+    QVector<int> itemMaterials_;
+
+    QVector<Engine::Renderable::Mesh::Ptr> renderables_;
+    QVector<Engine::Material::Ptr> materials_;
+
+    // Returns the average time of an operation, or a negative value if the fixture couldn't be used
+    double resizeBoxes();
+    double frustumQt();
+    double frustumSimd();
+    double propagateDeep();
+    double propagateWide();
+    double fillQueue();
+    double sortQueue();
+    double preprocessCold();
+    double preprocessCached();
+    double importMeshes();
+    double decodeTexture(const QString& fileName, Engine::TextureConversion conversion);
+
+    void createScene();
+    void createBoxes();
+    void createHierarchies();
+    void createQueueItems();
+    bool writeShaders();
+    bool writeTextures();
+
+    // Renderables and materials need the context
+    void createQueueFixtures();
+    void releaseQueueFixtures();
+
+    MicroBenchmark(const MicroBenchmark&);
+    MicroBenchmark& operator=(const MicroBenchmark&);
+};
+
+#endif // MICROBENCHMARK_H
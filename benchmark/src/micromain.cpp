@@ -0,0 +1,68 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Standalone micro-benchmark built with CMake. Runs the MicroBenchmark cases without
+//             the UI and the demo scenes, so it builds on any platform with Qt, Assimp and gli.
+//
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+#include "benchmarkreport.h"
+#include "microbenchmark.h"
+
+int main(int argc, char *argv[])
+{
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+    // Without a display the offscreen platform is used; the render queue cases are skipped
+    // unless it provides an OpenGL context.
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY")
+        && qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+#endif
+
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times engine hot paths with fixed fixtures.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("base current", "Reports to compare with --compare.");
+
+    QCommandLineOption repetitionsOption("repetitions", "Samples of every case.", "count", "20");
+    QCommandLineOption filterOption("filter", "Runs only the cases whose name contains the text.", "text");
+    QCommandLineOption outputOption("output", "Report file, written to stdout if not given.", "file");
+    QCommandLineOption compareOption("compare", "Compares two reports instead of running.");
+    QCommandLineOption baselineOption("baseline", "Compares the run against a report and fails on regressions.", "file");
+    QCommandLineOption thresholdOption("threshold", "Regression threshold for --compare and --baseline.", "percent", "5");
+
+    parser.addOptions(QList<QCommandLineOption>() << repetitionsOption << filterOption << outputOption
+        << compareOption << baselineOption << thresholdOption);
+
+    parser.process(app);
+
+    const double threshold = parser.value(thresholdOption).toDouble() / 100;
+
+    if(parser.isSet(compareOption))
+    {
+        return BenchmarkReport::compareFiles(parser.positionalArguments(), threshold);
+    }
+
+    const int repetitions = parser.value(repetitionsOption).toInt();
+    if(repetitions < 1)
+    {
+        qWarning() << "Invalid repetition count" << parser.value(repetitionsOption);
+        return 2;
+    }
+
+    BenchmarkReport report;
+    MicroBenchmark benchmark;
+
+    if(!benchmark.run(repetitions, parser.value(filterOption), report))
+    {
+        return 2;
+    }
+
+    return report.write(parser.value(outputOption), parser.value(baselineOption), threshold);
+}
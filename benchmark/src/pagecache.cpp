@@ -0,0 +1,69 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "pagecache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QDebug>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool PageCache::evict(const QString& path)
+{
+    QFileInfo info(path);
+    if(!info.isDir())
+    {
+        return evictFile(path);
+    }
+
+    bool result = true;
+
+    QDirIterator iter(path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        result = evictFile(iter.next()) && result;
+    }
+
+    return result;
+}
+
+bool PageCache::evictFile(const QString& fileName)
+{
+#ifdef Q_OS_WIN
+    // Opening a file without buffering discards its cached pages
+    HANDLE file = CreateFileW(reinterpret_cast<const wchar_t*>(fileName.utf16()), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName;
+        return false;
+    }
+
+    CloseHandle(file);
+
+#else
+    int file = open(QFile::encodeName(fileName).constData(), O_RDONLY);
+    if(file < 0)
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName;
+        return false;
+    }
+
+    // Dirty pages aren't dropped
+    fdatasync(file);
+    posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+    close(file);
+#endif
+
+    return true;
+}
@@ -0,0 +1,26 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : PageCache evicts files from the operating system's file cache, so that a benchmark
+//             run measures loading from the disk instead of memory.
+//
+
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+#include <QString>
+
+class PageCache
+{
+public:
+    // Evicts the cached pages of the file, or of every file under the directory. Files still open
+    // or mapped elsewhere, eg. by other processes, can stay cached.
+    // postcondition: false if a file couldn't be opened
+    static bool evict(const QString& path);
+
+private:
+    static bool evictFile(const QString& fileName);
+
+    PageCache();
+};
+
+#endif // PAGECACHE_H
@@ -0,0 +1,171 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "prefabbenchmark.h"
+
+#include "benchmarkreport.h"
+#include "heapcounter.h"
+
+#include "graph/geometry.h"
+#include "graph/prefabinstance.h"
+#include "renderable/primitive.h"
+#include "renderable/cube.h"
+#include "scene/basicscenemanager.h"
+#include "renderercontext.h"
+
+#include <QSurfaceFormat>
+#include <QElapsedTimer>
+#include <QHash>
+
+using namespace Engine;
+
+namespace {
+    struct Spawn
+    {
+        double time;            // Nanoseconds per instance
+        double bytes;           // Heap bytes per instance
+        double allocations;     // Heap allocations per instance
+    };
+
+    // Copies the node and its children, mapping the original nodes to the copies.
+    Graph::SceneNode* copyHierarchy(const Graph::SceneNode* node, QHash<const Graph::SceneNode*, Graph::SceneNode*>& copies);
+}
+
+PrefabBenchmark::PrefabBenchmark()
+{
+}
+
+PrefabBenchmark::~PrefabBenchmark()
+{
+}
+
+bool PrefabBenchmark::run(int repetitions, BenchmarkReport& report)
+{
+    QSurfaceFormat format;
+    format.setVersion(4, 2);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+
+    Ui::RendererContext context(format);
+    if(!context.createContext(nullptr))
+    {
+        return false;
+    }
+
+    createSource();
+
+    for(int i = 0; i < repetitions; ++i)
+    {
+        Spawn clones, instances;
+
+        {
+            BasicSceneManager scene;
+            Graph::SceneNode root;
+
+            const quint64 allocations = HeapCounter::allocations();
+            const quint64 bytes = HeapCounter::allocatedBytes();
+
+            QElapsedTimer timer;
+            timer.start();
+
+            // Copies the hierarchy and leaves of every instance
+            for(int n = 0; n < INSTANCES; ++n)
+            {
+                QHash<const Graph::SceneNode*, Graph::SceneNode*> copies;
+                root.addChild(copyHierarchy(&source_, copies));
+
+                for(const SceneManager::SceneLeafPtr& leaf : leaves_)
+                {
+                    SceneManager::SceneLeafPtr copy = Graph::SceneLeaf::clone(leaf);
+                    copy->attach(copies.value(leaf->parentNode()));
+                    scene.addSceneLeaf(copy);
+                }
+            }
+
+            clones.time = static_cast<double>(timer.nsecsElapsed()) / INSTANCES;
+            clones.bytes = static_cast<double>(HeapCounter::allocatedBytes() - bytes) / INSTANCES;
+            clones.allocations = static_cast<double>(HeapCounter::allocations() - allocations) / INSTANCES;
+        }
+
+        {
+            BasicSceneManager scene;
+            Graph::SceneNode root;
+
+            const quint64 allocations = HeapCounter::allocations();
+            const quint64 bytes = HeapCounter::allocatedBytes();
+
+            QElapsedTimer timer;
+            timer.start();
+
+            // One node and one leaf referencing the prefab per instance
+            for(int n = 0; n < INSTANCES; ++n)
+            {
+                Graph::PrefabInstance::Ptr instance = std::make_shared<Graph::PrefabInstance>(prefab_);
+                instance->attach(root.createChild());
+                scene.addSceneLeaf(instance);
+            }
+
+            instances.time = static_cast<double>(timer.nsecsElapsed()) / INSTANCES;
+            instances.bytes = static_cast<double>(HeapCounter::allocatedBytes() - bytes) / INSTANCES;
+            instances.allocations = static_cast<double>(HeapCounter::allocations() - allocations) / INSTANCES;
+        }
+
+        report.addSample("Clone spawn time", clones.time, "ns");
+        report.addSample("Clone memory per instance", clones.bytes, "bytes");
+        report.addSample("Clone allocations per instance", clones.allocations, "allocs");
+        report.addSample("Prefab spawn time", instances.time, "ns");
+        report.addSample("Prefab memory per instance", instances.bytes, "bytes");
+        report.addSample("Prefab allocations per instance", instances.allocations, "allocs");
+    }
+
+    report.setProperty("prefabParts", PARTS);
+    report.setProperty("prefabInstances", INSTANCES);
+
+    // Meshes are released while the context exists
+    prefab_.reset();
+    leaves_.clear();
+
+    return true;
+}
+
+void PrefabBenchmark::createSource()
+{
+    Renderable::Cube::Ptr cube = Renderable::Primitive<Renderable::Cube>::instance();
+
+    for(int i = 0; i < PARTS; ++i)
+    {
+        Graph::SceneNode* node = source_.createChild();
+        node->setPosition(QVector3D(static_cast<float>(i), 0.0f, 0.0f));
+        node->scale(0.5f);
+
+        Material::Ptr material = std::make_shared<Material>();
+        material->setDiffuseColor(QVector3D(1.0f, static_cast<float>(i) / PARTS, 0.0f));
+
+        Graph::Geometry::Ptr geometry = std::make_shared<Graph::Geometry>(cube, material);
+        geometry->setName(QString("Part %1").arg(i));
+        geometry->attach(node);
+
+        leaves_.push_back(geometry);
+    }
+
+    prefab_ = Prefab::create(&source_, leaves_);
+}
+
+namespace {
+    Graph::SceneNode* copyHierarchy(const Graph::SceneNode* node, QHash<const Graph::SceneNode*, Graph::SceneNode*>& copies)
+    {
+        Graph::SceneNode* copy = new Graph::SceneNode;
+        copy->applyTransformation(node->localTransformation());
+        copy->setLightMask(node->lightMask());
+
+        copies.insert(node, copy);
+
+        for(Graph::SceneNode::ChildSceneNodes::size_type i = 0; i < node->numChildren(); ++i)
+        {
+            copy->addChild(copyHierarchy(node->getChild(i), copies));
+        }
+
+        return copy;
+    }
+}
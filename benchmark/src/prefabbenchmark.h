@@ -0,0 +1,43 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : PrefabBenchmark spawns instances of a small hierarchy by copying its nodes and leaves,
+//             as ImportedNode::clone does, and by instancing a shared Prefab. The spawn time and
+//             the heap memory and allocations of an instance are added to the report as samples.
+//
+
+#ifndef PREFABBENCHMARK_H
+#define PREFABBENCHMARK_H
+
+#include "graph/scenenode.h"
+#include "graph/sceneleaf.h"
+#include "scene/prefab.h"
+
+#include <QVector>
+#include <memory>
+
+class BenchmarkReport;
+
+class PrefabBenchmark
+{
+public:
+    PrefabBenchmark();
+    ~PrefabBenchmark();
+
+    // Creates an offscreen context for the meshes of the spawned hierarchy.
+    // postcondition: false if the context couldn't be created
+    bool run(int repetitions, BenchmarkReport& report);
+
+private:
+    enum { PARTS = 8, INSTANCES = 1000 };
+
+    Engine::Graph::SceneNode source_;
+    QVector<std::shared_ptr<Engine::Graph::SceneLeaf>> leaves_;
+    Engine::Prefab::Ptr prefab_;
+
+    void createSource();
+
+    PrefabBenchmark(const PrefabBenchmark&);
+    PrefabBenchmark& operator=(const PrefabBenchmark&);
+};
+
+#endif // PREFABBENCHMARK_H
@@ -9,9 +9,25 @@
 
 QMap<GLenum, GLuint> Binder::state_;
 
+unsigned int Binder::bindCount_ = 0;
+unsigned int Binder::skipCount_ = 0;
+
 void Binder::reset()
 {
     state_.clear();
+
+    bindCount_ = 0;
+    skipCount_ = 0;
+}
+
+unsigned int Binder::bindCount()
+{
+    return bindCount_;
+}
+
+unsigned int Binder::skipCount()
+{
+    return skipCount_;
 }
 
 bool Binder::test(Bindable& target, GLenum id)
@@ -10,6 +10,7 @@
 #define BINDER_H
 
 #include "common.h"
+#include "gpucounters.h"
 
 #include <QMap>
 #include <memory>
@@ -28,9 +29,14 @@ public:
     template<typename BindableDerived, typename... Args>
     static bool bind(BindableDerived* target, Args&&... args);
 
-    // Clears the state map.
+    // Clears the state map and the bind counters.
     static void reset();
 
+    // Returns the number of objects bound, and the number of binds skipped because
+    // the object was already bound, since the last reset.
+    static unsigned int bindCount();
+    static unsigned int skipCount();
+
 private:
     static bool test(Bindable& target, GLenum id);
     static bool test(Bindable& target);
@@ -40,6 +46,9 @@ private:
     static bool testKey(GLenum key, GLuint value);
 
     static QMap<GLenum, GLuint> state_;
+
+    static unsigned int bindCount_;
+    static unsigned int skipCount_;
 };
 
 #include "binder.inl"
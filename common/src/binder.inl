@@ -8,9 +8,13 @@ bool Binder::bind(BindableDerived& target, Args&&... args)
 {
     if(!test(target, std::forward<Args>(args)...))
     {
+        ++bindCount_;
+        GPU_COUNT(TEXTURE_BINDS, 1);
+
         return target.bind(std::forward<Args>(args)...);
     }
 
+    ++skipCount_;
     return true; // Object is already bound
 }
 
@@ -0,0 +1,205 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "framearena.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QList>
+#include <QVector>
+#include <QThreadStorage>
+
+#include <cstdlib>
+
+namespace {
+    struct Block
+    {
+        char* data;
+        std::size_t size;
+    };
+
+    // Sub-arena of one thread. The blocks of each generation are kept and reused.
+    struct ThreadArena
+    {
+        struct Generation
+        {
+            QVector<Block> blocks;
+            int block;                      // Block being allocated from
+            std::size_t offset;             // Bytes used in the block
+            std::atomic<quint64> frame;     // Frame the generation was last reset for
+            std::atomic<qint64> used;
+        };
+
+        Generation generations[FrameArena::GENERATIONS];
+
+        // Guarded by the arena mutex
+        bool owned;
+
+        ThreadArena();
+    };
+
+    // Returns the arena of the calling thread, registering the thread on first use.
+    ThreadArena* threadArena();
+
+    // Reuses the arena of an exited thread.
+    ThreadArena* acquireArena();
+
+    // Returns the arena to the pool when the thread exits
+    struct ArenaOwner
+    {
+        ThreadArena* arena;
+        ~ArenaOwner();
+    };
+
+    QMutex mutex;
+    QList<ThreadArena*> arenas;
+    QThreadStorage<ArenaOwner*> owners;
+
+    std::atomic<qint64> reservedBytes(0);
+    std::atomic<int> blockAllocations(0);
+}
+
+std::atomic<quint64> FrameArena::frame_(0);
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    ThreadArena* arena = threadArena();
+
+    const quint64 current = frame_.load(std::memory_order_acquire);
+    ThreadArena::Generation& generation = arena->generations[current % GENERATIONS];
+
+    // Reclaims the memory of the frame that last used this generation
+    if(generation.frame.load(std::memory_order_relaxed) != current)
+    {
+        generation.block = 0;
+        generation.offset = 0;
+        generation.used.store(0, std::memory_order_relaxed);
+        generation.frame.store(current, std::memory_order_relaxed);
+    }
+
+    for(;;)
+    {
+        if(generation.block < generation.blocks.count())
+        {
+            const Block& block = generation.blocks[generation.block];
+
+            quintptr start = reinterpret_cast<quintptr>(block.data) + generation.offset;
+            quintptr aligned = (start + alignment - 1) & ~static_cast<quintptr>(alignment - 1);
+            std::size_t offset = aligned - reinterpret_cast<quintptr>(block.data);
+
+            if(offset + size <= block.size)
+            {
+                generation.offset = offset + size;
+                generation.used.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+
+                return block.data + offset;
+            }
+
+            ++generation.block;
+            generation.offset = 0;
+            continue;
+        }
+
+        // Allocations larger than a block get a block of their own
+        Block block;
+        block.size = qMax<std::size_t>(BLOCK_SIZE, size + alignment);
+        block.data = static_cast<char*>(std::malloc(block.size));
+
+        if(block.data == nullptr)
+        {
+            return nullptr;
+        }
+
+        generation.blocks.push_back(block);
+
+        reservedBytes.fetch_add(block.size, std::memory_order_relaxed);
+        blockAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FrameArena::endFrame()
+{
+    frame_.fetch_add(1, std::memory_order_release);
+}
+
+quint64 FrameArena::frame()
+{
+    return frame_.load(std::memory_order_acquire);
+}
+
+FrameArena::Stats FrameArena::stats()
+{
+    Stats stats;
+    stats.frameBytes = 0;
+    stats.reservedBytes = reservedBytes.load(std::memory_order_relaxed);
+    stats.blockAllocations = blockAllocations.load(std::memory_order_relaxed);
+
+    const quint64 current = frame();
+
+    QMutexLocker lock(&mutex);
+    for(ThreadArena* arena : arenas)
+    {
+        const ThreadArena::Generation& generation = arena->generations[current % GENERATIONS];
+        if(generation.frame.load(std::memory_order_relaxed) == current)
+        {
+            stats.frameBytes += generation.used.load(std::memory_order_relaxed);
+        }
+    }
+
+    return stats;
+}
+
+namespace {
+    ThreadArena::ThreadArena()
+        : owned(false)
+    {
+        for(Generation& generation : generations)
+        {
+            generation.block = 0;
+            generation.offset = 0;
+            generation.frame.store(~0ull, std::memory_order_relaxed);
+            generation.used.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ThreadArena* threadArena()
+    {
+        if(!owners.hasLocalData())
+        {
+            ArenaOwner* owner = new ArenaOwner;
+            owner->arena = acquireArena();
+            owners.setLocalData(owner);
+        }
+
+        return owners.localData()->arena;
+    }
+
+    ThreadArena* acquireArena()
+    {
+        QMutexLocker lock(&mutex);
+
+        // Memory of the previous owner stays valid, a generation is only reset for a newer frame
+        for(ThreadArena* arena : arenas)
+        {
+            if(!arena->owned)
+            {
+                arena->owned = true;
+                return arena;
+            }
+        }
+
+        ThreadArena* arena = new ThreadArena;
+        arena->owned = true;
+        arenas.append(arena);
+
+        return arena;
+    }
+
+    ArenaOwner::~ArenaOwner()
+    {
+        QMutexLocker lock(&mutex);
+        arena->owned = false;
+    }
+}
@@ -0,0 +1,55 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : FrameArena is a linear allocator for data rebuilt every frame, eg. render queues and
+//             light lists. Each thread allocates from its own sub-arena without locking. Memory is
+//             never freed individually; ending a frame reclaims the memory of the frame before it
+//             in one step, so the arena stops touching the heap once its blocks have grown to fit.
+//
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstddef>
+
+class FrameArena
+{
+public:
+    enum
+    {
+        // Memory stays valid until the end of the frame after the one it was allocated in,
+        // so data culled for the next frame can be rendered from.
+        GENERATIONS = 2,
+        BLOCK_SIZE = 64 * 1024
+    };
+
+    struct Stats
+    {
+        qint64 frameBytes;      // Allocated during the current frame on all threads
+        qint64 reservedBytes;   // Size of the blocks of all sub-arenas
+        int blockAllocations;   // Heap allocations done by the arena since startup
+    };
+
+    // Returns memory from the calling thread's sub-arena. Destructors are never run.
+    // precondition: alignment is a power of two and at most 16
+    static void* allocate(std::size_t size, std::size_t alignment = 16);
+
+    // Ends the current frame. Called once per frame by the frame owner, eg. the presenter.
+    // Without it the arena keeps growing.
+    // precondition: no thread is using memory of the frame before the current one
+    static void endFrame();
+
+    // Number of ended frames.
+    static quint64 frame();
+
+    static Stats stats();
+
+private:
+    static std::atomic<quint64> frame_;
+
+    FrameArena();
+};
+
+#endif // FRAMEARENA_H
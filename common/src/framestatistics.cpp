@@ -0,0 +1,162 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "framestatistics.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QDebug>
+
+Statistic::Statistic(const QString& name, const QString& unit, double scale)
+    : name_(name), unit_(unit), scale_(scale)
+{
+}
+
+void Statistic::add(qint64 value)
+{
+    window_.add(value);
+    total_.add(value);
+}
+
+const QString& Statistic::name() const
+{
+    return name_;
+}
+
+const QString& Statistic::unit() const
+{
+    return unit_;
+}
+
+double Statistic::scale() const
+{
+    return scale_;
+}
+
+const Histogram& Statistic::window() const
+{
+    return window_;
+}
+
+const Histogram& Statistic::total() const
+{
+    return total_;
+}
+
+void Statistic::resetWindow()
+{
+    window_.reset();
+}
+
+void Statistic::reset()
+{
+    window_.reset();
+    total_.reset();
+}
+
+FrameStatistics::FrameStatistics()
+{
+}
+
+FrameStatistics::~FrameStatistics()
+{
+    qDeleteAll(stats_);
+}
+
+Statistic* FrameStatistics::stat(const QString& name, const QString& unit, double scale)
+{
+    QMutexLocker lock(&mutex_);
+
+    for(Statistic* stat : stats_)
+    {
+        if(stat->name() == name)
+        {
+            return stat;
+        }
+    }
+
+    Statistic* stat = new Statistic(name, unit, scale);
+    stats_.push_back(stat);
+
+    return stat;
+}
+
+QList<Statistic*> FrameStatistics::stats() const
+{
+    QMutexLocker lock(&mutex_);
+    return stats_;
+}
+
+void FrameStatistics::resetWindows()
+{
+    for(Statistic* stat : stats())
+    {
+        stat->resetWindow();
+    }
+}
+
+void FrameStatistics::reset()
+{
+    for(Statistic* stat : stats())
+    {
+        stat->reset();
+    }
+}
+
+bool FrameStatistics::dump(const QString& fileName) const
+{
+    QJsonArray statistics;
+
+    for(const Statistic* stat : stats())
+    {
+        const Histogram& total = stat->total();
+        const double scale = stat->scale();
+
+        // Buckets as [lower, upper, samples], in reported units
+        QJsonArray buckets;
+        for(int i = 0; i < Histogram::BUCKET_COUNT; ++i)
+        {
+            int samples = total.bucketSamples(i);
+            if(samples > 0)
+            {
+                QJsonArray bucket;
+                bucket.append(Histogram::bucketLowerBound(i) * scale);
+                bucket.append(Histogram::bucketUpperBound(i) * scale);
+                bucket.append(samples);
+
+                buckets.append(bucket);
+            }
+        }
+
+        QJsonObject object;
+        object["name"] = stat->name();
+        object["unit"] = stat->unit();
+        object["count"] = total.count();
+        object["mean"] = total.mean() * scale;
+        object["p50"] = total.percentile(0.50) * scale;
+        object["p95"] = total.percentile(0.95) * scale;
+        object["p99"] = total.percentile(0.99) * scale;
+        object["max"] = static_cast<double>(total.max()) * scale;
+        object["buckets"] = buckets;
+
+        statistics.append(object);
+    }
+
+    QJsonObject root;
+    root["statistics"] = statistics;
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName;
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson());
+    return file.error() == QFile::NoError;
+}
@@ -0,0 +1,79 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : FrameStatistics collects named timing statistics, eg. frame and stage times.
+//             Each Statistic keeps a histogram of the current reporting window, from which the
+//             percentiles are shown, and one of the whole run, which can be dumped to a file.
+//
+
+#ifndef FRAMESTATISTICS_H
+#define FRAMESTATISTICS_H
+
+#include "histogram.h"
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+
+class Statistic
+{
+public:
+    // Samples are multiplied by scale when reported, eg. 1e-6 for nanoseconds shown in milliseconds.
+    Statistic(const QString& name, const QString& unit, double scale);
+
+    // Thread-safe and allocation free.
+    void add(qint64 value);
+
+    const QString& name() const;
+    const QString& unit() const;
+    double scale() const;
+
+    const Histogram& window() const;
+    const Histogram& total() const;
+
+    void resetWindow();
+    void reset();
+
+private:
+    QString name_;
+    QString unit_;
+    double scale_;
+
+    Histogram window_;
+    Histogram total_;
+
+    Statistic(const Statistic&);
+    Statistic& operator=(const Statistic&);
+};
+
+class FrameStatistics
+{
+public:
+    FrameStatistics();
+    ~FrameStatistics();
+
+    // Returns the named statistic, which is created on first use. Statistics live as long as
+    // the collection, so the pointer can be kept and shared with other threads.
+    Statistic* stat(const QString& name, const QString& unit = QString(), double scale = 1.0);
+
+    // Statistics in creation order.
+    QList<Statistic*> stats() const;
+
+    // Starts a new reporting window.
+    void resetWindows();
+
+    // Discards all samples, eg. after warming up.
+    void reset();
+
+    // Writes the percentiles and the non-empty buckets of the run's histograms as JSON.
+    // postcondition: false if the file couldn't be written
+    bool dump(const QString& fileName) const;
+
+private:
+    mutable QMutex mutex_;
+    QList<Statistic*> stats_;
+
+    FrameStatistics(const FrameStatistics&);
+    FrameStatistics& operator=(const FrameStatistics&);
+};
+
+#endif // FRAMESTATISTICS_H
@@ -0,0 +1,63 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : FrameVector is a growable array allocated from the FrameArena, meant for lists that
+//             are rebuilt every frame. Clearing drops the storage instead of freeing it. Contents
+//             stay valid until the end of the frame after the last modification and read as
+//             empty after that. Elements are never destroyed, so T must be trivially destructible.
+//
+
+#ifndef FRAMEVECTOR_H
+#define FRAMEVECTOR_H
+
+#include "framearena.h"
+
+#include <type_traits>
+
+template<typename T>
+class FrameVector
+{
+public:
+    typedef T* Iterator;
+    typedef const T* ConstIterator;
+
+    FrameVector();
+
+    void push_back(const T& value);
+
+    // Grows the storage to hold at least capacity elements.
+    void reserve(int capacity);
+
+    void clear();
+
+    int count() const;
+    int size() const;
+    bool isEmpty() const;
+
+    T& operator[](int index);
+    const T& operator[](int index) const;
+
+    Iterator begin();
+    Iterator end();
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+private:
+    static_assert(std::is_trivially_destructible<T>::value, "FrameVector elements are never destroyed");
+
+    T* data_;
+    int size_;
+    int capacity_;
+    quint64 frame_;     // Frame the storage was allocated in
+
+    // Returns false once the arena may have reclaimed the storage.
+    bool valid() const;
+
+    void reallocate(int capacity);
+
+    FrameVector(const FrameVector&);
+    FrameVector& operator=(const FrameVector&);
+};
+
+#include "framevector.inl"
+
+#endif // FRAMEVECTOR_H
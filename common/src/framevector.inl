@@ -0,0 +1,119 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include <new>
+
+template<typename T>
+FrameVector<T>::FrameVector()
+    : data_(nullptr), size_(0), capacity_(0), frame_(0)
+{
+}
+
+template<typename T>
+void FrameVector<T>::push_back(const T& value)
+{
+    // Storage of an older frame is moved to the current one, so it lives as long as the contents
+    if(size_ == capacity_ || frame_ != FrameArena::frame())
+    {
+        reallocate(qMax(8, size_ == capacity_ ? capacity_ * 2 : capacity_));
+    }
+
+    new(data_ + size_) T(value);
+    ++size_;
+}
+
+template<typename T>
+void FrameVector<T>::reserve(int capacity)
+{
+    if(capacity > capacity_ || frame_ != FrameArena::frame())
+    {
+        reallocate(qMax(capacity, capacity_));
+    }
+}
+
+template<typename T>
+void FrameVector<T>::clear()
+{
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+}
+
+template<typename T>
+int FrameVector<T>::count() const
+{
+    return valid() ? size_ : 0;
+}
+
+template<typename T>
+int FrameVector<T>::size() const
+{
+    return count();
+}
+
+template<typename T>
+bool FrameVector<T>::isEmpty() const
+{
+    return count() == 0;
+}
+
+template<typename T>
+T& FrameVector<T>::operator[](int index)
+{
+    return data_[index];
+}
+
+template<typename T>
+const T& FrameVector<T>::operator[](int index) const
+{
+    return data_[index];
+}
+
+template<typename T>
+typename FrameVector<T>::Iterator FrameVector<T>::begin()
+{
+    return data_;
+}
+
+template<typename T>
+typename FrameVector<T>::Iterator FrameVector<T>::end()
+{
+    return data_ + count();
+}
+
+template<typename T>
+typename FrameVector<T>::ConstIterator FrameVector<T>::begin() const
+{
+    return data_;
+}
+
+template<typename T>
+typename FrameVector<T>::ConstIterator FrameVector<T>::end() const
+{
+    return data_ + count();
+}
+
+template<typename T>
+bool FrameVector<T>::valid() const
+{
+    return data_ != nullptr && FrameArena::frame() - frame_ < FrameArena::GENERATIONS;
+}
+
+template<typename T>
+void FrameVector<T>::reallocate(int capacity)
+{
+    const int size = count();
+    T* data = static_cast<T*>(FrameArena::allocate(capacity * sizeof(T), std::alignment_of<T>::value));
+
+    for(int i = 0; i < size; ++i)
+    {
+        new(data + i) T(data_[i]);
+    }
+
+    data_ = data;
+    size_ = size;
+    capacity_ = capacity;
+    frame_ = FrameArena::frame();
+}
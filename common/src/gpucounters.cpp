@@ -0,0 +1,185 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "gpucounters.h"
+
+#include <algorithm>
+
+namespace {
+    // Returns the number of components of a pixel transfer format, or 0 if unknown.
+    int formatComponents(GLenum format);
+
+    // Returns the size of a pixel transfer type in bytes, or 0 if unknown.
+    int typeSize(GLenum type);
+}
+
+GpuCounters::Snapshot GpuCounters::counts_;
+
+bool GpuCounters::itemTracking_ = false;
+const void* GpuCounters::itemKey_ = nullptr;
+GpuCounters::Snapshot GpuCounters::itemStart_;
+QHash<const void*, GpuCounters::Item> GpuCounters::items_;
+
+GpuCounters::Snapshot::Snapshot()
+{
+    std::fill(counts, counts + COUNTER_COUNT, 0);
+}
+
+quint64 GpuCounters::Snapshot::operator[](Counter counter) const
+{
+    return counts[counter];
+}
+
+GpuCounters::Snapshot GpuCounters::Snapshot::operator-(const Snapshot& other) const
+{
+    Snapshot result;
+    for(int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        result.counts[i] = counts[i] - other.counts[i];
+    }
+
+    return result;
+}
+
+GpuCounters::Snapshot& GpuCounters::Snapshot::operator+=(const Snapshot& other)
+{
+    for(int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+
+    return *this;
+}
+
+GpuCounters::Snapshot GpuCounters::snapshot()
+{
+    return counts_;
+}
+
+QString GpuCounters::name(Counter counter)
+{
+    switch(counter)
+    {
+    case DRAW_CALLS: return "Draw calls";
+    case PRIMITIVES: return "Primitives";
+    case PROGRAM_BINDS: return "Program binds";
+    case TEXTURE_BINDS: return "Texture binds";
+    case FRAMEBUFFER_BINDS: return "Framebuffer binds";
+    case UNIFORM_UPLOADS: return "Uniform uploads";
+    case UNIFORM_BYTES: return "Uniform upload size";
+    case BUFFER_UPLOAD_BYTES: return "Buffer upload size";
+    case TEXTURE_UPLOAD_BYTES: return "Texture upload size";
+
+    default: return QString();
+    }
+}
+
+void GpuCounters::setItemTracking(bool enable)
+{
+    itemTracking_ = enable;
+    itemKey_ = nullptr;
+}
+
+void GpuCounters::beginItem(const void* key, const QString& name)
+{
+    itemKey_ = key;
+    itemStart_ = counts_;
+
+    auto iter = items_.find(key);
+    if(iter == items_.end())
+    {
+        Item item;
+        item.name = name;
+
+        items_.insert(key, item);
+    }
+}
+
+void GpuCounters::endItem()
+{
+    if(itemKey_ == nullptr)
+    {
+        return;
+    }
+
+    items_[itemKey_].counts += counts_ - itemStart_;
+    itemKey_ = nullptr;
+}
+
+QList<GpuCounters::Item> GpuCounters::topItems(Counter counter, int count)
+{
+    QList<Item> items = items_.values();
+
+    std::sort(items.begin(), items.end(), [counter] (const Item& a, const Item& b)
+    {
+        return a.counts[counter] > b.counts[counter];
+    });
+
+    return items.mid(0, count);
+}
+
+void GpuCounters::resetItems()
+{
+    items_.clear();
+    itemKey_ = nullptr;
+}
+
+quint64 GpuCounters::imageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+    return static_cast<quint64>(qMax(width, 0)) * qMax(height, 0) * formatComponents(format) * typeSize(type);
+}
+
+namespace {
+    int formatComponents(GLenum format)
+    {
+        switch(format)
+        {
+        case GL_RED:
+        case GL_RED_INTEGER:
+        case GL_DEPTH_COMPONENT:
+            return 1;
+
+        case GL_RG:
+        case GL_RG_INTEGER:
+            return 2;
+
+        case GL_RGB:
+        case GL_BGR:
+        case GL_RGB_INTEGER:
+            return 3;
+
+        case GL_RGBA:
+        case GL_BGRA:
+        case GL_RGBA_INTEGER:
+            return 4;
+
+        default:
+            return 0;
+        }
+    }
+
+    int typeSize(GLenum type)
+    {
+        switch(type)
+        {
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+            return 1;
+
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            return 2;
+
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+        case GL_FLOAT:
+            return 4;
+
+        default:
+            return 0;
+        }
+    }
+}
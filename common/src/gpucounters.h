@@ -0,0 +1,144 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : GpuCounters counts OpenGL API work done through the engine, eg. draw calls, state
+//             changes and uploaded bytes. The counters are snapshotted around frames and render
+//             stages, and counts between beginItem and endItem can be attributed to eg. materials
+//             to find the most expensive ones. Counting is only done on the rendering thread.
+//             Define ENGINE_NO_GPU_COUNTERS to compile the counting macros out.
+//
+
+#ifndef GPUCOUNTERS_H
+#define GPUCOUNTERS_H
+
+#include "common.h"
+
+#include <QString>
+#include <QHash>
+#include <QList>
+
+class GpuCounters
+{
+public:
+    enum Counter
+    {
+        DRAW_CALLS,
+        PRIMITIVES,
+        PROGRAM_BINDS,
+        TEXTURE_BINDS,
+        FRAMEBUFFER_BINDS,
+        UNIFORM_UPLOADS,
+        UNIFORM_BYTES,
+        BUFFER_UPLOAD_BYTES,
+        TEXTURE_UPLOAD_BYTES,
+        COUNTER_COUNT
+    };
+
+    struct Snapshot
+    {
+        quint64 counts[COUNTER_COUNT];
+
+        Snapshot();
+
+        quint64 operator[](Counter counter) const;
+        Snapshot operator-(const Snapshot& other) const;
+        Snapshot& operator+=(const Snapshot& other);
+    };
+
+    struct Item
+    {
+        QString name;
+        Snapshot counts;
+    };
+
+    static void add(Counter counter, quint64 amount = 1);
+
+    // Returns the counts since the start of the program. Work done between two snapshots
+    // is given by their difference.
+    static Snapshot snapshot();
+
+    // Human readable name of the counter, eg. "Draw calls".
+    static QString name(Counter counter);
+
+    // Item counts are only recorded while enabled, since each item costs a hash lookup.
+    static void setItemTracking(bool enable);
+    static bool itemTracking();
+
+    // Attributes the work until endItem to the item identified by key, eg. a Material.
+    // Items can't be nested. The name is only copied when the item is first seen.
+    static void beginItem(const void* key, const QString& name);
+    static void endItem();
+
+    // Returns the items with the largest counts of the given counter, largest first.
+    static QList<Item> topItems(Counter counter, int count);
+
+    // Discards the recorded item counts.
+    static void resetItems();
+
+    // Returns the size of a width * height image of the given pixel format and type,
+    // or 0 if the format isn't known.
+    static quint64 imageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type);
+
+private:
+    static Snapshot counts_;
+
+    static bool itemTracking_;
+    static const void* itemKey_;
+    static Snapshot itemStart_;
+    static QHash<const void*, Item> items_;
+
+    GpuCounters();
+};
+
+// Records the work of the enclosing scope as an item.
+class GpuCounterItem
+{
+public:
+    GpuCounterItem(const void* key, const QString& name);
+    ~GpuCounterItem();
+
+private:
+    bool active_;
+
+    GpuCounterItem(const GpuCounterItem&);
+    GpuCounterItem& operator=(const GpuCounterItem&);
+};
+
+inline void GpuCounters::add(Counter counter, quint64 amount)
+{
+    counts_.counts[counter] += amount;
+}
+
+inline bool GpuCounters::itemTracking()
+{
+    return itemTracking_;
+}
+
+inline GpuCounterItem::GpuCounterItem(const void* key, const QString& name)
+    : active_(GpuCounters::itemTracking())
+{
+    if(active_)
+    {
+        GpuCounters::beginItem(key, name);
+    }
+}
+
+inline GpuCounterItem::~GpuCounterItem()
+{
+    if(active_)
+    {
+        GpuCounters::endItem();
+    }
+}
+
+#define GPU_COUNT_CONCAT_(a, b) a##b
+#define GPU_COUNT_CONCAT(a, b) GPU_COUNT_CONCAT_(a, b)
+
+#ifndef ENGINE_NO_GPU_COUNTERS
+    #define GPU_COUNT(counter, amount) ::GpuCounters::add(::GpuCounters::counter, amount)
+    #define GPU_COUNT_ITEM(key, name) ::GpuCounterItem GPU_COUNT_CONCAT(gpuCounterItem, __LINE__)(key, name)
+#else
+    #define GPU_COUNT(counter, amount)
+    #define GPU_COUNT_ITEM(key, name)
+#endif // ENGINE_NO_GPU_COUNTERS
+
+#endif // GPUCOUNTERS_H
@@ -0,0 +1,166 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "histogram.h"
+
+#include <cmath>
+
+namespace {
+    // Returns the index of the highest set bit.
+    // precondition: value > 0
+    int highestBit(quint64 value);
+}
+
+Histogram::Histogram()
+{
+    reset();
+}
+
+void Histogram::add(qint64 value)
+{
+    value = qMax<qint64>(0, value);
+
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    qint64 max = max_.load(std::memory_order_relaxed);
+    while(value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void Histogram::reset()
+{
+    for(int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+int Histogram::count() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+double Histogram::mean() const
+{
+    int samples = count();
+    if(samples == 0)
+    {
+        return 0;
+    }
+
+    return static_cast<double>(sum_.load(std::memory_order_relaxed)) / samples;
+}
+
+qint64 Histogram::max() const
+{
+    return max_.load(std::memory_order_relaxed);
+}
+
+qint64 Histogram::percentile(double fraction) const
+{
+    int samples = count();
+    if(samples == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the sample, starting from one
+    double rank = qMax(1.0, std::ceil(qBound(0.0, fraction, 1.0) * samples));
+    double below = 0;
+
+    for(int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        int inBucket = bucketSamples(i);
+        if(inBucket == 0 || below + inBucket < rank)
+        {
+            below += inBucket;
+            continue;
+        }
+
+        // Samples are assumed to be spread evenly within the bucket
+        qint64 lower = bucketLowerBound(i);
+        qint64 width = bucketUpperBound(i) - lower;
+        qint64 value = lower + static_cast<qint64>(width * (rank - below) / inBucket);
+
+        return qMin(value, max());
+    }
+
+    return max();
+}
+
+int Histogram::bucketSamples(int bucket) const
+{
+    return buckets_[bucket].load(std::memory_order_relaxed);
+}
+
+int Histogram::bucketIndex(qint64 value)
+{
+    if(value < SUB_BUCKETS)
+    {
+        return static_cast<int>(qMax<qint64>(0, value));
+    }
+
+    int exponent = highestBit(value);
+    if(exponent > MAX_EXPONENT)
+    {
+        return BUCKET_COUNT - 1;
+    }
+
+    // Sub-bucket is given by the bits following the highest one
+    int shift = exponent - SUB_BUCKET_BITS;
+    int subBucket = static_cast<int>(value >> shift) & (SUB_BUCKETS - 1);
+
+    return SUB_BUCKETS + shift * SUB_BUCKETS + subBucket;
+}
+
+qint64 Histogram::bucketLowerBound(int bucket)
+{
+    if(bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    int subBucket = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+
+    return static_cast<qint64>(SUB_BUCKETS + subBucket) << shift;
+}
+
+qint64 Histogram::bucketUpperBound(int bucket)
+{
+    if(bucket < SUB_BUCKETS)
+    {
+        return bucket + 1;
+    }
+
+    int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    int subBucket = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+
+    return static_cast<qint64>(SUB_BUCKETS + subBucket + 1) << shift;
+}
+
+namespace {
+    int highestBit(quint64 value)
+    {
+        int bit = 0;
+        for(int step = 32; step > 0; step /= 2)
+        {
+            if(value >> step)
+            {
+                value >>= step;
+                bit += step;
+            }
+        }
+
+        return bit;
+    }
+}
@@ -4,6 +4,7 @@
 //
 
 #include "mathelp.h"
+#include "simdmath.h"
 
 #include <qmath.h>
 
@@ -93,28 +94,32 @@ QQuaternion orientationFromRotationMatrix(const QMatrix3x3& rot)
     return quat;
 }
 
-inline QVector3D linearColor(const QVector3D& color, float gamma)
+QVector3D linearColor(const QVector3D& color, float gamma)
 {
     return QVector3D(qPow(color.x(), gamma), qPow(color.y(), gamma), qPow(color.z(), gamma));
 }
 
-inline QVector3D extractScale(const QMatrix4x4& mat)
+QVector3D extractScale(const QMatrix4x4& mat)
 {
+    const Simd::Mat4 matrix = Simd::Mat4::fromQt(mat);
+
     // Scale is the vector norm of axes
-    return QVector3D(mat.column(0).toVector3D().length(),
-        mat.column(1).toVector3D().length(),
-        mat.column(2).toVector3D().length());
+    return QVector3D(Simd::length3(Simd::Vec4(matrix.column(0))),
+        Simd::length3(Simd::Vec4(matrix.column(1))),
+        Simd::length3(Simd::Vec4(matrix.column(2))));
 }
 
-inline QQuaternion extractOrientation(const QMatrix4x4& mat)
+QQuaternion extractOrientation(const QMatrix4x4& mat)
 {
+    const Simd::Mat4 matrix = Simd::Mat4::fromQt(mat);
+
     // Calculate orientation from axes
-    return orientationFromAxes(mat.column(0).toVector3D().normalized(),
-        mat.column(1).toVector3D().normalized(),
-        mat.column(2).toVector3D().normalized());
+    return orientationFromAxes(Simd::normalized3(Simd::Vec4(matrix.column(0))).toVector3D(),
+        Simd::normalized3(Simd::Vec4(matrix.column(1))).toVector3D(),
+        Simd::normalized3(Simd::Vec4(matrix.column(2))).toVector3D());
 }
 
-inline QVector3D extractTranslation(const QMatrix4x4& mat)
+QVector3D extractTranslation(const QMatrix4x4& mat)
 {
     // Translation is the 4th column
     return mat.column(3).toVector3D();
@@ -2,13 +2,14 @@
 //  Author   : Matti Määttä
 //  Summary  : MovingAverage does average filtering on the inserted values:
 //             calcAverage := sum(v, 0, samples) / samples
+//             The samples are kept in a ring buffer with a running sum, so neither push nor
+//             calcAverage allocates. calcAverage is constant time, and push is amortised
+//             constant time: the sum is recomputed over all samples once per round.
 //
 
 #ifndef MOVINGAVERAGE_H
 #define MOVINGAVERAGE_H
 
-#include <QVector>
-
 template<
     typename ValueType,
     typename ReturnType,
@@ -18,25 +19,37 @@ class MovingAverage
 {
 public:
     MovingAverage(ValueType initial = 0)
-        : samples_(samples, initial)
+        : next_(0), sum_(0)
     {
+        for(int i = 0; i < samples; ++i)
+        {
+            samples_[i] = initial;
+            sum_ += initial;
+        }
     }
 
     void push(const ValueType& value)
     {
-        samples_.pop_front();
-        samples_.push_back(value);
-    }
+        sum_ -= samples_[next_];
+        sum_ += value;
+        samples_[next_] = value;
 
-    ReturnType calcAverage() const
-    {
-        ReturnType sum = 0;
-        for(int i = 0; i < samples; ++i)
+        // The sum is recalculated once per round so that rounding errors don't accumulate
+        if(++next_ == samples)
         {
-            sum += samples_[i];
+            next_ = 0;
+            sum_ = 0;
+
+            for(int i = 0; i < samples; ++i)
+            {
+                sum_ += samples_[i];
+            }
         }
+    }
 
-        return static_cast<ReturnType>(sum / samples);
+    ReturnType calcAverage() const
+    {
+        return static_cast<ReturnType>(sum_ / samples);
     }
 
     MovingAverage& operator<<(const ValueType& value)
@@ -51,7 +64,9 @@ public:
     }
 
 private:
-    QVector<ValueType> samples_;
+    ValueType samples_[samples];
+    int next_;
+    ReturnType sum_;
 };
 
-#endif // MOVINGAVERAGE_H
\ No newline at end of file
+#endif // MOVINGAVERAGE_H
@@ -0,0 +1,181 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Aligned 4-wide math for the hot transform paths. The types are built on a small set
+//             of Float4 primitives, which use SSE2 when available and plain floats otherwise, so
+//             that other instruction sets only need the primitives. Conversions to and from Qt
+//             types are meant for API boundaries; hot loops should convert once and stay here.
+//
+
+#ifndef SIMDMATH_H
+#define SIMDMATH_H
+
+#include <QVector3D>
+#include <QVector4D>
+#include <QMatrix4x4>
+#include <QQuaternion>
+
+#include <cmath>
+
+// SSE2 is used on 64-bit targets only: the types are loaded with aligned loads, and only there
+// do the heap and the containers holding them guarantee 16-byte alignment. 32-bit builds use the
+// scalar primitives, which don't need the alignment either.
+#if !defined(ENGINE_NO_SIMD) && (defined(_M_X64) || defined(__x86_64__))
+    #define SIMD_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if !defined(SIMD_SSE2)
+    #define SIMD_ALIGNED
+#elif defined(_MSC_VER)
+    #define SIMD_ALIGNED __declspec(align(16))
+#else
+    #define SIMD_ALIGNED __attribute__((aligned(16)))
+#endif
+
+namespace Simd {
+
+// Primitives
+
+#ifdef SIMD_SSE2
+typedef __m128 Float4;
+#else
+struct Float4
+{
+    float v[4];
+};
+#endif
+
+// precondition: p is 16 byte aligned
+Float4 load(const float* p);
+Float4 loadUnaligned(const float* p);
+void store(float* p, Float4 a);
+void storeUnaligned(float* p, Float4 a);
+
+Float4 set(float x, float y, float z, float w);
+Float4 splat(float value);
+Float4 splatX(Float4 a);
+Float4 splatY(Float4 a);
+Float4 splatZ(Float4 a);
+Float4 splatW(Float4 a);
+
+Float4 add(Float4 a, Float4 b);
+Float4 sub(Float4 a, Float4 b);
+Float4 mul(Float4 a, Float4 b);
+Float4 madd(Float4 a, Float4 b, Float4 c);      // a * b + c
+Float4 minimum(Float4 a, Float4 b);
+Float4 maximum(Float4 a, Float4 b);
+Float4 abs(Float4 a);
+
+// Horizontal sums
+float sum3(Float4 a);
+float sum4(Float4 a);
+
+// Returns a bitmask of the lanes greater than zero, x being the lowest bit.
+int positiveMask(Float4 a);
+
+void transpose(Float4& a, Float4& b, Float4& c, Float4& d);
+
+// Types
+
+// Points have w = 1 and directions w = 0. Operations named with 3 ignore w.
+struct SIMD_ALIGNED Vec4
+{
+    float v[4];
+
+    Vec4();
+    Vec4(float x, float y, float z, float w);
+    explicit Vec4(Float4 value);
+
+    static Vec4 fromQt(const QVector3D& vec, float w);
+    static Vec4 fromQt(const QVector4D& vec);
+
+    QVector3D toVector3D() const;
+    QVector4D toVector4D() const;
+
+    Float4 value() const;
+
+    float x() const;
+    float y() const;
+    float z() const;
+    float w() const;
+};
+
+float dot3(const Vec4& a, const Vec4& b);
+float dot4(const Vec4& a, const Vec4& b);
+float length3(const Vec4& a);
+Vec4 normalized3(const Vec4& a);
+Vec4 minimum(const Vec4& a, const Vec4& b);
+Vec4 maximum(const Vec4& a, const Vec4& b);
+
+// Column-major like QMatrix4x4.
+struct SIMD_ALIGNED Mat4
+{
+    float m[4][4];
+
+    static Mat4 identity();
+    static Mat4 fromColumns(const Float4& c0, const Float4& c1, const Float4& c2, const Float4& c3);
+    static Mat4 fromQt(const QMatrix4x4& matrix);
+
+    QMatrix4x4 toQt() const;
+
+    Float4 column(int index) const;
+
+    Mat4 operator*(const Mat4& other) const;
+
+    // Returns M * v
+    Vec4 map(const Vec4& vec) const;
+};
+
+// Affine 3x4 transformation, stored as rows. The implicit last row is (0, 0, 0, 1).
+struct SIMD_ALIGNED Affine
+{
+    float m[3][4];
+
+    static Affine identity();
+    static Affine fromMat4(const Mat4& matrix);
+    static Affine fromQt(const QMatrix4x4& matrix);
+
+    Mat4 toMat4() const;
+    QMatrix4x4 toQt() const;
+
+    Float4 row(int index) const;
+
+    Affine operator*(const Affine& other) const;
+
+    Vec4 mapPoint(const Vec4& point) const;
+};
+
+// Stored as x, y, z, w; QQuaternion stores the scalar first.
+struct SIMD_ALIGNED Quat
+{
+    float v[4];
+
+    Quat();
+    Quat(float x, float y, float z, float w);
+
+    static Quat fromQt(const QQuaternion& quat);
+    QQuaternion toQt() const;
+
+    // Returns the quaternion unchanged if its length is zero.
+    Quat normalized() const;
+
+    // precondition: quaternion is normalized
+    Mat4 toMat4() const;
+};
+
+// Transforms the box given as center and extent by an affine matrix, returning the box that
+// encloses the result. The projective part of the matrix is ignored.
+void transformBox(const Mat4& matrix, const Vec4& center, const Vec4& extent, Vec4& outCenter, Vec4& outExtent);
+
+// Tests whether the box given as center and extent is fully or partially inside the clip space
+// of the model-view-projection matrix. Planes are extracted as in isInsideFrustum.
+bool boxInClipSpace(const Mat4& mvp, const Vec4& center, const Vec4& extent);
+
+// Returns a * b without leaving the aligned types in between.
+QMatrix4x4 multiply(const QMatrix4x4& a, const QMatrix4x4& b);
+
+}
+
+#include "simdmath.inl"
+
+#endif // SIMDMATH_H
@@ -0,0 +1,594 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+namespace Simd {
+
+#ifdef SIMD_SSE2
+
+inline Float4 load(const float* p)
+{
+    return _mm_load_ps(p);
+}
+
+inline Float4 loadUnaligned(const float* p)
+{
+    return _mm_loadu_ps(p);
+}
+
+inline void store(float* p, Float4 a)
+{
+    _mm_store_ps(p, a);
+}
+
+inline void storeUnaligned(float* p, Float4 a)
+{
+    _mm_storeu_ps(p, a);
+}
+
+inline Float4 set(float x, float y, float z, float w)
+{
+    return _mm_setr_ps(x, y, z, w);
+}
+
+inline Float4 splat(float value)
+{
+    return _mm_set1_ps(value);
+}
+
+inline Float4 splatX(Float4 a)
+{
+    return _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+inline Float4 splatY(Float4 a)
+{
+    return _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1));
+}
+
+inline Float4 splatZ(Float4 a)
+{
+    return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2));
+}
+
+inline Float4 splatW(Float4 a)
+{
+    return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+inline Float4 add(Float4 a, Float4 b)
+{
+    return _mm_add_ps(a, b);
+}
+
+inline Float4 sub(Float4 a, Float4 b)
+{
+    return _mm_sub_ps(a, b);
+}
+
+inline Float4 mul(Float4 a, Float4 b)
+{
+    return _mm_mul_ps(a, b);
+}
+
+inline Float4 madd(Float4 a, Float4 b, Float4 c)
+{
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+}
+
+inline Float4 minimum(Float4 a, Float4 b)
+{
+    return _mm_min_ps(a, b);
+}
+
+inline Float4 maximum(Float4 a, Float4 b)
+{
+    return _mm_max_ps(a, b);
+}
+
+inline Float4 abs(Float4 a)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+}
+
+inline float sum3(Float4 a)
+{
+    return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(a, splatY(a)), splatZ(a)));
+}
+
+inline float sum4(Float4 a)
+{
+    Float4 pairs = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, splatY(pairs)));
+}
+
+inline int positiveMask(Float4 a)
+{
+    return _mm_movemask_ps(_mm_cmpgt_ps(a, _mm_setzero_ps()));
+}
+
+inline void transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+{
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+}
+
+#else
+
+inline Float4 load(const float* p)
+{
+    Float4 result = { { p[0], p[1], p[2], p[3] } };
+    return result;
+}
+
+inline Float4 loadUnaligned(const float* p)
+{
+    return load(p);
+}
+
+inline void store(float* p, Float4 a)
+{
+    for(int i = 0; i < 4; ++i)
+    {
+        p[i] = a.v[i];
+    }
+}
+
+inline void storeUnaligned(float* p, Float4 a)
+{
+    store(p, a);
+}
+
+inline Float4 set(float x, float y, float z, float w)
+{
+    Float4 result = { { x, y, z, w } };
+    return result;
+}
+
+inline Float4 splat(float value)
+{
+    return set(value, value, value, value);
+}
+
+inline Float4 splatX(Float4 a)
+{
+    return splat(a.v[0]);
+}
+
+inline Float4 splatY(Float4 a)
+{
+    return splat(a.v[1]);
+}
+
+inline Float4 splatZ(Float4 a)
+{
+    return splat(a.v[2]);
+}
+
+inline Float4 splatW(Float4 a)
+{
+    return splat(a.v[3]);
+}
+
+inline Float4 add(Float4 a, Float4 b)
+{
+    return set(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]);
+}
+
+inline Float4 sub(Float4 a, Float4 b)
+{
+    return set(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]);
+}
+
+inline Float4 mul(Float4 a, Float4 b)
+{
+    return set(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]);
+}
+
+inline Float4 madd(Float4 a, Float4 b, Float4 c)
+{
+    return add(mul(a, b), c);
+}
+
+inline Float4 minimum(Float4 a, Float4 b)
+{
+    return set(qMin(a.v[0], b.v[0]), qMin(a.v[1], b.v[1]), qMin(a.v[2], b.v[2]), qMin(a.v[3], b.v[3]));
+}
+
+inline Float4 maximum(Float4 a, Float4 b)
+{
+    return set(qMax(a.v[0], b.v[0]), qMax(a.v[1], b.v[1]), qMax(a.v[2], b.v[2]), qMax(a.v[3], b.v[3]));
+}
+
+inline Float4 abs(Float4 a)
+{
+    return set(std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3]));
+}
+
+inline float sum3(Float4 a)
+{
+    return a.v[0] + a.v[1] + a.v[2];
+}
+
+inline float sum4(Float4 a)
+{
+    return (a.v[0] + a.v[2]) + (a.v[1] + a.v[3]);
+}
+
+inline int positiveMask(Float4 a)
+{
+    int mask = 0;
+    for(int i = 0; i < 4; ++i)
+    {
+        mask |= (a.v[i] > 0.0f) << i;
+    }
+
+    return mask;
+}
+
+inline void transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+{
+    Float4 rows[4] = { a, b, c, d };
+
+    a = set(rows[0].v[0], rows[1].v[0], rows[2].v[0], rows[3].v[0]);
+    b = set(rows[0].v[1], rows[1].v[1], rows[2].v[1], rows[3].v[1]);
+    c = set(rows[0].v[2], rows[1].v[2], rows[2].v[2], rows[3].v[2]);
+    d = set(rows[0].v[3], rows[1].v[3], rows[2].v[3], rows[3].v[3]);
+}
+
+#endif // SIMD_SSE2
+
+// Vec4
+
+inline Vec4::Vec4()
+{
+    store(v, splat(0.0f));
+}
+
+inline Vec4::Vec4(float x, float y, float z, float w)
+{
+    store(v, set(x, y, z, w));
+}
+
+inline Vec4::Vec4(Float4 value)
+{
+    store(v, value);
+}
+
+inline Vec4 Vec4::fromQt(const QVector3D& vec, float w)
+{
+    return Vec4(vec.x(), vec.y(), vec.z(), w);
+}
+
+inline Vec4 Vec4::fromQt(const QVector4D& vec)
+{
+    return Vec4(vec.x(), vec.y(), vec.z(), vec.w());
+}
+
+inline QVector3D Vec4::toVector3D() const
+{
+    return QVector3D(v[0], v[1], v[2]);
+}
+
+inline QVector4D Vec4::toVector4D() const
+{
+    return QVector4D(v[0], v[1], v[2], v[3]);
+}
+
+inline Float4 Vec4::value() const
+{
+    return load(v);
+}
+
+inline float Vec4::x() const
+{
+    return v[0];
+}
+
+inline float Vec4::y() const
+{
+    return v[1];
+}
+
+inline float Vec4::z() const
+{
+    return v[2];
+}
+
+inline float Vec4::w() const
+{
+    return v[3];
+}
+
+inline float dot3(const Vec4& a, const Vec4& b)
+{
+    return sum3(mul(a.value(), b.value()));
+}
+
+inline float dot4(const Vec4& a, const Vec4& b)
+{
+    return sum4(mul(a.value(), b.value()));
+}
+
+inline float length3(const Vec4& a)
+{
+    return std::sqrt(dot3(a, a));
+}
+
+inline Vec4 normalized3(const Vec4& a)
+{
+    float length = length3(a);
+    if(length == 0.0f)
+    {
+        return a;
+    }
+
+    return Vec4(mul(a.value(), splat(1.0f / length)));
+}
+
+inline Vec4 minimum(const Vec4& a, const Vec4& b)
+{
+    return Vec4(minimum(a.value(), b.value()));
+}
+
+inline Vec4 maximum(const Vec4& a, const Vec4& b)
+{
+    return Vec4(maximum(a.value(), b.value()));
+}
+
+// Mat4
+
+inline Mat4 Mat4::identity()
+{
+    return fromColumns(set(1, 0, 0, 0), set(0, 1, 0, 0), set(0, 0, 1, 0), set(0, 0, 0, 1));
+}
+
+inline Mat4 Mat4::fromColumns(const Float4& c0, const Float4& c1, const Float4& c2, const Float4& c3)
+{
+    Mat4 result;
+    store(result.m[0], c0);
+    store(result.m[1], c1);
+    store(result.m[2], c2);
+    store(result.m[3], c3);
+
+    return result;
+}
+
+inline Mat4 Mat4::fromQt(const QMatrix4x4& matrix)
+{
+    // QMatrix4x4 is not aligned
+    const float* data = matrix.constData();
+
+    return fromColumns(loadUnaligned(data), loadUnaligned(data + 4),
+        loadUnaligned(data + 8), loadUnaligned(data + 12));
+}
+
+inline QMatrix4x4 Mat4::toQt() const
+{
+    QMatrix4x4 result;
+
+    // data() marks the matrix as general, so Qt won't take identity shortcuts with it
+    float* data = result.data();
+    for(int i = 0; i < 4; ++i)
+    {
+        storeUnaligned(data + i * 4, column(i));
+    }
+
+    return result;
+}
+
+inline Float4 Mat4::column(int index) const
+{
+    return load(m[index]);
+}
+
+inline Mat4 Mat4::operator*(const Mat4& other) const
+{
+    const Float4 c0 = column(0);
+    const Float4 c1 = column(1);
+    const Float4 c2 = column(2);
+    const Float4 c3 = column(3);
+
+    Mat4 result;
+    for(int i = 0; i < 4; ++i)
+    {
+        const Float4 b = other.column(i);
+        const Float4 ab = madd(c0, splatX(b), madd(c1, splatY(b), madd(c2, splatZ(b), mul(c3, splatW(b)))));
+
+        store(result.m[i], ab);
+    }
+
+    return result;
+}
+
+inline Vec4 Mat4::map(const Vec4& vec) const
+{
+    const Float4 v = vec.value();
+    return Vec4(madd(column(0), splatX(v), madd(column(1), splatY(v), madd(column(2), splatZ(v), mul(column(3), splatW(v))))));
+}
+
+// Affine
+
+inline Affine Affine::identity()
+{
+    return fromMat4(Mat4::identity());
+}
+
+inline Affine Affine::fromMat4(const Mat4& matrix)
+{
+    Float4 r0 = matrix.column(0);
+    Float4 r1 = matrix.column(1);
+    Float4 r2 = matrix.column(2);
+    Float4 r3 = matrix.column(3);
+    transpose(r0, r1, r2, r3);
+
+    Affine result;
+    store(result.m[0], r0);
+    store(result.m[1], r1);
+    store(result.m[2], r2);
+
+    return result;
+}
+
+inline Affine Affine::fromQt(const QMatrix4x4& matrix)
+{
+    return fromMat4(Mat4::fromQt(matrix));
+}
+
+inline Mat4 Affine::toMat4() const
+{
+    Float4 c0 = row(0);
+    Float4 c1 = row(1);
+    Float4 c2 = row(2);
+    Float4 c3 = set(0, 0, 0, 1);
+    transpose(c0, c1, c2, c3);
+
+    return Mat4::fromColumns(c0, c1, c2, c3);
+}
+
+inline QMatrix4x4 Affine::toQt() const
+{
+    return toMat4().toQt();
+}
+
+inline Float4 Affine::row(int index) const
+{
+    return load(m[index]);
+}
+
+inline Affine Affine::operator*(const Affine& other) const
+{
+    const Float4 b0 = other.row(0);
+    const Float4 b1 = other.row(1);
+    const Float4 b2 = other.row(2);
+    const Float4 translation = set(0, 0, 0, 1);
+
+    Affine result;
+    for(int i = 0; i < 3; ++i)
+    {
+        const Float4 a = row(i);
+        const Float4 ab = madd(splatX(a), b0, madd(splatY(a), b1, madd(splatZ(a), b2, mul(splatW(a), translation))));
+
+        store(result.m[i], ab);
+    }
+
+    return result;
+}
+
+inline Vec4 Affine::mapPoint(const Vec4& point) const
+{
+    const Float4 p = point.value();
+    const Float4 homogeneous = add(mul(p, set(1, 1, 1, 0)), set(0, 0, 0, 1));
+
+    return Vec4(sum4(mul(row(0), homogeneous)), sum4(mul(row(1), homogeneous)),
+        sum4(mul(row(2), homogeneous)), 1.0f);
+}
+
+// Quat
+
+inline Quat::Quat()
+{
+    store(v, set(0, 0, 0, 1));
+}
+
+inline Quat::Quat(float x, float y, float z, float w)
+{
+    store(v, set(x, y, z, w));
+}
+
+inline Quat Quat::fromQt(const QQuaternion& quat)
+{
+    return Quat(quat.x(), quat.y(), quat.z(), quat.scalar());
+}
+
+inline QQuaternion Quat::toQt() const
+{
+    return QQuaternion(v[3], v[0], v[1], v[2]);
+}
+
+inline Quat Quat::normalized() const
+{
+    const Float4 q = load(v);
+    const float length = std::sqrt(sum4(mul(q, q)));
+
+    if(length == 0.0f)
+    {
+        return *this;
+    }
+
+    Quat result;
+    store(result.v, mul(q, splat(1.0f / length)));
+
+    return result;
+}
+
+inline Mat4 Quat::toMat4() const
+{
+    const float x = v[0], y = v[1], z = v[2], w = v[3];
+
+    const float xx = x * x, yy = y * y, zz = z * z;
+    const float xy = x * y, xz = x * z, yz = y * z;
+    const float wx = w * x, wy = w * y, wz = w * z;
+
+    return Mat4::fromColumns(set(1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0),
+                             set(2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0),
+                             set(2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0),
+                             set(0, 0, 0, 1));
+}
+
+// Boxes
+
+inline void transformBox(const Mat4& matrix, const Vec4& center, const Vec4& extent, Vec4& outCenter, Vec4& outExtent)
+{
+    const Float4 c = center.value();
+    const Float4 e = extent.value();
+
+    const Float4 c0 = matrix.column(0);
+    const Float4 c1 = matrix.column(1);
+    const Float4 c2 = matrix.column(2);
+
+    // Extent along each axis is the sum of the absolute projections of the box axes
+    outCenter = Vec4(madd(c0, splatX(c), madd(c1, splatY(c), madd(c2, splatZ(c), matrix.column(3)))));
+    outExtent = Vec4(madd(abs(c0), splatX(e), madd(abs(c1), splatY(e), mul(abs(c2), splatZ(e)))));
+}
+
+inline bool boxInClipSpace(const Mat4& mvp, const Vec4& center, const Vec4& extent)
+{
+    // Lanes x, y and z of the sums below are the left, bottom and near planes, or the right,
+    // top and far planes when subtracted. Lane w of the matrix is the fourth row.
+    const Float4 c0 = mvp.column(0);
+    const Float4 c1 = mvp.column(1);
+    const Float4 c2 = mvp.column(2);
+    const Float4 c3 = mvp.column(3);
+
+    const Float4 c = center.value();
+    const Float4 e = extent.value();
+    const Float4 cx = splatX(c), cy = splatY(c), cz = splatZ(c);
+    const Float4 ex = splatX(e), ey = splatY(e), ez = splatZ(e);
+
+    const Float4 nx[2] = { add(splatW(c0), c0), sub(splatW(c0), c0) };
+    const Float4 ny[2] = { add(splatW(c1), c1), sub(splatW(c1), c1) };
+    const Float4 nz[2] = { add(splatW(c2), c2), sub(splatW(c2), c2) };
+    const Float4 d[2] = { add(splatW(c3), c3), sub(splatW(c3), c3) };
+
+    for(int i = 0; i < 2; ++i)
+    {
+        // http://fgiesen.wordpress.com/2010/10/17/view-frustum-culling/
+        Float4 distance = madd(nx[i], cx, madd(ny[i], cy, madd(nz[i], cz, d[i])));
+        distance = madd(abs(nx[i]), ex, madd(abs(ny[i]), ey, madd(abs(nz[i]), ez, distance)));
+
+        if((positiveMask(distance) & 0x7) != 0x7)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline QMatrix4x4 multiply(const QMatrix4x4& a, const QMatrix4x4& b)
+{
+    return (Mat4::fromQt(a) * Mat4::fromQt(b)).toQt();
+}
+
+}
@@ -0,0 +1,371 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "tracer.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QThreadStorage>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+
+struct TraceEvent
+{
+    const char* name;
+    qint64 start;
+    qint64 duration;
+    char phase;         // Chrome trace event phase: B, E, X or i
+};
+
+// Single writer ring buffer. Only the owning thread writes the events, the capture is
+// read after it has ended. The buffer is reset by the writer when a new capture begins.
+class TraceBuffer
+{
+public:
+    enum { CAPACITY = 1 << 14 };
+
+    TraceBuffer(int id, const QString& name);
+
+    // Owning thread only.
+    void push(const TraceEvent& event, int capture);
+
+    // Returns the number of events written during the capture, including the overwritten ones.
+    int written(int capture) const;
+
+    // Index is taken modulo the capacity.
+    const TraceEvent& at(int index) const;
+
+    const int id;
+
+    // Guarded by the tracer mutex
+    QString name;
+    bool owned;
+
+private:
+    TraceEvent* events_;
+    QAtomicInt head_;
+    QAtomicInt capture_;
+
+    TraceBuffer(const TraceBuffer&);
+    TraceBuffer& operator=(const TraceBuffer&);
+};
+
+namespace {
+    // Returns the buffer of the calling thread, registering the thread on first use.
+    TraceBuffer* threadBuffer();
+
+    // Reuses the buffer of an exited thread if it isn't part of the current capture.
+    TraceBuffer* acquireBuffer();
+
+    void recordEvent(TraceBuffer* buffer, const char* name, qint64 start, qint64 duration, char phase);
+
+    QString escaped(const QString& text);
+
+    // Retires the thread's buffer when the thread exits
+    struct ThreadTrack
+    {
+        TraceBuffer* buffer;
+        ~ThreadTrack();
+    };
+
+    QMutex mutex;
+    QList<TraceBuffer*> buffers;
+    QHash<QString, QByteArray> names;
+    QThreadStorage<ThreadTrack*> threadTracks;
+
+    QElapsedTimer clock;
+    QAtomicInt capture;
+}
+
+QAtomicInt Tracer::enabled_;
+
+void Tracer::beginCapture()
+{
+    QMutexLocker lock(&mutex);
+
+    clock.start();
+    capture.ref();
+    enabled_.storeRelease(1);
+}
+
+void Tracer::endCapture()
+{
+    enabled_.storeRelease(0);
+}
+
+void Tracer::beginZone(const char* name)
+{
+    recordEvent(threadBuffer(), name, now(), 0, 'B');
+}
+
+void Tracer::endZone()
+{
+    // Zones left open by the end of the capture are closed by the trace viewer
+    if(enabled())
+    {
+        recordEvent(threadBuffer(), nullptr, now(), 0, 'E');
+    }
+}
+
+void Tracer::frameMarker()
+{
+    if(enabled())
+    {
+        recordEvent(threadBuffer(), "Frame", now(), 0, 'i');
+    }
+}
+
+void Tracer::setThreadName(const QString& name)
+{
+    TraceBuffer* buffer = threadBuffer();
+
+    QMutexLocker lock(&mutex);
+    buffer->name = name;
+}
+
+Tracer::Track Tracer::addTrack(const QString& name)
+{
+    QMutexLocker lock(&mutex);
+
+    TraceBuffer* buffer = new TraceBuffer(buffers.count(), name);
+    buffer->owned = true;
+    buffers.append(buffer);
+
+    return buffer;
+}
+
+void Tracer::releaseTrack(Track track)
+{
+    QMutexLocker lock(&mutex);
+    track->owned = false;
+}
+
+void Tracer::addZone(Track track, const char* name, qint64 start, qint64 end)
+{
+    if(track != nullptr && enabled())
+    {
+        recordEvent(track, name, start, end - start, 'X');
+    }
+}
+
+const char* Tracer::intern(const QString& name)
+{
+    QMutexLocker lock(&mutex);
+
+    auto it = names.find(name);
+    if(it == names.end())
+    {
+        it = names.insert(name, name.toUtf8());
+    }
+
+    return it->constData();
+}
+
+qint64 Tracer::now()
+{
+    return clock.nsecsElapsed();
+}
+
+int Tracer::capturedEvents()
+{
+    QMutexLocker lock(&mutex);
+
+    int count = 0;
+    for(const TraceBuffer* buffer : buffers)
+    {
+        count += buffer->written(capture.load());
+    }
+
+    return count;
+}
+
+int Tracer::droppedEvents()
+{
+    QMutexLocker lock(&mutex);
+
+    int count = 0;
+    for(const TraceBuffer* buffer : buffers)
+    {
+        count += qMax(0, buffer->written(capture.load()) - TraceBuffer::CAPACITY);
+    }
+
+    return count;
+}
+
+bool Tracer::writeChromeTrace(const QString& fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName;
+        return false;
+    }
+
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(3);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    QMutexLocker lock(&mutex);
+    bool first = true;
+
+    for(const TraceBuffer* buffer : buffers)
+    {
+        const int written = buffer->written(capture.load());
+        if(written == 0)
+        {
+            continue;
+        }
+
+        // Tracks are listed in registration order, the render thread first
+        out << (first ? "" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":\"" << escaped(buffer->name) << "\"}},\n"
+            << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"sort_index\":" << buffer->id << "}}";
+
+        first = false;
+
+        // Timestamps are in microseconds
+        for(int i = qMax(0, written - TraceBuffer::CAPACITY); i < written; ++i)
+        {
+            const TraceEvent& event = buffer->at(i);
+
+            out << ",\n{\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << event.start * 1e-3;
+
+            if(event.name != nullptr)
+            {
+                out << ",\"name\":\"" << escaped(QString::fromUtf8(event.name)) << "\"";
+            }
+
+            if(event.phase == 'X')
+            {
+                out << ",\"dur\":" << event.duration * 1e-3;
+            }
+
+            else if(event.phase == 'i')
+            {
+                out << ",\"s\":\"g\"";
+            }
+
+            out << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    out.flush();
+
+    return file.error() == QFile::NoError;
+}
+
+TraceBuffer::TraceBuffer(int id, const QString& name)
+    : id(id), name(name), owned(false), events_(nullptr), head_(0), capture_(0)
+{
+}
+
+void TraceBuffer::push(const TraceEvent& event, int capture)
+{
+    if(capture_.load() != capture)
+    {
+        if(events_ == nullptr)
+        {
+            events_ = new TraceEvent[CAPACITY];
+        }
+
+        // Readers check the capture before the head, so the old head is never paired with it
+        head_.storeRelease(0);
+        capture_.storeRelease(capture);
+    }
+
+    int head = head_.load();
+    events_[head & (CAPACITY - 1)] = event;
+    head_.storeRelease(head + 1);
+}
+
+int TraceBuffer::written(int capture) const
+{
+    if(capture_.loadAcquire() != capture)
+    {
+        return 0;
+    }
+
+    return head_.loadAcquire();
+}
+
+const TraceEvent& TraceBuffer::at(int index) const
+{
+    return events_[index & (CAPACITY - 1)];
+}
+
+namespace {
+    TraceBuffer* threadBuffer()
+    {
+        if(!threadTracks.hasLocalData())
+        {
+            ThreadTrack* track = new ThreadTrack;
+            track->buffer = acquireBuffer();
+            threadTracks.setLocalData(track);
+        }
+
+        return threadTracks.localData()->buffer;
+    }
+
+    TraceBuffer* acquireBuffer()
+    {
+        QMutexLocker lock(&mutex);
+
+        TraceBuffer* buffer = nullptr;
+        for(TraceBuffer* retired : buffers)
+        {
+            if(!retired->owned && retired->written(capture.load()) == 0)
+            {
+                buffer = retired;
+                break;
+            }
+        }
+
+        if(buffer == nullptr)
+        {
+            buffer = new TraceBuffer(buffers.count(), QString());
+            buffers.append(buffer);
+        }
+
+        QString threadName = QThread::currentThread()->objectName();
+        buffer->name = threadName.isEmpty() ? QString("Thread %1").arg(buffer->id) : threadName;
+        buffer->owned = true;
+
+        return buffer;
+    }
+
+    void recordEvent(TraceBuffer* buffer, const char* name, qint64 start, qint64 duration, char phase)
+    {
+        TraceEvent event = { name, start, duration, phase };
+        buffer->push(event, capture.load());
+    }
+
+    QString escaped(const QString& text)
+    {
+        QString result = text;
+        result.replace('\\', "\\\\");
+        result.replace('"', "\\\"");
+
+        return result;
+    }
+
+    ThreadTrack::~ThreadTrack()
+    {
+        QMutexLocker lock(&mutex);
+        buffer->owned = false;
+    }
+}
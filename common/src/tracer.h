@@ -0,0 +1,121 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Tracer records scoped CPU zones and frame markers into per-thread ring buffers,
+//             and zones with known timestamps, eg. resolved GPU queries, into named tracks.
+//             A capture can be written as Chrome trace JSON, which opens in chrome://tracing
+//             and Perfetto. Define ENGINE_NO_TRACING to compile the trace macros out.
+//
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QAtomicInt>
+#include <QString>
+
+class TraceBuffer;
+
+class Tracer
+{
+public:
+    typedef TraceBuffer* Track;
+
+    // Returns true while a capture is recorded.
+    static bool enabled();
+
+    // Starts a new capture. Events of the previous capture are discarded.
+    static void beginCapture();
+
+    // Stops recording. The capture is kept until the next one begins.
+    static void endCapture();
+
+    // Zones are closed in reverse order on the thread that opened them.
+    // name must stay valid until the capture has been written, eg. a string literal.
+    static void beginZone(const char* name);
+    static void endZone();
+
+    // Marks the beginning of a frame. Ignored when not capturing.
+    static void frameMarker();
+
+    // Names the calling thread's track in the written trace.
+    static void setThreadName(const QString& name);
+
+    // Registers a track that isn't bound to a thread. Only one thread may add zones to a track.
+    static Track addTrack(const QString& name);
+
+    // The track's buffer is reused by new threads once its events are no longer captured.
+    static void releaseTrack(Track track);
+
+    // Adds a zone with timestamps from now() to the track.
+    static void addZone(Track track, const char* name, qint64 start, qint64 end);
+
+    // Returns a copy of the name which stays valid for the lifetime of the program.
+    // Meant for names built at runtime, eg. frame graph passes. Not for per-frame use.
+    static const char* intern(const QString& name);
+
+    // Nanoseconds since the capture began.
+    static qint64 now();
+
+    // Returns the number of events in the capture, including the ones lost to a full buffer.
+    static int capturedEvents();
+
+    // Returns the number of events overwritten because a buffer was full.
+    static int droppedEvents();
+
+    // Writes the capture as Chrome trace event JSON. Should be called after the capture has ended.
+    // postcondition: false if the file couldn't be written
+    static bool writeChromeTrace(const QString& fileName);
+
+private:
+    static QAtomicInt enabled_;
+
+    Tracer();
+};
+
+// Records a zone on the calling thread from construction to destruction.
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name);
+    ~TraceScope();
+
+private:
+    bool active_;
+
+    TraceScope(const TraceScope&);
+    TraceScope& operator=(const TraceScope&);
+};
+
+inline bool Tracer::enabled()
+{
+    return enabled_.load() != 0;
+}
+
+inline TraceScope::TraceScope(const char* name)
+    : active_(Tracer::enabled())
+{
+    if(active_)
+    {
+        Tracer::beginZone(name);
+    }
+}
+
+inline TraceScope::~TraceScope()
+{
+    if(active_)
+    {
+        Tracer::endZone();
+    }
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifndef ENGINE_NO_TRACING
+    #define TRACE_SCOPE(name) ::TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+    #define TRACE_FRAME() ::Tracer::frameMarker()
+#else
+    #define TRACE_SCOPE(name)
+    #define TRACE_FRAME()
+#endif // ENGINE_NO_TRACING
+
+#endif // TRACER_H
@@ -23,6 +23,42 @@ Rectangle {
             checked: true
         }
 
+        CheckBoxAttribute {
+            id: permutations
+            name: "Shader permutations"
+            checked: false
+        }
+
+        CheckBoxAttribute {
+            name: "Texture arrays"
+            checked: false
+        }
+
+        CheckBoxAttribute {
+            name: "Dynamic resolution"
+            checked: false
+        }
+
+        CheckBoxAttribute {
+            name: "Frame graph"
+            checked: false
+        }
+
+        CheckBoxAttribute {
+            name: "Pipelined frames"
+            checked: false
+        }
+
+        CheckBoxAttribute {
+            name: "Capture trace"
+            checked: false
+        }
+
+        CheckBoxAttribute {
+            name: "Record statistics"
+            checked: false
+        }
+
         CheckBoxAttribute {
             id: gbuffer
             name: "Show GBuffer"
@@ -39,6 +75,11 @@ Rectangle {
             checked: false
         }
 
+        ComboBoxAttribute {
+            name: "MSAA"
+            model: [ "1", "2", "4", "8" ]
+        }
+
         ComboBoxAttribute {
             id: scene
             name: "Scene"
@@ -47,6 +88,7 @@ Rectangle {
         function onValueChange(name, value) {
             if(name === "deferred rendering") {
                 gbuffer.visible = value;
+                permutations.visible = value;
             }
 
             general.valueChanged(name, value);
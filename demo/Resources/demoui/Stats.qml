@@ -4,36 +4,78 @@ Item {
     width: 150
     height: 50
 
+    // Values named "<name> <suffix>" are shown on the row of <name>
+    property var percentiles: [ "p50", "p95", "p99", "max" ]
+
     Column {
         id: column
         spacing: 5
     }
 
+    function findRow(name) {
+        for(var i = 0; i < column.children.length; ++i) {
+            var textObject = column.children[i];
+
+            if(textObject.name === name) {
+                return textObject;
+            }
+        }
+
+        var textItem = Qt.createQmlObject('import QtQuick 2.0; Text { font.family: "Consolas"; font.pointSize: 10; color: "white"; ' +
+                                          'property string name; property string value; property string unit; property var percentiles: ({}) }',
+                                          column);
+        textItem.name = name;
+
+        return textItem;
+    }
+
+    function updateRow(textItem) {
+        var text = textItem.name + ":";
+
+        if(textItem.value !== "") {
+            text += " " + textItem.value;
+            if(textItem.unit !== "") {
+                text += " " + textItem.unit;
+            }
+        }
+
+        for(var i = 0; i < percentiles.length; ++i) {
+            var percentile = textItem.percentiles[percentiles[i]];
+            if(percentile !== undefined) {
+                text += "  " + percentiles[i] + " " + percentile;
+            }
+        }
+
+        textItem.text = text;
+    }
+
     function watchValue(name, value, unit) {
         if(column === undefined) {
             return;
         }
 
+        var separator = name.lastIndexOf(" ");
+        var suffix = name.substring(separator + 1);
         var textItem;
 
-        for(var i = 0; i < column.children.length; ++i) {
-            var textObject = column.children[i];
+        if(separator !== -1 && percentiles.indexOf(suffix) !== -1) {
+            textItem = findRow(name.substring(0, separator));
 
-            if(textObject.text.search(name) !== -1) {
-                textItem = textObject;
-                break;
-            }
+            var values = textItem.percentiles;
+            values[suffix] = value.toFixed(2);
+            textItem.percentiles = values;
         }
 
-        if(textItem === undefined) {
-            textItem = Qt.createQmlObject('import QtQuick 2.0; Text { font.family: "Consolas"; font.pointSize: 10; color: "white" }',
-                                                column);
+        else {
+            textItem = findRow(name);
+            textItem.value = value.toFixed(2);
         }
 
-        textItem.text = name + ": " + value.toFixed(2);
         if(unit !== undefined) {
-            textItem.text += " " + unit;
+            textItem.unit = unit;
         }
+
+        updateRow(textItem);
     }
 
     function clearValues() {
@@ -32,6 +32,11 @@ Rectangle {
             value: 0.25
         }
 
+        CheckBoxAttribute {
+            name: "Dual filter bloom"
+            checked: false
+        }
+
         SliderAttribute {
             name: "Bright level"
             minimumValue: 0
@@ -51,6 +56,13 @@ Rectangle {
             checked: false
         }
 
+        CheckBoxAttribute {
+            id: histogram
+            name: "Histogram exposure"
+            checked: false
+            visible: false
+        }
+
         SliderAttribute {
             id: exposure
             name: "Exposure"
@@ -62,6 +74,7 @@ Rectangle {
         function onValueChange(name, value) {
             if(name === "automatic exposure") {
                 exposure.visible = !value;
+                histogram.visible = value;
 
                 if(value) {
                     tonemap.valueChanged("exposure", -1);
@@ -13,24 +13,48 @@
 #include "renderable/cube.h"
 #include "inputstate.h"
 #include "texture2dresource.h"
+#include "framestatistics.h"
 
+#include <QElapsedTimer>
 #include <QTime>
 #include <QDebug>
 #include <qmath.h>
 
 using namespace Engine;
 
+unsigned int GameOfLife::randomSeed_ = 0;
+QSize GameOfLife::gridSize_(GameOfLife::DEFAULT_WIDTH, GameOfLife::DEFAULT_HEIGHT);
+
 GameOfLife::GameOfLife(Engine::ResourceDespatcher& despatcher)
     : FreeLookScene(despatcher), generationNum_(0), autoAdvance_(false),
-    totalElapsed_(0), base_(nullptr)
+    totalElapsed_(0), base_(nullptr), grid_(gridSize_.width(), gridSize_.height()),
+    generationStat_(nullptr), generationRateStat_(nullptr), sceneUpdateStat_(nullptr)
 {
-    qsrand(QTime::currentTime().msec());
+    qsrand(randomSeed_ != 0 ? randomSeed_ : QTime::currentTime().msec());
 }
 
 GameOfLife::~GameOfLife()
 {
 }
 
+void GameOfLife::setRandomSeed(unsigned int seed)
+{
+    randomSeed_ = seed;
+}
+
+void GameOfLife::setGridSize(const QSize& size)
+{
+    const int words = (qMax(1, size.width()) + LifeGrid::CELLS_PER_WORD - 1) / LifeGrid::CELLS_PER_WORD;
+    gridSize_ = QSize(words * LifeGrid::CELLS_PER_WORD, qMax(1, size.height()));
+}
+
+void GameOfLife::setStatistics(FrameStatistics* statistics)
+{
+    generationStat_ = statistics->stat("Life generation time", "ms", 1e-6);
+    generationRateStat_ = statistics->stat("Life generation rate", "Mcells/s", 1e-3);
+    sceneUpdateStat_ = statistics->stat("Life scene update time", "ms", 1e-6);
+}
+
 void GameOfLife::update(unsigned int elapsed)
 {
     FreeLookScene::update(elapsed);
@@ -49,7 +73,7 @@ void GameOfLife::update(unsigned int elapsed)
         if(totalElapsed_ >= 100 || !autoAdvance_)
         {
             totalElapsed_ = 0;
-            qDebug() << "Generation:" << ++generationNum_;
+            ++generationNum_;
             nextGeneration();
         }
     }
@@ -80,14 +104,31 @@ void GameOfLife::initialise()
 
     Renderable::Cube::Ptr cube = Renderable::Primitive<Renderable::Cube>::instance();
 
+    // Cells share a palette of random colors, large grids would otherwise hold a material per cell
+    QVector<Material::Ptr> materials;
+    for(int i = 0; i < MATERIAL_COUNT; ++i)
+    {
+        Material::Ptr material = std::make_shared<Material>();
+        material->setDiffuseColor(QVector3D(qrand() % 225 + 25, qrand() % 225 + 25, qrand() % 225 + 25) / 255.0f);
+        material->setShininess(50.0f);
+        material->setSpecularIntensity(0.7f);
+
+        materials.append(material);
+    }
+
     base_ = rootNode().createChild();
 
+    const int width = grid_.width();
+    const int height = grid_.height();
+
     const float gap = 0.15f;
-    const float circ = (WIDTH - 1) * (1 + gap);
+    const float circ = (width - 1) * (1 + gap);
     const qreal radius = circ / (2 * M_PI);
 
+    space_.resize(width * height);
+
     // Initialise space
-    for(int x = 0; x < WIDTH; ++x)
+    for(int x = 0; x < width; ++x)
     {
         qreal coeff = (x * (1 + gap)) / circ * 2 * M_PI;
         float xcoord = qSin(coeff) * radius;
@@ -95,22 +136,16 @@ void GameOfLife::initialise()
 
         QVector3D direction = -QVector3D(xcoord, 0, zcoord).normalized();
 
-        for(int y = 0; y < HEIGHT; ++y)
+        for(int y = 0; y < height; ++y)
         {
             // Set fixed transformation
-            Population& pop = space_[y][x];
+            Population& pop = space_[y * width + x];
             pop.node = base_->createChild();
             pop.node->scale(0.5f);
             pop.node->setPosition(QVector3D(xcoord, y * (1 + gap), zcoord) + direction * (0.5f - (qrand() % 10) / 10.0f));
             pop.node->setDirection(direction);
 
-            // Apply random color
-            Material::Ptr material = std::make_shared<Material>();
-            material->setDiffuseColor(QVector3D(qrand() % 225 + 25, qrand() % 225 + 25, qrand() % 225 + 25) / 255.0f);
-            material->setShininess(50.0f);
-            material->setSpecularIntensity(0.7f);
-
-            pop.leaf = std::make_shared<Graph::Geometry>(cube, material);
+            pop.leaf = std::make_shared<Graph::Geometry>(cube, materials[qrand() % MATERIAL_COUNT]);
             scene().addSceneLeaf(pop.leaf);
         }
     }
@@ -123,50 +158,50 @@ void GameOfLife::initialise()
 
 void GameOfLife::nextGeneration()
 {
-    for(int x = 0; x < WIDTH; ++x)
-    {
-        for(int y = 0; y < HEIGHT; ++y)
-        {
-            unsigned int neighbours = countNeighbours(currentGen_, QPoint(x, y));
-            bool nextPopulation = false;
-            bool currentPopulation = currentGen_[y][x];
+    QElapsedTimer timer;
+    timer.start();
 
-            if(!currentPopulation && neighbours == 3)
-            {
-                nextPopulation = true;
-            }
+    const int flipped = grid_.step();
+    const qint64 generationTime = timer.nsecsElapsed();
 
-            else if(currentPopulation && (neighbours == 2 || neighbours == 3))
-            {
-                nextPopulation = true;
-            }
+    // Only the flipped cells are attached or detached
+    grid_.forEachChange([this] (int x, int y, bool alive) {
+        setPopulation(x, y, alive);
+    });
 
-            setGeneration(nextGen_, x, y, nextPopulation);
-        }
+    const qint64 sceneUpdateTime = timer.nsecsElapsed() - generationTime;
+
+    if(generationStat_ != nullptr)
+    {
+        const qint64 cells = static_cast<qint64>(grid_.width()) * grid_.height();
+
+        generationStat_->add(generationTime);
+        generationRateStat_->add(cells * 1000000 / qMax<qint64>(1, generationTime));
+        sceneUpdateStat_->add(sceneUpdateTime);
     }
 
-    currentGen_ = nextGen_;
+    qDebug() << "Generation:" << generationNum_ << "flipped" << flipped << "cells";
 }
 
 void GameOfLife::randomSeed()
 {
     unsigned int modulus = qrand() % 15 + 5;
 
-    for(int x = 0; x < WIDTH; ++x)
+    for(int x = 0; x < grid_.width(); ++x)
     {
-        for(int y = 0; y < HEIGHT; ++y)
+        for(int y = 0; y < grid_.height(); ++y)
         {
             // Make random population
-            setGeneration(currentGen_, x, y, qrand() % modulus == 0);
-            //setGeneration(currentGen_, x, y, true);
+            const bool alive = qrand() % modulus == 0;
+            grid_.setCell(x, y, alive);
+            setPopulation(x, y, alive);
         }
     }
 }
 
-void GameOfLife::setGeneration(GenerationType& gen, int x, int y, bool alive)
+void GameOfLife::setPopulation(int x, int y, bool alive)
 {
-    Population& pop = space_[y][x];
-    gen[y][x] = alive;
+    Population& pop = space_[y * grid_.width() + x];
 
     if(alive)
     {
@@ -178,42 +213,3 @@ void GameOfLife::setGeneration(GenerationType& gen, int x, int y, bool alive)
         pop.leaf->detach();
     }
 }
-
-unsigned int GameOfLife::countNeighbours(const GenerationType& gen, const QPoint& loc)
-{
-    unsigned int count = 0;
-
-    for(int x = -1; x <= 1; ++x)
-    {
-        for(int y = -1; y <= 1; ++y)
-        {
-            if(x == 0 && y == 0)
-            {
-                continue;
-            }
-
-            QPoint coord = wrap(loc + QPoint(x, y));
-            if(gen[coord.y()][coord.x()])
-            {
-                count++;
-            }
-        }
-    }
-
-    return count;
-}
-
-QPoint GameOfLife::wrap(QPoint loc)
-{
-    if(loc.x() < 0)
-    {
-        loc.setX(loc.x() + WIDTH);
-    }
-
-    if(loc.y() < 0)
-    {
-        loc.setY(loc.y() + HEIGHT);
-    }
-
-    return QPoint(loc.x() % WIDTH, loc.y() % HEIGHT);
-}
\ No newline at end of file
@@ -10,28 +10,43 @@
 
 #include "scene/importednode.h"
 #include "graph/geometry.h"
+#include "lifegrid.h"
 
 #include <memory>
-#include <array>
 
-#include <QPoint>
+#include <QVector>
+#include <QSize>
+
+class Statistic;
 
 class GameOfLife : public Engine::Ui::FreeLookScene
 {
 public:
-    enum { WIDTH = 512, HEIGHT = 128 };
+    enum { DEFAULT_WIDTH = 512, DEFAULT_HEIGHT = 128 };
 
     explicit GameOfLife(Engine::ResourceDespatcher& despatcher);
     ~GameOfLife();
 
     // Reimplemented methods from FreeLookScene
     virtual void update(unsigned int elapsed);
+    virtual void setStatistics(FrameStatistics* statistics);
+
+    // Seeds the population of new scenes. Zero seeds from the current time.
+    static void setRandomSeed(unsigned int seed);
+
+    // Sets the grid size of new scenes. The width is rounded up to a multiple of 64.
+    static void setGridSize(const QSize& size);
 
 protected:
     // Implemented methods from FreeLookScene
     virtual void initialise();
 
 private:
+    enum { MATERIAL_COUNT = 256 };
+
+    static unsigned int randomSeed_;
+    static QSize gridSize_;
+
     unsigned int generationNum_;
     unsigned int totalElapsed_;
     bool autoAdvance_;
@@ -44,26 +59,19 @@ private:
         Engine::Graph::Geometry::Ptr leaf;
     };
 
-    typedef std::array<Population, WIDTH> RowType;
-    typedef std::array<RowType, HEIGHT> SpaceType;
-
-    SpaceType space_;
-
-    typedef std::array<bool, WIDTH> GenRowType;
-    typedef std::array<GenRowType, HEIGHT> GenerationType;
-
-    GenerationType currentGen_;
-    GenerationType nextGen_;
-
-    unsigned int countNeighbours(const GenerationType& gen, const QPoint& loc);
+    // Cells in row order
+    QVector<Population> space_;
+    LifeGrid grid_;
 
-    QPoint wrap(QPoint loc);
+    Statistic* generationStat_;
+    Statistic* generationRateStat_;
+    Statistic* sceneUpdateStat_;
 
-    // Sets and displays tile
-    void setGeneration(GenerationType& gen, int x, int y, bool alive);
+    // Displays or hides the cell
+    void setPopulation(int x, int y, bool alive);
 
     void nextGeneration();
     void randomSeed();
 };
 
-#endif // GAMEOFLIFE_H
\ No newline at end of file
+#endif // GAMEOFLIFE_H
@@ -0,0 +1,168 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "lifegrid.h"
+
+#include <QRunnable>
+#include <QThread>
+
+namespace {
+    // Bands smaller than this are stepped faster than a task is started
+    const int MIN_BAND_WORDS = 4096;
+
+    int bitCount(quint64 word);
+}
+
+class LifeGrid::BandTask : public QRunnable
+{
+public:
+    BandTask(LifeGrid& grid, int first, int last, int& flipped)
+        : grid_(grid), first_(first), last_(last), flipped_(flipped) {}
+
+    virtual void run()
+    {
+        flipped_ = grid_.stepRows(first_, last_);
+    }
+
+private:
+    LifeGrid& grid_;
+    int first_;
+    int last_;
+    int& flipped_;
+};
+
+LifeGrid::LifeGrid(int width, int height)
+    : width_(width), height_(height), words_(width / CELLS_PER_WORD)
+{
+    current_.fill(0, words_ * height_);
+    next_.fill(0, words_ * height_);
+    changes_.fill(0, words_ * height_);
+
+    // The calling thread steps the first band
+    threadPool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+LifeGrid::~LifeGrid()
+{
+    threadPool_.waitForDone();
+}
+
+int LifeGrid::width() const
+{
+    return width_;
+}
+
+int LifeGrid::height() const
+{
+    return height_;
+}
+
+bool LifeGrid::cell(int x, int y) const
+{
+    const quint64 word = current_[y * words_ + x / CELLS_PER_WORD];
+    return ((word >> (x % CELLS_PER_WORD)) & 1) != 0;
+}
+
+void LifeGrid::setCell(int x, int y, bool alive)
+{
+    quint64& word = current_[y * words_ + x / CELLS_PER_WORD];
+    const quint64 mask = 1ull << (x % CELLS_PER_WORD);
+
+    word = alive ? word | mask : word & ~mask;
+}
+
+int LifeGrid::step()
+{
+    const int bands = qBound(1, words_ * height_ / MIN_BAND_WORDS, threadPool_.maxThreadCount() + 1);
+    const int rows = (height_ + bands - 1) / bands;
+
+    QVector<int> flipped(bands, 0);
+
+    for(int band = 1; band < bands; ++band)
+    {
+        threadPool_.start(new BandTask(*this, band * rows, qMin(height_, (band + 1) * rows), flipped[band]));
+    }
+
+    flipped[0] = stepRows(0, qMin(height_, rows));
+    threadPool_.waitForDone();
+
+    current_.swap(next_);
+
+    int count = 0;
+    for(int value : flipped)
+    {
+        count += value;
+    }
+
+    return count;
+}
+
+int LifeGrid::stepRows(int first, int last)
+{
+    const quint64* cells = current_.constData();
+    quint64* next = next_.data();
+    quint64* changes = changes_.data();
+
+    int flipped = 0;
+
+    for(int y = first; y < last; ++y)
+    {
+        const quint64* above = cells + ((y + height_ - 1) % height_) * words_;
+        const quint64* row = cells + y * words_;
+        const quint64* below = cells + ((y + 1) % height_) * words_;
+
+        for(int w = 0; w < words_; ++w)
+        {
+            const int west = w > 0 ? w - 1 : words_ - 1;
+            const int east = w + 1 < words_ ? w + 1 : 0;
+
+            // Bit n of each word holds a neighbour of the cell at bit n
+            const quint64 neighbours[8] = {
+                (above[w] << 1) | (above[west] >> 63), above[w], (above[w] >> 1) | (above[east] << 63),
+                (row[w] << 1) | (row[west] >> 63), (row[w] >> 1) | (row[east] << 63),
+                (below[w] << 1) | (below[west] >> 63), below[w], (below[w] >> 1) | (below[east] << 63)
+            };
+
+            // Counts the neighbours of all 64 cells at once: the first two bits of the count,
+            // and whether it has reached four
+            quint64 ones = 0;
+            quint64 twos = 0;
+            quint64 fours = 0;
+
+            for(quint64 neighbour : neighbours)
+            {
+                const quint64 carry = ones & neighbour;
+                ones ^= neighbour;
+                fours |= twos & carry;
+                twos ^= carry;
+            }
+
+            // Born with three neighbours, survives with two or three
+            const quint64 alive = ~fours & twos & (ones | row[w]);
+            const quint64 changed = alive ^ row[w];
+
+            next[y * words_ + w] = alive;
+            changes[y * words_ + w] = changed;
+
+            if(changed != 0)
+            {
+                flipped += bitCount(changed);
+            }
+        }
+    }
+
+    return flipped;
+}
+
+namespace {
+    int bitCount(quint64 word)
+    {
+        word = word - ((word >> 1) & 0x5555555555555555ull);
+        word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+        word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+
+        return static_cast<int>((word * 0x0101010101010101ull) >> 56);
+    }
+}
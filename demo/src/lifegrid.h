@@ -0,0 +1,66 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : LifeGrid advances a toroidal Game of Life grid. Cells are packed 64 to a word and
+//             the neighbours of a whole word are counted at once with bitwise adders. Large grids
+//             are split into row bands which are stepped on a thread pool. The cells flipped by
+//             the last step are kept, so the scene only has to update those.
+//
+
+#ifndef LIFEGRID_H
+#define LIFEGRID_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QThreadPool>
+
+class LifeGrid
+{
+public:
+    enum { CELLS_PER_WORD = 64 };
+
+    // precondition: width is a multiple of CELLS_PER_WORD, height > 0
+    LifeGrid(int width, int height);
+    ~LifeGrid();
+
+    int width() const;
+    int height() const;
+
+    bool cell(int x, int y) const;
+
+    // Doesn't mark the cell as changed.
+    void setCell(int x, int y, bool alive);
+
+    // Computes the next generation and returns the number of flipped cells.
+    int step();
+
+    // Calls visitor(x, y, alive) for every cell flipped by the last step.
+    template<typename Visitor>
+    void forEachChange(Visitor visitor) const;
+
+private:
+    class BandTask;
+
+    int width_;
+    int height_;
+    int words_;     // Words per row
+
+    QVector<quint64> current_;
+    QVector<quint64> next_;
+    QVector<quint64> changes_;
+
+    QThreadPool threadPool_;
+
+    // Steps rows [first, last) from current_ to next_ and returns the number of flipped cells.
+    int stepRows(int first, int last);
+
+    // Returns the index of the lowest set bit.
+    // precondition: word != 0
+    static int lowestBit(quint64 word);
+
+    LifeGrid(const LifeGrid&);
+    LifeGrid& operator=(const LifeGrid&);
+};
+
+#include "lifegrid.inl"
+
+#endif // LIFEGRID_H
@@ -0,0 +1,50 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+inline int LifeGrid::lowestBit(quint64 word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#elif defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int index = 0;
+    while((word & 1) == 0)
+    {
+        word >>= 1;
+        ++index;
+    }
+
+    return index;
+#endif
+}
+
+template<typename Visitor>
+void LifeGrid::forEachChange(Visitor visitor) const
+{
+    const quint64* changes = changes_.constData();
+    const quint64* cells = current_.constData();
+
+    for(int y = 0; y < height_; ++y)
+    {
+        for(int w = 0; w < words_; ++w)
+        {
+            const int index = y * words_ + w;
+
+            // Most words are unchanged in a settled population
+            for(quint64 word = changes[index]; word != 0; word &= word - 1)
+            {
+                const int bit = lowestBit(word);
+                visitor(w * CELLS_PER_WORD + bit, y, ((cells[index] >> bit) & 1) != 0);
+            }
+        }
+    }
+}
@@ -6,11 +6,13 @@
 #include <QGuiApplication>
 #include <QSurfaceFormat>
 #include <QScreen>
+#include <QFile>
 
 #include "sceneview.h"
 #include "qmlapplication.h"
 #include "uicontroller.h"
 #include "scenefactory.h"
+#include "assetfile.h"
 
 // Demo scenes
 #include "basicscene.h"
@@ -22,6 +24,12 @@ int main(int argc, char *argv[])
 {
     QGuiApplication app(argc, argv);
 
+    // Packed assets take precedence over the asset directory
+    if(QFile::exists("assets.pak"))
+    {
+        Engine::AssetFile::mount("assets.pak");
+    }
+
     // Create OpenGL context
     QSurfaceFormat format;
     format.setVersion(4, 2);
@@ -204,13 +204,20 @@ Graph::Light::Ptr SponzaScene::insertLight(Engine::Graph::SceneNode* node)
 void SponzaScene::addProjectile(Projectile&& projectile, const QVector3D& initialPosition)
 {
     projectile.light->parentNode()->setPosition(initialPosition);
-    projectile.object = Graph::Geometry::clone(sphere_->findLeaf<Graph::Geometry>("Sphere"));
 
-    Graph::SceneNode* leaf = projectile.light->parentNode()->createChild();
-    leaf->scale(0.1f);
+    // Shares the light's node, the instance is scaled instead of adding a child node
+    Prefab::Ptr prefab = sphere_->prefab();
+    if(prefab != nullptr)
+    {
+        QMatrix4x4 scale;
+        scale.scale(0.1f);
+
+        projectile.object = std::make_shared<Graph::PrefabInstance>(prefab);
+        projectile.object->setTransformation(scale);
+        projectile.object->attach(projectile.light->parentNode());
 
-    scene().addSceneLeaf(projectile.object);
-    projectile.object->attach(leaf);
+        scene().addSceneLeaf(projectile.object);
+    }
 
     projectiles_.push_back(projectile);
 }
@@ -10,6 +10,7 @@
 
 #include "scene/importednode.h"
 #include "graph/geometry.h"
+#include "graph/prefabinstance.h"
 
 namespace Engine {
     class ResourceDespatcher;
@@ -41,7 +42,7 @@ private:
         float velocity;
         QVector3D direction;
         Engine::Graph::Light::Ptr light;
-        Engine::Graph::Geometry::Ptr object;
+        Engine::Graph::PrefabInstance::Ptr object;
     };
 
     Engine::ImportedNode::Ptr sceneMesh_;
@@ -15,6 +15,8 @@
 #define SHADOWMAP_DIR_SIZE 2048
 #define SHADOWMAP_SIZE 1024
 
+#include "materialsampler.frag"
+
 in vec2 texCoord0;
 in vec3 normal0;
 in vec3 tangent0;
@@ -73,11 +75,17 @@ uniform DirectionalLight gDirectionalLight;
 uniform PointLight gPointLights[MAX_POINT_LIGHTS];
 uniform SpotLight gSpotLights[MAX_SPOT_LIGHTS];
 
-uniform sampler2D gDiffuseSampler;
-uniform sampler2D gNormalSampler;
-uniform sampler2D gSpecularSampler;
-uniform sampler2D gMaskSampler;
-uniform sampler2D gShininessSampler;
+uniform MaterialSampler gDiffuseSampler;
+uniform MaterialSampler gNormalSampler;
+uniform MaterialSampler gSpecularSampler;
+uniform MaterialSampler gMaskSampler;
+uniform MaterialSampler gShininessSampler;
+
+uniform float gDiffuseLayer;
+uniform float gNormalLayer;
+uniform float gSpecularLayer;
+uniform float gMaskLayer;
+uniform float gShininessLayer;
 
 uniform sampler2DShadow gSpotLightShadowMap[MAX_SPOT_LIGHTS];
 uniform sampler2DShadow gDirectionalLightShadowMap;
@@ -136,8 +144,8 @@ vec4 calcLightCommon(in Light light, in vec3 lightDirection, in vec3 normal)
         vec3 v = normalize(gEyeWorldPos - worldPos0);
         vec3 h = normalize(v + l);
 
-		float shininess = max(gMaterial.shininess * texture(gShininessSampler, texCoord0).r, 0.0001);
-		float factor = texture(gSpecularSampler, texCoord0).r * gMaterial.specularIntensity;
+		float shininess = max(gMaterial.shininess * sampleMaterial(gShininessSampler, gShininessLayer, texCoord0).r, 0.0001);
+		float factor = sampleMaterial(gSpecularSampler, gSpecularLayer, texCoord0).r * gMaterial.specularIntensity;
 
         // Cosine power normalisation factor
         float d = (shininess + 2) / 8;
@@ -212,7 +220,7 @@ vec3 calcBumpedNormal()
     tangent = normalize(tangent - dot(tangent, normal) * normal);
     
     vec3 bitangent = cross(tangent, normal);
-    vec3 bumpMapNormal = texture(gNormalSampler, texCoord0).xyz;
+    vec3 bumpMapNormal = sampleMaterial(gNormalSampler, gNormalLayer, texCoord0).xyz;
 
     // Since color components are stored in the range [0, 1], we have to transform
     // them back using f(x) = 2*x - 1
@@ -227,7 +235,7 @@ vec3 calcBumpedNormal()
 void main()
 {
     // Check if this part of the fragment is visible according to mask
-    if(texture(gMaskSampler, texCoord0).r <= 0.2)
+    if(sampleMaterial(gMaskSampler, gMaskLayer, texCoord0).r <= 0.2)
         discard;
 
     // We have to normalize our normal (again) since the fragment shader does interpolation between vertices
@@ -246,6 +254,6 @@ void main()
         light += shadow * calcSpotLight(gSpotLights[i], normal);
     }
     
-    fragColor = texture(gDiffuseSampler, texCoord0) * light *
+    fragColor = sampleMaterial(gDiffuseSampler, gDiffuseLayer, texCoord0) * light *
                 vec4(gMaterial.diffuseColor, 1.0) + vec4(gMaterial.ambientColor, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Highpass filter and the first downsample of the dual filter bloom chain.
+//
+
+#version 420
+
+uniform sampler2DMS renderedTexture;
+
+uniform float threshold;
+uniform float renderScale;  // Portion of the input containing the rendered image
+
+in vec2 uv;
+
+out vec4 fragColor;
+
+void main()
+{
+    ivec2 size = ivec2(textureSize(renderedTexture) * renderScale);
+    ivec2 st = ivec2(size * uv);
+
+    // Spread four fetches over the source footprint of the output texel
+    vec3 color = vec3(0.0);
+    color += texelFetch(renderedTexture, clamp(st + ivec2(-1, -1), ivec2(0), size - 1), 0).rgb;
+    color += texelFetch(renderedTexture, clamp(st + ivec2( 1, -1), ivec2(0), size - 1), 0).rgb;
+    color += texelFetch(renderedTexture, clamp(st + ivec2(-1,  1), ivec2(0), size - 1), 0).rgb;
+    color += texelFetch(renderedTexture, clamp(st + ivec2( 1,  1), ivec2(0), size - 1), 0).rgb;
+    color *= 0.25;
+
+    vec3 brightColor = max(color - vec3(threshold), vec3(0.0));
+    float bright = dot(brightColor, vec3(1.0));
+    bright = smoothstep(0.0, 0.5, bright);
+
+    fragColor.rgb = mix(vec3(0.0), color, bright);
+}
\ No newline at end of file
@@ -2,8 +2,25 @@
 //  Author   : Matti Määttä
 //  Type     : Fragment shader
 //  Summary  : Deferred shading material shader for implementing different lightning models.
+//             The shader is compiled either as a generic program which selects the light pass
+//             using subroutines, or as a permutation specialised to a single light pass.
 //
 
+#version 420
+
+// Light pass permutation. LIGHT_TYPE matches Graph::Light::LightType, or is negative
+// for the generic program. SHADOW enables shadow mapping for spot and point lights.
+#define LIGHT_TYPE <>
+#define SHADOW <>
+
+#define LIGHT_POINT 0
+#define LIGHT_SPOT 1
+#define LIGHT_DIRECTIONAL 2
+
+#if LIGHT_TYPE >= 0
+#define STATIC_OUTPUT
+#endif
+
 #include "dsmaterial.frag"
 
 struct Light
@@ -28,12 +45,24 @@ struct Light
 
 uniform Light light;
 
-uniform mat4 lightVP;
+#if LIGHT_TYPE < 0 || SHADOW
 uniform mat4 viewInverse;
+#endif
+
+#if LIGHT_TYPE < 0 || (LIGHT_TYPE == LIGHT_SPOT && SHADOW)
+uniform mat4 lightVP;
 uniform vec2 shadowOffset;
 uniform sampler2DShadow shadowSampler;
+#endif
+
+#if LIGHT_TYPE < 0 || (LIGHT_TYPE == LIGHT_POINT && SHADOW)
+// Depth terms of the cube face projection: (P[2][2], P[3][2])
+uniform vec2 cubeProjection;
+uniform samplerCubeShadow shadowCubeSampler;
+#endif
 
 #define SHADOW_BIAS 0.0002
+#define CUBE_SHADOW_BIAS 0.0005
 
 vec3 lightningModel(in vec3 lightToFragment, in VertexInfo vertex, in MaterialInfo material)
 {
@@ -72,6 +101,7 @@ vec3 lightningModel(in vec3 lightToFragment, in VertexInfo vertex, in MaterialIn
     return diffuse + specular;
 }
 
+#if LIGHT_TYPE < 0 || (LIGHT_TYPE == LIGHT_SPOT && SHADOW)
 float softShadowModel(in vec4 lightSpacePos, in sampler2DShadow shadowMap, in vec2 offset)
 {
     // Project shadow map on current fragment
@@ -94,8 +124,25 @@ float softShadowModel(in vec4 lightSpacePos, in sampler2DShadow shadowMap, in ve
 
     return factor / 9.0;
 }
+#endif
 
-subroutine(CalculateOutputType)
+#if LIGHT_TYPE < 0 || (LIGHT_TYPE == LIGHT_POINT && SHADOW)
+float cubeShadowModel(in vec3 lightToFragment, in samplerCubeShadow shadowMap)
+{
+    // The face is selected by the major axis, so the fragment's depth in that face
+    // only depends on the distance along it.
+    vec3 axisDistance = abs(lightToFragment);
+    float z = max(axisDistance.x, max(axisDistance.y, axisDistance.z));
+
+    float depth = -cubeProjection.x + cubeProjection.y / z;
+    depth = 0.5 * depth + 0.5;
+
+    // Linear filtering compares the 2x2 nearest texels
+    return texture(shadowMap, vec4(lightToFragment, depth - CUBE_SHADOW_BIAS));
+}
+#endif
+
+OUTPUT_SUBROUTINE
 vec4 pointLightPass(in VertexInfo vertex, in MaterialInfo material)
 {
     // Light ray to fragment
@@ -112,7 +159,7 @@ vec4 pointLightPass(in VertexInfo vertex, in MaterialInfo material)
     return vec4(material.diffuse * color / attenuation, 1.0);
 }
 
-subroutine(CalculateOutputType)
+OUTPUT_SUBROUTINE
 vec4 spotLightPass(in VertexInfo vertex, in MaterialInfo material)
 {
     vec3 lightToFragment = normalize(light.position - vertex.position.xyz);
@@ -126,7 +173,20 @@ vec4 spotLightPass(in VertexInfo vertex, in MaterialInfo material)
     return vec4(material.diffuse * color, 1.0);
 }
 
-subroutine(CalculateOutputType)
+#if LIGHT_TYPE < 0 || (LIGHT_TYPE == LIGHT_POINT && SHADOW)
+OUTPUT_SUBROUTINE
+vec4 pointLightPassShadow(in VertexInfo vertex, in MaterialInfo material)
+{
+    // Cubemap is indexed by the world space direction from the light
+    vec3 lightToFragment = mat3(viewInverse) * (vertex.position.xyz - light.position);
+    float shadow = cubeShadowModel(lightToFragment, shadowCubeSampler);
+
+    return vec4(pointLightPass(vertex, material).rgb * shadow, 1.0);
+}
+#endif
+
+#if LIGHT_TYPE < 0 || (LIGHT_TYPE == LIGHT_SPOT && SHADOW)
+OUTPUT_SUBROUTINE
 vec4 spotLightPassShadow(in VertexInfo vertex, in MaterialInfo material)
 {
 	// Transform fragment position to light space
@@ -135,12 +195,40 @@ vec4 spotLightPassShadow(in VertexInfo vertex, in MaterialInfo material)
 
 	return vec4(spotLightPass(vertex, material).rgb * shadow, 1.0);
 }
+#endif
 
-subroutine(CalculateOutputType)
+OUTPUT_SUBROUTINE
 vec4 directionalLightPass(in VertexInfo vertex, in MaterialInfo material)
 {
     vec3 ambient = light.color * light.ambientIntensity;
     vec3 color = lightningModel(-light.direction, vertex, material) + ambient;
 
     return vec4(material.diffuse * color, 1.0);
-}
\ No newline at end of file
+}
+
+#if LIGHT_TYPE == LIGHT_POINT && SHADOW
+vec4 calculateOutput(in VertexInfo vertex, in MaterialInfo material)
+{
+    return pointLightPassShadow(vertex, material);
+}
+#elif LIGHT_TYPE == LIGHT_POINT
+vec4 calculateOutput(in VertexInfo vertex, in MaterialInfo material)
+{
+    return pointLightPass(vertex, material);
+}
+#elif LIGHT_TYPE == LIGHT_SPOT && SHADOW
+vec4 calculateOutput(in VertexInfo vertex, in MaterialInfo material)
+{
+    return spotLightPassShadow(vertex, material);
+}
+#elif LIGHT_TYPE == LIGHT_SPOT
+vec4 calculateOutput(in VertexInfo vertex, in MaterialInfo material)
+{
+    return spotLightPass(vertex, material);
+}
+#elif LIGHT_TYPE == LIGHT_DIRECTIONAL
+vec4 calculateOutput(in VertexInfo vertex, in MaterialInfo material)
+{
+    return directionalLightPass(vertex, material);
+}
+#endif
\ No newline at end of file
@@ -7,6 +7,11 @@
 
 #version 420
 
+// Light pass permutation, see dsillumination.frag
+#define LIGHT_TYPE <>
+
+#define LIGHT_DIRECTIONAL 2
+
 layout(location = 0) in vec3 vertexPosition;
 
 uniform float quadScale;
@@ -16,11 +21,17 @@ uniform vec3 cameraRight;
 uniform vec3 cameraUp;
 uniform mat4 viewProj;
 
+#if LIGHT_TYPE < 0
 // Subroutine used to change between fullscreen and screen-oriented quads.
 subroutine void TransformQuadType();
 subroutine uniform TransformQuadType transformQuad;
 
-subroutine(TransformQuadType)
+#define QUAD_SUBROUTINE subroutine(TransformQuadType)
+#else
+#define QUAD_SUBROUTINE
+#endif
+
+QUAD_SUBROUTINE
 void screenOrientedQuad()
 {
     vec3 position = quadCenter
@@ -30,7 +41,7 @@ void screenOrientedQuad()
     gl_Position = viewProj * vec4(position, 1);
 }
 
-subroutine(TransformQuadType)
+QUAD_SUBROUTINE
 void fullscreenQuad()
 {
     gl_Position = vec4(vertexPosition, 1.0);
@@ -38,5 +49,11 @@ void fullscreenQuad()
 
 void main()
 {
+#if LIGHT_TYPE < 0
     transformQuad();
+#elif LIGHT_TYPE == LIGHT_DIRECTIONAL
+    fullscreenQuad();
+#else
+    screenOrientedQuad();
+#endif
 }
\ No newline at end of file
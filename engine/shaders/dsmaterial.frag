@@ -2,10 +2,10 @@
 //  Author   : Matti Määttä
 //  Type     : Fragment shader
 //  Summary  : GBuffer unpack material shader
+//             Including shaders must declare the GLSL version. If STATIC_OUTPUT is defined,
+//             the including shader implements calculateOutput directly instead of the subroutine.
 //
 
-#version 420
-
 #define SAMPLES <>
 
 // R32F        -> Depth attachment
@@ -26,6 +26,9 @@ uniform vec4 viewport;
 // Depth range: far - near
 uniform float depthScale;
 
+// Shade every sample instead of the first. Set for pixels classified as edges.
+uniform bool perSample = true;
+
 // Output fragment color
 layout (location = 0) out vec4 fragColor;
 
@@ -44,14 +47,17 @@ struct MaterialInfo
     float specular;
 };
 
+#ifdef STATIC_OUTPUT
+vec4 calculateOutput(in VertexInfo vertex, in MaterialInfo material);
+
+#define OUTPUT_SUBROUTINE
+#else
 // Subroutine used to implement different shading functions
 subroutine vec4 CalculateOutputType(in VertexInfo vertex, in MaterialInfo material);
 subroutine uniform CalculateOutputType calculateOutput;
 
-vec2 calcTexCoord()
-{
-    return (gl_FragCoord.xy - viewport.xy) / viewport.zw;
-}
+#define OUTPUT_SUBROUTINE subroutine(CalculateOutputType)
+#endif
 
 void unpackPosition(inout VertexInfo vertex, float z)
 {
@@ -104,19 +110,6 @@ float getSample(inout VertexInfo vertex, inout MaterialInfo material, in ivec2 s
     return z;
 }
 
-bool testEdgeVertex(in ivec2 st)
-{
-    for(int i = 1; i < SAMPLES; ++i)
-    {
-        if(texelFetch(normalSpecData, st, i).a > 0.0)
-        {
-            return true;
-        }
-    }
-
-    return false;
-}
-
 vec4 calcAverageOutput(in VertexInfo vertex, in MaterialInfo material, float z)
 {
     if(gl_FragCoord.z > z)
@@ -132,15 +125,16 @@ void main()
     VertexInfo vertex;
     MaterialInfo material;
 
-    ivec2 st = ivec2(calcTexCoord() * textureSize(depthData));
+    // Gbuffer is rendered from the origin; the viewport may cover only part of it
+    ivec2 st = ivec2(gl_FragCoord.xy);
     vec4 color = vec4(0.0);
 
     float z = getSample(vertex, material, st, 0);
     color += calcAverageOutput(vertex, material, z);
 
 #if SAMPLES > 1
-    // Calculate average output for vertex edge samples to resolve MSAA
-    if(vertex.edge > 0.0 || testEdgeVertex(st))
+    // Calculate average output for edge samples to resolve MSAA
+    if(perSample)
     {
         // Average sample
         for(int i = 1; i < SAMPLES; ++i)
@@ -4,6 +4,8 @@
 //  Summary  : Material shader for debugging gbuffer values
 //
 
+#version 420
+
 #include "dsmaterial.frag"
 
 subroutine(CalculateOutputType)
@@ -0,0 +1,69 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Calculates the percentile-clipped average luminance from the histogram and
+//             adapts the stored exposure towards it. Rendered as a single fragment.
+//
+
+#version 420
+
+#define BINS <>
+
+const float MIN_LOG_LUMINANCE = -10.0;
+const float LOG_LUMINANCE_RANGE = 14.0;
+const float KEY_VALUE = 0.18;           // Middle gray
+const float MIN_EXPOSURE = 0.05;
+const float MAX_EXPOSURE = 16.0;
+
+layout(r32ui, binding = 0) uniform uimage1D histogram;
+layout(r32f, binding = 1) uniform image2D exposureImage;
+
+uniform float lowPercentile;
+uniform float highPercentile;
+uniform float adaptation;       // Blend factor towards the target exposure
+
+out vec4 fragColor;
+
+void main()
+{
+    uint counts[BINS];
+    uint total = 0u;
+
+    // Consume and clear the bins for the next frame
+    for(int i = 0; i < BINS; ++i)
+    {
+        counts[i] = imageLoad(histogram, i).r;
+        total += counts[i];
+
+        imageStore(histogram, i, uvec4(0u));
+    }
+
+    float low = float(total) * lowPercentile;
+    float high = float(total) * highPercentile;
+
+    float start = 0.0;
+    float weight = 0.0;
+    float sum = 0.0;
+
+    for(int i = 0; i < BINS; ++i)
+    {
+        float end = start + float(counts[i]);
+
+        // Portion of the bin inside the percentile range
+        float clipped = max(0.0, min(end, high) - max(start, low));
+        float binLuminance = MIN_LOG_LUMINANCE + (float(i) + 0.5) / BINS * LOG_LUMINANCE_RANGE;
+
+        sum += clipped * binLuminance;
+        weight += clipped;
+        start = end;
+    }
+
+    float average = weight > 0.0 ? exp2(sum / weight) : KEY_VALUE;
+    float target = clamp(KEY_VALUE / average, MIN_EXPOSURE, MAX_EXPOSURE);
+
+    float previous = imageLoad(exposureImage, ivec2(0)).r;
+    float exposure = previous > 0.0 ? mix(previous, target, adaptation) : target;
+
+    imageStore(exposureImage, ivec2(0), vec4(exposure));
+    fragColor = vec4(0.0);
+}
\ No newline at end of file
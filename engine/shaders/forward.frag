@@ -6,6 +6,10 @@
 
 #version 420
 
+#define SAMPLES <>
+
+#include "materialsampler.frag"
+
 layout(location = 0) out vec4 fragColor;
 
 in vec2 texCoord0;
@@ -16,26 +20,50 @@ struct Material
     vec3 diffuse;
     float alpha;
     
-    sampler2D diffuseSampler;
-    sampler2D maskSampler;
+    MaterialSampler diffuseSampler;
+    MaterialSampler maskSampler;
+
+    float diffuseLayer;
+    float maskLayer;
 };
 
 uniform Material material;
 uniform sampler2DMS depth;
 
+// Test every depth sample instead of the first. Set for pixels classified as edges.
+uniform bool perSample = true;
+
+// Fraction of the depth samples in front of which the fragment lies
+float coverage(in ivec2 st)
+{
+    int samples = perSample ? SAMPLES : 1;
+    float visible = 0.0;
+
+    for(int i = 0; i < samples; ++i)
+    {
+        if(gl_FragCoord.z <= texelFetch(depth, st, i).x)
+        {
+            visible += 1.0;
+        }
+    }
+
+    return visible / samples;
+}
+
 void main()
 {
     // Check if this part of the fragment is opaque according to mask
-    if(texture(material.maskSampler, texCoord0).r <= 0.2)
+    if(sampleMaterial(material.maskSampler, material.maskLayer, texCoord0).r <= 0.2)
         discard;
 
     ivec2 st = ivec2(gl_FragCoord.xy);
 
-    // Discard occluded fragments
-    if(gl_FragCoord.z > texelFetch(depth, st, 0).x)
+    // Discard occluded fragments; partially covered edges are blended by their visibility
+    float visible = coverage(st);
+    if(visible == 0.0)
         discard;
 
-    fragColor.rgb = texture(material.diffuseSampler, texCoord0).rgb * material.diffuse
+    fragColor.rgb = sampleMaterial(material.diffuseSampler, material.diffuseLayer, texCoord0).rgb * material.diffuse
                         + material.ambient;
-    fragColor.a = material.alpha;
+    fragColor.a = material.alpha * visible;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 
 #define SAMPLES <>
 
+#include "materialsampler.frag"
+
 in vec2 texCoord0;
 in vec3 normal0;
 in mat3 TBN;
@@ -29,11 +31,18 @@ struct Material
     float specular;
 
     // Material samplers
-    sampler2D diffuseSampler;
-    sampler2D normalSampler;
-    sampler2D specularSampler;
-    sampler2D maskSampler;
-    sampler2D shininessSampler;
+    MaterialSampler diffuseSampler;
+    MaterialSampler normalSampler;
+    MaterialSampler specularSampler;
+    MaterialSampler maskSampler;
+    MaterialSampler shininessSampler;
+
+    // Texture array layers
+    float diffuseLayer;
+    float normalLayer;
+    float specularLayer;
+    float maskLayer;
+    float shininessLayer;
 };
 
 uniform Material material;
@@ -52,7 +61,7 @@ vec3 calculateBumpedNormal()
 {
     // Since color components are stored in the range [0, 1], we have to transform
     // them back using f(x) = 2*x - 1
-    vec3 bumpMapNormal = texture(material.normalSampler, texCoord0).xyz;
+    vec3 bumpMapNormal = sampleMaterial(material.normalSampler, material.normalLayer, texCoord0).xyz;
     bumpMapNormal = 2.0 * bumpMapNormal - 1.0;
 
     vec3 newNormal = TBN * bumpMapNormal;
@@ -68,7 +77,7 @@ void packNormalSpecData()
     float p = sqrt(normal.z * 8 + 8);
     normalSpecData.rg = normal.xy / p + 0.5;
 
-    normalSpecData.b = texture(material.shininessSampler, texCoord0).r * material.shininess / 1000.0;
+    normalSpecData.b = sampleMaterial(material.shininessSampler, material.shininessLayer, texCoord0).r * material.shininess / 1000.0;
 
 #if SAMPLES > 1
     // Write potential vertex edges to output.
@@ -81,14 +90,14 @@ void packNormalSpecData()
 
 void packDiffuseSpecData()
 {
-    diffuseSpecData.rgb = texture(material.diffuseSampler, texCoord0).rgb * material.diffuse;
-    diffuseSpecData.a = texture(material.specularSampler, texCoord0).r * material.specular / 10.0;
+    diffuseSpecData.rgb = sampleMaterial(material.diffuseSampler, material.diffuseLayer, texCoord0).rgb * material.diffuse;
+    diffuseSpecData.a = sampleMaterial(material.specularSampler, material.specularLayer, texCoord0).r * material.specular / 10.0;
 }
 
 void main()
 {
     // Check if this part of the fragment is opaque according to mask
-    if(texture(material.maskSampler, texCoord0).r <= 0.2)
+    if(sampleMaterial(material.maskSampler, material.maskLayer, texCoord0).r <= 0.2)
         discard;
 
     packNormalSpecData();
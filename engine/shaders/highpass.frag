@@ -9,6 +9,7 @@
 uniform sampler2DMS renderedTexture;
 
 uniform float threshold;
+uniform float renderScale;  // Portion of the input containing the rendered image
 
 in vec2 uv;
 
@@ -16,7 +17,7 @@ out vec4 fragColor;
 
 void main()
 {
-    vec3 color = texelFetch(renderedTexture, ivec2(textureSize(renderedTexture) * uv), 0).rgb;
+    vec3 color = texelFetch(renderedTexture, ivec2(textureSize(renderedTexture) * uv * renderScale), 0).rgb;
 
     vec3 brightColor = max(color - vec3(threshold), vec3(0.0));
     float bright = dot(brightColor, vec3(1.0));
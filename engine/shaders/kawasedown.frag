@@ -0,0 +1,28 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Dual filter downsample; five bilinear taps from the previous level.
+//
+
+#version 420
+
+uniform sampler2D inputTexture;
+uniform vec2 texelSize;     // Texel size of the sampled level
+uniform float lodLevel;
+
+in vec2 uv;
+
+out vec4 fragColor;
+
+void main()
+{
+    vec4 color = textureLod(inputTexture, uv, lodLevel) * 4.0;
+
+    // Corner taps land between four source texels
+    color += textureLod(inputTexture, uv + vec2(-texelSize.x, -texelSize.y), lodLevel);
+    color += textureLod(inputTexture, uv + vec2( texelSize.x, -texelSize.y), lodLevel);
+    color += textureLod(inputTexture, uv + vec2(-texelSize.x,  texelSize.y), lodLevel);
+    color += textureLod(inputTexture, uv + vec2( texelSize.x,  texelSize.y), lodLevel);
+
+    fragColor = color / 8.0;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Dual filter upsample; eight bilinear taps from the smaller level blended
+//             with the down chain level of the same size.
+//
+
+#version 420
+
+uniform sampler2D inputTexture;
+uniform sampler2D blendTexture;
+uniform vec2 texelSize;     // Texel size of the sampled level
+uniform float lodLevel;
+
+in vec2 uv;
+
+out vec4 fragColor;
+
+void main()
+{
+    vec2 h = texelSize * 0.5;
+
+    vec4 color = vec4(0.0);
+    color += textureLod(inputTexture, uv + vec2(-texelSize.x, 0.0), lodLevel);
+    color += textureLod(inputTexture, uv + vec2( texelSize.x, 0.0), lodLevel);
+    color += textureLod(inputTexture, uv + vec2(0.0, -texelSize.y), lodLevel);
+    color += textureLod(inputTexture, uv + vec2(0.0,  texelSize.y), lodLevel);
+
+    color += textureLod(inputTexture, uv + vec2(-h.x, -h.y), lodLevel) * 2.0;
+    color += textureLod(inputTexture, uv + vec2( h.x, -h.y), lodLevel) * 2.0;
+    color += textureLod(inputTexture, uv + vec2(-h.x,  h.y), lodLevel) * 2.0;
+    color += textureLod(inputTexture, uv + vec2( h.x,  h.y), lodLevel) * 2.0;
+
+    color /= 12.0;
+
+    // Blend levels evenly so that sharper levels keep their contribution
+    vec4 level = textureLod(blendTexture, uv, lodLevel - 1.0);
+    fragColor = (color + level) * 0.5;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Bins scene log-luminance into a histogram. Each fragment samples one
+//             pixel of its block; output is discarded.
+//
+
+#version 420
+
+#define BINS <>
+
+const float MIN_LOG_LUMINANCE = -10.0;
+const float LOG_LUMINANCE_RANGE = 14.0;
+
+uniform sampler2DMS sceneTexture;
+uniform float renderScale;  // Portion of the input containing the rendered image
+
+layout(r32ui, binding = 0) uniform uimage1D histogram;
+
+in vec2 uv;
+
+out vec4 fragColor;
+
+void main()
+{
+    vec2 size = textureSize(sceneTexture) * renderScale;
+    vec3 color = texelFetch(sceneTexture, ivec2(size * uv), 0).rgb;
+
+    float luminance = dot(color, vec3(0.2126, 0.7152, 0.0722));
+
+    // Black pixels fall to the first bin
+    int bin = 0;
+    if(luminance > 0.0)
+    {
+        float t = (log2(luminance) - MIN_LOG_LUMINANCE) / LOG_LUMINANCE_RANGE;
+        bin = clamp(int(t * BINS), 0, BINS - 1);
+    }
+
+    imageAtomicAdd(histogram, bin, 1u);
+    fragColor = vec4(0.0);
+}
\ No newline at end of file
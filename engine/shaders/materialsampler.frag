@@ -0,0 +1,23 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Material texture sampling. If TEXTURE_ARRAYS is defined, material textures are layers
+//             of texture array pages and the layer is passed alongside the sampler.
+//             Including shaders must declare the GLSL version.
+//
+
+#ifdef TEXTURE_ARRAYS
+#define MaterialSampler sampler2DArray
+
+vec4 sampleMaterial(sampler2DArray tex, float layer, vec2 uv)
+{
+    return texture(tex, vec3(uv, layer));
+}
+#else
+#define MaterialSampler sampler2D
+
+vec4 sampleMaterial(sampler2D tex, float layer, vec2 uv)
+{
+    return texture(tex, uv);
+}
+#endif
@@ -11,11 +11,14 @@
 
 uniform sampler2DMS inputTexture;
 uniform sampler2D bloomTexture;
+uniform sampler2D exposureTexture;  // Adapted on the GPU when gpuExposure is set
 
 uniform float bloomFactor;
 uniform float exposure;
+uniform bool gpuExposure;
 uniform float bright;   // Linear white point value
 uniform float gamma;
+uniform float renderScale;  // Portion of the input containing the rendered image
 
 in vec2 uv;
 
@@ -37,6 +40,7 @@ vec3 tonemap(in vec3 x)
 // Blend bloom samples
 vec3 calcBloomColor()
 {
+#if BLOOMLOD > 0
     vec3 color = vec3(0, 0, 0);
 
     // Skip first lod level to reduce aliasing
@@ -46,24 +50,55 @@ vec3 calcBloomColor()
     }
 
     return color / BLOOMLOD;
+#else
+    // Levels have already been blended by the bloom filter
+    return textureLod(bloomTexture, uv, 0).rgb;
+#endif
 }
 
-void main()
+vec3 resolveTexel(in ivec2 st)
 {
     vec3 color = vec3(0, 0, 0);
 
-    ivec2 st = ivec2(textureSize(inputTexture) * uv);
     for(int i = 0; i < SAMPLES; ++i)
     {
         color += texelFetch(inputTexture, st, i).rgb;
     }
 
-    color /= SAMPLES;
+    return color / SAMPLES;
+}
+
+// Upscales the rendered sub-rect bilinearly to the output
+vec3 sampleInput()
+{
+    if(renderScale >= 1.0)
+    {
+        return resolveTexel(ivec2(textureSize(inputTexture) * uv));
+    }
+
+    vec2 size = textureSize(inputTexture) * renderScale;
+    vec2 pos = uv * size - 0.5;
+
+    ivec2 st = ivec2(floor(pos));
+    ivec2 maxSt = ivec2(size) - 1;
+    vec2 f = pos - floor(pos);
+
+    vec3 a = resolveTexel(clamp(st, ivec2(0), maxSt));
+    vec3 b = resolveTexel(clamp(st + ivec2(1, 0), ivec2(0), maxSt));
+    vec3 c = resolveTexel(clamp(st + ivec2(0, 1), ivec2(0), maxSt));
+    vec3 d = resolveTexel(clamp(st + ivec2(1, 1), ivec2(0), maxSt));
+
+    return mix(mix(a, b, f.x), mix(c, d, f.x), f.y);
+}
+
+void main()
+{
+    vec3 color = sampleInput();
 
     // Add bloom
     color += calcBloomColor() * bloomFactor;
 
-    color *= exposure;
+    color *= gpuExposure ? texelFetch(exposureTexture, ivec2(0), 0).r : exposure;
 
     float expBias = 2.0f;
     vec3 current = tonemap(expBias * color.rgb);
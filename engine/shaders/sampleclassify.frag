@@ -0,0 +1,43 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Classifies multisampled gbuffer pixels. Pixels whose samples hold the same
+//             surface are discarded; the remaining edge pixels are marked in the stencil.
+//
+
+#version 420
+
+#define SAMPLES <>
+
+// R10G10B10A2 -> Normal.X, Normal.Y, Shininess, Edge
+uniform sampler2DMS normalSpecData;
+
+// R8G8B8A8    -> Diffuse.R, Diffuse.G, Diffuse.B, Specular intensity
+uniform sampler2DMS diffuseSpecData;
+
+// Attribute difference treated as a different surface
+#define EPSILON 0.01
+
+void main()
+{
+    ivec2 st = ivec2(gl_FragCoord.xy);
+
+    vec4 normalSpec = texelFetch(normalSpecData, st, 0);
+    vec4 diffuseSpec = texelFetch(diffuseSpecData, st, 0);
+
+    // Geometry pass flags pixels partially covered by a primitive
+    bool edge = normalSpec.a > 0.0;
+
+    for(int i = 1; i < SAMPLES && !edge; ++i)
+    {
+        vec4 normalDiff = abs(texelFetch(normalSpecData, st, i) - normalSpec);
+        vec4 diffuseDiff = abs(texelFetch(diffuseSpecData, st, i) - diffuseSpec);
+
+        edge = any(greaterThan(normalDiff, vec4(EPSILON))) || any(greaterThan(diffuseDiff, vec4(EPSILON)));
+    }
+
+    if(!edge)
+    {
+        discard;
+    }
+}
@@ -0,0 +1,28 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Vertex shader
+//  Summary  : Transforms the vertices to world space for the cube shadow map faces.
+//
+
+#version 420
+
+#define MAX_CASTER_INSTANCES <>
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec3 tangent;
+
+// Model matrix and the faces touched per instance
+uniform mat4 casterTransforms[MAX_CASTER_INSTANCES];
+uniform int casterLayers[MAX_CASTER_INSTANCES];
+
+out vec2 vsTexCoord;
+flat out int vsLayers;
+
+void main()
+{
+    vsTexCoord = texCoord;
+    vsLayers = casterLayers[gl_InstanceID];
+    gl_Position = casterTransforms[gl_InstanceID] * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+//
+//  Author   : Matti Määttä
+//  Type     : Fragment shader
+//  Summary  : Depth only output for shadow casters without an alpha mask.
+//
+
+#version 420
+
+void main()
+{
+}
\ No newline at end of file
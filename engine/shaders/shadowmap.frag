@@ -6,13 +6,16 @@
 
 #version 420
 
-uniform sampler2D maskSampler;
+#include "materialsampler.frag"
+
+uniform MaterialSampler maskSampler;
+uniform float maskLayer;
 
 in vec2 texCoord0;
 
 void main()
 {
-    if(texture(maskSampler, texCoord0).r <= 0.2)
+    if(sampleMaterial(maskSampler, maskLayer, texCoord0).r <= 0.2)
     {
         discard;
     }
@@ -1,22 +1,25 @@
 //
 //  Author   : Matti Määttä
 //  Type     : Vertex shader
-//  Summary  : Renders depth to texture.
+//  Summary  : Renders depth to texture. Casters are drawn instanced, each instance having its
+//             own light-space transformation.
 //
 
 #version 420
 
+#define MAX_CASTER_INSTANCES <>
+
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 texCoord;
 layout(location = 2) in vec3 normal;
 layout(location = 3) in vec3 tangent;
 
-uniform mat4 MVP;
+uniform mat4 casterTransforms[MAX_CASTER_INSTANCES];
 
 out vec2 texCoord0;
 
 void main()
 {
     texCoord0 = texCoord;
-    gl_Position = MVP * vec4(position, 1.0);
+    gl_Position = casterTransforms[gl_InstanceID] * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -16,6 +16,9 @@ uniform sampler2DMS depth;
 uniform samplerCube cubemap;
 uniform float brightness;
 
+// Test every sample instead of the first. Set for pixels classified as edges.
+uniform bool perSample = true;
+
 subroutine void DepthTestType();
 subroutine uniform DepthTestType depthTest;
 
@@ -25,13 +28,15 @@ void sampleDepthTest()
     float alpha = 1.0;
     ivec2 st = ivec2(gl_FragCoord.xy);
 
+    int samples = perSample ? SAMPLES : 1;
+
     // Blend skybox based on average visibility to reduce aliasing on skybox and mesh edges.
-    for(int i = 0; i < SAMPLES; ++i)
+    for(int i = 0; i < samples; ++i)
     {
         float depth = texelFetch(depth, st, i).x;
         if(gl_FragCoord.z > depth)
         {
-            alpha -= 1.0 / SAMPLES;
+            alpha -= 1.0 / samples;
         }
     }
 
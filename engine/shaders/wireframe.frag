@@ -6,7 +6,10 @@
 
 #version 420
 
-uniform sampler2D gDiffuseSampler;
+#include "materialsampler.frag"
+
+uniform MaterialSampler gDiffuseSampler;
+uniform float gDiffuseLayer;
 uniform vec3 ambientColor;
 uniform vec3 diffuseColor;
 
@@ -16,5 +19,5 @@ layout(location = 0) out vec4 fragColor;
 
 void main()
 {
-    fragColor = texture(gDiffuseSampler, texCoord0) * vec4(diffuseColor, 1.0) + vec4(ambientColor, 1.0);
+    fragColor = sampleMaterial(gDiffuseSampler, gDiffuseLayer, texCoord0) * vec4(diffuseColor, 1.0) + vec4(ambientColor, 1.0);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 //
 
 #include "compactgbuffer.h"
+#include "gpucounters.h"
 
 #include <QDebug>
 #include <algorithm>
@@ -81,6 +82,7 @@ bool CompactGBuffer::isInitialised() const
 void CompactGBuffer::bindFbo()
 {
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 }
 
 void CompactGBuffer::bindTextures() const
@@ -0,0 +1,155 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "cubeshadowmap.h"
+#include "gpucounters.h"
+
+using namespace Engine;
+
+namespace {
+    const float NEAR_PLANE = 0.1f;
+
+    // Face directions and up vectors of the cubemap layers
+    const QVector3D FACE_DIRECTIONS[CubeShadowMap::FACE_COUNT] = {
+        QVector3D(1, 0, 0), QVector3D(-1, 0, 0), QVector3D(0, 1, 0),
+        QVector3D(0, -1, 0), QVector3D(0, 0, 1), QVector3D(0, 0, -1)
+    };
+
+    const QVector3D FACE_UPS[CubeShadowMap::FACE_COUNT] = {
+        QVector3D(0, -1, 0), QVector3D(0, -1, 0), QVector3D(0, 0, 1),
+        QVector3D(0, 0, -1), QVector3D(0, -1, 0), QVector3D(0, -1, 0)
+    };
+}
+
+CubeShadowMap::CubeShadowMap()
+    : fbo_(0), radius_(0.0f)
+{
+}
+
+CubeShadowMap::~CubeShadowMap()
+{
+    if(fbo_ != 0)
+    {
+        gl->glDeleteFramebuffers(1, &fbo_);
+    }
+}
+
+bool CubeShadowMap::bindTextures(GLenum location)
+{
+    return texture_.bind(location);
+}
+
+void CubeShadowMap::setSize(const QSize& size)
+{
+    size_ = size;
+}
+
+const QSize& CubeShadowMap::size()
+{
+    return size_;
+}
+
+bool CubeShadowMap::create()
+{
+    if(fbo_ != 0)
+    {
+        gl->glDeleteFramebuffers(1, &fbo_);
+        fbo_ = 0;
+    }
+
+    // Faces are rendered with a perspective projection, so the depth needs more precision
+    // than the spot light maps.
+    for(int face = 0; face < FACE_COUNT; ++face)
+    {
+        if(!texture_.create(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_DEPTH_COMPONENT24,
+            size_.width(), size_.height(), 0, GL_DEPTH_COMPONENT, GL_FLOAT))
+        {
+            return false;
+        }
+    }
+
+    texture_.bind();
+    texture_.setFiltering(GL_LINEAR, GL_LINEAR);
+    texture_.setWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+    texture_.texParameteri(GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    // Hardware PCF using samplerCubeShadow
+    texture_.texParameteri(GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    texture_.texParameteri(GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    // Attach all faces, the geometry shader selects the layer
+    gl->glGenFramebuffers(1, &fbo_);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl->glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture_.handle(), 0);
+    gl->glDrawBuffer(GL_NONE);
+
+    if(gl->glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        qWarning() << __FUNCTION__ << "Failed to init CubeShadowMap fbo!";
+        return false;
+    }
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl->glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    return true;
+}
+
+const QMatrix4x4& CubeShadowMap::lightVP() const
+{
+    return projection_;
+}
+
+void CubeShadowMap::setLight(const QVector3D& position, float radius)
+{
+    position_ = position;
+    radius_ = radius;
+
+    projection_.setToIdentity();
+    projection_.perspective(90.0f, 1.0f, NEAR_PLANE, qMax(radius, 2 * NEAR_PLANE));
+
+    for(int face = 0; face < FACE_COUNT; ++face)
+    {
+        faceVP_[face] = projection_;
+        faceVP_[face].lookAt(position, position + FACE_DIRECTIONS[face], FACE_UPS[face]);
+    }
+}
+
+const QVector3D& CubeShadowMap::lightPosition() const
+{
+    return position_;
+}
+
+float CubeShadowMap::radius() const
+{
+    return radius_;
+}
+
+const QMatrix4x4& CubeShadowMap::faceVP(int face) const
+{
+    return faceVP_[face];
+}
+
+bool CubeShadowMap::bindFbo()
+{
+    if(fbo_ == 0)
+    {
+        return false;
+    }
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+    return true;
+}
+
+GLuint CubeShadowMap::fboHandle() const
+{
+    return fbo_;
+}
+
+RenderQueue& CubeShadowMap::batch()
+{
+    return queue_;
+}
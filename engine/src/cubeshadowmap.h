@@ -0,0 +1,73 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Shadow map containing a depth cubemap representing the scene depth around a
+//             point light. The faces are attached as layers of a single framebuffer, so all
+//             six can be rendered in one pass.
+//
+
+#ifndef CUBESHADOWMAP_H
+#define CUBESHADOWMAP_H
+
+#include "shadowmap.h"
+
+#include "renderqueue.h"
+#include "cubemaptexture.h"
+
+#include <QVector3D>
+
+namespace Engine {
+
+class CubeShadowMap : public ShadowMap
+{
+public:
+    enum { FACE_COUNT = 6 };
+
+    CubeShadowMap();
+    virtual ~CubeShadowMap();
+
+    // Binds all textures starting from location.
+    virtual bool bindTextures(GLenum location);
+
+    virtual void setSize(const QSize& size);
+    virtual const QSize& size();
+
+    virtual bool create();
+
+    // Returns the projection shared by the faces. Lightning uses it to convert the distance
+    // along the face axis to depth.
+    virtual const QMatrix4x4& lightVP() const;
+
+    // Positions the faces at the light, the far plane being at the light's radius.
+    void setLight(const QVector3D& position, float radius);
+    const QVector3D& lightPosition() const;
+    float radius() const;
+
+    // View-projection of the face in the layer order of the cubemap, ie. +X, -X, +Y, -Y, +Z, -Z.
+    const QMatrix4x4& faceVP(int face) const;
+
+    bool bindFbo();
+    GLuint fboHandle() const;
+
+    // Returns the batch that contains the scene geometry within the light's radius.
+    RenderQueue& batch();
+
+private:
+    GLuint fbo_;
+    CubemapTexture texture_;
+
+    QVector3D position_;
+    float radius_;
+
+    QMatrix4x4 projection_;
+    QMatrix4x4 faceVP_[FACE_COUNT];
+
+    RenderQueue queue_;
+    QSize size_;
+
+    CubeShadowMap(const CubeShadowMap&);
+    CubeShadowMap& operator=(const CubeShadowMap&);
+};
+
+}
+
+#endif // CUBESHADOWMAP_H
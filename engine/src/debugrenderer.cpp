@@ -14,6 +14,9 @@
 #include "scene/sceneobservable.h"
 
 #include "binder.h"
+#include "textureresidency.h"
+#include "gpucounters.h"
+#include "simdmath.h"
 
 using namespace Engine;
 
@@ -27,8 +30,11 @@ DebugRenderer::DebugRenderer(ResourceDespatcher* despatcher)
     aabbTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/aabb.frag"), Shader::Type::Fragment));
 
     // Wireframe tech
+    ShaderData::DefineMap wireframeDefines;
+    textureArrays_ = TextureResidency::shaderDefines(wireframeDefines);
+
     wireframeTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/wireframe.vert"), Shader::Type::Vertex));
-    wireframeTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/wireframe.frag"), Shader::Type::Fragment));
+    wireframeTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/wireframe.frag"), wireframeDefines, Shader::Type::Fragment));
 
     // GBuffer visualizer
     gbufferMS_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/dsmaterial.vert"), Shader::Type::Vertex));
@@ -85,6 +91,7 @@ void DebugRenderer::render()
     }
 
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
     gl->glViewport(viewport_.x(), viewport_.y(), viewport_.width(), viewport_.height());
 
     if(flags_ != DEBUG_GBUFFER)
@@ -117,12 +124,19 @@ void DebugRenderer::renderWireframe()
     gl->glDisable(GL_CULL_FACE);
     gl->glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
+    const Simd::Mat4 viewProj = Simd::Mat4::fromQt(camera_->worldView());
+
     RenderQueue::RenderRange range = batch_->getItems(Material::RENDER_OPAQUE);
     for(auto it = range.first; it != range.second; ++it)
     {
-        wireframeTech_->setUniformValue("gMVP", camera_->worldView() * *it->modelView);
+        wireframeTech_->setUniformValue("gMVP", (viewProj * Simd::Mat4::fromQt(*it->modelView)).toQt());
 
         Binder::bind(it->material->getTexture(Material::TEXTURE_DIFFUSE), GL_TEXTURE0);
+
+        if(textureArrays_)
+        {
+            wireframeTech_->setUniformValue("gDiffuseLayer", it->material->textureLayer(Material::TEXTURE_DIFFUSE));
+        }
             
         QVector3D highlight = it->material->attributes().ambientColor + QVector3D(0.2f, 0.2f, 0.2f);
         wireframeTech_->setUniformValue("ambientColor", highlight);
@@ -146,10 +160,12 @@ void DebugRenderer::renderAABBs()
     gl->glDisable(GL_CULL_FACE);
     gl->glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
+    const Simd::Mat4 viewProj = Simd::Mat4::fromQt(camera_->worldView());
+
     for(auto it = aabbs_.begin(); it != aabbs_.end(); ++it)
     {
         aabbTech_->setUniformValue("gColor", it->second);
-        aabbTech_->setUniformValue("gMVP", camera_->worldView() * it->first);
+        aabbTech_->setUniformValue("gMVP", (viewProj * Simd::Mat4::fromQt(it->first)).toQt());
         boundingMesh_->render();
     }
 
@@ -14,9 +14,9 @@
 #include "aabb.h"
 #include "shaderprogram.h"
 #include "technique/gbuffervisualizer.h"
+#include "framevector.h"
 
 #include <QRect>
-#include <deque>
 #include <QVector3D>
 
 namespace Engine {
@@ -69,6 +69,7 @@ private:
     GLuint fbo_;
     GBuffer const* gbuffer_;
     unsigned int flags_;
+    bool textureArrays_;
 
     RenderQueue* batch_;
     Graph::Camera* camera_;
@@ -81,7 +82,7 @@ private:
     Technique::GBufferVisualizer gbufferMS_;
 
     typedef std::pair<QMatrix4x4, QVector3D> AABBDraw;
-    std::deque<AABBDraw> aabbs_;
+    FrameVector<AABBDraw> aabbs_;
 
     void renderWireframe();
     void renderAABBs();
@@ -12,15 +12,21 @@
 #include "graph/camera.h"
 #include "renderqueue.h"
 #include "texture2dresource.h"
+#include "textureresidency.h"
+#include "gputracer.h"
+#include "gpucounters.h"
+#include "simdmath.h"
 
 using namespace Engine;
 
 DeferredRenderer::DeferredRenderer(const GBufferPtr& gbuffer, ResourceDespatcher& despatcher, unsigned int samples)
-    : gbuffer_(gbuffer), renderQueue_(nullptr), camera_(nullptr)
+    : gbuffer_(gbuffer), renderQueue_(nullptr), camera_(nullptr), renderScale_(1.0f)
 {
     ShaderData::DefineMap shaderDefines;
     shaderDefines.insert("SAMPLES", samples);
 
+    textureArrays_ = TextureResidency::shaderDefines(shaderDefines);
+
     geometryShader_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/gbuffer.vert"), shaderDefines, Shader::Type::Vertex));
     geometryShader_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/gbuffer.frag"), shaderDefines, Shader::Type::Fragment));
 
@@ -54,6 +60,11 @@ void DeferredRenderer::setRenderTarget(GLuint /*fbo*/)
     // Geometry pass doesn't output anything to screen
 }
 
+void DeferredRenderer::setRenderScale(float scale)
+{
+    renderScale_ = scale;
+}
+
 void DeferredRenderer::setObservable(SceneObservable* /*observable*/)
 {
 }
@@ -70,8 +81,12 @@ void DeferredRenderer::render()
         return;
     }
 
+    TRACE_GPU_SCOPE("Geometry pass");
+
     // Cull visibles
-    gl->glViewport(viewport_.x(), viewport_.y(), viewport_.width(), viewport_.height());
+    // Following stages inherit the scaled viewport
+    QRect viewport = scaledViewport(viewport_, renderScale_);
+    gl->glViewport(viewport.x(), viewport.y(), viewport.width(), viewport.height());
 
     gl->glEnable(GL_DEPTH_TEST);
     gl->glEnable(GL_CULL_FACE);
@@ -92,7 +107,8 @@ void DeferredRenderer::geometryPass()
     gl->glClearColor(0, 0, 0, 0);
     gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    const QMatrix4x4 view = camera_->view();
+    const Simd::Mat4 view = Simd::Mat4::fromQt(camera_->view());
+    const Simd::Mat4 viewProj = Simd::Mat4::fromQt(camera_->worldView());
 
     // Render only opaque items to gbuffer
     RenderQueue::RenderRange range = renderQueue_->getItems(Material::RENDER_OPAQUE);
@@ -101,8 +117,11 @@ void DeferredRenderer::geometryPass()
         Material* material = it->material;
         Renderable::Renderable* renderable = it->renderable;
 
-        geometryShader_.setNormalMatrix((view * *it->modelView).normalMatrix());
-        geometryShader_.setMVP(camera_->worldView() * *it->modelView);
+        GPU_COUNT_ITEM(material, material->name());
+
+        const Simd::Mat4 modelView = Simd::Mat4::fromQt(*it->modelView);
+        geometryShader_.setNormalMatrix((view * modelView).toQt().normalMatrix());
+        geometryShader_.setMVP((viewProj * modelView).toQt());
 
         if(!material->bind())
         {
@@ -113,6 +132,12 @@ void DeferredRenderer::geometryPass()
         }
 
         geometryShader_.setMaterialAttributes(material->attributes());
+
+        if(textureArrays_)
+        {
+            geometryShader_.setTextureLayers(*material);
+        }
+
         geometryShader_.setHasTangentsAndNormals(renderable->hasTangents()
             && material->hasTexture(Material::TEXTURE_NORMALS));
 
@@ -52,9 +52,13 @@ public:
     // If fbo is 0, the default framebuffer is used.
     virtual void setRenderTarget(GLuint fbo);
 
+    // Renders the gbuffer into a sub-rect of the viewport.
+    virtual void setRenderScale(float scale);
+
 private:
     GBufferPtr gbuffer_;
     QRect viewport_;
+    float renderScale_;
 
     Graph::Camera* camera_;
 
@@ -64,6 +68,8 @@ private:
     // Error material
     Material errorMaterial_;
 
+    bool textureArrays_;
+
     bool initialise(unsigned int width, unsigned int height, unsigned int samples);
 
     void geometryPass();
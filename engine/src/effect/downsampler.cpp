@@ -7,6 +7,7 @@
 
 #include "resourcedespatcher.h"
 #include "technique/blurfilter.h"
+#include "gpucounters.h"
 
 using namespace Engine;
 using namespace Engine::Effect;
@@ -88,6 +89,7 @@ bool DownSampler::downSample(GLuint textureId, const Renderable::Quad& quad)
         height = floor(height / 2.0f);
 
         gl->glBindFramebuffer(GL_FRAMEBUFFER, fbos_[i]);
+        GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 
         filter_->setTextureParams(width, height, static_cast<float>(i));
 
@@ -97,5 +99,6 @@ bool DownSampler::downSample(GLuint textureId, const Renderable::Quad& quad)
     }
 
     gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,243 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "dualfilter.h"
+
+#include "resourcedespatcher.h"
+#include "gpucounters.h"
+
+#include <QVector2D>
+#include <qmath.h>
+
+using namespace Engine;
+using namespace Engine::Effect;
+
+DualFilter::DualFilter(ResourceDespatcher* despatcher)
+    : width_(0), height_(0), bloomLevels_(0)
+{
+    textures_[0] = textures_[1] = 0;
+
+    prefilterTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/passthrough.vert"), Shader::Type::Vertex));
+    prefilterTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/bloomprefilter.frag"), Shader::Type::Fragment));
+
+    downTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/passthrough.vert"), Shader::Type::Vertex));
+    downTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/kawasedown.frag"), Shader::Type::Fragment));
+
+    upTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/passthrough.vert"), Shader::Type::Vertex));
+    upTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/kawaseup.frag"), Shader::Type::Fragment));
+}
+
+DualFilter::~DualFilter()
+{
+    destroy();
+}
+
+void DualFilter::destroy()
+{
+    if(!downFbos_.empty())
+    {
+        gl->glDeleteFramebuffers(downFbos_.size(), &downFbos_[0]);
+    }
+
+    if(!upFbos_.empty())
+    {
+        gl->glDeleteFramebuffers(upFbos_.size(), &upFbos_[0]);
+    }
+
+    if(textures_[0] != 0)
+    {
+        gl->glDeleteTextures(2, textures_);
+    }
+
+    downFbos_.clear();
+    upFbos_.clear();
+    textures_[0] = textures_[1] = 0;
+}
+
+bool DualFilter::initialise(int width, int height, int bloomLevels)
+{
+    destroy();
+
+    if(width < 1 || height < 1 || bloomLevels < 1)
+    {
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+
+    // Down chain runs to a single texel
+    int levels = 1;
+    while((qMax(width, height) >> levels) >= 1) ++levels;
+
+    bloomLevels_ = qMin(bloomLevels, levels - 1);
+    if(bloomLevels_ < 1)
+    {
+        return false;
+    }
+
+    gl->glGenTextures(2, textures_);
+
+    if(!createChain(textures_[0], levels, downFbos_))
+    {
+        return false;
+    }
+
+    return createChain(textures_[1], bloomLevels_, upFbos_);
+}
+
+bool DualFilter::createChain(GLuint texture, int levels, std::vector<GLuint>& fbos)
+{
+    // Immutable storage; the levels are rendered to directly so mipmaps are never generated
+    gl->glBindTexture(GL_TEXTURE_2D, texture);
+    gl->glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA16F, width_, height_);
+
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+
+    fbos.resize(levels, 0);
+    gl->glGenFramebuffers(levels, &fbos[0]);
+
+    bool complete = true;
+
+    for(int i = 0; i < levels && complete; ++i)
+    {
+        gl->glBindFramebuffer(GL_FRAMEBUFFER, fbos[i]);
+        gl->glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture, i);
+
+        complete = gl->glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
+}
+
+bool DualFilter::prefilter(GLuint inputTexture, float threshold, float renderScale, const Renderable::Quad& quad)
+{
+    if(downFbos_.empty() || !prefilterTech_.enable())
+    {
+        return false;
+    }
+
+    prefilterTech_.setUniformValue("renderedTexture", 0);
+    prefilterTech_.setUniformValue("threshold", threshold);
+    prefilterTech_.setUniformValue("renderScale", renderScale);
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, downFbos_[0]);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+    gl->glViewport(0, 0, width_, height_);
+
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, inputTexture);
+
+    quad.renderDirect();
+
+    gl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+    return true;
+}
+
+bool DualFilter::downSample(bool exposureChain, const Renderable::Quad& quad)
+{
+    if(downFbos_.empty() || !downTech_.enable())
+    {
+        return false;
+    }
+
+    downTech_.setUniformValue("inputTexture", 0);
+
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glBindTexture(GL_TEXTURE_2D, textures_[0]);
+
+    int last = exposureChain ? smallestLevel() : bloomLevels_;
+
+    // Each level samples the previous one
+    for(int i = 1; i <= last; ++i)
+    {
+        gl->glBindFramebuffer(GL_FRAMEBUFFER, downFbos_[i]);
+        GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+        gl->glViewport(0, 0, levelWidth(i), levelHeight(i));
+
+        downTech_.setUniformValue("texelSize", QVector2D(1.0f / levelWidth(i - 1), 1.0f / levelHeight(i - 1)));
+        downTech_.setUniformValue("lodLevel", static_cast<float>(i - 1));
+
+        quad.renderDirect();
+    }
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+    return true;
+}
+
+bool DualFilter::upSample(const Renderable::Quad& quad)
+{
+    if(upFbos_.empty() || !upTech_.enable())
+    {
+        return false;
+    }
+
+    upTech_.setUniformValue("inputTexture", 0);
+    upTech_.setUniformValue("blendTexture", 1);
+
+    gl->glActiveTexture(GL_TEXTURE1);
+    gl->glBindTexture(GL_TEXTURE_2D, textures_[0]);
+
+    // The smallest bloom level is upsampled straight from the down chain
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glBindTexture(GL_TEXTURE_2D, textures_[0]);
+
+    for(int i = bloomLevels_ - 1; i >= 0; --i)
+    {
+        gl->glBindFramebuffer(GL_FRAMEBUFFER, upFbos_[i]);
+        GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+        gl->glViewport(0, 0, levelWidth(i), levelHeight(i));
+
+        upTech_.setUniformValue("texelSize", QVector2D(1.0f / levelWidth(i + 1), 1.0f / levelHeight(i + 1)));
+        upTech_.setUniformValue("lodLevel", static_cast<float>(i + 1));
+
+        quad.renderDirect();
+
+        if(i == bloomLevels_ - 1)
+        {
+            gl->glBindTexture(GL_TEXTURE_2D, textures_[1]);
+        }
+    }
+
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    gl->glActiveTexture(GL_TEXTURE1);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    gl->glActiveTexture(GL_TEXTURE0);
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+    return true;
+}
+
+GLuint DualFilter::bloomTexture() const
+{
+    return textures_[1];
+}
+
+GLuint DualFilter::downTexture() const
+{
+    return textures_[0];
+}
+
+int DualFilter::smallestLevel() const
+{
+    return static_cast<int>(downFbos_.size()) - 1;
+}
+
+int DualFilter::levelWidth(int level) const
+{
+    return qMax(1, width_ >> level);
+}
+
+int DualFilter::levelHeight(int level) const
+{
+    return qMax(1, height_ >> level);
+}
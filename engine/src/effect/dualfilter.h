@@ -0,0 +1,80 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : DualFilter calculates bloom using a dual-Kawase style down/up filter chain.
+//             The highpass filter is folded into the first downsample, and the down chain
+//             continues to a single texel, which is used as the exposure input.
+//
+
+#ifndef DUALFILTER_H
+#define DUALFILTER_H
+
+#include "common.h"
+#include "renderable/quad.h"
+#include "technique/technique.h"
+
+#include <vector>
+
+namespace Engine {
+
+class ResourceDespatcher;
+
+namespace Effect {
+
+class DualFilter
+{
+public:
+    explicit DualFilter(ResourceDespatcher* despatcher);
+    ~DualFilter();
+
+    // Allocates the down and up chains. The down chain covers every mipmap level of the
+    // given size, the up chain bloomLevels levels.
+    // precondition: width, height and bloomLevels >= 1
+    bool initialise(int width, int height, int bloomLevels);
+
+    // Filters the multisampled input texture to the first down chain level.
+    // Only renderScale portion of the input is sampled.
+    // precondition: initialise is called, quad must be bound for direct rendering.
+    bool prefilter(GLuint inputTexture, float threshold, float renderScale, const Renderable::Quad& quad);
+
+    // Downsamples the down chain. If exposureChain is true, the chain is continued
+    // past the bloom levels until the smallest level.
+    // precondition: prefilter is called, quad must be bound for direct rendering.
+    bool downSample(bool exposureChain, const Renderable::Quad& quad);
+
+    // Upsamples and blends the bloom levels to the first up chain level.
+    // precondition: downSample is called, quad must be bound for direct rendering.
+    bool upSample(const Renderable::Quad& quad);
+
+    // Blended bloom at the first level.
+    GLuint bloomTexture() const;
+
+    // Down chain; smallestLevel contains the average of the highpassed input.
+    GLuint downTexture() const;
+    int smallestLevel() const;
+
+private:
+    int width_;
+    int height_;
+    int bloomLevels_;
+
+    GLuint textures_[2];
+    std::vector<GLuint> downFbos_;
+    std::vector<GLuint> upFbos_;
+
+    Technique::Technique prefilterTech_;
+    Technique::Technique downTech_;
+    Technique::Technique upTech_;
+
+    void destroy();
+    bool createChain(GLuint texture, int levels, std::vector<GLuint>& fbos);
+
+    int levelWidth(int level) const;
+    int levelHeight(int level) const;
+
+    DualFilter(const DualFilter&);
+    DualFilter& operator=(const DualFilter&);
+};
+
+}}
+
+#endif // DUALFILTER_H
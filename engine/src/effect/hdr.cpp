@@ -10,6 +10,8 @@
 #include "samplerfunction.h"
 #include "technique/hdrtonemap.h"
 #include "renderable/primitive.h"
+#include "gputracer.h"
+#include "gpucounters.h"
 
 #include <QOpenGLFramebufferObject>
 #include <qmath.h>
@@ -18,7 +20,7 @@ using namespace Engine;
 using namespace Engine::Effect;
 
 Hdr::Hdr(ResourceDespatcher* despatcher, int bloomLevels)
-    : fbo_(nullptr), downSampler_(despatcher), threshold_(1.0f),
+    : fbo_(nullptr), downSampler_(despatcher), dualFilter_(despatcher), threshold_(1.0f), method_(BLOOM_GAUSSIAN),
     width_(0), height_(0), bloomLevels_(bloomLevels), sampleLevel_(0),
     quad_(Renderable::Primitive<Renderable::Quad>::instance())
 {
@@ -38,6 +40,26 @@ void Hdr::setBrightThreshold(float threshold)
     threshold_ = qPow(threshold, 1.0 / 2.2);
 }
 
+void Hdr::setBloomMethod(BloomMethod method)
+{
+    method_ = method;
+}
+
+Hdr::BloomMethod Hdr::bloomMethod() const
+{
+    return method_;
+}
+
+QStringList Hdr::passNames() const
+{
+    if(method_ == BLOOM_DUAL_FILTER)
+    {
+        return QStringList() << "Bloom prefilter" << "Bloom downsample" << "Bloom upsample" << "Tonemap";
+    }
+
+    return QStringList() << "Bloom highpass" << "Bloom downsample" << "Tonemap";
+}
+
 void Hdr::setBlurFilter(const DownSampler::FilterPtr& filter)
 {
     downSampler_.setBlurFilter(filter);
@@ -49,7 +71,10 @@ bool Hdr::initialize(int width, int height, int samples)
         return false;
 
     if(fbo_ != nullptr)
+    {
         delete fbo_;
+        fbo_ = nullptr;
+    }
 
     // Viewport
     width_ = width;
@@ -59,6 +84,38 @@ bool Hdr::initialize(int width, int height, int samples)
     width = std::floor(width / 4.0f);
     height = std::floor(height / 4.0f);
 
+    if(method_ == BLOOM_DUAL_FILTER)
+    {
+        if(!dualFilter_.initialise(width, height, bloomLevels_))
+        {
+            return false;
+        }
+    }
+
+    else if(!initializeGaussian(width, height))
+    {
+        return false;
+    }
+
+    if(!setExposureInput())
+    {
+        return false;
+    }
+
+    if(tonemap_ == nullptr)
+    {
+        return false;
+    }
+
+    tonemap_->setInputTexture(0);
+    tonemap_->setBloomTexture(1);
+    tonemap_->setExposureTexture(2);
+
+    return true;
+}
+
+bool Hdr::initializeGaussian(int width, int height)
+{
     QOpenGLFramebufferObjectFormat format;
     format.setTextureTarget(GL_TEXTURE_2D);
     format.setMipmap(true);                     // Allocate mipmaps for downsampling
@@ -86,21 +143,35 @@ bool Hdr::initialize(int width, int height, int samples)
 
     sampleLevel_ = qMax(tx, ty);
 
-    if(exposureFunc_ != nullptr
-        && !exposureFunc_->setInputTexture(fbo_->texture(), 1, 1, sampleLevel_))
+    return downSampler_.initialise(width, height, fbo_->texture(), bloomLevels_);
+}
+
+bool Hdr::readbackExposure() const
+{
+    return exposureFunc_ != nullptr && exposureFunc_->resultTexture() == 0;
+}
+
+bool Hdr::setExposureInput()
+{
+    if(exposureFunc_ == nullptr)
     {
-        return false;
+        return true;
     }
 
-    if(tonemap_ == nullptr)
+    // GPU functions sample the scene directly
+    if(exposureFunc_->resultTexture() != 0)
     {
-        return false;
+        return inputTexture() != 0 && exposureFunc_->setInputTexture(inputTexture(), width_, height_, 0);
     }
 
-    tonemap_->setInputTexture(0);
-    tonemap_->setBloomTexture(1);
+    // Dual filter continues the down chain to the smallest level, which replaces mipmap generation
+    if(method_ == BLOOM_DUAL_FILTER)
+    {
+        return dualFilter_.downTexture() != 0
+            && exposureFunc_->setInputTexture(dualFilter_.downTexture(), 1, 1, dualFilter_.smallestLevel());
+    }
 
-    return downSampler_.initialise(width, height, fbo_->texture(), bloomLevels_);
+    return fbo_ != nullptr && exposureFunc_->setInputTexture(fbo_->texture(), 1, 1, sampleLevel_);
 }
 
 void Hdr::render()
@@ -110,20 +181,33 @@ void Hdr::render()
         return;
     }
 
+    TRACE_GPU_SCOPE("Postprocess");
+
     quad_->bindVaoDirect();
 
-    // Pass 1
-    // Highpass filter
-    if(!renderHighpass())
+    if(method_ == BLOOM_DUAL_FILTER)
     {
-        return;
+        renderDualFilter();
     }
 
-    // Pass 2
-    // Downsample and blur input
-    downSampler_.downSample(fbo_->texture(), *quad_);
+    else
+    {
+        // Pass 1
+        // Highpass filter
+        if(!renderHighpass())
+        {
+            return;
+        }
+
+        passFinished();
+
+        // Pass 2
+        // Downsample and blur input
+        downSampler_.downSample(fbo_->texture(), *quad_);
+        passFinished();
+    }
 
-    // Pass 3
+    // Last pass
     // Render tonemap to output
     renderTonemap();
 
@@ -139,9 +223,11 @@ bool Hdr::renderHighpass()
 
     highpassTech_.setUniformValue("renderedTexture", 0);
     highpassTech_.setUniformValue("threshold", threshold_);
+    highpassTech_.setUniformValue("renderScale", renderScale());
 
     // QOpenGLFramebufferObject seems to insist on calling glCheckFramebufferStatus on each bind() invocation
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_->handle());
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 
     gl->glViewport(0, 0, fbo_->width(), fbo_->height());
 
@@ -151,7 +237,7 @@ bool Hdr::renderHighpass()
     quad_->renderDirect();
 
     // Generate mipmaps for exposure sampler
-    if(exposureFunc_ != nullptr)
+    if(readbackExposure())
     {
         gl->glBindTexture(GL_TEXTURE_2D, fbo_->texture());
         gl->glGenerateMipmap(GL_TEXTURE_2D);
@@ -160,9 +246,47 @@ bool Hdr::renderHighpass()
     return true;
 }
 
+void Hdr::renderDualFilter()
+{
+    // Pass 1
+    // Highpass filter and the first downsample
+    dualFilter_.prefilter(inputTexture(), threshold_, renderScale(), *quad_);
+    passFinished();
+
+    // Pass 2
+    // Downsample bloom levels, and the remaining levels for the exposure sampler
+    dualFilter_.downSample(readbackExposure(), *quad_);
+    passFinished();
+
+    // Pass 3
+    // Upsample and blend bloom levels
+    dualFilter_.upSample(*quad_);
+    passFinished();
+}
+
 void Hdr::renderTonemap()
 {
+    // Exposure functions may render passes of their own
+    GLuint exposureTexture = 0;
+
+    if(exposureFunc_ != nullptr)
+    {
+        exposureFunc_->setInputScale(renderScale());
+
+        float exposure = exposureFunc_->result();
+        exposureTexture = exposureFunc_->resultTexture();
+
+        if(exposureTexture == 0)
+        {
+            tonemap_->setExposure(exposure);
+        }
+    }
+
+    tonemap_->setGpuExposure(exposureTexture != 0);
+    tonemap_->setRenderScale(renderScale());
+
     gl->glBindFramebuffer(GL_FRAMEBUFFER, outputFbo());
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 
     gl->glViewport(0, 0, width_, height_);
 
@@ -171,32 +295,37 @@ void Hdr::renderTonemap()
         return;
     }
 
-    if(exposureFunc_ != nullptr)
+    if(exposureTexture != 0)
     {
-        tonemap_->setExposure(exposureFunc_->result());
+        gl->glActiveTexture(GL_TEXTURE2);
+        gl->glBindTexture(GL_TEXTURE_2D, exposureTexture);
     }
 
     gl->glActiveTexture(GL_TEXTURE0);
     gl->glBindTexture(inputType(), inputTexture());
 
     gl->glActiveTexture(GL_TEXTURE1);
-    gl->glBindTexture(GL_TEXTURE_2D, fbo_->texture());
+    gl->glBindTexture(GL_TEXTURE_2D, method_ == BLOOM_DUAL_FILTER ? dualFilter_.bloomTexture() : fbo_->texture());
 
     quad_->renderDirect();
 
     gl->glBindTexture(GL_TEXTURE_2D, 0);
     gl->glBindTexture(inputType(), 0);
+
+    if(exposureTexture != 0)
+    {
+        gl->glActiveTexture(GL_TEXTURE2);
+        gl->glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
     gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 }
 
 void Hdr::setExposureFunction(const ExposureFuncPtr& function)
 {
     exposureFunc_ = function;
-
-    if(fbo_ != nullptr && exposureFunc_ != nullptr)
-    {
-        exposureFunc_->setInputTexture(fbo_->texture(), 1, 1, sampleLevel_);
-    }
+    setExposureInput();
 }
 
 void Hdr::setHDRTonemapShader(const HDRTonemapPtr& shader)
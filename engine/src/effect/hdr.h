@@ -10,6 +10,7 @@
 
 #include "common.h"
 #include "downsampler.h"
+#include "dualfilter.h"
 #include "renderable/quad.h"
 #include "technique/technique.h"
 
@@ -40,6 +41,17 @@ public:
     virtual bool initialize(int width, int height, int samples);
     virtual void render();
 
+    // Returns the names of the passes rendered by the selected bloom method.
+    virtual QStringList passNames() const;
+
+    enum BloomMethod { BLOOM_GAUSSIAN, BLOOM_DUAL_FILTER };
+
+    // Sets the method used for calculating bloom. The tonemap shader must match the
+    // method; dual filter bloom is blended to a single level.
+    // postcondition: Initialize must be called after calling this function.
+    void setBloomMethod(BloomMethod method);
+    BloomMethod bloomMethod() const;
+
     typedef std::shared_ptr<SamplerFunction<float>> ExposureFuncPtr;
     typedef std::shared_ptr<Technique::HDRTonemap> HDRTonemapPtr;
     typedef DownSampler::FilterPtr BlurFilterPtr;
@@ -69,8 +81,10 @@ private:
     int bloomLevels_;
     int sampleLevel_;
     float threshold_;
+    BloomMethod method_;
 
     DownSampler downSampler_;
+    DualFilter dualFilter_;
     std::shared_ptr<Renderable::Quad> quad_;
     QOpenGLFramebufferObject* fbo_;
 
@@ -80,7 +94,12 @@ private:
     HDRTonemapPtr tonemap_;
 
     bool renderHighpass();
+    void renderDualFilter();
     void renderTonemap();
+
+    bool initializeGaussian(int width, int height);
+    bool setExposureInput();
+    bool readbackExposure() const;
 };
 
 }}
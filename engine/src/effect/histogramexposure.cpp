@@ -0,0 +1,193 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "histogramexposure.h"
+
+#include "resourcedespatcher.h"
+#include "renderable/primitive.h"
+#include "gpucounters.h"
+
+#include <QVector>
+#include <QDebug>
+#include <cmath>
+
+using namespace Engine;
+using namespace Engine::Effect;
+
+namespace {
+    // Must fit the adaptation pass' local array
+    const int HISTOGRAM_BINS = 64;
+
+    // Each histogram fragment samples a block of scene pixels
+    const int GRID_SCALE = 8;
+}
+
+HistogramExposure::HistogramExposure(ResourceDespatcher* despatcher)
+    : inputTexture_(0), histogram_(0), exposure_(0), target_(0), fbo_(0),
+    gridWidth_(0), gridHeight_(0), lowPercentile_(0.4f), highPercentile_(0.95f), adaptationRate_(1.5f), inputScale_(1.0f),
+    quad_(Renderable::Primitive<Renderable::Quad>::instance())
+{
+    ShaderData::DefineMap shaderDefines;
+    shaderDefines.insert("BINS", HISTOGRAM_BINS);
+
+    histogramTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/passthrough.vert"), Shader::Type::Vertex));
+    histogramTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/luminancehistogram.frag"),
+        shaderDefines, Shader::Type::Fragment));
+
+    adaptTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/passthrough.vert"), Shader::Type::Vertex));
+    adaptTech_.addShader(despatcher->get<Shader>(RESOURCE_PATH("shaders/exposureadaptation.frag"),
+        shaderDefines, Shader::Type::Fragment));
+
+    // Histogram bins are cleared by the adaptation pass after they have been consumed
+    QVector<GLuint> bins(HISTOGRAM_BINS, 0);
+
+    gl->glGenTextures(1, &histogram_);
+    gl->glBindTexture(GL_TEXTURE_1D, histogram_);
+    gl->glTexStorage1D(GL_TEXTURE_1D, 1, GL_R32UI, HISTOGRAM_BINS);
+    gl->glTexSubImage1D(GL_TEXTURE_1D, 0, 0, HISTOGRAM_BINS, GL_RED_INTEGER, GL_UNSIGNED_INT, bins.constData());
+    gl->glBindTexture(GL_TEXTURE_1D, 0);
+
+    // Zero exposure marks the first frame, which is not adapted
+    const float initial = 0.0f;
+
+    gl->glGenTextures(1, &exposure_);
+    gl->glBindTexture(GL_TEXTURE_2D, exposure_);
+    gl->glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32F, 1, 1);
+    gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RED, GL_FLOAT, &initial);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+HistogramExposure::~HistogramExposure()
+{
+    destroyTarget();
+
+    gl->glDeleteTextures(1, &histogram_);
+    gl->glDeleteTextures(1, &exposure_);
+}
+
+void HistogramExposure::destroyTarget()
+{
+    if(fbo_ != 0)
+    {
+        gl->glDeleteFramebuffers(1, &fbo_);
+        gl->glDeleteTextures(1, &target_);
+    }
+
+    fbo_ = target_ = 0;
+}
+
+bool HistogramExposure::setInputTexture(GLint textureId, unsigned int width, unsigned int height, GLuint /*level*/)
+{
+    if(width == 0 || height == 0)
+    {
+        return false;
+    }
+
+    inputTexture_ = textureId;
+
+    destroyTarget();
+
+    gridWidth_ = qMax<int>(1, width / GRID_SCALE);
+    gridHeight_ = qMax<int>(1, height / GRID_SCALE);
+
+    // GL 4.2 can't rasterise without attachments; color writes are masked during the passes
+    gl->glGenTextures(1, &target_);
+    gl->glBindTexture(GL_TEXTURE_2D, target_);
+    gl->glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, gridWidth_, gridHeight_);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+
+    gl->glGenFramebuffers(1, &fbo_);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    gl->glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target_, 0);
+
+    GLenum status = gl->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if(status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        qWarning() << __FUNCTION__ << "Failed to create histogram target";
+        return false;
+    }
+
+    frameTimer_.start();
+    return true;
+}
+
+HistogramExposure::ResultType HistogramExposure::result()
+{
+    if(fbo_ == 0 || !histogramTech_.enable())
+    {
+        return 1.0f;
+    }
+
+    float elapsed = frameTimer_.restart() / 1000.0f;
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+    gl->glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    gl->glBindImageTexture(0, histogram_, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+    gl->glBindImageTexture(1, exposure_, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32F);
+
+    quad_->bindVaoDirect();
+
+    // Pass 1
+    // Bin scene log-luminance
+    histogramTech_.setUniformValue("sceneTexture", 0);
+    histogramTech_.setUniformValue("renderScale", inputScale_);
+
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, inputTexture_);
+
+    gl->glViewport(0, 0, gridWidth_, gridHeight_);
+    quad_->renderDirect();
+
+    gl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+    gl->glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    // Pass 2
+    // Average the clipped histogram and adapt towards it in a single fragment
+    if(adaptTech_.enable())
+    {
+        adaptTech_.setUniformValue("lowPercentile", lowPercentile_);
+        adaptTech_.setUniformValue("highPercentile", highPercentile_);
+        adaptTech_.setUniformValue("adaptation", 1.0f - std::exp(-elapsed * adaptationRate_));
+
+        gl->glViewport(0, 0, 1, 1);
+        quad_->renderDirect();
+    }
+
+    // Exposure is sampled by the tonemap pass
+    gl->glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    gl->glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+
+    return 1.0f;
+}
+
+GLuint HistogramExposure::resultTexture() const
+{
+    return exposure_;
+}
+
+void HistogramExposure::setInputScale(float scale)
+{
+    inputScale_ = scale;
+}
+
+void HistogramExposure::setPercentiles(float low, float high)
+{
+    lowPercentile_ = low;
+    highPercentile_ = high;
+}
+
+void HistogramExposure::setAdaptationRate(float rate)
+{
+    adaptationRate_ = rate;
+}
@@ -0,0 +1,81 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : A Sampler function which bins the scene's log-luminance into a histogram and
+//             adapts the exposure on the GPU. The result is never read back; consumers
+//             sample the exposure texture directly.
+//
+
+#ifndef HISTOGRAMEXPOSURE_H
+#define HISTOGRAMEXPOSURE_H
+
+#include "samplerfunction.h"
+#include "renderable/quad.h"
+#include "technique/technique.h"
+
+#include <QElapsedTimer>
+#include <memory>
+
+namespace Engine {
+
+class ResourceDespatcher;
+
+namespace Effect {
+
+class HistogramExposure : public SamplerFunction<float>
+{
+public:
+    explicit HistogramExposure(ResourceDespatcher* despatcher);
+    virtual ~HistogramExposure();
+
+    // Sets the multisampled scene texture.
+    // precondition: textureId is valid, width and height correspond to the scene size.
+    virtual bool setInputTexture(GLint textureId, unsigned int width, unsigned int height, GLuint level);
+
+    // Submits the histogram and adaptation passes. Returns a neutral exposure;
+    // the adapted value is stored in resultTexture.
+    // precondition: texture has been set.
+    virtual ResultType result();
+
+    // 1x1 GL_R32F texture containing the adapted exposure.
+    virtual GLuint resultTexture() const;
+
+    // Only the rendered sub-rect of the scene is binned.
+    virtual void setInputScale(float scale);
+
+    // Sets the portion of the darkest and brightest pixels ignored when averaging.
+    // precondition: 0 <= low < high <= 1
+    void setPercentiles(float low, float high);
+
+    // Sets the adaptation speed; higher values adapt faster.
+    void setAdaptationRate(float rate);
+
+private:
+    GLuint inputTexture_;
+    GLuint histogram_;
+    GLuint exposure_;
+    GLuint target_;
+    GLuint fbo_;
+
+    int gridWidth_;
+    int gridHeight_;
+
+    float lowPercentile_;
+    float highPercentile_;
+    float adaptationRate_;
+    float inputScale_;
+
+    QElapsedTimer frameTimer_;
+
+    std::shared_ptr<Renderable::Quad> quad_;
+    Technique::Technique histogramTech_;
+    Technique::Technique adaptTech_;
+
+    void destroyTarget();
+
+    HistogramExposure(const HistogramExposure&);
+    HistogramExposure& operator=(const HistogramExposure&);
+};
+
+}}
+
+#endif // HISTOGRAMEXPOSURE_H
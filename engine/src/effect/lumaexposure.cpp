@@ -11,7 +11,7 @@ using namespace Engine;
 using namespace Engine::Effect;
 
 LumaExposure::LumaExposure()
-    : exposure_(), width_(0), height_(0), sampleLevel_(0)
+    : exposure_(), width_(0), height_(0), texture_(0), sampleLevel_(0)
 {
     samplePbo_[0] = samplePbo_[1] = 0;
     writeIndex_ = 1;
@@ -35,6 +35,7 @@ bool LumaExposure::setInputTexture(GLint textureId, unsigned int width, unsigned
 
     width_ = width;
     height_ = height;
+    texture_ = textureId;
     sampleLevel_ = level;
 
     if(*samplePbo_ != 0)
@@ -69,6 +70,7 @@ QVector3D LumaExposure::sampleTexture()
     readIndex_ = (readIndex_ + 1) % 2;
 
     // Read from gpu asynchronously
+    gl->glBindTexture(GL_TEXTURE_2D, texture_);
     gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, samplePbo_[writeIndex_]);
     gl->glGetTexImage(GL_TEXTURE_2D, sampleLevel_, GL_RGBA, GL_FLOAT, nullptr);
 
@@ -33,6 +33,7 @@ private:
     unsigned int width_;
     unsigned int height_;
 
+    GLuint texture_;
     GLuint samplePbo_[2];
     GLuint sampleLevel_;
     int writeIndex_;
@@ -9,7 +9,7 @@ using namespace Engine;
 using namespace Engine::Effect;
 
 Postfx::Postfx() 
-    : inputTexture_(0), outputFbo_(0), inputType_(GL_TEXTURE_2D_MULTISAMPLE)
+    : inputTexture_(0), outputFbo_(0), inputType_(GL_TEXTURE_2D_MULTISAMPLE), renderScale_(1.0f)
 {
 }
 
@@ -28,6 +28,21 @@ void Postfx::setOutputFbo(GLuint framebufferId)
     outputFbo_ = framebufferId;
 }
 
+void Postfx::setRenderScale(float scale)
+{
+    renderScale_ = scale;
+}
+
+QStringList Postfx::passNames() const
+{
+    return QStringList() << "Postprocess";
+}
+
+void Postfx::passFinished()
+{
+    notify(&PostfxObserver::postfxPassFinished);
+}
+
 GLuint Postfx::outputFbo() const
 {
     return outputFbo_;
@@ -41,4 +56,9 @@ GLuint Postfx::inputTexture() const
 GLenum Postfx::inputType() const
 {
     return inputType_;
+}
+
+float Postfx::renderScale() const
+{
+    return renderScale_;
 }
\ No newline at end of file
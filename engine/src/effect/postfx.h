@@ -7,10 +7,13 @@
 #define POSTFX_H
 
 #include "common.h"
+#include "postfxobserver.h"
+
+#include <QStringList>
 
 namespace Engine { namespace Effect {
 
-class Postfx
+class Postfx : public Observable<PostfxObserver>
 {
 public:
     Postfx();
@@ -23,16 +26,28 @@ public:
     virtual void setInputTexture(GLuint textureId, GLenum inputType = GL_TEXTURE_2D_MULTISAMPLE);
     virtual void setOutputFbo(GLuint framebufferId);
 
+    // Sets the portion of the input texture containing the rendered image. The effect
+    // upscales it to the full output.
+    virtual void setRenderScale(float scale);
+
+    // Returns the names of the passes rendered by the effect in submission order.
+    virtual QStringList passNames() const;
+
 protected:
+    // Notifies observers that an intermediate pass has been submitted.
+    void passFinished();
+
     GLuint outputFbo() const;
     GLuint inputTexture() const;
     GLenum inputType() const;
+    float renderScale() const;
 
 private:
     GLuint inputTexture_;
     GLuint outputFbo_;
 
     GLenum inputType_;
+    float renderScale_;
 
     Postfx(const Postfx&);
     Postfx& operator=(const Postfx&);
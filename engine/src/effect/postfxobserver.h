@@ -0,0 +1,27 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : PostfxObserver receives events emitted by post-processing effects. Used
+//             for profiling individual effect passes.
+//
+
+#ifndef POSTFXOBSERVER_H
+#define POSTFXOBSERVER_H
+
+#include "observer.h"
+
+namespace Engine { namespace Effect {
+
+class PostfxObserver : public Observer<PostfxObserver>
+{
+public:
+    PostfxObserver() {};
+    virtual ~PostfxObserver() {};
+
+    // Called when the effect has submitted an intermediate pass. The last pass
+    // of the effect is not reported, since it finishes the effect.
+    virtual void postfxPassFinished() {};
+};
+
+}}
+
+#endif // POSTFXOBSERVER_H
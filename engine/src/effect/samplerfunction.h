@@ -25,6 +25,14 @@ public:
     // Returns the result of the function.
     // precondition: texture has been set.
     virtual ResultType result() = 0;
+
+    // Functions evaluated entirely on the GPU return the texture which holds the result.
+    // Such functions sample the full resolution scene instead of a downsampled level,
+    // and result() only submits the passes. If 0 is returned, result() is used instead.
+    virtual GLuint resultTexture() const { return 0; };
+
+    // Sets the portion of the input texture containing valid data.
+    virtual void setInputScale(float scale) {};
 };
 
 }};
@@ -14,20 +14,27 @@
 #include "renderable/renderable.h"
 #include "resourcedespatcher.h"
 #include "texture2dresource.h"
+#include "textureresidency.h"
 #include "scene/sceneobservable.h"
+#include "gputracer.h"
+#include "gpucounters.h"
+#include "simdmath.h"
 
 using namespace Engine;
 
 ForwardRenderer::ForwardRenderer(ResourceDespatcher& despatcher)
-    : renderQueue_(nullptr), samples_(1), fbo_(0), camera_(nullptr), directionalLight_(nullptr), observable_(nullptr)
+    : renderQueue_(nullptr), renderScale_(1.0f), samples_(1), fbo_(0), camera_(nullptr), directionalLight_(nullptr), observable_(nullptr)
 {
     // Cache error material
     errorMaterial_.setTexture(Material::TEXTURE_DIFFUSE,
         despatcher.get<Texture2DResource>(RESOURCE_PATH("images/pink.png"), TC_SRGBA));
 
     // BasicLightning shaders
+    ShaderData::DefineMap shaderDefines;
+    textureArrays_ = TextureResidency::shaderDefines(shaderDefines);
+
     lightningTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/basiclightning.vert"), Shader::Type::Vertex));
-    lightningTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/basiclightning.frag"), Shader::Type::Fragment));
+    lightningTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/basiclightning.frag"), shaderDefines, Shader::Type::Fragment));
 }
 
 ForwardRenderer::~ForwardRenderer()
@@ -92,11 +99,14 @@ void ForwardRenderer::setRenderTarget(GLuint fbo)
 
 void ForwardRenderer::render()
 {
+    TRACE_GPU_SCOPE("Forward pass");
+
     gl->glEnable(GL_CULL_FACE);
     gl->glEnable(GL_DEPTH_TEST);
 
     // Render geometry and lightning
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 
     renderPass();
 
@@ -104,10 +114,16 @@ void ForwardRenderer::render()
     gl->glDisable(GL_CULL_FACE);
 }
 
+void ForwardRenderer::setRenderScale(float scale)
+{
+    renderScale_ = scale;
+}
+
 void ForwardRenderer::renderPass()
 {
     // Prepare OpenGL state for render pass
-    gl->glViewport(viewport_.x(), viewport_.y(), viewport_.width(), viewport_.height());
+    QRect viewport = scaledViewport(viewport_, renderScale_);
+    gl->glViewport(viewport.x(), viewport.y(), viewport.width(), viewport.height());
     gl->glClearColor(0.0063f, 0.0063f, 0.0063f, 0);
     gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -129,10 +145,14 @@ void ForwardRenderer::renderPass()
 
 void ForwardRenderer::renderRange(RenderQueue::RenderRange range)
 {
+    const Simd::Mat4 viewProj = Simd::Mat4::fromQt(camera_->worldView());
+
     for(auto it = range.first; it != range.second; ++it)
     {
+        GPU_COUNT_ITEM(it->material, it->material->name());
+
         lightningTech_.setWorldView(*it->modelView);
-        lightningTech_.setMVP(camera_->worldView() * *it->modelView);
+        lightningTech_.setMVP((viewProj * Simd::Mat4::fromQt(*it->modelView)).toQt());
 
         renderNode(*it);
     }
@@ -154,5 +174,10 @@ void ForwardRenderer::renderNode(const RenderQueue::RenderItem& node)
     lightningTech_.setHasTangents(renderable->hasTangents() && material->hasTexture(Material::TEXTURE_NORMALS));
     lightningTech_.setMaterialAttributes(material->attributes());
 
+    if(textureArrays_)
+    {
+        lightningTech_.setTextureLayers(*material);
+    }
+
     renderable->render();
 }
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "technique/basiclightning.h"
 #include "renderqueue.h"
 #include "material.h"
+#include "framevector.h"
 
 namespace Engine {
 
@@ -54,6 +55,9 @@ public:
     // If fbo is 0, the default framebuffer is used.
     virtual void setRenderTarget(GLuint fbo);
 
+    // Renders into a sub-rect of the viewport.
+    virtual void setRenderScale(float scale);
+
     virtual void visit(Graph::Light& light);
 
     virtual void sceneInvalidated();
@@ -61,17 +65,19 @@ public:
 private:
     RenderQueue* renderQueue_;
     QRect viewport_;
+    float renderScale_;
     unsigned int samples_;
 
     // Error material
     Material errorMaterial_;
 
     Technique::BasicLightning lightningTech_;
+    bool textureArrays_;
 
     GLuint fbo_;
 
     Graph::Light* directionalLight_;
-    QList<Graph::Light*> lights_;
+    FrameVector<Graph::Light*> lights_;
     Graph::Camera* camera_;
     SceneObservable* observable_;
 
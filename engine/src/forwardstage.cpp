@@ -8,14 +8,23 @@
 #include "resourcedespatcher.h"
 #include "graph/camera.h"
 #include "renderable/renderable.h"
+#include "textureresidency.h"
+#include "sampleclassifier.h"
+#include "gputracer.h"
+#include "gpucounters.h"
+#include "simdmath.h"
 
 using namespace Engine;
 
-ForwardStage::ForwardStage(Renderer* renderer, ResourceDespatcher& despatcher)
-    : RenderStage(renderer), batch_(nullptr), camera_(nullptr), fbo_(0)
+ForwardStage::ForwardStage(Renderer* renderer, ResourceDespatcher& despatcher, unsigned int samples)
+    : RenderStage(renderer), batch_(nullptr), camera_(nullptr), fbo_(0), gbuffer_(nullptr), classifier_(nullptr)
 {
+    ShaderData::DefineMap shaderDefines;
+    shaderDefines.insert("SAMPLES", samples);
+    textureArrays_ = TextureResidency::shaderDefines(shaderDefines);
+
     shader_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/forward.vert"), Shader::Type::Vertex));
-    shader_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/forward.frag"), Shader::Type::Fragment));
+    shader_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/forward.frag"), shaderDefines, Shader::Type::Fragment));
 }
 
 ForwardStage::~ForwardStage()
@@ -38,23 +47,49 @@ void ForwardStage::render()
 {
     RenderStage::render();
 
+    TRACE_GPU_SCOPE("Forward pass");
+
     if(!shader_.enable())
     {
         return;
     }
 
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 
     gl->glEnable(GL_BLEND);
     gl->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     gbuffer_->bindTextures();
 
+    if(classifier_ != nullptr)
+    {
+        // Forward items are few, so drawing them once per pixel set is cheaper
+        // than testing every depth sample on the whole screen.
+        classifier_->beginPixelSet(SampleClassifier::PIXELS_UNIFORM);
+        shader_.setPerSample(false);
+        renderItems();
+
+        classifier_->beginPixelSet(SampleClassifier::PIXELS_EDGE);
+        shader_.setPerSample(true);
+        renderItems();
+
+        classifier_->endPixelSet();
+    }
+
+    else
+    {
+        renderItems();
+    }
+
+    gl->glDisable(GL_BLEND);
+}
+
+void ForwardStage::renderItems()
+{
     // TODO: Depth testing and back-to-front sorting
     renderRange(batch_->getItems(Material::RENDER_EMISSIVE));
     renderRange(batch_->getItems(Material::RENDER_TRANSPARENT));
-
-    gl->glDisable(GL_BLEND);
 }
 
 void ForwardStage::setRenderTarget(GLuint fbo)
@@ -71,16 +106,30 @@ void ForwardStage::setGBuffer(GBuffer* gbuffer)
     shader_.setDepthTextureUnit(depthUnit);
 }
 
+void ForwardStage::setSampleClassifier(SampleClassifier* classifier)
+{
+    classifier_ = classifier;
+}
+
 void ForwardStage::renderRange(const RenderQueue::RenderRange& range)
 {
+    const Simd::Mat4 viewProj = Simd::Mat4::fromQt(camera_->worldView());
+
     for(auto it = range.first; it != range.second; ++it)
     {
         Material* material = it->material;
         Renderable::Renderable* renderable = it->renderable;
 
-        shader_.setMVP(camera_->worldView() * *it->modelView);
+        GPU_COUNT_ITEM(material, material->name());
+
+        shader_.setMVP((viewProj * Simd::Mat4::fromQt(*it->modelView)).toQt());
         shader_.setMaterialAttributes(*material);
 
+        if(textureArrays_)
+        {
+            shader_.setTextureLayers(*material);
+        }
+
         if(material->bind())
         {
             renderable->render();
@@ -16,11 +16,12 @@ namespace Engine {
 
 class GBuffer;
 class ResourceDespatcher;
+class SampleClassifier;
 
 class ForwardStage : public RenderStage
 {
 public:
-    explicit ForwardStage(Renderer* renderer, ResourceDespatcher& despatcher);
+    ForwardStage(Renderer* renderer, ResourceDespatcher& despatcher, unsigned int samples);
     virtual ~ForwardStage();
 
     // Sets the render queue which contains the visible geometry of the scene.
@@ -40,14 +41,21 @@ public:
 
     void setGBuffer(GBuffer* gbuffer);
 
+    // If set, the depth samples are tested only on the classified edge pixels.
+    // precondition: the classifier marks the render target's stencil
+    void setSampleClassifier(SampleClassifier* classifier);
+
 private:
     RenderQueue* batch_;
     Graph::Camera* camera_;
     GLuint fbo_;
     GBuffer* gbuffer_;
+    SampleClassifier* classifier_;
 
     Technique::ForwardShader shader_;
+    bool textureArrays_;
 
+    void renderItems();
     void renderRange(const RenderQueue::RenderRange& range);
 };
 
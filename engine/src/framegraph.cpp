@@ -0,0 +1,380 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "framegraph.h"
+
+#include <QDebug>
+#include <QSet>
+
+using namespace Engine;
+
+namespace {
+    int bytesPerPixel(GLenum format)
+    {
+        switch(format)
+        {
+        case GL_R8:
+            return 1;
+
+        case GL_RGBA16F:
+            return 8;
+
+        case GL_RGBA32F:
+            return 16;
+
+        default:
+            // RGBA8, RGB10_A2, R32F, DEPTH_COMPONENT32F and DEPTH24_STENCIL8
+            return 4;
+        }
+    }
+}
+
+FrameGraph::TextureDesc::TextureDesc()
+    : format(GL_RGBA8), width(0), height(0), samples(0)
+{
+}
+
+FrameGraph::TextureDesc::TextureDesc(GLenum format, int width, int height, int samples)
+    : format(format), width(width), height(height), samples(samples)
+{
+}
+
+bool FrameGraph::TextureDesc::operator==(const TextureDesc& other) const
+{
+    return format == other.format && width == other.width
+        && height == other.height && samples == other.samples;
+}
+
+qint64 FrameGraph::TextureDesc::bytes() const
+{
+    return static_cast<qint64>(width) * height * bytesPerPixel(format) * qMax(1, samples);
+}
+
+FrameGraph::Stats::Stats()
+    : passes(0), culledPasses(0), transientTextures(0), physicalTextures(0),
+    transientBytes(0), physicalBytes(0)
+{
+}
+
+FrameGraph::FrameGraph()
+{
+}
+
+FrameGraph::~FrameGraph()
+{
+}
+
+void FrameGraph::clear()
+{
+    passes_.clear();
+    resources_.clear();
+    order_.clear();
+    slots_.clear();
+    stats_ = Stats();
+}
+
+FrameGraph::Pass FrameGraph::addPass(const QString& name)
+{
+    PassNode node;
+    node.name = name;
+    node.sideEffect = false;
+    node.culled = false;
+
+    passes_.push_back(node);
+    return passes_.size() - 1;
+}
+
+void FrameGraph::setExecute(Pass pass, const ExecuteFunction& execute)
+{
+    passes_[pass].execute = execute;
+}
+
+void FrameGraph::setPrepare(Pass pass, const ExecuteFunction& prepare)
+{
+    passes_[pass].prepare = prepare;
+}
+
+void FrameGraph::setSideEffect(Pass pass)
+{
+    passes_[pass].sideEffect = true;
+}
+
+FrameGraph::Resource FrameGraph::createTexture(Pass pass, const QString& name,
+                                               const TextureDesc& desc, Attachment attachment)
+{
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    node.imported = 0;
+    node.isImported = false;
+    node.slot = -1;
+
+    resources_.push_back(node);
+    Resource resource = resources_.size() - 1;
+
+    write(pass, resource, attachment);
+    return resource;
+}
+
+FrameGraph::Resource FrameGraph::importTexture(const QString& name, GLuint texture)
+{
+    ResourceNode node;
+    node.name = name;
+    node.imported = texture;
+    node.isImported = true;
+    node.slot = -1;
+
+    resources_.push_back(node);
+    return resources_.size() - 1;
+}
+
+void FrameGraph::read(Pass pass, Resource resource)
+{
+    passes_[pass].reads.push_back(resource);
+}
+
+void FrameGraph::write(Pass pass, Resource resource, Attachment attachment)
+{
+    passes_[pass].writes.push_back(qMakePair(resource, attachment));
+}
+
+bool FrameGraph::compile()
+{
+    order_.clear();
+    slots_.clear();
+    stats_ = Stats();
+
+    for(ResourceNode& resource : resources_)
+    {
+        resource.slot = -1;
+    }
+
+    if(!validate())
+    {
+        return false;
+    }
+
+    cull();
+    assignSlots();
+
+    return true;
+}
+
+bool FrameGraph::validate() const
+{
+    QSet<Resource> written;
+
+    for(const PassNode& pass : passes_)
+    {
+        for(Resource resource : pass.reads)
+        {
+            if(!resources_[resource].isImported && !written.contains(resource))
+            {
+                qWarning() << __FUNCTION__ << "Pass" << pass.name << "reads"
+                    << resources_[resource].name << "before it is written.";
+
+                return false;
+            }
+        }
+
+        for(const Write& write : pass.writes)
+        {
+            written.insert(write.first);
+        }
+    }
+
+    return true;
+}
+
+void FrameGraph::cull()
+{
+    // Walk backwards; a pass is needed if it has side effects or writes something read later.
+    QSet<Resource> live;
+
+    for(int i = passes_.size() - 1; i >= 0; --i)
+    {
+        PassNode& pass = passes_[i];
+        pass.culled = !pass.sideEffect;
+
+        for(const Write& write : pass.writes)
+        {
+            if(live.contains(write.first))
+            {
+                pass.culled = false;
+                break;
+            }
+        }
+
+        if(!pass.culled)
+        {
+            for(Resource resource : pass.reads)
+            {
+                live.insert(resource);
+            }
+        }
+    }
+
+    for(int i = 0; i < passes_.size(); ++i)
+    {
+        if(passes_[i].culled)
+        {
+            ++stats_.culledPasses;
+        }
+
+        else
+        {
+            order_.push_back(i);
+        }
+    }
+
+    stats_.passes = order_.size();
+}
+
+void FrameGraph::assignSlots()
+{
+    // Lifetime of each transient texture as indices to the execution order
+    QVector<int> firstUse(resources_.size(), -1);
+    QVector<int> lastUse(resources_.size(), -1);
+
+    for(int i = 0; i < order_.size(); ++i)
+    {
+        const PassNode& pass = passes_[order_[i]];
+
+        for(Resource resource : pass.reads)
+        {
+            lastUse[resource] = i;
+        }
+
+        for(const Write& write : pass.writes)
+        {
+            if(firstUse[write.first] == -1)
+            {
+                firstUse[write.first] = i;
+            }
+
+            lastUse[write.first] = i;
+        }
+    }
+
+    QVector<bool> slotFree;
+
+    for(int i = 0; i < order_.size(); ++i)
+    {
+        // Acquire slots for textures first used by this pass
+        for(int res = 0; res < resources_.size(); ++res)
+        {
+            ResourceNode& resource = resources_[res];
+            if(resource.isImported || firstUse[res] != i)
+            {
+                continue;
+            }
+
+            for(int slot = 0; slot < slots_.size(); ++slot)
+            {
+                if(slotFree[slot] && slots_[slot] == resource.desc)
+                {
+                    resource.slot = slot;
+                    break;
+                }
+            }
+
+            if(resource.slot == -1)
+            {
+                slots_.push_back(resource.desc);
+                slotFree.push_back(false);
+                resource.slot = slots_.size() - 1;
+
+                stats_.physicalBytes += resource.desc.bytes();
+            }
+
+            slotFree[resource.slot] = false;
+
+            ++stats_.transientTextures;
+            stats_.transientBytes += resource.desc.bytes();
+        }
+
+        // Release slots of textures which are not used after this pass
+        for(int res = 0; res < resources_.size(); ++res)
+        {
+            const ResourceNode& resource = resources_[res];
+            if(!resource.isImported && resource.slot != -1 && lastUse[res] == i)
+            {
+                slotFree[resource.slot] = true;
+            }
+        }
+    }
+
+    stats_.physicalTextures = slots_.size();
+}
+
+const QVector<FrameGraph::Pass>& FrameGraph::order() const
+{
+    return order_;
+}
+
+int FrameGraph::passCount() const
+{
+    return passes_.size();
+}
+
+const QString& FrameGraph::passName(Pass pass) const
+{
+    return passes_[pass].name;
+}
+
+bool FrameGraph::isCulled(Pass pass) const
+{
+    return passes_[pass].culled;
+}
+
+const FrameGraph::ExecuteFunction& FrameGraph::execute(Pass pass) const
+{
+    return passes_[pass].execute;
+}
+
+const FrameGraph::ExecuteFunction& FrameGraph::prepare(Pass pass) const
+{
+    return passes_[pass].prepare;
+}
+
+const QVector<FrameGraph::Write>& FrameGraph::writes(Pass pass) const
+{
+    return passes_[pass].writes;
+}
+
+const QString& FrameGraph::resourceName(Resource resource) const
+{
+    return resources_[resource].name;
+}
+
+bool FrameGraph::isImported(Resource resource) const
+{
+    return resources_[resource].isImported;
+}
+
+GLuint FrameGraph::importedTexture(Resource resource) const
+{
+    return resources_[resource].imported;
+}
+
+int FrameGraph::physicalSlot(Resource resource) const
+{
+    return resources_[resource].slot;
+}
+
+int FrameGraph::slotCount() const
+{
+    return slots_.size();
+}
+
+const FrameGraph::TextureDesc& FrameGraph::slotDesc(int slot) const
+{
+    return slots_[slot];
+}
+
+const FrameGraph::Stats& FrameGraph::stats() const
+{
+    return stats_;
+}
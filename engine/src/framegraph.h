@@ -0,0 +1,165 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : FrameGraph orders render passes by the virtual textures they read and write.
+//             Compiling culls the passes whose results are never read, and aliases transient
+//             textures with disjoint lifetimes to shared physical slots. The graph only does
+//             the bookkeeping; physical textures are allocated by the user.
+//
+
+#ifndef FRAMEGRAPH_H
+#define FRAMEGRAPH_H
+
+#include "common.h"
+
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include <functional>
+
+namespace Engine {
+
+class FrameGraph
+{
+public:
+    typedef int Pass;
+    typedef int Resource;
+
+    // Transient textures share a physical slot only when the descriptions match.
+    struct TextureDesc
+    {
+        GLenum format;      // Sized internal format
+        int width;
+        int height;
+        int samples;        // 0 for GL_TEXTURE_2D, otherwise GL_TEXTURE_2D_MULTISAMPLE
+
+        TextureDesc();
+        TextureDesc(GLenum format, int width, int height, int samples);
+        bool operator==(const TextureDesc& other) const;
+
+        // Estimated video memory used by the texture
+        qint64 bytes() const;
+    };
+
+    // How a written texture is attached to the pass framebuffer.
+    enum Attachment { ATTACH_DEFAULT, ATTACH_STENCIL, ATTACH_NONE };
+
+    typedef QPair<Resource, Attachment> Write;
+
+    // Resolves the physical objects while a pass is executed.
+    class Context
+    {
+    public:
+        virtual ~Context() {};
+
+        virtual GLuint texture(Resource resource) const = 0;
+
+        // Framebuffer with the written textures attached in declaration order.
+        virtual GLuint framebuffer() const = 0;
+    };
+
+    typedef std::function<void(const Context&)> ExecuteFunction;
+
+    struct Stats
+    {
+        int passes;
+        int culledPasses;
+        int transientTextures;
+        int physicalTextures;
+        qint64 transientBytes;      // Every transient texture allocated separately
+        qint64 physicalBytes;       // Aliased physical slots
+
+        Stats();
+    };
+
+    FrameGraph();
+    ~FrameGraph();
+
+    // Removes all passes and resources.
+    void clear();
+
+    // Passes are executed in declaration order, so a pass may only read resources
+    // written by earlier passes.
+    Pass addPass(const QString& name);
+    void setExecute(Pass pass, const ExecuteFunction& execute);
+
+    // The prepare function is called once after the physical textures have been allocated.
+    void setPrepare(Pass pass, const ExecuteFunction& prepare);
+
+    // Passes with side effects, such as rendering to the output, are never culled.
+    void setSideEffect(Pass pass);
+
+    // Creates a transient texture written by the pass.
+    Resource createTexture(Pass pass, const QString& name, const TextureDesc& desc,
+                           Attachment attachment = ATTACH_DEFAULT);
+
+    // Imports a texture owned outside the graph. Imported textures are not aliased.
+    Resource importTexture(const QString& name, GLuint texture);
+
+    void read(Pass pass, Resource resource);
+    void write(Pass pass, Resource resource, Attachment attachment = ATTACH_DEFAULT);
+
+    // Culls unused passes and assigns transient textures to physical slots.
+    // postcondition: false if a pass reads a texture which is not written before it.
+    bool compile();
+
+    // Executed passes in order
+    // precondition: compile returned true
+    const QVector<Pass>& order() const;
+
+    int passCount() const;
+    const QString& passName(Pass pass) const;
+    bool isCulled(Pass pass) const;
+    const ExecuteFunction& execute(Pass pass) const;
+    const ExecuteFunction& prepare(Pass pass) const;
+    const QVector<Write>& writes(Pass pass) const;
+
+    const QString& resourceName(Resource resource) const;
+    bool isImported(Resource resource) const;
+    GLuint importedTexture(Resource resource) const;
+
+    // Returns the physical slot of a transient texture, or -1 if the texture is unused.
+    int physicalSlot(Resource resource) const;
+    int slotCount() const;
+    const TextureDesc& slotDesc(int slot) const;
+
+    // Memory statistics of the last compile
+    const Stats& stats() const;
+
+private:
+    struct PassNode
+    {
+        QString name;
+        ExecuteFunction execute;
+        ExecuteFunction prepare;
+        QVector<Resource> reads;
+        QVector<Write> writes;
+        bool sideEffect;
+        bool culled;
+    };
+
+    struct ResourceNode
+    {
+        QString name;
+        TextureDesc desc;
+        GLuint imported;
+        bool isImported;
+        int slot;
+    };
+
+    QVector<PassNode> passes_;
+    QVector<ResourceNode> resources_;
+    QVector<Pass> order_;
+    QVector<TextureDesc> slots_;
+    Stats stats_;
+
+    bool validate() const;
+    void cull();
+    void assignSlots();
+
+    FrameGraph(const FrameGraph&);
+    FrameGraph& operator=(const FrameGraph&);
+};
+
+}
+
+#endif // FRAMEGRAPH_H
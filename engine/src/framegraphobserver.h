@@ -0,0 +1,27 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : FrameGraphObserver receives events emitted by the frame graph renderer. Used
+//             for profiling individual graph passes.
+//
+
+#ifndef FRAMEGRAPHOBSERVER_H
+#define FRAMEGRAPHOBSERVER_H
+
+#include "observer.h"
+
+namespace Engine {
+
+class FrameGraphObserver : public Observer<FrameGraphObserver>
+{
+public:
+    FrameGraphObserver() {};
+    virtual ~FrameGraphObserver() {};
+
+    // Called when a graph pass has been submitted. Culled passes are reported as well,
+    // so the reported sequence doesn't change with the graph. The last pass is not reported.
+    virtual void framePassFinished() {};
+};
+
+}
+
+#endif // FRAMEGRAPHOBSERVER_H
@@ -0,0 +1,264 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "framegraphrenderer.h"
+
+#include <QDebug>
+
+using namespace Engine;
+
+namespace {
+    GLenum attachmentPoint(GLenum format, FrameGraph::Attachment attachment, int& colorAttachments)
+    {
+        if(attachment == FrameGraph::ATTACH_STENCIL)
+        {
+            return GL_STENCIL_ATTACHMENT;
+        }
+
+        switch(format)
+        {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+        case GL_DEPTH_COMPONENT32F:
+            return GL_DEPTH_ATTACHMENT;
+
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH32F_STENCIL8:
+            return GL_DEPTH_STENCIL_ATTACHMENT;
+
+        default:
+            return GL_COLOR_ATTACHMENT0 + colorAttachments++;
+        }
+    }
+}
+
+FrameGraphRenderer::FrameGraphRenderer()
+    : compiled_(false), output_(0), renderScale_(1.0f)
+{
+}
+
+FrameGraphRenderer::~FrameGraphRenderer()
+{
+    for(Renderer* renderer : renderers_)
+    {
+        delete renderer;
+    }
+}
+
+void FrameGraphRenderer::setSetupFunction(const SetupFunction& setup)
+{
+    setup_ = setup;
+}
+
+void FrameGraphRenderer::addRenderer(Renderer* renderer)
+{
+    renderers_.push_back(renderer);
+}
+
+void FrameGraphRenderer::setObservable(SceneObservable* observable)
+{
+    for(Renderer* renderer : renderers_)
+    {
+        renderer->setObservable(observable);
+    }
+}
+
+bool FrameGraphRenderer::setViewport(const QRect& viewport, unsigned int samples)
+{
+    compiled_ = false;
+
+    for(Renderer* renderer : renderers_)
+    {
+        if(!renderer->setViewport(viewport, samples))
+        {
+            return false;
+        }
+    }
+
+    if(!setup_)
+    {
+        return false;
+    }
+
+    graph_.clear();
+    setup_(graph_, viewport.size(), samples);
+
+    if(!graph_.compile())
+    {
+        return false;
+    }
+
+    compiled_ = allocate();
+    return compiled_;
+}
+
+bool FrameGraphRenderer::allocate()
+{
+    // Physical textures are reused from the previous graph when the descriptions match
+    slotTextures_.clear();
+    pool_.beginAllocation();
+
+    for(int slot = 0; slot < graph_.slotCount(); ++slot)
+    {
+        slotTextures_.push_back(pool_.acquire(graph_.slotDesc(slot)));
+    }
+
+    pool_.endAllocation();
+
+    passFbos_.fill(0, graph_.passCount());
+
+    for(FrameGraph::Pass pass : graph_.order())
+    {
+        QVector<TexturePool::Attachment> attachments;
+        int colorAttachments = 0;
+
+        for(const FrameGraph::Write& write : graph_.writes(pass))
+        {
+            if(write.second == FrameGraph::ATTACH_NONE)
+            {
+                continue;
+            }
+
+            GLenum point = GL_COLOR_ATTACHMENT0;
+            GLuint texture = 0;
+
+            if(graph_.isImported(write.first))
+            {
+                point = attachmentPoint(GL_RGBA8, write.second, colorAttachments);
+                texture = graph_.importedTexture(write.first);
+            }
+
+            else
+            {
+                int slot = graph_.physicalSlot(write.first);
+                point = attachmentPoint(graph_.slotDesc(slot).format, write.second, colorAttachments);
+                texture = slotTextures_[slot];
+            }
+
+            attachments.push_back(qMakePair(point, texture));
+        }
+
+        if(attachments.isEmpty())
+        {
+            continue;
+        }
+
+        passFbos_[pass] = pool_.framebuffer(attachments);
+        if(passFbos_[pass] == 0)
+        {
+            qWarning() << __FUNCTION__ << "Failed to create framebuffer for pass" << graph_.passName(pass);
+            return false;
+        }
+    }
+
+    for(FrameGraph::Pass pass : graph_.order())
+    {
+        const FrameGraph::ExecuteFunction& prepare = graph_.prepare(pass);
+        if(prepare)
+        {
+            prepare(PassContext(*this, pass));
+        }
+    }
+
+    return true;
+}
+
+void FrameGraphRenderer::setGeometryBatch(RenderQueue* batch)
+{
+    for(Renderer* renderer : renderers_)
+    {
+        renderer->setGeometryBatch(batch);
+    }
+}
+
+void FrameGraphRenderer::setCamera(Graph::Camera* camera)
+{
+    for(Renderer* renderer : renderers_)
+    {
+        renderer->setCamera(camera);
+    }
+}
+
+void FrameGraphRenderer::render()
+{
+    if(!compiled_)
+    {
+        return;
+    }
+
+    const int last = graph_.passCount() - 1;
+
+    for(FrameGraph::Pass pass = 0; pass <= last; ++pass)
+    {
+        const FrameGraph::ExecuteFunction& execute = graph_.execute(pass);
+        if(!graph_.isCulled(pass) && execute)
+        {
+            execute(PassContext(*this, pass));
+        }
+
+        if(pass != last)
+        {
+            notify(&FrameGraphObserver::framePassFinished);
+        }
+    }
+}
+
+void FrameGraphRenderer::setRenderTarget(GLuint fbo)
+{
+    output_ = fbo;
+}
+
+GLuint FrameGraphRenderer::renderTarget() const
+{
+    return output_;
+}
+
+void FrameGraphRenderer::setRenderScale(float scale)
+{
+    renderScale_ = scale;
+
+    for(Renderer* renderer : renderers_)
+    {
+        renderer->setRenderScale(scale);
+    }
+}
+
+float FrameGraphRenderer::renderScale() const
+{
+    return renderScale_;
+}
+
+const FrameGraph& FrameGraphRenderer::graph() const
+{
+    return graph_;
+}
+
+const TexturePool& FrameGraphRenderer::pool() const
+{
+    return pool_;
+}
+
+FrameGraphRenderer::PassContext::PassContext(const FrameGraphRenderer& renderer, FrameGraph::Pass pass)
+    : renderer_(renderer), pass_(pass)
+{
+}
+
+GLuint FrameGraphRenderer::PassContext::texture(FrameGraph::Resource resource) const
+{
+    const FrameGraph& graph = renderer_.graph_;
+    if(graph.isImported(resource))
+    {
+        return graph.importedTexture(resource);
+    }
+
+    int slot = graph.physicalSlot(resource);
+    return slot != -1 ? renderer_.slotTextures_[slot] : 0;
+}
+
+GLuint FrameGraphRenderer::PassContext::framebuffer() const
+{
+    return renderer_.passFbos_[pass_];
+}
@@ -0,0 +1,99 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : FrameGraphRenderer builds a FrameGraph on every viewport change and executes
+//             the compiled passes each frame. Render targets of the passes are transient
+//             textures allocated from a TexturePool.
+//
+
+#ifndef FRAMEGRAPHRENDERER_H
+#define FRAMEGRAPHRENDERER_H
+
+#include "renderer.h"
+#include "framegraph.h"
+#include "framegraphobserver.h"
+#include "texturepool.h"
+
+#include <QVector>
+#include <QSize>
+#include <functional>
+
+namespace Engine {
+
+class FrameGraphRenderer : public Renderer, public Observable<FrameGraphObserver>
+{
+public:
+    // Declares the passes for the given viewport size and sample count.
+    typedef std::function<void(FrameGraph& graph, const QSize& size, unsigned int samples)> SetupFunction;
+
+    FrameGraphRenderer();
+    virtual ~FrameGraphRenderer();
+
+    // The setup function is called on every viewport change.
+    void setSetupFunction(const SetupFunction& setup);
+
+    // Renderers executed by the passes. The scene, camera, batch, viewport and render scale
+    // are forwarded to them, render targets are set by the passes.
+    // FrameGraphRenderer takes ownership of the renderer.
+    // precondition: renderer != nullptr
+    void addRenderer(Renderer* renderer);
+
+    virtual void setObservable(SceneObservable* observable);
+
+    // Initialises the renderers and rebuilds the graph.
+    // postcondition: true on success, graph compiled and transient textures allocated
+    virtual bool setViewport(const QRect& viewport, unsigned int samples);
+
+    virtual void setGeometryBatch(RenderQueue* batch);
+
+    virtual void setCamera(Graph::Camera* camera);
+
+    // Executes the passes in declaration order.
+    // preconditions: viewport has been set
+    virtual void render();
+
+    // Output framebuffer of the side effect passes
+    virtual void setRenderTarget(GLuint fbo);
+    GLuint renderTarget() const;
+
+    virtual void setRenderScale(float scale);
+    float renderScale() const;
+
+    const FrameGraph& graph() const;
+    const TexturePool& pool() const;
+
+private:
+    class PassContext : public FrameGraph::Context
+    {
+    public:
+        PassContext(const FrameGraphRenderer& renderer, FrameGraph::Pass pass);
+
+        virtual GLuint texture(FrameGraph::Resource resource) const;
+        virtual GLuint framebuffer() const;
+
+    private:
+        const FrameGraphRenderer& renderer_;
+        FrameGraph::Pass pass_;
+    };
+
+    SetupFunction setup_;
+    QVector<Renderer*> renderers_;
+
+    FrameGraph graph_;
+    TexturePool pool_;
+    bool compiled_;
+
+    QVector<GLuint> slotTextures_;
+    QVector<GLuint> passFbos_;
+
+    GLuint output_;
+    float renderScale_;
+
+    bool allocate();
+
+    FrameGraphRenderer(const FrameGraphRenderer&);
+    FrameGraphRenderer& operator=(const FrameGraphRenderer&);
+};
+
+}
+
+#endif // FRAMEGRAPHRENDERER_H
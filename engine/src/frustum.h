@@ -9,14 +9,13 @@
 #include <QMatrix4x4>
 
 #include "aabb.h"
+#include "simdmath.h"
 
 namespace Engine {
 
 // Tests whether the AABB is fully or partially inside the frustum
 bool isInsideFrustum(const AABB& aabb, const QMatrix4x4& view);
-
-// http://fgiesen.wordpress.com/2010/10/17/view-frustum-culling/
-extern bool extentSignTest(const QVector3D& center, const QVector3D& extent, const QVector4D& plane);
+bool isInsideFrustum(const AABB& aabb, const Simd::Mat4& mvp);
 
 }
 
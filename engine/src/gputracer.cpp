@@ -0,0 +1,150 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "gputracer.h"
+
+using namespace Engine;
+
+GpuTracer* GpuTracer::current_ = nullptr;
+
+GpuTracer::GpuTracer()
+    : track_(Tracer::addTrack("GPU")), frame_(0)
+{
+    for(Frame& frame : frames_)
+    {
+        frame.cpuTime = 0;
+        frame.gpuTime = 0;
+        frame.calibrated = false;
+    }
+}
+
+GpuTracer::~GpuTracer()
+{
+    if(current_ == this)
+    {
+        current_ = nullptr;
+    }
+
+    for(Frame& frame : frames_)
+    {
+        for(const Zone& zone : frame.zones)
+        {
+            freeQueries_ << zone.begin << zone.end;
+        }
+    }
+
+    if(!freeQueries_.isEmpty())
+    {
+        gl->glDeleteQueries(freeQueries_.size(), freeQueries_.data());
+    }
+
+    Tracer::releaseTrack(track_);
+}
+
+void GpuTracer::setCurrent(GpuTracer* tracer)
+{
+    current_ = tracer;
+}
+
+GpuTracer* GpuTracer::current()
+{
+    return current_;
+}
+
+void GpuTracer::beginFrame()
+{
+    // Zones are never left open across frames
+    openZones_.clear();
+
+    frame_ = (frame_ + 1) % FRAMES_IN_FLIGHT;
+
+    // The oldest frame has most likely finished, waits otherwise
+    Frame& frame = frames_[frame_];
+    resolve(frame);
+
+    if(Tracer::enabled())
+    {
+        gl->glGetInteger64v(GL_TIMESTAMP, &frame.gpuTime);
+        frame.cpuTime = Tracer::now();
+        frame.calibrated = true;
+    }
+}
+
+void GpuTracer::flush()
+{
+    // Oldest first, so that the zones are added in order
+    for(int i = 1; i <= FRAMES_IN_FLIGHT; ++i)
+    {
+        resolve(frames_[(frame_ + i) % FRAMES_IN_FLIGHT]);
+    }
+}
+
+void GpuTracer::beginZone(const char* name)
+{
+    Frame& frame = frames_[frame_];
+    if(!frame.calibrated)
+    {
+        openZones_.push_back(-1);
+        return;
+    }
+
+    Zone zone = { name, query(), query() };
+    gl->glQueryCounter(zone.begin, GL_TIMESTAMP);
+
+    openZones_.push_back(frame.zones.size());
+    frame.zones.push_back(zone);
+}
+
+void GpuTracer::endZone()
+{
+    if(openZones_.isEmpty())
+    {
+        return;
+    }
+
+    int index = openZones_.back();
+    openZones_.pop_back();
+
+    if(index != -1)
+    {
+        gl->glQueryCounter(frames_[frame_].zones[index].end, GL_TIMESTAMP);
+    }
+}
+
+GLuint GpuTracer::query()
+{
+    if(freeQueries_.isEmpty())
+    {
+        freeQueries_.resize(16);
+        gl->glGenQueries(freeQueries_.size(), freeQueries_.data());
+    }
+
+    GLuint query = freeQueries_.back();
+    freeQueries_.pop_back();
+
+    return query;
+}
+
+void GpuTracer::resolve(Frame& frame)
+{
+    for(const Zone& zone : frame.zones)
+    {
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+
+        gl->glGetQueryObjectui64v(zone.begin, GL_QUERY_RESULT, &begin);
+        gl->glGetQueryObjectui64v(zone.end, GL_QUERY_RESULT, &end);
+
+        // Zones are moved to the CPU clock from the frame's calibration point
+        Tracer::addZone(track_, zone.name,
+            frame.cpuTime + static_cast<qint64>(begin) - frame.gpuTime,
+            frame.cpuTime + static_cast<qint64>(end) - frame.gpuTime);
+
+        freeQueries_ << zone.begin << zone.end;
+    }
+
+    frame.zones.clear();
+    frame.calibrated = false;
+}
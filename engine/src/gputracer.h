@@ -0,0 +1,114 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : GpuTracer records GPU zones with timestamp queries and adds them to the Tracer's
+//             GPU track once the results are available, a few frames later. GPU timestamps are
+//             mapped to the CPU clock at the beginning of every frame.
+//
+
+#ifndef GPUTRACER_H
+#define GPUTRACER_H
+
+#include "common.h"
+#include "tracer.h"
+
+#include <QVector>
+
+namespace Engine {
+
+class GpuTracer
+{
+public:
+    GpuTracer();
+    ~GpuTracer();
+
+    // Tracer used by the GPU trace scopes. Should only be set and used on the rendering thread.
+    static void setCurrent(GpuTracer* tracer);
+    static GpuTracer* current();
+
+    // Resolves the oldest frame in flight and starts recording a new one.
+    void beginFrame();
+
+    // Waits for the frames in flight and adds their zones to the capture.
+    // Should be called before the capture ends, or the last frames are lost.
+    void flush();
+
+    // Zones may be nested and are closed in reverse order.
+    // name must stay valid until the capture has been written.
+    void beginZone(const char* name);
+    void endZone();
+
+private:
+    enum { FRAMES_IN_FLIGHT = 3 };
+
+    struct Zone
+    {
+        const char* name;
+        GLuint begin;
+        GLuint end;
+    };
+
+    struct Frame
+    {
+        QVector<Zone> zones;
+        qint64 cpuTime;         // Tracer clock when the frame began
+        GLint64 gpuTime;        // GPU clock when the frame began
+        bool calibrated;        // Zones are only recorded when captured from the beginning
+    };
+
+    static GpuTracer* current_;
+
+    Tracer::Track track_;
+    Frame frames_[FRAMES_IN_FLIGHT];
+    int frame_;
+
+    QVector<int> openZones_;
+    QVector<GLuint> freeQueries_;
+
+    GLuint query();
+    void resolve(Frame& frame);
+
+    GpuTracer(const GpuTracer&);
+    GpuTracer& operator=(const GpuTracer&);
+};
+
+// Records a zone on both the calling thread and the GPU.
+class GpuTraceScope
+{
+public:
+    explicit GpuTraceScope(const char* name);
+    ~GpuTraceScope();
+
+private:
+    TraceScope cpuScope_;
+    GpuTracer* tracer_;
+
+    GpuTraceScope(const GpuTraceScope&);
+    GpuTraceScope& operator=(const GpuTraceScope&);
+};
+
+inline GpuTraceScope::GpuTraceScope(const char* name)
+    : cpuScope_(name), tracer_(Tracer::enabled() ? GpuTracer::current() : nullptr)
+{
+    if(tracer_ != nullptr)
+    {
+        tracer_->beginZone(name);
+    }
+}
+
+inline GpuTraceScope::~GpuTraceScope()
+{
+    if(tracer_ != nullptr)
+    {
+        tracer_->endZone();
+    }
+}
+
+}
+
+#ifndef ENGINE_NO_TRACING
+    #define TRACE_GPU_SCOPE(name) Engine::GpuTraceScope TRACE_CONCAT(traceGpuScope, __LINE__)(name)
+#else
+    #define TRACE_GPU_SCOPE(name)
+#endif // ENGINE_NO_TRACING
+
+#endif // GPUTRACER_H
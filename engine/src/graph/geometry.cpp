@@ -27,6 +27,11 @@ const Material::Ptr& Geometry::material() const
     return material_;
 }
 
+const Renderable::Renderable::Ptr& Geometry::renderable() const
+{
+    return mesh_;
+}
+
 void Geometry::setMaterial(const Material::Ptr& material)
 {
     material_ = material;
@@ -23,6 +23,7 @@ public:
     virtual void updateRenderList(RenderQueue& list);
 
     const Material::Ptr& material() const;
+    const Renderable::Renderable::Ptr& renderable() const;
 
     // Sets the material used to render this sub entity
     // precondition: material != nullptr
@@ -10,6 +10,7 @@
 #include <qmath.h>
 
 #include "mathelp.h"
+#include "simdmath.h"
 #include "scenenode.h"
 #include "camera.h"
 
@@ -174,12 +175,11 @@ void Light::calculateAABB()
         const float dist = cutoffDistance();
         const float height = qTan(qDegreesToRadians(angleOuterCone_)) * dist;
 
-        // Point light cone points, default orientation is facing +X
-        const QVector3D conePoints[5] = { QVector3D(0, 0, 0),    // Cone origin
-                                          QVector3D(dist, height, height),
-                                          QVector3D(dist, -height, height),
-                                          QVector3D(dist, height, -height),
-                                          QVector3D(dist, -height, -height) };
+        // Point light cone points, default orientation is facing +X. The cone origin is at zero.
+        const Simd::Vec4 conePoints[4] = { Simd::Vec4(dist, height, height, 0),
+                                           Simd::Vec4(dist, -height, height, 0),
+                                           Simd::Vec4(dist, height, -height, 0),
+                                           Simd::Vec4(dist, -height, -height, 0) };
 
         // Rotate cone extremes to match the light orientation
         QQuaternion rotation;
@@ -195,13 +195,21 @@ void Light::calculateAABB()
             rotation = rotationBetweenVectors(UNIT_X, direction_);
         }
 
-        QMatrix4x4 rot;
-        rot.rotate(rotation.normalized());
+        const Simd::Mat4 rot = Simd::Quat::fromQt(rotation).normalized().toMat4();
 
-        for(size_t i = 0; i < 5; ++i)
+        // Box starts from the cone origin
+        Simd::Vec4 min;
+        Simd::Vec4 max;
+
+        for(int i = 0; i < 4; ++i)
         {
-            aabb.resize(rot * conePoints[i]);
+            const Simd::Vec4 point = rot.map(conePoints[i]);
+
+            min = Simd::minimum(min, point);
+            max = Simd::maximum(max, point);
         }
+
+        aabb.reset(min.toVector3D(), max.toVector3D());
     }
 
     updateAABB(aabb);
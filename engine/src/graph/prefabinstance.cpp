@@ -0,0 +1,85 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "prefabinstance.h"
+
+#include "renderqueue.h"
+#include "framearena.h"
+#include "simdmath.h"
+
+#include <new>
+
+using namespace Engine;
+using namespace Engine::Graph;
+
+PrefabInstance::PrefabInstance(const Prefab::Ptr& prefab)
+    : SceneLeaf(), prefab_(prefab), identity_(true)
+{
+    updateAABB(prefab->boundingBox());
+}
+
+void PrefabInstance::updateRenderList(RenderQueue& list)
+{
+    const QMatrix4x4* parent = list.modelView();
+    const QMatrix4x4* instance = parent;
+    const QVector<Prefab::Part>& parts = prefab_->parts();
+
+    // Transformations of the parts live as long as the queue. Parts at the prefab root
+    // share the instance's transformation.
+    const QMatrix4x4** modelViews = static_cast<const QMatrix4x4**>(
+        FrameArena::allocate(parts.count() * sizeof(const QMatrix4x4*), sizeof(void*)));
+
+    if(!identity_)
+    {
+        instance = new(FrameArena::allocate(sizeof(QMatrix4x4))) QMatrix4x4(Simd::multiply(*parent, transformation_));
+    }
+
+    for(int i = 0; i < parts.count(); ++i)
+    {
+        const Prefab::Part& part = parts[i];
+        modelViews[i] = part.identity ? instance :
+            new(FrameArena::allocate(sizeof(QMatrix4x4))) QMatrix4x4(Simd::multiply(*instance, part.transformation));
+    }
+
+    for(const Prefab::Item& item : prefab_->items())
+    {
+        list.setModelView(modelViews[item.part]);
+        list.addNode(item.material.get(), item.renderable.get());
+    }
+
+    list.setModelView(parent);
+}
+
+const Prefab::Ptr& PrefabInstance::prefab() const
+{
+    return prefab_;
+}
+
+void PrefabInstance::setTransformation(const QMatrix4x4& transformation)
+{
+    transformation_ = transformation;
+    identity_ = transformation.isIdentity();
+
+    // Bounding box relative to the parent node
+    const AABB& aabb = prefab_->boundingBox();
+
+    Simd::Vec4 center, extent;
+    Simd::transformBox(Simd::Mat4::fromQt(transformation), Simd::Vec4::fromQt(aabb.center(), 1.0f),
+        Simd::Vec4::fromQt(aabb.extent(), 0.0f), center, extent);
+
+    const QVector3D boxCenter = center.toVector3D();
+    const QVector3D boxExtent = extent.toVector3D();
+    updateAABB(AABB(boxCenter - boxExtent, boxCenter + boxExtent));
+}
+
+const QMatrix4x4& PrefabInstance::transformation() const
+{
+    return transformation_;
+}
+
+std::shared_ptr<SceneLeaf> PrefabInstance::cloneImpl() const
+{
+    return std::make_shared<PrefabInstance>(*this);
+}
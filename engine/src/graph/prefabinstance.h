@@ -0,0 +1,45 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : PrefabInstance places the geometry of a shared Prefab at the node it's attached to.
+//             An instance only holds the prefab reference and an optional transformation relative
+//             to the node, so spawning one doesn't copy meshes, materials or scene nodes.
+//
+
+#ifndef PREFABINSTANCE_H
+#define PREFABINSTANCE_H
+
+#include "sceneleaf.h"
+#include "scene/prefab.h"
+
+#include <QMatrix4x4>
+
+namespace Engine { namespace Graph {
+
+class PrefabInstance : public SceneLeaf
+{
+public:
+    typedef std::shared_ptr<PrefabInstance> Ptr;
+
+    // precondition: prefab != nullptr
+    explicit PrefabInstance(const Prefab::Ptr& prefab);
+
+    // Queues every prefab item. Part transformations are allocated from the FrameArena.
+    virtual void updateRenderList(RenderQueue& list);
+
+    const Prefab::Ptr& prefab() const;
+
+    // Sets the transformation relative to the parent node, eg. a scale.
+    void setTransformation(const QMatrix4x4& transformation);
+    const QMatrix4x4& transformation() const;
+
+    virtual std::shared_ptr<SceneLeaf> cloneImpl() const;
+
+private:
+    Prefab::Ptr prefab_;
+    QMatrix4x4 transformation_;
+    bool identity_;
+};
+
+}}
+
+#endif // PREFABINSTANCE_H
@@ -6,6 +6,7 @@
 #include "scenenode.h"
 
 #include "mathelp.h"
+#include "simdmath.h"
 #include "light.h"
 
 #include <algorithm>
@@ -59,7 +60,7 @@ void SceneNode::updateTransformation(bool updateWorld)
         SceneNode* parent = getParent();
         if(parent != nullptr)
         {
-            world_ = parent->world_ * local_;
+            world_ = Simd::multiply(parent->world_, local_);
         }
 
         else
@@ -86,6 +87,11 @@ void SceneNode::applyTransformation(const QMatrix4x4& matrix)
     markDirty();
 }
 
+const QMatrix4x4& SceneNode::localTransformation() const
+{
+    return local_;
+}
+
 SceneNode::ChildSceneNodes::size_type SceneNode::numChildren() const
 {
     return children_.size();
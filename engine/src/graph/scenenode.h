@@ -35,6 +35,9 @@ public:
     // Sets the node's transformation
     void applyTransformation(const QMatrix4x4& matrix);
 
+    // Returns the transformation relative to the parent node.
+    const QMatrix4x4& localTransformation() const;
+
     // Set node position in world space
     void setPosition(const QVector3D& position);
     QVector3D position() const;
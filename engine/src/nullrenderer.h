@@ -0,0 +1,30 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : NullRenderer renders nothing. It terminates a RenderStage which is
+//             executed on its own, e.g. as a frame graph pass.
+//
+
+#ifndef NULLRENDERER_H
+#define NULLRENDERER_H
+
+#include "renderer.h"
+
+namespace Engine {
+
+class NullRenderer : public Renderer
+{
+public:
+    NullRenderer() {};
+    virtual ~NullRenderer() {};
+
+    virtual void setObservable(SceneObservable* /*observable*/) {};
+    virtual bool setViewport(const QRect& /*viewport*/, unsigned int /*samples*/) { return true; };
+    virtual void setGeometryBatch(RenderQueue* /*batch*/) {};
+    virtual void setCamera(Graph::Camera* /*camera*/) {};
+    virtual void render() {};
+    virtual void setRenderTarget(GLuint /*fbo*/) {};
+};
+
+}
+
+#endif // NULLRENDERER_H
@@ -9,6 +9,12 @@
 #include "technique/technique.h"
 #include "renderable/renderable.h"
 #include "graph/camera.h"
+#include "gpucounters.h"
+#include "simdmath.h"
+#include "binder.h"
+#include "texture2d.h"
+
+#include <algorithm>
 
 using namespace Engine;
 
@@ -18,6 +24,11 @@ OffscreenRenderer::OffscreenRenderer()
 {
 }
 
+OffscreenRenderer::CasterPass::CasterPass()
+    : opaque(nullptr), alphaTested(nullptr), views(nullptr), viewCount(0), textureArrays(false)
+{
+}
+
 OffscreenRenderer::~OffscreenRenderer()
 {
 }
@@ -57,50 +68,242 @@ void OffscreenRenderer::setRenderCallback(OnRenderCallback callback)
     renderCallback_ = callback;
 }
 
+void OffscreenRenderer::setCasterPass(const CasterPass& pass)
+{
+    casterPass_ = pass;
+}
+
 void OffscreenRenderer::render()
 {
-    if(batch_ == nullptr || tech_ == nullptr)
+    const bool casters = casterPass_.opaque != nullptr && casterPass_.alphaTested != nullptr;
+
+    if(batch_ == nullptr || (tech_ == nullptr && !casters))
     {
         return;
     }
 
-    // Bind shader
-    if(!tech_->enable())
+    // Bind shader, the caster pass binds its own
+    if(!casters && !tech_->enable())
     {
         return;
     }
 
     // Bind framebuffer
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
     gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     gl->glViewport(viewport_.x(), viewport_.y(), viewport_.width(), viewport_.height());
 
-    for(int i = 0; i < Material::RENDER_COUNT; ++i)
+    if(casters)
     {
-        Material::RenderType index = static_cast<Material::RenderType>(i);
-        renderBatch(batch_->getItems(index));
+        renderCasters();
+    }
+
+    else
+    {
+        for(int i = 0; i < Material::RENDER_COUNT; ++i)
+        {
+            Material::RenderType index = static_cast<Material::RenderType>(i);
+            renderBatch(batch_->getItems(index));
+        }
     }
 
     gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 }
 
 void OffscreenRenderer::renderBatch(const RenderQueue::RenderRange& range)
 {
-    QMatrix4x4 worldView;
+    Simd::Mat4 worldView = Simd::Mat4::identity();
 
     if(camera_ != nullptr)
     {
-        worldView = camera_->worldView();
+        worldView = Simd::Mat4::fromQt(camera_->worldView());
     }
 
     for(auto it = range.first; it != range.second; ++it)
     {
         if(renderCallback_ != nullptr)
         {
-            renderCallback_(*it->material, worldView * *it->modelView);
+            renderCallback_(*it->material, (worldView * Simd::Mat4::fromQt(*it->modelView)).toQt());
         }
 
         it->renderable->render();
     }
+}
+
+void OffscreenRenderer::renderCasters()
+{
+    opaqueCasters_.clear();
+    maskedCasters_.clear();
+
+    for(int i = 0; i < Material::RENDER_COUNT; ++i)
+    {
+        collectCasters(batch_->getItems(static_cast<Material::RenderType>(i)));
+    }
+
+    // Instances of a renderable are drawn together, alpha-tested casters are grouped by mask
+    // first so that each mask is bound once.
+    std::sort(opaqueCasters_.begin(), opaqueCasters_.end(), [] (const Caster& first, const Caster& second)
+        {
+            return first.renderable < second.renderable;
+        }
+    );
+
+    std::sort(maskedCasters_.begin(), maskedCasters_.end(), [] (const Caster& first, const Caster& second)
+        {
+            if(first.mask != second.mask)
+            {
+                return first.mask < second.mask;
+            }
+
+            return first.renderable < second.renderable;
+        }
+    );
+
+    drawCasters(*casterPass_.opaque, opaqueCasters_, false);
+    drawCasters(*casterPass_.alphaTested, maskedCasters_, true);
+}
+
+void OffscreenRenderer::collectCasters(const RenderQueue::RenderRange& range)
+{
+    const bool layered = casterPass_.viewCount > 1;
+
+    for(auto it = range.first; it != range.second; ++it)
+    {
+        Caster caster;
+        caster.renderable = it->renderable;
+        caster.material = it->material;
+        caster.layers = 1;
+
+        const Simd::Mat4 model = Simd::Mat4::fromQt(*it->modelView);
+
+        if(layered)
+        {
+            // Casters are culled per layer with the same box test as the scene
+            const AABB& box = it->renderable->boundingBox();
+
+            Simd::Vec4 center, extent;
+            Simd::transformBox(model, Simd::Vec4::fromQt(box.center(), 1.0f),
+                Simd::Vec4::fromQt(box.extent(), 0.0f), center, extent);
+
+            caster.layers = 0;
+            for(int view = 0; view < casterPass_.viewCount; ++view)
+            {
+                if(Simd::boxInClipSpace(casterPass_.views[view], center, extent))
+                {
+                    caster.layers |= 1 << view;
+                }
+            }
+
+            if(caster.layers == 0)
+            {
+                continue;
+            }
+
+            // Views are applied by the shader
+            caster.transform = model;
+        }
+
+        else
+        {
+            caster.transform = casterPass_.views[0] * model;
+        }
+
+        if(it->material->hasAlphaMask())
+        {
+            caster.mask = it->material->getTexture(Material::TEXTURE_MASK).get();
+            maskedCasters_.push_back(caster);
+        }
+
+        else
+        {
+            caster.mask = nullptr;
+            opaqueCasters_.push_back(caster);
+        }
+    }
+}
+
+void OffscreenRenderer::drawCasters(Technique::Technique& tech, const FrameVector<Caster>& casters, bool alphaTested)
+{
+    if(casters.isEmpty() || !tech.enable())
+    {
+        return;
+    }
+
+    if(casterPass_.viewCount > 1)
+    {
+        tech.setUniformValueArray("layerVP", casterPass_.views, casterPass_.viewCount);
+    }
+
+    if(alphaTested)
+    {
+        tech.setUniformValue("maskSampler", static_cast<int>(Material::TEXTURE_MASK));
+    }
+
+    const Texture2D* boundMask = nullptr;
+
+    auto it = casters.begin();
+    while(it != casters.end())
+    {
+        // Consecutive casters sharing the renderable and the mask are drawn as instances
+        auto first = it;
+        int instances = 0;
+
+        while(it != casters.end() && instances < MAX_CASTER_INSTANCES &&
+            it->renderable == first->renderable && it->mask == first->mask)
+        {
+            transforms_[instances] = it->transform;
+            layers_[instances] = it->layers;
+
+            ++instances;
+            ++it;
+        }
+
+        if(alphaTested && first->mask != boundMask)
+        {
+            Material& mat = *first->material;
+            Binder::bind(mat.getTexture(Material::TEXTURE_MASK), GL_TEXTURE0 + Material::TEXTURE_MASK);
+
+            if(casterPass_.textureArrays)
+            {
+                tech.setUniformValue("maskLayer", mat.textureLayer(Material::TEXTURE_MASK));
+            }
+
+            boundMask = first->mask;
+        }
+
+        drawInstances(tech, *first->renderable, instances);
+    }
+}
+
+void OffscreenRenderer::drawInstances(Technique::Technique& tech, const Renderable::Renderable& renderable, int instances)
+{
+    const bool layered = casterPass_.viewCount > 1;
+
+    tech.setUniformValueArray("casterTransforms", transforms_, instances);
+
+    if(layered)
+    {
+        tech.setUniformValueArray("casterLayers", layers_, instances);
+    }
+
+    if(renderable.renderInstanced(instances))
+    {
+        return;
+    }
+
+    // The renderable can't be instanced, draw one at a time through the first element
+    for(int i = 0; i < instances; ++i)
+    {
+        tech.setUniformValueArray("casterTransforms", &transforms_[i], 1);
+
+        if(layered)
+        {
+            tech.setUniformValueArray("casterLayers", &layers_[i], 1);
+        }
+
+        renderable.render();
+    }
 }
\ No newline at end of file
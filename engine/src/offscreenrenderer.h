@@ -2,7 +2,8 @@
 //  Author   : Matti Määttä
 //  Summary  : OffscreenRenderer implements a simple forward pass using an anynomous technique.
 //             This renderer is used by shadow and cubemap renderers which need more simplified pipeline
-//             than actual renderers that output directly to screen.
+//             than actual renderers that output directly to screen. Shadow casters can be submitted
+//             through a depth-only caster pass instead of the technique.
 //
 
 #ifndef OFFSCREENRENDERER_H
@@ -10,6 +11,8 @@
 
 #include "renderer.h"
 #include "renderqueue.h"
+#include "framevector.h"
+#include "simdmath.h"
 
 #include <functional>
 
@@ -20,6 +23,7 @@ namespace Technique {
 }
 
 class Material;
+class Texture2D;
 
 class OffscreenRenderer : public Renderer
 {
@@ -62,6 +66,35 @@ public:
     // This allows the caller to set technique's attributes for the current material.
     void setRenderCallback(OnRenderCallback callback);
 
+    // Number of instances drawn at once by the caster pass. Caster shaders are compiled with
+    // MAX_CASTER_INSTANCES defined as this.
+    enum { MAX_CASTER_INSTANCES = 32 };
+
+    struct CasterPass
+    {
+        // Techniques for the casters without an alpha mask and for the alpha-tested casters
+        Technique::Technique* opaque;
+        Technique::Technique* alphaTested;
+
+        // Light view-projections. With more than one view, the casters are rendered to layers:
+        // the shaders get the model matrices, the views as layerVP and a bit per view the
+        // caster touches in casterLayers.
+        const Simd::Mat4* views;
+        int viewCount;
+
+        // Alpha-tested technique samples texture arrays
+        bool textureArrays;
+
+        CasterPass();
+    };
+
+    // Renders the batch as depth-only shadow casters instead of using the technique and callbacks.
+    // Casters without an alpha mask are drawn instanced by renderable without binding textures,
+    // and the alpha-tested casters are grouped by mask and renderable. The light-space transformations
+    // are read from casterTransforms[gl_InstanceID].
+    // precondition: views are valid until render is called. Pass with nullptr techniques disables.
+    void setCasterPass(const CasterPass& pass);
+
 private:
     RenderQueue* batch_;
     Graph::Camera* camera_;
@@ -72,7 +105,29 @@ private:
 
     QRect viewport_;
 
+    struct Caster
+    {
+        Simd::Mat4 transform;
+        Renderable::Renderable* renderable;
+        Material* material;
+        const Texture2D* mask;
+        GLint layers;
+    };
+
+    CasterPass casterPass_;
+    FrameVector<Caster> opaqueCasters_;
+    FrameVector<Caster> maskedCasters_;
+
+    // Instance data of the current draw
+    Simd::Mat4 transforms_[MAX_CASTER_INSTANCES];
+    GLint layers_[MAX_CASTER_INSTANCES];
+
     void renderBatch(const RenderQueue::RenderRange& range);
+
+    void renderCasters();
+    void collectCasters(const RenderQueue::RenderRange& range);
+    void drawCasters(Technique::Technique& tech, const FrameVector<Caster>& casters, bool alphaTested);
+    void drawInstances(Technique::Technique& tech, const Renderable::Renderable& renderable, int instances);
 };
 
 };
@@ -0,0 +1,121 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "pointlightmethod.h"
+
+#include "scene/sceneobservable.h"
+#include "graph/light.h"
+#include "graph/scenenode.h"
+#include "graph/sceneleaf.h"
+#include "resourcedespatcher.h"
+#include "textureresidency.h"
+
+using namespace Engine;
+
+PointLightMethod::PointLightMethod(ResourceDespatcher& despatcher)
+    : scene_(nullptr), shadow_(nullptr)
+{
+    ShaderData::DefineMap shaderDefines;
+    textureArrays_ = TextureResidency::shaderDefines(shaderDefines);
+    shaderDefines.insert("MAX_CASTER_INSTANCES", static_cast<int>(OffscreenRenderer::MAX_CASTER_INSTANCES));
+
+    // Load shaders, the fragment shaders are shared with spot lights
+    depthTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowcube.vert"), shaderDefines, Shader::Type::Vertex));
+    depthTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowcube.geom"), Shader::Type::Geometry));
+    depthTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowdepth.frag"), Shader::Type::Fragment));
+
+    maskTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowcube.vert"), shaderDefines, Shader::Type::Vertex));
+    maskTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowcube.geom"), Shader::Type::Geometry));
+    maskTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowmap.frag"), shaderDefines, Shader::Type::Fragment));
+
+    // The faces are layers of the pass. Casters are culled per face with the same box test
+    // as the scene, and the geometry shader emits them only to the faces they touch.
+    OffscreenRenderer::CasterPass pass;
+    pass.opaque = &depthTech_;
+    pass.alphaTested = &maskTech_;
+    pass.views = faceVP_;
+    pass.viewCount = CubeShadowMap::FACE_COUNT;
+    pass.textureArrays = textureArrays_;
+
+    renderer_.setCasterPass(pass);
+}
+
+PointLightMethod::~PointLightMethod()
+{
+}
+
+ShadowMap* PointLightMethod::createShadowMap()
+{
+    return new CubeShadowMap();
+}
+
+void PointLightMethod::setShadowMap(ShadowMap* shadow)
+{
+#ifdef _DEBUG
+    Q_ASSERT(dynamic_cast<CubeShadowMap*>(shadow));
+#endif
+
+    shadow_ = static_cast<CubeShadowMap*>(shadow);
+}
+
+void PointLightMethod::setCamera(Graph::Camera* /*camera*/)
+{
+}
+
+void PointLightMethod::setSceneObservable(SceneObservable* observable)
+{
+    scene_ = observable;
+}
+
+void PointLightMethod::prepare(Graph::Light& light)
+{
+    // Reset batch
+    shadow_->batch().clear();
+
+    const float radius = light.cutoffDistance();
+    shadow_->setLight(light.position(), radius);
+
+    // The box enclosing the light's radius is culled together with the other views of the frame,
+    // and the casters are tested against the faces when rendering.
+    QMatrix4x4 bounds;
+    bounds.ortho(-radius, radius, -radius, radius, -radius, radius);
+    bounds.translate(-light.position());
+
+    RenderQueue& visibles = shadow_->batch();
+    unsigned int lightMask = light.lightMask();
+
+    scene_->addCullView(bounds, visibles,
+        [lightMask] (const Graph::SceneLeaf&, const Graph::SceneNode& node)
+        {
+            // Accept only renderables that cast shadows by this light.
+            return (lightMask & node.lightMask()) == lightMask;
+        }
+    );
+}
+
+void PointLightMethod::render()
+{
+    for(int face = 0; face < CubeShadowMap::FACE_COUNT; ++face)
+    {
+        faceVP_[face] = Simd::Mat4::fromQt(shadow_->faceVP(face));
+    }
+
+    renderer_.setGeometryBatch(&shadow_->batch());
+    renderer_.setRenderTarget(shadow_->fboHandle());
+    renderer_.setViewport(QRect(QPoint(0, 0), shadow_->size()), 1);
+
+    if(shadow_->bindFbo())
+    {
+        // Cull front faces to reduce self-shadowing
+        gl->glCullFace(GL_FRONT);
+
+        renderer_.render();
+
+        gl->glCullFace(GL_BACK);
+    }
+
+    // Reset batch
+    shadow_->batch().clear();
+}
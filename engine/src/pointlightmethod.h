@@ -0,0 +1,61 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Shadow rendering method for point lights. The six faces of the cube shadow map
+//             are rendered in a single layered pass: every caster is drawn once, and the
+//             geometry shader emits it only to the faces its bounds were found in on the CPU.
+//
+
+#ifndef POINTLIGHTMETHOD_H
+#define POINTLIGHTMETHOD_H
+
+#include "shadowrendermethod.h"
+#include "offscreenrenderer.h"
+#include "cubeshadowmap.h"
+#include "technique/technique.h"
+#include "simdmath.h"
+
+namespace Engine {
+
+class ResourceDespatcher;
+
+class PointLightMethod : public ShadowRenderMethod
+{
+public:
+    PointLightMethod(ResourceDespatcher& despatcher);
+    virtual ~PointLightMethod();
+
+    virtual ShadowMap* createShadowMap();
+
+    // Precondition: shadow is same type as returned by createShadowMap.
+    virtual void setShadowMap(ShadowMap* shadow);
+
+    virtual void setCamera(Graph::Camera* camera);
+    virtual void setSceneObservable(SceneObservable* observable);
+
+    // Culls the scene within the light's radius but does not render anything to fbo;
+    // Precondition: Shadow map is set, observable is set, camera is set.
+    virtual void prepare(Graph::Light& light);
+
+    // Renders the scene around the light to the cube faces in a single pass.
+    // Precondition: Shadow map is set
+    virtual void render();
+
+private:
+    SceneObservable* scene_;
+    CubeShadowMap* shadow_;
+
+    // Face frusta of the light being rendered
+    Simd::Mat4 faceVP_[CubeShadowMap::FACE_COUNT];
+
+    OffscreenRenderer renderer_;
+
+    // Casters without an alpha mask only write depth
+    Technique::Technique depthTech_;
+    Technique::Technique maskTech_;
+
+    bool textureArrays_;
+};
+
+}
+
+#endif // POINTLIGHTMETHOD_H
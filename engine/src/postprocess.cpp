@@ -34,7 +34,7 @@ void PostProcess::deleteBuffers()
         gl->glDeleteTextures(1, &texture_);
 
     if(depth_ != 0)
-        gl->glDeleteTextures(1, &depth_);
+        gl->glDeleteRenderbuffers(1, &depth_);
 
     if(proxy_ != 0)
         gl->glDeleteFramebuffers(1, &proxy_);
@@ -76,7 +76,18 @@ bool PostProcess::setViewport(const QRect& viewport, unsigned int samples)
         gl->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_);
     }
 
-    // TODO: If stencil is needed in output pass, create it here
+    // Stencil attachment for masking passes. Deferred stages test depth against the gbuffer,
+    // so the depth part is left unattached.
+    else if(format_.attachment() == QOpenGLFramebufferObject::CombinedDepthStencil)
+    {
+        gl->glGenRenderbuffers(1, &depth_);
+        gl->glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+        gl->glRenderbufferStorageMultisample(GL_RENDERBUFFER, format_.samples(), GL_DEPTH24_STENCIL8,
+            viewport.width(), viewport.height());
+
+        gl->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        gl->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_);
+    }
 
     GLenum status = gl->glCheckFramebufferStatus(GL_FRAMEBUFFER);
     gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -109,6 +120,16 @@ void PostProcess::setRenderTarget(GLuint fbo)
     effect_->setOutputFbo(out_);
 }
 
+void PostProcess::setRenderScale(float scale)
+{
+    RenderStage::setRenderScale(scale);
+
+    if(effect_ != nullptr)
+    {
+        effect_->setRenderScale(scale);
+    }
+}
+
 bool PostProcess::setEffect(const PostfxPtr& effect)
 {
     effect_ = effect;
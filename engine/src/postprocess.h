@@ -33,6 +33,9 @@ public:
 
     virtual void setRenderTarget(GLuint fbo);
 
+    // The effect upscales the rendered sub-rect to the full viewport.
+    virtual void setRenderScale(float scale);
+
     typedef std::shared_ptr<Effect::Postfx> PostfxPtr;
 
     // Precondition: Viewport has been set.
@@ -6,22 +6,42 @@
 #include "gbuffer.h"
 #include "renderable/primitive.h"
 #include "shadowstage.h"
+#include "gputracer.h"
+#include "gpucounters.h"
 
 #include "scene/sceneobservable.h"
 
 using namespace Engine;
 
 QuadLighting::QuadLighting(Renderer* renderer, GBuffer& gbuffer, ResourceDespatcher& despatcher, unsigned int samples)
-    : RenderStage(renderer), gbuffer_(gbuffer), fbo_(0), directionalLight_(nullptr), camera_(nullptr), observable_(nullptr),
-    shadowStage_(nullptr), quad_(Renderable::Primitive<Renderable::Quad>::instance()), lightningTech_()
+    : RenderStage(renderer), gbuffer_(gbuffer), despatcher_(despatcher), fbo_(0), renderScale_(1.0f), directionalLight_(nullptr), camera_(nullptr),
+    observable_(nullptr), shadowStage_(nullptr), quad_(Renderable::Primitive<Renderable::Quad>::instance()), lightningTech_(),
+    usePermutations_(false), enabledTech_(nullptr), enabledType_(Graph::Light::LIGHT_COUNT), enabledShadow_(false),
+    perSample_(false)
 {
     lightningTech_.setGBuffer(&gbuffer);
 
-    ShaderData::DefineMap shaderDefines;
-    shaderDefines.insert("SAMPLES", samples);
+    shaderDefines_.insert("SAMPLES", samples);
 
-    lightningTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/dsillumination.vert"), Shader::Type::Vertex));
-    lightningTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/dsillumination.frag"), shaderDefines, Shader::Type::Fragment));
+    ShaderData::DefineMap defines = shaderDefines_;
+    Technique::IlluminationModel::permutationDefines(defines, Graph::Light::LIGHT_COUNT, false);
+
+    // Permutations share the source files, so they can't be looked up by file name
+    Shader::Ptr vert = std::make_shared<Shader>(RESOURCE_PATH("shaders/dsillumination.vert"), defines, Shader::Type::Vertex);
+    Shader::Ptr frag = std::make_shared<Shader>(RESOURCE_PATH("shaders/dsillumination.frag"), defines, Shader::Type::Fragment);
+
+    lightningTech_.addShader(vert);
+    lightningTech_.addShader(frag);
+
+    despatcher_.loadResource(vert);
+    despatcher_.loadResource(frag);
+
+    permutations_.setCreateFunction(std::bind(&QuadLighting::createPermutation, this, std::placeholders::_1));
+
+    if(samples > 1)
+    {
+        classifier_.reset(new SampleClassifier(gbuffer, despatcher, samples));
+    }
 }
 
 QuadLighting::~QuadLighting()
@@ -62,74 +82,234 @@ void QuadLighting::setRenderTarget(GLuint fbo)
     fbo_ = fbo;
 }
 
+void QuadLighting::setRenderScale(float scale)
+{
+    RenderStage::setRenderScale(scale);
+    renderScale_ = scale;
+}
+
 void QuadLighting::setShadowStage(ShadowStage* shadowStage)
 {
     shadowStage_ = shadowStage;
 }
 
+void QuadLighting::setShaderPermutations(bool enabled)
+{
+    usePermutations_ = enabled;
+
+    if(!enabled)
+    {
+        return;
+    }
+
+    // Start loading all permutations so they are ready when needed
+    for(int type = 0; type < Graph::Light::LIGHT_COUNT; ++type)
+    {
+        ShaderData::DefineMap defines = shaderDefines_;
+        Technique::IlluminationModel::permutationDefines(defines, static_cast<Graph::Light::LightType>(type), false);
+        permutations_.get(defines);
+    }
+
+    ShaderData::DefineMap defines = shaderDefines_;
+    Technique::IlluminationModel::permutationDefines(defines, Graph::Light::LIGHT_SPOT, true);
+    permutations_.get(defines);
+
+    defines = shaderDefines_;
+    Technique::IlluminationModel::permutationDefines(defines, Graph::Light::LIGHT_POINT, true);
+    permutations_.get(defines);
+}
+
+bool QuadLighting::shaderPermutations() const
+{
+    return usePermutations_;
+}
+
+SampleClassifier* QuadLighting::sampleClassifier() const
+{
+    return classifier_.get();
+}
+
 void QuadLighting::render()
 {
     RenderStage::render();
 
+    TRACE_GPU_SCOPE("Lightning pass");
+
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
     gl->glClear(GL_COLOR_BUFFER_BIT);
 
-    if(!lightningTech_.enable())
+    gbuffer_.bindTextures();
+    quad_->bindVaoDirect();
+
+    // Cache view matrix for positioning quads
+    viewMatrix_ = camera_->view();
+    viewMatrixInverse_ = viewMatrix_.inverted();
+
+    if(classifier_ != nullptr && classifier_->classify(*quad_))
     {
-        return;
+        // Uniform pixels are shaded once, edge pixels per sample
+        classifier_->beginPixelSet(SampleClassifier::PIXELS_UNIFORM);
+        renderLights(false);
+
+        classifier_->beginPixelSet(SampleClassifier::PIXELS_EDGE);
+        renderLights(true);
+
+        classifier_->endPixelSet();
     }
 
-    lightningTech_.setProjMatrix(camera_->projection());
-    lightningTech_.setCamera(*camera_);
-    lightningTech_.setViewport(viewport_);
-    lightningTech_.setDepthRange(camera_->nearPlane(), camera_->farPlane());
+    else
+    {
+        renderLights(true);
+    }
 
-    gbuffer_.bindTextures();
-    quad_->bindVaoDirect();
+    gl->glBindVertexArray(0);
+}
+
+void QuadLighting::renderLights(bool perSample)
+{
+    enabledTech_ = nullptr;
+    perSample_ = perSample;
 
     // Render directional light
     if(directionalLight_ != nullptr)
     {
-        lightningTech_.enableDirectionalLight(*directionalLight_);
-        quad_->renderDirect();
+        Technique::IlluminationModel* tech = enableTechnique(Graph::Light::LIGHT_DIRECTIONAL, false);
+        if(tech != nullptr)
+        {
+            tech->enableDirectionalLight(*directionalLight_);
+            quad_->renderDirect();
+        }
     }
 
-    // Cache view matrix for positioning quads
-    viewMatrix_ = camera_->view();
-    viewMatrixInverse_ = viewMatrix_.inverted();
-
     gl->glEnable(GL_BLEND);
     gl->glBlendFunc(GL_ONE, GL_ONE);
 
-    // Blend spotlights
-    for(Graph::Light* light : spotLights_)
+    // Blend spotlights. Shadowed lights are batched separately so the program
+    // or subroutine changes only once.
+    renderSpotLights(false);
+    renderSpotLights(true);
+
+    // Blend point lights
+    renderPointLights(false);
+    renderPointLights(true);
+
+    gl->glDisable(GL_BLEND);
+}
+
+void QuadLighting::renderPointLights(bool shadowed)
+{
+    for(Graph::Light* light : pointLights_)
     {
-        setSpotLightExtents(light);
-        
-        if(shadowStage_ != nullptr)
+        ShadowMap* shadow = shadowMap(light);
+        if((shadow != nullptr) != shadowed)
         {
-            lightningTech_.enableSpotLight(*light, shadowStage_->shadowMap(light));
+            continue;
         }
 
-        else
+        Technique::IlluminationModel* tech = enableTechnique(Graph::Light::LIGHT_POINT, shadowed);
+        if(tech == nullptr)
         {
-            lightningTech_.enableSpotLight(*light);
+            break;
         }
 
+        setPointLightExtents(tech, light);
+        tech->enablePointLight(*light, shadow);
+
         quad_->renderDirect();
     }
+}
 
-    // Blend point lights
-    for(Graph::Light* light : pointLights_)
+void QuadLighting::renderSpotLights(bool shadowed)
+{
+    for(Graph::Light* light : spotLights_)
     {
-        setPointLightExtents(light);
-        lightningTech_.enablePointLight(*light);
+        ShadowMap* shadow = shadowMap(light);
+        if((shadow != nullptr) != shadowed)
+        {
+            continue;
+        }
+
+        Technique::IlluminationModel* tech = enableTechnique(Graph::Light::LIGHT_SPOT, shadowed);
+        if(tech == nullptr)
+        {
+            break;
+        }
+
+        setSpotLightExtents(tech, light);
+        tech->enableSpotLight(*light, shadow);
 
         quad_->renderDirect();
     }
+}
 
-    gl->glBindVertexArray(0);
-    gl->glDisable(GL_BLEND);
+ShadowMap* QuadLighting::shadowMap(Graph::Light* light) const
+{
+    if(shadowStage_ == nullptr)
+    {
+        return nullptr;
+    }
+
+    return shadowStage_->shadowMap(light);
+}
+
+Technique::IlluminationModel* QuadLighting::enableTechnique(Graph::Light::LightType type, bool shadow)
+{
+    // The generic technique handles all light passes
+    if(enabledTech_ != nullptr && (!usePermutations_ || (type == enabledType_ && shadow == enabledShadow_)))
+    {
+        return enabledTech_;
+    }
+
+    Technique::IlluminationModel* tech = &lightningTech_;
+    if(usePermutations_)
+    {
+        ShaderData::DefineMap defines = shaderDefines_;
+        Technique::IlluminationModel::permutationDefines(defines, type, shadow);
+
+        tech = permutations_.get(defines);
+    }
+
+    if(camera_ == nullptr || !tech->enable())
+    {
+        return nullptr;
+    }
+
+    tech->setProjMatrix(camera_->projection());
+    tech->setCamera(*camera_);
+    tech->setViewport(scaledViewport(viewport_, renderScale_));
+    tech->setDepthRange(camera_->nearPlane(), camera_->farPlane());
+
+    if(classifier_ != nullptr)
+    {
+        tech->setPerSample(perSample_);
+    }
+
+    enabledTech_ = tech;
+    enabledType_ = type;
+    enabledShadow_ = shadow;
+
+    return tech;
+}
+
+std::shared_ptr<Technique::IlluminationModel> QuadLighting::createPermutation(const ShaderData::DefineMap& defines)
+{
+    auto type = static_cast<Graph::Light::LightType>(defines["LIGHT_TYPE"].toInt());
+    bool shadow = defines["SHADOW"].toBool();
+
+    auto tech = std::make_shared<Technique::IlluminationModel>(type, shadow);
+    tech->setGBuffer(&gbuffer_);
+
+    Shader::Ptr vert = std::make_shared<Shader>(RESOURCE_PATH("shaders/dsillumination.vert"), defines, Shader::Type::Vertex);
+    Shader::Ptr frag = std::make_shared<Shader>(RESOURCE_PATH("shaders/dsillumination.frag"), defines, Shader::Type::Fragment);
+
+    tech->addShader(vert);
+    tech->addShader(frag);
+
+    despatcher_.loadResource(vert);
+    despatcher_.loadResource(frag);
+
+    return tech;
 }
 
 void QuadLighting::visit(Graph::Light& light)
@@ -160,17 +340,17 @@ void QuadLighting::sceneInvalidated()
     directionalLight_ = nullptr;
 }
 
-void QuadLighting::setPointLightExtents(Graph::Light* light)
+void QuadLighting::setPointLightExtents(Technique::IlluminationModel* tech, Graph::Light* light)
 {
-    lightningTech_.setQuadExtents(light->cutoffDistance(),
+    tech->setQuadExtents(light->cutoffDistance(),
         calcQuadPosition(light->position(), light->cutoffDistance()));
 }
 
-void QuadLighting::setSpotLightExtents(Graph::Light* light)
+void QuadLighting::setSpotLightExtents(Technique::IlluminationModel* tech, Graph::Light* light)
 {
     QVector3D spotCenter = light->position() + light->direction() * light->cutoffDistance() / 2.0f;
 
-    lightningTech_.setQuadExtents(light->cutoffDistance(),
+    tech->setQuadExtents(light->cutoffDistance(),
         calcQuadPosition(spotCenter, light->cutoffDistance()));
 }
 
@@ -13,6 +13,10 @@
 
 #include "renderable/quad.h"
 #include "technique/illuminationmodel.h"
+#include "technique/permutationcache.h"
+#include "shaderdata.h"
+#include "sampleclassifier.h"
+#include "framevector.h"
 
 #include <QVector>
 #include <memory>
@@ -22,6 +26,7 @@ namespace Engine {
 class ResourceDespatcher;
 class GBuffer;
 class ShadowStage;
+class ShadowMap;
 
 class QuadLighting : public RenderStage, public SceneObserver,
     public BaseVisitor, public Visitor<Graph::Light>
@@ -50,19 +55,35 @@ public:
     // If fbo is nullptr, the default framebuffer (0) is used.
     virtual void setRenderTarget(GLuint fbo);
 
+    // Light passes reconstruct positions from the scaled sub-rect.
+    virtual void setRenderScale(float scale);
+
     virtual void visit(Graph::Light& light);
 
     virtual void sceneInvalidated();
 
     void setShadowStage(ShadowStage* shadowStage);
 
+    // If enabled, each light pass uses a program permutation specialised to the light type
+    // instead of switching subroutines of a generic program. Permutations are compiled
+    // asynchronously when first enabled.
+    void setShaderPermutations(bool enabled);
+    bool shaderPermutations() const;
+
+    // Edge pixels are classified into the render target's stencil when multisampling is used.
+    // Following stages may restrict rendering to the classified pixel sets.
+    // postcondition: nullptr if the gbuffer is not multisampled
+    SampleClassifier* sampleClassifier() const;
+
 private:
     GLuint fbo_;
     GBuffer& gbuffer_;
+    ResourceDespatcher& despatcher_;
     QRect viewport_;
+    float renderScale_;
 
-    QVector<Graph::Light*> spotLights_;
-    QVector<Graph::Light*> pointLights_;
+    FrameVector<Graph::Light*> spotLights_;
+    FrameVector<Graph::Light*> pointLights_;
     Graph::Light* directionalLight_;
     Graph::Camera* camera_;
     SceneObservable* observable_;
@@ -71,12 +92,36 @@ private:
     Technique::IlluminationModel lightningTech_;
     std::shared_ptr<Renderable::Quad> quad_;
 
+    typedef Technique::PermutationCache<Technique::IlluminationModel> PermutationCache;
+    PermutationCache permutations_;
+    ShaderData::DefineMap shaderDefines_;
+    bool usePermutations_;
+
+    // Currently enabled technique and the light pass it was enabled for
+    Technique::IlluminationModel* enabledTech_;
+    Graph::Light::LightType enabledType_;
+    bool enabledShadow_;
+
+    std::unique_ptr<SampleClassifier> classifier_;
+    bool perSample_;
+
     // Cached values
     QMatrix4x4 viewMatrix_;
     QMatrix4x4 viewMatrixInverse_;
 
-    void setPointLightExtents(Graph::Light* light);
-    void setSpotLightExtents(Graph::Light* light);
+    // Returns the enabled technique for the light pass, or nullptr if the technique is not ready.
+    // Per-frame uniforms are set when the technique changes.
+    Technique::IlluminationModel* enableTechnique(Graph::Light::LightType type, bool shadow);
+    std::shared_ptr<Technique::IlluminationModel> createPermutation(const ShaderData::DefineMap& defines);
+
+    // Renders every light restricted to the classified pixel set if multisampling is used.
+    void renderLights(bool perSample);
+    void renderSpotLights(bool shadowed);
+    void renderPointLights(bool shadowed);
+    ShadowMap* shadowMap(Graph::Light* light) const;
+
+    void setPointLightExtents(Technique::IlluminationModel* tech, Graph::Light* light);
+    void setSpotLightExtents(Technique::IlluminationModel* tech, Graph::Light* light);
 
     // Positions light so it faces the camera at the light's minZ extent.
     QVector3D calcQuadPosition(const QVector3D& lightPos, float lightCutoff);
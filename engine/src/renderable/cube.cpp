@@ -5,6 +5,8 @@
 
 #include "cube.h"
 
+#include "gpucounters.h"
+
 using namespace Engine;
 using namespace Renderable;
 
@@ -67,6 +69,7 @@ Cube::Cube()
     gl->glGenBuffers(1, &vertexBuffer_);
     gl->glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
     gl->glBufferData(GL_ARRAY_BUFFER, sizeof(VERTEX_DATA), VERTEX_DATA, GL_STATIC_DRAW);
+    GPU_COUNT(BUFFER_UPLOAD_BYTES, sizeof(VERTEX_DATA));
 
     // Set up vertex attributes
     // Vertices
@@ -102,5 +105,22 @@ void Cube::render() const
     
     gl->glDrawArrays(GL_TRIANGLES, 0, 6 * 2 * 3);
 
+    GPU_COUNT(DRAW_CALLS, 1);
+    GPU_COUNT(PRIMITIVES, 6 * 2);
+
+    gl->glBindVertexArray(0);
+}
+
+bool Cube::renderInstanced(int instances) const
+{
+    if(!bindVertexArray())
+        return true;
+
+    gl->glDrawArraysInstanced(GL_TRIANGLES, 0, 6 * 2 * 3, instances);
+
+    GPU_COUNT(DRAW_CALLS, 1);
+    GPU_COUNT(PRIMITIVES, 6 * 2 * instances);
+
     gl->glBindVertexArray(0);
+    return true;
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ public:
     ~Cube();
 
     virtual void render() const;
+    virtual bool renderInstanced(int instances) const;
 
 private:
     GLuint vertexBuffer_;
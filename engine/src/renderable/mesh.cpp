@@ -5,6 +5,8 @@
 
 #include "mesh.h"
 
+#include "gpucounters.h"
+
 #include <QDebug>
 
 using namespace Engine;
@@ -39,7 +41,24 @@ void Mesh::render() const
 
     gl->glDrawElements(GL_TRIANGLES, numIndices_, GL_UNSIGNED_INT, 0);
 
+    GPU_COUNT(DRAW_CALLS, 1);
+    GPU_COUNT(PRIMITIVES, numIndices_ / 3);
+
+    gl->glBindVertexArray(0);
+}
+
+bool Mesh::renderInstanced(int instances) const
+{
+    if(!bindVertexArray() || numIndices_ == 0)
+        return true;
+
+    gl->glDrawElementsInstanced(GL_TRIANGLES, numIndices_, GL_UNSIGNED_INT, 0, instances);
+
+    GPU_COUNT(DRAW_CALLS, 1);
+    GPU_COUNT(PRIMITIVES, numIndices_ / 3 * instances);
+
     gl->glBindVertexArray(0);
+    return true;
 }
 
 bool Mesh::initMesh( const QVector<QVector3D>& vertices,
@@ -89,6 +108,9 @@ bool Mesh::initMesh( const QVector<QVector3D>& vertices,
     gl->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[BINDEX]);
     gl->glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * indices.size(), &indices[0], GL_STATIC_DRAW);
 
+    GPU_COUNT(BUFFER_UPLOAD_BYTES, sizeof(vertices[0]) * vertices.size() + sizeof(uvs[0]) * uvs.size()
+        + sizeof(normals[0]) * normals.size() + sizeof(tangents[0]) * tangents.size() + sizeof(indices[0]) * indices.size());
+
     gl->glBindVertexArray(0);
 
     numIndices_ = indices.size();
@@ -25,6 +25,7 @@ public:
     virtual ~Mesh();
 
     virtual void render() const;
+    virtual bool renderInstanced(int instances) const;
 
     bool initMesh(const QVector<QVector3D>& vertices,
                   const QVector<QVector3D>& normals,
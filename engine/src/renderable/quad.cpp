@@ -5,6 +5,8 @@
 
 #include "quad.h"
 
+#include "gpucounters.h"
+
 using namespace Engine;
 using namespace Renderable;
 
@@ -29,6 +31,7 @@ Quad::Quad()
     gl->glGenBuffers(1, &vertexBuffer_);
     gl->glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
     gl->glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD_VERTEX_DATA), QUAD_VERTEX_DATA, GL_STATIC_DRAW);
+    GPU_COUNT(BUFFER_UPLOAD_BYTES, sizeof(QUAD_VERTEX_DATA));
 
     gl->glEnableVertexAttribArray(0);
     gl->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
@@ -66,4 +69,7 @@ void Quad::bindVaoDirect() const
 void Quad::renderDirect() const
 {
     gl->glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    GPU_COUNT(DRAW_CALLS, 1);
+    GPU_COUNT(PRIMITIVES, 2);
 }
\ No newline at end of file
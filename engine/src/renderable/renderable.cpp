@@ -21,6 +21,11 @@ Renderable::~Renderable()
     }
 }
 
+bool Renderable::renderInstanced(int /*instances*/) const
+{
+    return false;
+}
+
 bool Renderable::hasTangents() const
 {
     return hasTangents_;
@@ -25,6 +25,10 @@ public:
 
     virtual void render() const = 0;
 
+    // Draws the renderable instances times, shaders tell the instances apart by gl_InstanceID.
+    // Returns false if the renderable can't be drawn instanced.
+    virtual bool renderInstanced(int instances) const;
+
     virtual bool hasTangents() const;
 
     // Returns the minimum bounding box that covers vertex extremes
@@ -50,8 +50,20 @@ public:
     // Renders the scene to a render target instead of the default surface.
     // If fbo is 0, the default framebuffer is used.
     virtual void setRenderTarget(GLuint fbo) = 0;
+
+    // Renders the scene into a sub-rect of the viewport without reallocating buffers.
+    // Renderers which don't support scaling ignore this.
+    // precondition: 0 < scale <= 1
+    virtual void setRenderScale(float scale) {};
 };
 
+// Returns the sub-rect of viewport covered by the given render scale.
+inline QRect scaledViewport(const QRect& viewport, float scale)
+{
+    return QRect(viewport.x(), viewport.y(),
+        qMax(1, qRound(viewport.width() * scale)), qMax(1, qRound(viewport.height() * scale)));
+}
+
 };
 
 #endif // RENDERER_H
\ No newline at end of file
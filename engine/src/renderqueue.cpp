@@ -20,6 +20,11 @@ void RenderQueue::setModelView(const QMatrix4x4* modelView)
     modelView_ = modelView;
 }
 
+const QMatrix4x4* RenderQueue::modelView() const
+{
+    return modelView_;
+}
+
 void RenderQueue::addNode(Material* material, Renderable::Renderable* renderable)
 {
     stacks_[material->renderType()].push_back({ modelView_, material, renderable });
@@ -35,6 +40,17 @@ void RenderQueue::clear()
     modelView_ = nullptr;
 }
 
+int RenderQueue::count() const
+{
+    int items = 0;
+    for(const auto& list : stacks_)
+    {
+        items += list.count();
+    }
+
+    return items;
+}
+
 RenderQueue::RenderRange RenderQueue::getItems(Material::RenderType renderIndex)
 {
     const RenderList& list = stacks_[renderIndex];
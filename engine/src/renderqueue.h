@@ -1,17 +1,19 @@
 //
 //  Author   : Matti Määttä
-//  Summary  : RenderQueue allows organised access to the culled geometry.
+//  Summary  : RenderQueue allows organised access to the culled geometry. The items are
+//             allocated from the FrameArena, so the queue has to be refilled every frame.
 //
 
 #ifndef RENDERQUEUE_H
 #define RENDERQUEUE_H
 
 #include <QMatrix4x4>
-#include <QList>
+#include <QPair>
 
 #include <array>
 
 #include "material.h"
+#include "framevector.h"
 
 namespace Engine {
 
@@ -34,6 +36,7 @@ public:
     // Sets transformation matrix for future addNode calls
     // precondition: modelView != nullptr
     void setModelView(const QMatrix4x4* modelView);
+    const QMatrix4x4* modelView() const;
 
     // Queues a new RenderItem under the set model view matrix
     // precondition: model view matrix set, material != nullptr, renderable != nullptr
@@ -42,12 +45,15 @@ public:
     // Clears the RenderList.
     void clear();
 
+    // Number of queued RenderItems in all render categories.
+    int count() const;
+
     // Sorts the RenderItems in each render category.
     // Comparator has to be a less-than functor that compares two RenderItem references.
     template<typename Comparator>
     void sort(const Comparator& lessThan);
 
-    typedef QList<RenderItem> RenderList;
+    typedef FrameVector<RenderItem> RenderList;
     typedef QPair<RenderList::ConstIterator, RenderList::ConstIterator> RenderRange;
 
     // Returns iterators to the RenderList based on RenderType.
@@ -56,6 +62,9 @@ public:
 private:
     const QMatrix4x4* modelView_;
     std::array<RenderList, Material::RENDER_COUNT> stacks_;
+
+    RenderQueue(const RenderQueue&);
+    RenderQueue& operator=(const RenderQueue&);
 };
 
 #include "renderqueue.inl"
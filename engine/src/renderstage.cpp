@@ -47,4 +47,9 @@ void RenderStage::render()
 void RenderStage::setRenderTarget(GLuint fbo)
 {
     renderer_->setRenderTarget(fbo);
+}
+
+void RenderStage::setRenderScale(float scale)
+{
+    renderer_->setRenderScale(scale);
 }
\ No newline at end of file
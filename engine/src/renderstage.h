@@ -46,6 +46,9 @@ public:
     // If fbo is 0, the default framebuffer is used.
     virtual void setRenderTarget(GLuint fbo);
 
+    // Renders the scene into a sub-rect of the viewport without reallocating buffers.
+    virtual void setRenderScale(float scale);
+
 signals:
     // Emitted when the previous stage has finished rendering.
     void stageFinished();
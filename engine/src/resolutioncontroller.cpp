@@ -0,0 +1,108 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "resolutioncontroller.h"
+
+#include <QtGlobal>
+
+using namespace Engine;
+
+namespace {
+    // Relative errors smaller than this hold the current scale to avoid hunting
+    const float DEADBAND = 0.02f;
+}
+
+ResolutionController::ResolutionController(float targetTime)
+    : targetTime_(targetTime), minScale_(0.5f), maxScale_(1.0f),
+    kp_(0.1f), ki_(0.05f), kd_(0.05f)
+{
+    reset();
+}
+
+void ResolutionController::setTargetTime(float targetTime)
+{
+    targetTime_ = targetTime;
+}
+
+float ResolutionController::targetTime() const
+{
+    return targetTime_;
+}
+
+void ResolutionController::setBounds(float minScale, float maxScale)
+{
+    minScale_ = minScale;
+    maxScale_ = maxScale;
+
+    scale_ = qBound(minScale_, scale_, maxScale_);
+}
+
+float ResolutionController::minScale() const
+{
+    return minScale_;
+}
+
+float ResolutionController::maxScale() const
+{
+    return maxScale_;
+}
+
+void ResolutionController::setGains(float kp, float ki, float kd)
+{
+    kp_ = kp;
+    ki_ = ki;
+    kd_ = kd;
+}
+
+float ResolutionController::update(float frameTime)
+{
+    // Relative error; positive when there is headroom left
+    float error = qBound(-1.0f, (targetTime_ - frameTime) / targetTime_, 1.0f);
+    if(qAbs(error) < DEADBAND)
+    {
+        error = 0.0f;
+    }
+
+    float derivative = hasPrevious_ ? error - previousError_ : 0.0f;
+    previousError_ = error;
+    hasPrevious_ = true;
+
+    float integral = integral_ + error;
+    float output = maxScale_ + kp_ * error + ki_ * integral + kd_ * derivative;
+
+    // Integrate only while unsaturated, or when the error pulls back inside the bounds
+    if(output > maxScale_)
+    {
+        output = maxScale_;
+    }
+
+    else if(output < minScale_)
+    {
+        output = minScale_;
+    }
+
+    if((output < maxScale_ && output > minScale_)
+        || (output == maxScale_ && error < 0.0f)
+        || (output == minScale_ && error > 0.0f))
+    {
+        integral_ = integral;
+    }
+
+    scale_ = output;
+    return scale_;
+}
+
+float ResolutionController::scale() const
+{
+    return scale_;
+}
+
+void ResolutionController::reset()
+{
+    scale_ = maxScale_;
+    integral_ = 0.0f;
+    previousError_ = 0.0f;
+    hasPrevious_ = false;
+}
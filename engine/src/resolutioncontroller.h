@@ -0,0 +1,57 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : ResolutionController adjusts the render scale towards a frame time budget
+//             using a PID controller. It has no OpenGL dependencies; frame times are fed
+//             from GPU timer queries or synthetic traces.
+//
+
+#ifndef RESOLUTIONCONTROLLER_H
+#define RESOLUTIONCONTROLLER_H
+
+namespace Engine {
+
+class ResolutionController
+{
+public:
+    // targetTime is the frame time budget in milliseconds.
+    explicit ResolutionController(float targetTime = 16.0f);
+
+    void setTargetTime(float targetTime);
+    float targetTime() const;
+
+    // Sets the render scale bounds. The scale is clamped to the new bounds.
+    // precondition: 0 < minScale <= maxScale
+    void setBounds(float minScale, float maxScale);
+    float minScale() const;
+    float maxScale() const;
+
+    // Sets the proportional, integral and derivative gains.
+    void setGains(float kp, float ki, float kd);
+
+    // Feeds a measured frame time in milliseconds and returns the new render scale.
+    // precondition: frameTime > 0
+    float update(float frameTime);
+
+    float scale() const;
+
+    // Resets the controller state and the scale to maxScale.
+    void reset();
+
+private:
+    float targetTime_;
+    float minScale_;
+    float maxScale_;
+
+    float kp_;
+    float ki_;
+    float kd_;
+
+    float scale_;
+    float integral_;
+    float previousError_;
+    bool hasPrevious_;
+};
+
+}
+
+#endif // RESOLUTIONCONTROLLER_H
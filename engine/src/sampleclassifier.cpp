@@ -0,0 +1,66 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "sampleclassifier.h"
+
+#include "resourcedespatcher.h"
+#include "gbuffer.h"
+
+using namespace Engine;
+
+SampleClassifier::SampleClassifier(const GBuffer& gbuffer, ResourceDespatcher& despatcher, unsigned int samples)
+    : gbuffer_(gbuffer)
+{
+    ShaderData::DefineMap defines;
+    defines.insert("SAMPLES", samples);
+
+    classifyTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/passthrough.vert"), Shader::Type::Vertex));
+    classifyTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/sampleclassify.frag"), defines, Shader::Type::Fragment));
+}
+
+SampleClassifier::~SampleClassifier()
+{
+}
+
+bool SampleClassifier::classify(const Renderable::Quad& quad)
+{
+    gl->glClearStencil(PIXELS_UNIFORM);
+    gl->glClear(GL_STENCIL_BUFFER_BIT);
+
+    if(!classifyTech_.enable())
+    {
+        // Nothing is marked, so edges are shaded only once until the program is ready
+        return false;
+    }
+
+    QList<QString> textures = gbuffer_.textures();
+    classifyTech_.setUniformValue("normalSpecData", textures.indexOf("normalSpec"));
+    classifyTech_.setUniformValue("diffuseSpecData", textures.indexOf("diffuseSpec"));
+
+    // Only the stencil is written; uniform pixels are discarded by the shader
+    gl->glEnable(GL_STENCIL_TEST);
+    gl->glStencilFunc(GL_ALWAYS, PIXELS_EDGE, 0xFF);
+    gl->glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    gl->glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    quad.renderDirect();
+
+    gl->glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    gl->glDisable(GL_STENCIL_TEST);
+
+    return true;
+}
+
+void SampleClassifier::beginPixelSet(PixelSet set)
+{
+    gl->glEnable(GL_STENCIL_TEST);
+    gl->glStencilFunc(GL_EQUAL, set, 0xFF);
+    gl->glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+}
+
+void SampleClassifier::endPixelSet()
+{
+    gl->glDisable(GL_STENCIL_TEST);
+}
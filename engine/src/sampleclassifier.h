@@ -0,0 +1,48 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : SampleClassifier marks the gbuffer pixels whose samples differ into the stencil
+//             buffer. Following passes shade the uniform pixels once and resolve per sample
+//             only on the edge pixels.
+//
+
+#ifndef SAMPLECLASSIFIER_H
+#define SAMPLECLASSIFIER_H
+
+#include "renderable/quad.h"
+#include "technique/technique.h"
+
+namespace Engine {
+
+class ResourceDespatcher;
+class GBuffer;
+
+class SampleClassifier
+{
+public:
+    // Stencil reference values of the pixel sets
+    enum PixelSet { PIXELS_UNIFORM, PIXELS_EDGE };
+
+    SampleClassifier(const GBuffer& gbuffer, ResourceDespatcher& despatcher, unsigned int samples);
+    ~SampleClassifier();
+
+    // Clears the stencil of the bound framebuffer and marks the edge pixels.
+    // precondition: framebuffer has a stencil attachment, gbuffer textures are bound,
+    //               quad must be bound for direct rendering.
+    bool classify(const Renderable::Quad& quad);
+
+    // Restricts rendering to the given pixel set until endPixelSet is called.
+    // precondition: classify has been called for the bound framebuffer
+    void beginPixelSet(PixelSet set);
+    void endPixelSet();
+
+private:
+    const GBuffer& gbuffer_;
+    Technique::Technique classifyTech_;
+
+    SampleClassifier(const SampleClassifier&);
+    SampleClassifier& operator=(const SampleClassifier&);
+};
+
+}
+
+#endif // SAMPLECLASSIFIER_H
@@ -0,0 +1,157 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "assetiosystem.h"
+#include "assetfile.h"
+
+#include <assimp/IOStream.hpp>
+
+#include <QByteArray>
+#include <QString>
+
+#include <cstring>
+
+using namespace Engine;
+
+namespace {
+    // Read-only stream over the contents of a file
+    class AssetIOStream : public Assimp::IOStream
+    {
+    public:
+        explicit AssetIOStream(const QByteArray& data);
+
+        virtual size_t Read(void* pvBuffer, size_t pSize, size_t pCount);
+        virtual size_t Write(const void* pvBuffer, size_t pSize, size_t pCount);
+        virtual aiReturn Seek(size_t pOffset, aiOrigin pOrigin);
+        virtual size_t Tell() const;
+        virtual size_t FileSize() const;
+        virtual void Flush();
+
+    private:
+        QByteArray data_;
+        size_t pos_;
+    };
+}
+
+AssetIOSystem::AssetIOSystem()
+    : Assimp::IOSystem()
+{
+}
+
+AssetIOSystem::~AssetIOSystem()
+{
+}
+
+bool AssetIOSystem::Exists(const char* pFile) const
+{
+    return AssetFile::exists(QString::fromUtf8(pFile));
+}
+
+char AssetIOSystem::getOsSeparator() const
+{
+    // AssetFile accepts both separators
+    return '/';
+}
+
+Assimp::IOStream* AssetIOSystem::Open(const char* pFile, const char* pMode)
+{
+    if(std::strchr(pMode, 'w') != nullptr || std::strchr(pMode, 'a') != nullptr)
+    {
+        return nullptr;
+    }
+
+    QByteArray data;
+    if(!AssetFile::read(QString::fromUtf8(pFile), data))
+    {
+        return nullptr;
+    }
+
+    return new AssetIOStream(data);
+}
+
+void AssetIOSystem::Close(Assimp::IOStream* pFile)
+{
+    delete pFile;
+}
+
+namespace {
+    AssetIOStream::AssetIOStream(const QByteArray& data)
+        : Assimp::IOStream(), data_(data), pos_(0)
+    {
+    }
+
+    size_t AssetIOStream::Read(void* pvBuffer, size_t pSize, size_t pCount)
+    {
+        if(pSize == 0)
+        {
+            return 0;
+        }
+
+        // Only whole elements are read
+        const size_t count = qMin(pCount, (FileSize() - pos_) / pSize);
+        std::memcpy(pvBuffer, data_.constData() + pos_, count * pSize);
+        pos_ += count * pSize;
+
+        return count;
+    }
+
+    size_t AssetIOStream::Write(const void* pvBuffer, size_t pSize, size_t pCount)
+    {
+        return 0;
+    }
+
+    aiReturn AssetIOStream::Seek(size_t pOffset, aiOrigin pOrigin)
+    {
+        size_t pos = 0;
+        switch(pOrigin)
+        {
+        case aiOrigin_SET:
+            {
+                pos = pOffset;
+                break;
+            }
+
+        case aiOrigin_CUR:
+            {
+                pos = pos_ + pOffset;
+                break;
+            }
+
+        case aiOrigin_END:
+            {
+                // The offset is unsigned, so it can only seek to the end
+                pos = FileSize() - pOffset;
+                break;
+            }
+
+        default:
+            {
+                return aiReturn_FAILURE;
+            }
+        }
+
+        if(pos > FileSize())
+        {
+            return aiReturn_FAILURE;
+        }
+
+        pos_ = pos;
+        return aiReturn_SUCCESS;
+    }
+
+    size_t AssetIOStream::Tell() const
+    {
+        return pos_;
+    }
+
+    size_t AssetIOStream::FileSize() const
+    {
+        return static_cast<size_t>(data_.size());
+    }
+
+    void AssetIOStream::Flush()
+    {
+    }
+}
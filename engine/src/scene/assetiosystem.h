@@ -0,0 +1,35 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : AssetIOSystem lets Assimp open model files, and the files they reference, through
+//             AssetFile. Files are read in one go, so packed models are imported straight from
+//             the archive mapping.
+//
+
+#ifndef ASSETIOSYSTEM_H
+#define ASSETIOSYSTEM_H
+
+#include <assimp/IOSystem.hpp>
+
+namespace Engine {
+
+class AssetIOSystem : public Assimp::IOSystem
+{
+public:
+    AssetIOSystem();
+    virtual ~AssetIOSystem();
+
+    virtual bool Exists(const char* pFile) const;
+    virtual char getOsSeparator() const;
+
+    // Only read modes are supported.
+    virtual Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb");
+    virtual void Close(Assimp::IOStream* pFile);
+
+private:
+    AssetIOSystem(const AssetIOSystem&);
+    AssetIOSystem& operator=(const AssetIOSystem&);
+};
+
+}
+
+#endif // ASSETIOSYSTEM_H
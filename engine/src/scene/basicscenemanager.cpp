@@ -7,18 +7,26 @@
 
 #include "graph/sceneleaf.h"
 #include "graph/camera.h"
+#include "graph/light.h"
 #include "frustum.h"
 #include "renderer.h"
 #include "cubemaptexture.h"
 #include "renderitemsorter.h"
+#include "tracer.h"
 
 #include <QDebug>
 
 using namespace Engine;
 
 BasicSceneManager::BasicSceneManager()
-    : renderer_(nullptr)
+    : renderer_(nullptr), deferViews_(false), pipelined_(false), frontFrame_(0)
 {
+    stats_.leaves = 0;
+    stats_.visibleLeaves = 0;
+    stats_.renderItems = 0;
+    stats_.views = 0;
+
+    clearFrames();
     addVisitor(this);
 }
 
@@ -30,6 +38,25 @@ BasicSceneManager::~BasicSceneManager()
 // Precondition: Renderer set
 void BasicSceneManager::renderFrame()
 {
+    TRACE_SCOPE("Render frame");
+
+    if(pipelined_)
+    {
+        FrameSnapshot& frame = frames_[frontFrame_];
+        if(frame.camera != nullptr)
+        {
+            renderer_->setGeometryBatch(&frame.queue);
+            renderer_->render();
+
+            for(const FrameSnapshot::View& view : frame.views)
+            {
+                renderView(view.renderer, view.camera.get(), view.queue.get());
+            }
+        }
+
+        return;
+    }
+
     if(culledCameras_.empty())
     {
         return;
@@ -37,11 +64,24 @@ void BasicSceneManager::renderFrame()
 
     renderer_->setGeometryBatch(&culledGeometry_);
     renderer_->render();
+
+    for(const CameraView& view : cameraViews_)
+    {
+        renderView(view.renderer, view.camera, view.queue.get());
+    }
 }
 
 // Culls visible scene leaves for rendering.
 void BasicSceneManager::prepareNextFrame()
 {
+    TRACE_SCOPE("Prepare frame");
+
+    if(pipelined_)
+    {
+        captureFrame(frames_[1 - frontFrame_]);
+        return;
+    }
+
     // If no cameras were previously culled, find all cameras in the scene
     if(culledCameras_.empty())
     {
@@ -53,6 +93,16 @@ void BasicSceneManager::prepareNextFrame()
 
     notify(&SceneObserver::sceneInvalidated);
     culledGeometry_.clear();
+    culler_.clear();
+
+    for(const CameraView& view : cameraViews_)
+    {
+        view.queue->clear();
+    }
+
+    stats_.leaves = 0;
+    stats_.visibleLeaves = 0;
+    stats_.views = 0;
 
     // If scene contains no cameras, there is nothing to cull
     if(culledCameras_.empty())
@@ -69,14 +119,113 @@ void BasicSceneManager::prepareNextFrame()
     renderer_->setCamera(camera);
 
     // Cull visible geometry and lights
-    findVisibleLeaves(camera->worldView(), culledGeometry_);
+    cullViews(camera);
 
     // Sort visible geometry
     culledGeometry_.sort(RenderItemSorter());
+    stats_.renderItems = culledGeometry_.count();
+
+    for(const CameraView& view : cameraViews_)
+    {
+        view.queue->sort(RenderItemSorter());
+    }
+}
+
+void BasicSceneManager::setPipelined(bool pipelined)
+{
+    if(pipelined_ == pipelined)
+    {
+        return;
+    }
+
+    pipelined_ = pipelined;
+
+    // Both modes start from an empty frame; the previous one may reference removed leaves
+    notify(&SceneObserver::sceneInvalidated);
+    culledGeometry_.clear();
+    culler_.clear();
+    clearFrames();
+}
+
+bool BasicSceneManager::pipelined() const
+{
+    return pipelined_;
+}
+
+void BasicSceneManager::swapFrames()
+{
+    frontFrame_ = 1 - frontFrame_;
+    FrameSnapshot& frame = frames_[frontFrame_];
+
+    notify(&SceneObserver::sceneInvalidated);
+    stats_ = frame.stats;
+
+    if(frame.camera != nullptr)
+    {
+        if(renderer_ != nullptr)
+        {
+            renderer_->setCamera(frame.camera.get());
+        }
+
+        // Leaves were queued by captureFrame, so the result of beforeRendering is ignored
+        deferViews_ = true;
+
+        for(const FrameSnapshot::Instance& instance : frame.instances)
+        {
+            if(!instance.visible)
+            {
+                continue;
+            }
+
+            notify(&SceneObserver::beforeRendering, instance.leaf.get(), instance.node);
+
+            for(BaseVisitor* visitor : visitors_)
+            {
+                instance.visitable->accept(*visitor);
+            }
+        }
+
+        notify(&SceneObserver::leavesVisited);
+        deferViews_ = false;
+
+        // Shadow frusta of the visible lights
+        frame.culler.cull();
+        stats_.views = frame.culler.viewCount();
+    }
+
+    // Release the previous frame here, so the last references to removed leaves
+    // are dropped on the render thread.
+    frames_[1 - frontFrame_].clear();
 }
 
-void BasicSceneManager::findVisibleLeaves(const QMatrix4x4& viewProj, RenderQueue& queue)
+void BasicSceneManager::captureFrame(FrameSnapshot& frame)
 {
+    frame.clear();
+
+    // If no cameras were previously culled, find all cameras in the scene
+    if(culledCameras_.empty())
+    {
+        for(const SceneLeafPtr& leaf : leaves_)
+        {
+            leaf->accept(*this);
+        }
+    }
+
+    if(culledCameras_.empty())
+    {
+        return;
+    }
+
+    rootNode_.propagate();
+
+    Graph::Camera* camera = culledCameras_.first();
+    camera->setAspectRatio(static_cast<float>(viewport_.width()) / viewport_.height());
+    camera->update();
+
+    // Captured camera and lights are detached, so they don't read the scene graph during rendering
+    frame.camera = captureCamera(*camera);
+    frame.instances.reserve(leaves_.count());
+
     for(const SceneLeafPtr& leaf : leaves_)
     {
         Graph::SceneNode* node = leaf->parentNode();
@@ -87,24 +236,198 @@ void BasicSceneManager::findVisibleLeaves(const QMatrix4x4& viewProj, RenderQueu
             continue;
         }
 
-        queue.setModelView(&node->transformation());
-        if(isInsideFrustum(leaf->boundingBox(), viewProj * node->transformation()))
+        FrameSnapshot::Instance instance;
+        instance.leaf = leaf;
+        instance.visitable = leaf;
+        instance.node = node;
+        instance.transformation = node->transformation();
+        instance.visible = false;
+
+        frame.instances.push_back(instance);
+    }
+
+    frame.stats.leaves = frame.instances.count();
+
+    // Instances are not reallocated after this, so the model view pointers stay valid
+    for(FrameSnapshot::Instance& instance : frame.instances)
+    {
+        frame.culler.addLeaf(instance.leaf.get(), instance.node, &instance.transformation);
+    }
+
+    // The camera views are culled in the same pass as the camera
+    frame.culler.addView(camera->worldView(), nullptr, nullptr);
+
+    for(const CameraView& view : cameraViews_)
+    {
+        view.camera->update();
+
+        FrameSnapshot::View captured;
+        captured.camera = captureCamera(*view.camera);
+        captured.renderer = view.renderer;
+        captured.queue = std::make_shared<RenderQueue>();
+
+        frame.culler.addView(view.camera->worldView(), captured.queue.get(), nullptr);
+        frame.views.push_back(captured);
+    }
+
+    frame.culler.cull();
+
+    for(int i = 0; i < frame.instances.count(); ++i)
+    {
+        FrameSnapshot::Instance& instance = frame.instances[i];
+        instance.visible = (frame.culler.visibility(i) & 1) != 0;
+
+        if(!instance.visible)
         {
-            if(notify(&SceneObserver::beforeRendering, leaf.get(), node))
+            continue;
+        }
+
+        ++frame.stats.visibleLeaves;
+
+        Graph::Light* light = dynamic_cast<Graph::Light*>(instance.leaf.get());
+        if(light != nullptr)
+        {
+            std::shared_ptr<Graph::Light> copy = std::make_shared<Graph::Light>(*light);
+            copy->setPosition(light->position());
+            copy->detach();
+
+            instance.visitable = copy;
+        }
+
+        frame.queue.setModelView(&instance.transformation);
+        instance.leaf->updateRenderList(frame.queue);
+    }
+
+    frame.queue.sort(RenderItemSorter());
+    frame.stats.renderItems = frame.queue.count();
+
+    for(const FrameSnapshot::View& view : frame.views)
+    {
+        view.queue->sort(RenderItemSorter());
+    }
+}
+
+void BasicSceneManager::clearFrames()
+{
+    frames_[0].clear();
+    frames_[1].clear();
+}
+
+void BasicSceneManager::FrameSnapshot::clear()
+{
+    camera.reset();
+    instances.clear();
+    queue.clear();
+    views.clear();
+    culler.clear();
+
+    stats.leaves = 0;
+    stats.visibleLeaves = 0;
+    stats.renderItems = 0;
+    stats.views = 0;
+}
+
+void BasicSceneManager::cullViews(Graph::Camera* camera)
+{
+    for(const SceneLeafPtr& leaf : leaves_)
+    {
+        Graph::SceneNode* node = leaf->parentNode();
+
+        // Skip nodes that are not attached to scenegraph
+        if(node != nullptr)
+        {
+            culler_.addLeaf(leaf.get(), node, &node->transformation());
+        }
+    }
+
+    stats_.leaves = culler_.leafCount();
+
+    // The camera views are culled in the same pass as the camera
+    culler_.addView(camera->worldView(), nullptr, nullptr);
+
+    for(const CameraView& view : cameraViews_)
+    {
+        view.camera->update();
+        culler_.addView(view.camera->worldView(), view.queue.get(), nullptr);
+    }
+
+    culler_.cull();
+
+    // Views added by the visitors, eg. the shadow frusta of visible lights, are culled together
+    // after all visible leaves have been visited.
+    deferViews_ = true;
+
+    for(int i = 0; i < culler_.leafCount(); ++i)
+    {
+        if((culler_.visibility(i) & 1) == 0)
+        {
+            continue;
+        }
+
+        Graph::SceneLeaf* leaf = culler_.leaf(i);
+        Graph::SceneNode* node = culler_.node(i);
+
+        ++stats_.visibleLeaves;
+
+        culledGeometry_.setModelView(&node->transformation());
+        if(notify(&SceneObserver::beforeRendering, leaf, node))
+        {
+            leaf->updateRenderList(culledGeometry_);
+        }
+
+        for(BaseVisitor* visitor : visitors_)
+        {
+            leaf->accept(*visitor);
+        }
+    }
+
+    notify(&SceneObserver::leavesVisited);
+    deferViews_ = false;
+
+    culler_.cull();
+    stats_.views = culler_.viewCount();
+}
+
+void BasicSceneManager::renderView(Renderer* renderer, Graph::Camera* camera, RenderQueue* queue)
+{
+    renderer->setCamera(camera);
+    renderer->setGeometryBatch(queue);
+    renderer->render();
+}
+
+std::shared_ptr<Graph::Camera> BasicSceneManager::captureCamera(Graph::Camera& camera)
+{
+    std::shared_ptr<Graph::Camera> copy = std::make_shared<Graph::Camera>(camera);
+    copy->setPosition(camera.position());
+    copy->setOrientation(camera.orientation());
+    copy->detach();
+
+    return copy;
+}
+
+void BasicSceneManager::findVisibleLeaves(const QMatrix4x4& frustum, RenderQueue& queue, AcceptVisibleLeaf acceptFunc)
+{
+    const Simd::Mat4 viewProj = Simd::Mat4::fromQt(frustum);
+
+    if(pipelined_)
+    {
+        for(const FrameSnapshot::Instance& instance : frames_[frontFrame_].instances)
+        {
+            if(acceptFunc != nullptr && !acceptFunc(*instance.leaf, *instance.node))
             {
-                leaf->updateRenderList(queue);
+                continue;
             }
 
-            for(BaseVisitor* visitor : visitors_)
+            queue.setModelView(&instance.transformation);
+            if(isInsideFrustum(instance.leaf->boundingBox(), viewProj * Simd::Mat4::fromQt(instance.transformation)))
             {
-                leaf->accept(*visitor);
+                instance.leaf->updateRenderList(queue);
             }
         }
+
+        return;
     }
-}
 
-void BasicSceneManager::findVisibleLeaves(const QMatrix4x4& frustum, RenderQueue& queue, AcceptVisibleLeaf acceptFunc)
-{
     for(const SceneLeafPtr& leaf : leaves_)
     {
         Graph::SceneNode* node = leaf->parentNode();
@@ -116,13 +439,62 @@ void BasicSceneManager::findVisibleLeaves(const QMatrix4x4& frustum, RenderQueue
         }
 
         queue.setModelView(&node->transformation());
-        if(isInsideFrustum(leaf->boundingBox(), frustum * node->transformation()))
+        if(isInsideFrustum(leaf->boundingBox(), viewProj * Simd::Mat4::fromQt(node->transformation())))
         {
             leaf->updateRenderList(queue);
         }
     }
 }
 
+void BasicSceneManager::addCullView(const QMatrix4x4& frustum, RenderQueue& queue, AcceptVisibleLeaf acceptFunc)
+{
+    ViewCuller& culler = pipelined_ ? frames_[frontFrame_].culler : culler_;
+
+    // Views beyond the culler's capacity get their own pass
+    if(!deferViews_ || culler.addView(frustum, &queue, acceptFunc) == -1)
+    {
+        findVisibleLeaves(frustum, queue, acceptFunc);
+    }
+}
+
+void BasicSceneManager::addCameraView(Graph::Camera* camera, Renderer* renderer)
+{
+    renderer->setObservable(this);
+    notify(&SceneObserver::skyboxTextureUpdated, skybox_.get());
+
+    for(CameraView& view : cameraViews_)
+    {
+        if(view.camera == camera)
+        {
+            view.renderer = renderer;
+            return;
+        }
+    }
+
+    Q_ASSERT(cameraViews_.count() < ViewCuller::MAX_VIEWS - 1);
+
+    CameraView view;
+    view.camera = camera;
+    view.renderer = renderer;
+    view.queue = std::make_shared<RenderQueue>();
+
+    cameraViews_.push_back(view);
+}
+
+bool BasicSceneManager::removeCameraView(Graph::Camera* camera)
+{
+    for(int i = 0; i < cameraViews_.count(); ++i)
+    {
+        if(cameraViews_[i].camera == camera)
+        {
+            cameraViews_.remove(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 // Sets the renderer used to render the scene.
 // Precondition: renderer != nullptr
 void BasicSceneManager::setRenderer(Renderer* renderer)
@@ -137,7 +509,15 @@ void BasicSceneManager::setRenderer(Renderer* renderer)
     renderer_->setObservable(this);
     notify(&SceneObserver::skyboxTextureUpdated, skybox_.get());
 
-    if(!culledCameras_.empty())
+    if(pipelined_)
+    {
+        if(frames_[frontFrame_].camera != nullptr)
+        {
+            renderer_->setCamera(frames_[frontFrame_].camera.get());
+        }
+    }
+
+    else if(!culledCameras_.empty())
     {
         renderer_->setCamera(culledCameras_.first());
     }
@@ -189,6 +569,8 @@ bool BasicSceneManager::removeSceneLeaf(const SceneLeafPtr& leaf)
         {
             culledCameras_.remove(i);
         }
+
+        removeCameraView(camera);
     }
 
     leaves_.remove(index);
@@ -199,7 +581,10 @@ bool BasicSceneManager::removeSceneLeaf(const SceneLeafPtr& leaf)
 void BasicSceneManager::eraseScene()
 {
     culledCameras_.clear();
+    cameraViews_.clear();
+    culler_.clear();
     leaves_.clear();
+    clearFrames();
     setSkyboxCubemap(nullptr);
 
 	// Clear SceneGraph and reset tranformation
@@ -224,6 +609,11 @@ void BasicSceneManager::removeVisitor(BaseVisitor* visitor)
     visitors_.remove(visitor);
 }
 
+const BasicSceneManager::Stats& BasicSceneManager::stats() const
+{
+    return stats_;
+}
+
 void BasicSceneManager::visit(Graph::Camera& camera)
 {
     if(culledCameras_.indexOf(&camera) == -1)
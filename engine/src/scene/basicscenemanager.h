@@ -13,9 +13,12 @@
 #include "visitor.h"
 #include "graph/scenenode.h"
 #include "renderqueue.h"
+#include "viewculler.h"
 
 #include <QVector>
 #include <QSet>
+#include <QMatrix4x4>
+#include <memory>
 
 namespace Engine {
 
@@ -38,6 +41,18 @@ public:
     // Culls visible scene leaves for rendering.
     virtual void prepareNextFrame();
 
+    // In pipelined mode prepareNextFrame only captures the next frame into a snapshot, and may
+    // run on a worker thread while the previous frame is being rendered. Observers, visitors and
+    // the renderer are not called until swapFrames.
+    // precondition: not called during prepareNextFrame
+    void setPipelined(bool pipelined);
+    bool pipelined() const;
+
+    // Publishes the frame captured by the last prepareNextFrame. Visible leaves are replayed to
+    // observers and visitors, and the renderer is given the captured camera and render queue.
+    // precondition: pipelined, prepareNextFrame has returned
+    void swapFrames();
+
     // Sets the renderer used to render the scene.
     // Precondition: renderer != nullptr
     virtual void setRenderer(Renderer* renderer);
@@ -73,13 +88,36 @@ public:
     virtual void removeVisitor(BaseVisitor* visitor);
 
     // Queries a list of visible scene leaves inside the given frustum. If acceptFunc is not null,
-    // the leaf can be rejected by returning false.
+    // the leaf can be rejected by returning false. In pipelined mode the leaves and transformations
+    // of the current frame snapshot are used.
     virtual void findVisibleLeaves(const QMatrix4x4& frustum, RenderQueue& queue, AcceptVisibleLeaf acceptFunc);
 
+    // Views added while the visible leaves are visited are culled in one pass over the leaves
+    // once all of them have been visited.
+    virtual void addCullView(const QMatrix4x4& frustum, RenderQueue& queue, AcceptVisibleLeaf acceptFunc);
+
+    // Renders the camera with the renderer after the scene camera in renderFrame, eg. for split-screen,
+    // picture-in-picture or probe captures. The camera is culled in the same pass as the scene camera,
+    // and the lights are those visible to the scene camera. The caller sets the camera's aspect ratio
+    // and the renderer's viewport and render target. An added camera's renderer is replaced.
+    // precondition: camera and renderer != nullptr, less than ViewCuller::MAX_VIEWS - 1 camera views
+    void addCameraView(Graph::Camera* camera, Renderer* renderer);
+
+    // Returns false if the camera has no view.
+    bool removeCameraView(Graph::Camera* camera);
+
     virtual void visit(Graph::Camera& camera);
 
-protected:
-    virtual void findVisibleLeaves(const QMatrix4x4& frustum, RenderQueue& queue);
+    struct Stats
+    {
+        int leaves;             // Leaves attached to the scene graph
+        int visibleLeaves;      // Leaves inside the camera frustum
+        int renderItems;        // Queued render items of the visible leaves
+        int views;              // Culled views, including the camera and shadow frusta
+    };
+
+    // Culling results of the frame being rendered.
+    const Stats& stats() const;
 
 private:
     Renderer* renderer_;
@@ -93,6 +131,66 @@ private:
 
     QVector<Graph::Camera*> culledCameras_;
     RenderQueue culledGeometry_;
+    Stats stats_;
+
+    struct CameraView
+    {
+        Graph::Camera* camera;
+        Renderer* renderer;
+        std::shared_ptr<RenderQueue> queue;
+    };
+
+    QVector<CameraView> cameraViews_;
+
+    // Views of the frame being prepared. Views are deferred while the visible leaves are visited.
+    ViewCuller culler_;
+    bool deferViews_;
+
+    // Copy of a culled frame. The render queue points to the captured transformations, so the
+    // scene graph can be updated while the frame is rendered.
+    struct FrameSnapshot
+    {
+        struct Instance
+        {
+            SceneLeafPtr leaf;
+            SceneLeafPtr visitable;     // Detached copy for lights
+            Graph::SceneNode* node;
+            QMatrix4x4 transformation;
+            bool visible;
+        };
+
+        struct View
+        {
+            std::shared_ptr<Graph::Camera> camera;
+            Renderer* renderer;
+            std::shared_ptr<RenderQueue> queue;
+        };
+
+        std::shared_ptr<Graph::Camera> camera;
+        QVector<Instance> instances;
+        RenderQueue queue;
+        QVector<View> views;
+        ViewCuller culler;
+        Stats stats;
+
+        void clear();
+    };
+
+    bool pipelined_;
+    FrameSnapshot frames_[2];
+    int frontFrame_;
+
+    void captureFrame(FrameSnapshot& frame);
+    void clearFrames();
+
+    // Culls the leaves visible to the camera and the camera views, visits the visible leaves
+    // and culls the views added by the visitors.
+    void cullViews(Graph::Camera* camera);
+
+    void renderView(Renderer* renderer, Graph::Camera* camera, RenderQueue* queue);
+
+    // Detached copy of the camera, which doesn't read the scene graph during rendering
+    static std::shared_ptr<Graph::Camera> captureCamera(Graph::Camera& camera);
 
     BasicSceneManager(const BasicSceneManager&);
     BasicSceneManager& operator=(const BasicSceneManager&);
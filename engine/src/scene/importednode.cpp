@@ -11,9 +11,15 @@
 #include "scene/scenemanager.h"
 
 #include <QVector>
+#include <QHash>
 
 using namespace Engine;
 
+namespace {
+    // Copies the node and its children, mapping the original nodes to the copies.
+    Graph::SceneNode* copyHierarchy(const Graph::SceneNode* node, QHash<const Graph::SceneNode*, Graph::SceneNode*>& copies);
+}
+
 ImportedNode::ImportedNode(SceneManager& scene)
     : Resource(), rootNode_(nullptr), parentNode_(nullptr), scene_(scene), pFlags_(0)
 {
@@ -133,6 +139,7 @@ void ImportedNode::releaseResource()
 
     rootNode_.reset();
     entities_.clear();
+    prefab_.reset();
 }
 
 ImportedNode::ResourceDataPtr ImportedNode::createData()
@@ -146,16 +153,63 @@ ImportedNode::ResourceDataPtr ImportedNode::createData()
 ImportedNode::Ptr ImportedNode::clone() const
 {
     ImportedNode::Ptr node(new ImportedNode(scene_));
-    node->parentNode_ = parentNode_;
 
-    // Copy root node
-    node->rootNode_ = rootNode_;
+    if(rootNode_ == nullptr)
+    {
+        return node;
+    }
 
-    // Clone entities
+    // Copy the hierarchy, so the clone can be placed independently
+    QHash<const Graph::SceneNode*, Graph::SceneNode*> copies;
+    node->rootNode_.reset(copyHierarchy(rootNode_.get(), copies));
+
+    // Clone entities and attach them to the copied nodes
     for(const ImportedNodeData::EntityPtr& leaf : entities_)
     {
-        node->entities_.push_back(Graph::SceneLeaf::clone(leaf));
+        ImportedNodeData::EntityPtr copy = Graph::SceneLeaf::clone(leaf);
+        Graph::SceneNode* parent = copies.value(leaf->parentNode(), nullptr);
+
+        if(parent != nullptr)
+        {
+            copy->attach(parent);
+        }
+
+        else
+        {
+            copy->detach();
+        }
+
+        node->entities_.push_back(copy);
+        scene_.addSceneLeaf(copy);
     }
 
     return node;
+}
+
+Prefab::Ptr ImportedNode::prefab() const
+{
+    if(prefab_ == nullptr && rootNode_ != nullptr)
+    {
+        prefab_ = Prefab::create(rootNode_.get(), entities_);
+    }
+
+    return prefab_;
+}
+
+namespace {
+    Graph::SceneNode* copyHierarchy(const Graph::SceneNode* node, QHash<const Graph::SceneNode*, Graph::SceneNode*>& copies)
+    {
+        Graph::SceneNode* copy = new Graph::SceneNode;
+        copy->applyTransformation(node->localTransformation());
+        copy->setLightMask(node->lightMask());
+
+        copies.insert(node, copy);
+
+        for(Graph::SceneNode::ChildSceneNodes::size_type i = 0; i < node->numChildren(); ++i)
+        {
+            copy->addChild(copyHierarchy(node->getChild(i), copies));
+        }
+
+        return copy;
+    }
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #define IMPORTEDNODE_H
 
 #include "importednodedata.h"
+#include "prefab.h"
 
 namespace Engine {
 
@@ -26,12 +27,17 @@ public:
 
     virtual ResourceDataPtr createData();
 
-    // Creates a copy of the ImportedNode and all entities.
+    // Creates a copy of the ImportedNode, its SceneNode hierarchy and all entities, and adds the
+    // entities to the scene. The copy is placed by attaching it to a parent.
     // The resulting copy is no longer attached to the resource despatcher.
     // Clone should be made after the resource has been loaded.
-    // TODO: The underlying SceneNode is not copied.
     ImportedNode::Ptr clone() const;
 
+    // Returns the geometry of the loaded hierarchy as a shared prefab, which is created on
+    // first use. Instancing the prefab is much cheaper than cloning.
+    // postcondition: nullptr if the resource hasn't been loaded
+    Prefab::Ptr prefab() const;
+
     template<typename LeafType>
     std::shared_ptr<LeafType> findLeaf(const QString& name);
 
@@ -47,6 +53,7 @@ private:
     unsigned int pFlags_;
 
     QVector<ImportedNodeData::EntityPtr> entities_;
+    mutable Prefab::Ptr prefab_;
 };
 
 #include "importednode.inl"
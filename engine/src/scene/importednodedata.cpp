@@ -4,6 +4,7 @@
 //
 
 #include "importednodedata.h"
+#include "assetiosystem.h"
 
 #include <assimp/vector3.h>
 #include <assimp/matrix4x4.h>
@@ -33,6 +34,9 @@ bool ImportedNodeData::load(const QString& fileName)
 {
     Assimp::Importer importer;
 
+    // The importer takes ownership of the handler
+    importer.SetIOHandler(new AssetIOSystem);
+
     const aiScene* scene = importer.ReadFile(fileName.toStdString(), aiProcess_FlipUVs | pFlags_);
 
     if(scene == nullptr)
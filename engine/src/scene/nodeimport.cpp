@@ -150,6 +150,12 @@ void importMaterial(aiMaterial* aiMat, Material& material, const QString& rootDi
     aiString path;
     QString fullpath = rootDir + "/";
 
+    aiString name;
+    if(aiMat->Get(AI_MATKEY_NAME, name) == AI_SUCCESS)
+    {
+        material.setName(name.data);
+    }
+
     // Query supported materials
     for(int j = 0; j < Material::TEXTURE_COUNT; ++j)
     {
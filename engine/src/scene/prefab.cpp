@@ -0,0 +1,122 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "prefab.h"
+
+#include "graph/scenenode.h"
+#include "graph/geometry.h"
+#include "simdmath.h"
+
+#include <QDebug>
+
+using namespace Engine;
+
+Prefab::Prefab()
+{
+}
+
+Prefab::Ptr Prefab::create(const Graph::SceneNode* root, const QVector<std::shared_ptr<Graph::SceneLeaf>>& leaves)
+{
+    std::shared_ptr<Prefab> prefab(new Prefab);
+    QVector<const Graph::SceneNode*> nodes;
+
+    bool empty = true;
+
+    for(const std::shared_ptr<Graph::SceneLeaf>& leaf : leaves)
+    {
+        Graph::Geometry::Ptr geometry = std::dynamic_pointer_cast<Graph::Geometry>(leaf);
+        if(geometry == nullptr || geometry->parentNode() == nullptr)
+        {
+            continue;
+        }
+
+        const Graph::SceneNode* node = geometry->parentNode();
+        int part = nodes.indexOf(node);
+
+        if(part == -1)
+        {
+            // Concatenates the local transformations up to and including the root
+            QMatrix4x4 transformation;
+            const Graph::SceneNode* parent = node;
+
+            for(; parent != nullptr; parent = parent->getParent())
+            {
+                transformation = Simd::multiply(parent->localTransformation(), transformation);
+
+                if(parent == root)
+                {
+                    break;
+                }
+            }
+
+            if(parent == nullptr)
+            {
+                qWarning() << __FUNCTION__ << "Leaf" << geometry->name() << "is not attached below the root";
+                continue;
+            }
+
+            Part entry = { transformation, transformation.isIdentity() };
+
+            part = nodes.count();
+            nodes.push_back(node);
+            prefab->parts_.push_back(entry);
+        }
+
+        Item item = { part, geometry->renderable(), geometry->material(), geometry->name() };
+        prefab->items_.push_back(item);
+
+        // Bounding box of the item relative to the root
+        const AABB& aabb = geometry->renderable()->boundingBox();
+
+        Simd::Vec4 center, extent;
+        Simd::transformBox(Simd::Mat4::fromQt(prefab->parts_[part].transformation),
+            Simd::Vec4::fromQt(aabb.center(), 1.0f), Simd::Vec4::fromQt(aabb.extent(), 0.0f), center, extent);
+
+        const QVector3D boxCenter = center.toVector3D();
+        const QVector3D boxExtent = extent.toVector3D();
+        AABB box(boxCenter - boxExtent, boxCenter + boxExtent);
+
+        if(empty)
+        {
+            prefab->aabb_ = box;
+            empty = false;
+        }
+
+        else
+        {
+            prefab->aabb_.resize(box);
+        }
+    }
+
+    return prefab;
+}
+
+const QVector<Prefab::Part>& Prefab::parts() const
+{
+    return parts_;
+}
+
+const QVector<Prefab::Item>& Prefab::items() const
+{
+    return items_;
+}
+
+const AABB& Prefab::boundingBox() const
+{
+    return aabb_;
+}
+
+int Prefab::findItem(const QString& name) const
+{
+    for(int i = 0; i < items_.count(); ++i)
+    {
+        if(items_[i].name == name)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
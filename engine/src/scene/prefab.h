@@ -0,0 +1,73 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Prefab is the immutable, shared geometry of an imported hierarchy: the meshes, their
+//             materials and transformations relative to the hierarchy's root. Instances reference
+//             the prefab instead of copying the nodes and leaves, see Graph::PrefabInstance.
+//
+
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#include "aabb.h"
+#include "material.h"
+#include "renderable/renderable.h"
+
+#include <QMatrix4x4>
+#include <QVector>
+#include <QString>
+#include <memory>
+
+namespace Engine {
+
+namespace Graph {
+    class SceneNode;
+    class SceneLeaf;
+}
+
+class Prefab
+{
+public:
+    typedef std::shared_ptr<const Prefab> Ptr;
+
+    // Node of the flattened hierarchy
+    struct Part
+    {
+        QMatrix4x4 transformation;  // Relative to the prefab root
+        bool identity;
+    };
+
+    struct Item
+    {
+        int part;
+        Renderable::Renderable::Ptr renderable;
+        Material::Ptr material;
+        QString name;
+    };
+
+    // Flattens the geometry leaves attached below root. Other leaves, eg. lights, are ignored.
+    // precondition: root != nullptr
+    static Ptr create(const Graph::SceneNode* root, const QVector<std::shared_ptr<Graph::SceneLeaf>>& leaves);
+
+    const QVector<Part>& parts() const;
+    const QVector<Item>& items() const;
+
+    // Bounding box of all items relative to the prefab root.
+    const AABB& boundingBox() const;
+
+    // Returns -1 if no item has the given name.
+    int findItem(const QString& name) const;
+
+private:
+    QVector<Part> parts_;
+    QVector<Item> items_;
+    AABB aabb_;
+
+    Prefab();
+
+    Prefab(const Prefab&);
+    Prefab& operator=(const Prefab&);
+};
+
+}
+
+#endif // PREFAB_H
@@ -34,6 +34,11 @@ public:
     // Queries a list of visible scene leaves inside the given frustum. If acceptFunc is not null,
     // the leaf can be rejected by returning false when the function is called.
     virtual void findVisibleLeaves(const QMatrix4x4& frustum, RenderQueue& queue, AcceptVisibleLeaf acceptFunc) = 0;
+
+    // Queues a view to be culled with the other views of the frame in a single pass over the scene
+    // leaves, after the leaves visible to the camera have been visited. The queue is filled before
+    // the frame is rendered. Outside visiting, the view is culled immediately as by findVisibleLeaves.
+    virtual void addCullView(const QMatrix4x4& frustum, RenderQueue& queue, AcceptVisibleLeaf acceptFunc) = 0;
 };
 
 };
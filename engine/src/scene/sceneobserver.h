@@ -28,6 +28,10 @@ public:
     // If this function returns false, the entity is not pushed to the default render queue.
     virtual bool beforeRendering(Graph::SceneLeaf* entity, Graph::SceneNode* node) { return true; };
 
+    // Called after the visible leaves of the frame have been visited. Views added with
+    // SceneObservable::addCullView are still culled together with the frame.
+    virtual void leavesVisited() {};
+
     // Called when the scene's skybox has been changed. The skybox can be nullptr.
     virtual void skyboxTextureUpdated(CubemapTexture* skybox) {};
 
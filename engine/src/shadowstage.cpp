@@ -8,11 +8,17 @@
 #include "scene/sceneobservable.h"
 #include "shadowrendermethod.h"
 #include "shadowmap.h"
+#include "gputracer.h"
+#include "graph/camera.h"
+
+#include <QElapsedTimer>
+#include <algorithm>
 
 using namespace Engine;
 
 ShadowStage::ShadowStage(Renderer* renderer)
-    : RenderStage(renderer), SceneObserver(), BaseVisitor(), observable_(nullptr)
+    : RenderStage(renderer), SceneObserver(), BaseVisitor(), observable_(nullptr), camera_(nullptr),
+    renderScale_(1.0f)
 {
     // Reset free list to beginning.
     for(int i = 0; i < Graph::Light::LIGHT_COUNT; ++i)
@@ -46,6 +52,15 @@ bool ShadowStage::createShadowMap(Graph::Light::LightType type, const QSize& siz
     // Rebuild all maps
     maps.clear();
     maps.resize(count);
+    gpuTimes_[type].fill(-1, count);
+
+    // Timer samples are allocated for the new map count
+    if(monitor_.isCreated())
+    {
+        monitor_.destroy();
+    }
+
+    measuredCosts_.clear();
 
     const ShadowMethodPtr& method = methods_[type];
     if(method == nullptr)
@@ -72,16 +87,34 @@ bool ShadowStage::createShadowMap(Graph::Light::LightType type, const QSize& siz
 
 ShadowMap* ShadowStage::shadowMap(Graph::Light* light) const
 {
-    ShadowMap* map = nullptr;
-
     // Return cached shadow map
-    auto result = lightIndices_.find(light);
-    if(result != lightIndices_.end())
+    for(const LightShadow& shadow : lightIndices_)
     {
-        map = result.value();
+        if(shadow.light == light)
+        {
+            return shadow.map;
+        }
     }
 
-    return map;
+    return nullptr;
+}
+
+const std::vector<ShadowStage::LightCost>& ShadowStage::lightCosts() const
+{
+    return lightCosts_;
+}
+
+float ShadowStage::priority(const Graph::Light& light, const Graph::Camera& camera)
+{
+    const float radius = light.cutoffDistance();
+    const float distance = qMax((light.position() - camera.position()).length() - radius, 0.0f);
+
+    if(radius <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    return radius / (radius + distance);
 }
 
 void ShadowStage::setObservable(SceneObservable* observable)
@@ -110,6 +143,7 @@ void ShadowStage::setObservable(SceneObservable* observable)
 void ShadowStage::setCamera(Graph::Camera* camera)
 {
     RenderStage::setCamera(camera);
+    camera_ = camera;
 
     for(int i = 0; i < Graph::Light::LIGHT_COUNT; ++i)
     {
@@ -120,42 +154,139 @@ void ShadowStage::setCamera(Graph::Camera* camera)
     }
 }
 
+bool ShadowStage::setViewport(const QRect& viewport, unsigned int samples)
+{
+    viewport_ = viewport;
+    return RenderStage::setViewport(viewport, samples);
+}
+
+void ShadowStage::setRenderScale(float scale)
+{
+    renderScale_ = scale;
+    RenderStage::setRenderScale(scale);
+}
+
 void ShadowStage::render()
 {
-    for(auto it = lightIndices_.begin(); it != lightIndices_.end(); ++it)
+    // Shadow maps are rendered after the decorated stages so that the stage's finished
+    // signal separates the geometry pass from the shadow pass. Lightning samples the maps
+    // after this stage has returned.
+    RenderStage::render();
+
+    readGpuTimes();
+    lightCosts_.clear();
+
+    if(lightIndices_.isEmpty())
+    {
+        return;
+    }
+
+    TRACE_GPU_SCOPE("Shadow pass");
+
+    if(!monitor_.isCreated())
     {
-        const ShadowMethodPtr& method = methods_[it.key()->type()];
+        int maps = 0;
+        for(int i = 0; i < Graph::Light::LIGHT_COUNT; ++i)
+        {
+            maps += shadowMaps_[i].count();
+        }
+
+        monitor_.setSampleCount(maps + 1);
+        monitor_.create();
+    }
+
+    // A frame is measured once the previous measurement has been read back
+    const bool measure = monitor_.isCreated() && measuredCosts_.empty();
+    if(measure)
+    {
+        monitor_.recordSample();
+    }
+
+    QElapsedTimer timer;
+
+    for(const LightShadow& shadow : lightIndices_)
+    {
+        const Graph::Light::LightType type = shadow.light->type();
+        const ShadowMethodPtr& method = methods_[type];
+
+        timer.start();
+        GpuCounters::Snapshot counters = GpuCounters::snapshot();
 
-        method->setShadowMap(it.value());
+        method->setShadowMap(shadow.map);
         method->render();
+
+        LightCost cost = { type, shadow.slot, timer.nsecsElapsed(), gpuTimes_[type][shadow.slot],
+            GpuCounters::snapshot() - counters };
+        lightCosts_.push_back(cost);
+
+        if(measure)
+        {
+            monitor_.recordSample();
+        }
     }
 
-    // TODO: Fix render time profiling since we render before the lightning stage.
-    RenderStage::render();
+    if(measure)
+    {
+        measuredCosts_ = lightCosts_;
+    }
+
+    QRect viewport = scaledViewport(viewport_, renderScale_);
+    gl->glViewport(viewport.x(), viewport.y(), viewport.width(), viewport.height());
 }
 
 void ShadowStage::visit(Graph::Light& light)
 {
     unsigned int mask = light.lightMask();
-    if((mask & Graph::Light::MASK_CAST_SHADOWS) == mask)
+    if((mask & Graph::Light::MASK_CAST_SHADOWS) != mask || methods_[light.type()] == nullptr)
     {
-        const ShadowMethodPtr& method = methods_[light.type()];
-        ShadowMap* map = availableShadowMap(light.type());
+        return;
+    }
 
-        // Prepare light shadow map for rendering
-        if(method != nullptr && map != nullptr)
+    // Point lights wait until all visible lights are known
+    if(light.type() == Graph::Light::LIGHT_POINT)
+    {
+        if(!shadowMaps_[Graph::Light::LIGHT_POINT].isEmpty() && camera_ != nullptr)
         {
-            method->setShadowMap(map);
-            method->prepare(light);
+            Candidate candidate = { &light, priority(light, *camera_) };
+            pointCandidates_.push_back(candidate);
+        }
+    }
+
+    else
+    {
+        prepareShadow(light);
+    }
+}
+
+void ShadowStage::leavesVisited()
+{
+    if(pointCandidates_.isEmpty())
+    {
+        return;
+    }
+
+    // Only the lights getting a map need to be ordered
+    const int count = qMin(pointCandidates_.count(), shadowMaps_[Graph::Light::LIGHT_POINT].count());
 
-            lightIndices_.insert(&light, map);
+    std::partial_sort(pointCandidates_.begin(), pointCandidates_.begin() + count, pointCandidates_.end(),
+        [] (const Candidate& a, const Candidate& b)
+        {
+            return a.priority > b.priority;
         }
+    );
+
+    for(int i = 0; i < count; ++i)
+    {
+        prepareShadow(*pointCandidates_[i].light);
     }
+
+    pointCandidates_.clear();
 }
 
 void ShadowStage::sceneInvalidated()
 {
     lightIndices_.clear();
+    pointCandidates_.clear();
 
     // Reset free list to beginning.
     // Immutable shadow maps (eg. directional light) could be marked here for optimisation.
@@ -165,7 +296,25 @@ void ShadowStage::sceneInvalidated()
     }
 }
 
-ShadowMap* ShadowStage::availableShadowMap(Graph::Light::LightType type)
+void ShadowStage::prepareShadow(Graph::Light& light)
+{
+    int slot = 0;
+    ShadowMap* map = availableShadowMap(light.type(), slot);
+
+    // Prepare light shadow map for rendering
+    if(map != nullptr)
+    {
+        const ShadowMethodPtr& method = methods_[light.type()];
+
+        method->setShadowMap(map);
+        method->prepare(light);
+
+        LightShadow shadow = { &light, map, slot };
+        lightIndices_.push_back(shadow);
+    }
+}
+
+ShadowMap* ShadowStage::availableShadowMap(Graph::Light::LightType type, int& slot)
 {
     ShadowMap* map = nullptr;
 
@@ -173,10 +322,30 @@ ShadowMap* ShadowStage::availableShadowMap(Graph::Light::LightType type)
     if(iter != shadowMaps_[type].end())
     {
         map = iter->get();
+        slot = static_cast<int>(iter - shadowMaps_[type].begin());
 
         // Mark shadow texture used.
         ++iter;
     }
 
     return map;
+}
+
+void ShadowStage::readGpuTimes()
+{
+    if(measuredCosts_.empty() || !monitor_.isResultAvailable())
+    {
+        return;
+    }
+
+    // An interval per measured light
+    QVector<GLuint64> intervals = monitor_.waitForIntervals();
+    for(int i = 0; i < intervals.size() && i < static_cast<int>(measuredCosts_.size()); ++i)
+    {
+        const LightCost& cost = measuredCosts_[i];
+        gpuTimes_[cost.type][cost.slot] = static_cast<qint64>(intervals[i]);
+    }
+
+    monitor_.reset();
+    measuredCosts_.clear();
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 //
 //  Author   : Matti Määttä
 //  Summary  : ShadowStage listens for visible lights in the scene and renders light
-//             shadow textures (maps). ShadowStage should be attached to the (first)
-//             lightning stage that uses shadows.
+//             shadow textures (maps) after the decorated stages. ShadowStage should be
+//             decorated by the (first) lightning stage that uses shadows. Point lights outnumber
+//             their shadow maps, so the maps are given to the point lights with the highest
+//             priority once all visible lights have been visited.
 //
 
 #ifndef SHADOWSTAGE_H
@@ -13,11 +15,15 @@
 #include "scene/sceneobserver.h"
 
 #include "graph/light.h"
+#include "framevector.h"
+#include "gpucounters.h"
 
 #include <QVector>
-#include <QMap>
 #include <QSize>
+#include <QRect>
+#include <QOpenGLTimeMonitor>
 #include <memory>
+#include <vector>
 
 namespace Engine {
 
@@ -43,6 +49,24 @@ public:
     // Returns nullptr if no shadow map is associated with the light.
     ShadowMap* shadowMap(Graph::Light* light) const;
 
+    struct LightCost
+    {
+        Graph::Light::LightType type;
+        int slot;               // Index of the light's shadow map. Point lights get the maps in
+                                // priority order, so 0 is the point light with the highest priority.
+        qint64 cpuTime;         // Nanoseconds spent submitting the light's shadow pass
+        qint64 gpuTime;         // Nanoseconds of the latest measured pass of the slot, -1 if none yet
+        GpuCounters::Snapshot counters;
+    };
+
+    // Costs of the shadow passes rendered by the last render call, in rendering order.
+    // GPU times are read back a few frames later.
+    const std::vector<LightCost>& lightCosts() const;
+
+    // Shadow map priority of a point light as seen from the camera: the light's radius relative
+    // to its distance, 1 if the camera is within the radius.
+    static float priority(const Graph::Light& light, const Graph::Camera& camera);
+
     // Sets the observable for the current scene.
     // precondition: observable != nullptr.
     virtual void setObservable(SceneObservable* observable);
@@ -51,16 +75,31 @@ public:
     // precondition: camera != nullptr
     virtual void setCamera(Graph::Camera* camera);
 
+    // Sets OpenGL viewport parameters and initialises buffers
+    // postcondition: true on success, viewport set and buffers initialised
+    virtual bool setViewport(const QRect& viewport, unsigned int samples);
+
+    // Renders the scene into a sub-rect of the viewport without reallocating buffers.
+    virtual void setRenderScale(float scale);
+
     // Renders the scene through the camera's viewport.
     // preconditions: scene has been set, viewport has been set, camera != nullptr
     virtual void render();
 
     virtual void visit(Graph::Light& light);
 
+    // Allocates the point light shadow maps by priority.
+    virtual void leavesVisited();
+
     virtual void sceneInvalidated();
 
 private:
     SceneObservable* observable_;
+    Graph::Camera* camera_;
+
+    // Shadow methods set their own viewport, the scaled viewport is restored for the next stages
+    QRect viewport_;
+    float renderScale_;
 
     typedef std::shared_ptr<ShadowMap> ShadowMapPtr;
     typedef QVector<ShadowMapPtr> ShadowMapVec;
@@ -71,9 +110,38 @@ private:
     ShadowMapVec shadowMaps_[Graph::Light::LIGHT_COUNT];
     ShadowMapVec::iterator freeMaps_[Graph::Light::LIGHT_COUNT];
 
-    QMap<Graph::Light*, ShadowMap*> lightIndices_;
+    struct LightShadow
+    {
+        Graph::Light* light;
+        ShadowMap* map;
+        int slot;
+    };
+
+    // Shadow casting lights of the frame, few enough to search linearly
+    FrameVector<LightShadow> lightIndices_;
+
+    struct Candidate
+    {
+        Graph::Light* light;
+        float priority;
+    };
+
+    // Visible shadow casting point lights waiting for maps
+    FrameVector<Candidate> pointCandidates_;
+
+    std::vector<LightCost> lightCosts_;
+
+    // Timestamps around each light's pass, read back like RenderTimeWatcher does
+    QOpenGLTimeMonitor monitor_;
+    std::vector<LightCost> measuredCosts_;
+    QVector<qint64> gpuTimes_[Graph::Light::LIGHT_COUNT];
+
+    void prepareShadow(Graph::Light& light);
+
+    // Returns the next free map and its index, or nullptr if all maps are used.
+    ShadowMap* availableShadowMap(Graph::Light::LightType type, int& slot);
 
-    ShadowMap* availableShadowMap(Graph::Light::LightType type);
+    void readGpuTimes();
 };
 
 }
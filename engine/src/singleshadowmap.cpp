@@ -1,4 +1,5 @@
 #include "singleshadowmap.h"
+#include "gpucounters.h"
 
 using namespace Engine;
 
@@ -82,6 +83,7 @@ bool SingleShadowMap::bindFbo()
     }
 
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
     return true;
 }
 
@@ -11,13 +11,16 @@
 #include "graph/camera.h"
 #include "gbuffer.h"
 #include "binder.h"
+#include "sampleclassifier.h"
+#include "gputracer.h"
 
 #include "scene/sceneobservable.h"
+#include "gpucounters.h"
 
 using namespace Engine;
 
 SkyboxStage::SkyboxStage(Renderer* renderer)
-    : RenderStage(renderer), gbuffer_(nullptr), fbo_(0), cubemap_(nullptr), cubemapUnit_(0), camera_(nullptr)
+    : RenderStage(renderer), gbuffer_(nullptr), classifier_(nullptr), fbo_(0), cubemap_(nullptr), cubemapUnit_(0), camera_(nullptr)
 {
 }
 
@@ -31,6 +34,11 @@ void SkyboxStage::setGBuffer(GBuffer const* gbuffer)
     initTechnique();
 }
 
+void SkyboxStage::setSampleClassifier(SampleClassifier* classifier)
+{
+    classifier_ = classifier;
+}
+
 void SkyboxStage::setObservable(SceneObservable* observable)
 {
     observable->addObserver(this);
@@ -47,6 +55,8 @@ void SkyboxStage::render()
 {
     RenderStage::render();
 
+    TRACE_GPU_SCOPE("Skybox pass");
+
     if(cubemap_ == nullptr || mesh_ == nullptr)
     {
         return; // Skybox not set
@@ -58,6 +68,7 @@ void SkyboxStage::render()
     }
 
     gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
 
     // Translate the skybox mesh to view origin
     QMatrix4x4 trans;
@@ -78,7 +89,16 @@ void SkyboxStage::render()
             gl->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
             gbuffer_->bindTextures();
-            mesh_->render();
+
+            if(classifier_ != nullptr)
+            {
+                renderClassified();
+            }
+
+            else
+            {
+                mesh_->render();
+            }
 
             gl->glDisable(GL_BLEND);
         }
@@ -98,6 +118,20 @@ void SkyboxStage::render()
     }
 }
 
+void SkyboxStage::renderClassified()
+{
+    // Uniform pixels are either fully covered or empty, so one depth sample is enough
+    classifier_->beginPixelSet(SampleClassifier::PIXELS_UNIFORM);
+    skybox_->setPerSample(false);
+    mesh_->render();
+
+    classifier_->beginPixelSet(SampleClassifier::PIXELS_EDGE);
+    skybox_->setPerSample(true);
+    mesh_->render();
+
+    classifier_->endPixelSet();
+}
+
 void SkyboxStage::setRenderTarget(GLuint fbo)
 {
     RenderStage::setRenderTarget(fbo);
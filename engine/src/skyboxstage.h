@@ -23,6 +23,7 @@ namespace Renderable {
 
 class GBuffer;
 class CubemapTexture;
+class SampleClassifier;
 
 class SkyboxStage : public RenderStage, public SceneObserver
 {
@@ -59,11 +60,16 @@ public:
     // precondition: gbuffer != nullptr
     void setGBuffer(GBuffer const* gbuffer);
 
+    // If set, the depth samples are tested only on the classified edge pixels.
+    // precondition: gbuffer is set, the classifier marks the render target's stencil
+    void setSampleClassifier(SampleClassifier* classifier);
+
     // SceneObserver implementation.
     virtual void skyboxTextureUpdated(CubemapTexture* skybox);
 
 private:
     GBuffer const* gbuffer_;
+    SampleClassifier* classifier_;
     GLuint fbo_;
     int cubemapUnit_;
 
@@ -73,6 +79,7 @@ private:
     Graph::Camera* camera_;
 
     void initTechnique();
+    void renderClassified();
 };
 
 }
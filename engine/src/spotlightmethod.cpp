@@ -11,35 +11,35 @@
 #include "graph/scenenode.h"
 #include "graph/sceneleaf.h"
 #include "resourcedespatcher.h"
+#include "textureresidency.h"
 
 #include "mathelp.h"
-#include "binder.h"
 
 using namespace Engine;
 
 SpotLightMethod::SpotLightMethod(ResourceDespatcher& despatcher)
-    : shadow_(nullptr), scene_(nullptr), initTech_(false), cachedVP_(nullptr)
+    : shadow_(nullptr), scene_(nullptr)
 {
+    ShaderData::DefineMap shaderDefines;
+    textureArrays_ = TextureResidency::shaderDefines(shaderDefines);
+    shaderDefines.insert("MAX_CASTER_INSTANCES", static_cast<int>(OffscreenRenderer::MAX_CASTER_INSTANCES));
+
     // Load shaders
-    tech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowmap.vert"), Shader::Type::Vertex));
-    tech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowmap.frag"), Shader::Type::Fragment));
+    depthTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowmap.vert"), shaderDefines, Shader::Type::Vertex));
+    depthTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowdepth.frag"), Shader::Type::Fragment));
 
-    // Set technique and OnRenderCallback for renderer.
-    renderer_.setRenderCallback([this] (Material& mat, const QMatrix4x4& mvp)
-        {
-            if(!initTech_)
-            {
-                tech_.setUniformValue("maskSampler", Material::TEXTURE_MASK);
-                initTech_ = true;
-            }
-
-            // Bind mask texture
-            Binder::bind(mat.getTexture(Material::TEXTURE_MASK), GL_TEXTURE0 + Material::TEXTURE_MASK);
-            tech_.setUniformValue("MVP", *cachedVP_ * mvp);
-        }
-    );
+    maskTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowmap.vert"), shaderDefines, Shader::Type::Vertex));
+    maskTech_.addShader(despatcher.get<Shader>(RESOURCE_PATH("shaders/shadowmap.frag"), shaderDefines, Shader::Type::Fragment));
+
+    // Casters are transformed to light space when the batch is rendered
+    OffscreenRenderer::CasterPass pass;
+    pass.opaque = &depthTech_;
+    pass.alphaTested = &maskTech_;
+    pass.views = &lightVP_;
+    pass.viewCount = 1;
+    pass.textureArrays = textureArrays_;
 
-    renderer_.setTechnique(&tech_);
+    renderer_.setCasterPass(pass);
 }
 
 SpotLightMethod::~SpotLightMethod()
@@ -75,19 +75,18 @@ void SpotLightMethod::prepare(Graph::Light& light)
     shadow_->batch().clear();
 
     // Set up frustum that fills the light's field of view.
-    // TODO: Detach Graph::Camera from frustrum implementation so we can pass that to renderer
-    // instead of using callback to calculate MVP
     QMatrix4x4 lightView;
     lightView.perspective(light.angleOuterCone() * 2, 1.0f, 1.0f, light.cutoffDistance());
     lightView.lookAt(light.position(), light.position() + light.direction(), UNIT_Y);
 
     shadow_->setLightVP(lightView);
 
-    // Query renderables inside the camera
+    // Query renderables inside the light's frustum. The query is culled together with the
+    // other views of the frame, and the batch is filled before rendering.
     RenderQueue& visibles = shadow_->batch();
     unsigned int lightMask = light.lightMask();
 
-    scene_->findVisibleLeaves(lightView, visibles,
+    scene_->addCullView(lightView, visibles,
         [lightMask] (const Graph::SceneLeaf&, const Graph::SceneNode& node)
         {
             // Accept only renderables that cast shadows by this light.
@@ -102,7 +101,7 @@ void SpotLightMethod::render()
     renderer_.setRenderTarget(shadow_->fboHandle());
     renderer_.setViewport(QRect(QPoint(0, 0), shadow_->size()), 1);
 
-    cachedVP_ = &shadow_->lightVP();
+    lightVP_ = Simd::Mat4::fromQt(shadow_->lightVP());
 
     if(shadow_->bindFbo())
     {
@@ -114,8 +113,6 @@ void SpotLightMethod::render()
         gl->glCullFace(GL_BACK);
     }
 
-    cachedVP_ = nullptr;
-
     // Reset batch
     shadow_->batch().clear();
 }
\ No newline at end of file
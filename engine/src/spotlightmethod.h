@@ -9,6 +9,7 @@
 #include "shadowrendermethod.h"
 #include "offscreenrenderer.h"
 #include "technique/technique.h"
+#include "simdmath.h"
 
 namespace Engine {
 
@@ -42,12 +43,15 @@ public:
 private:
     SceneObservable* scene_;
     SingleShadowMap* shadow_;
-    const QMatrix4x4* cachedVP_;
+    Simd::Mat4 lightVP_;
 
     OffscreenRenderer renderer_;
-    Technique::Technique tech_;
 
-    bool initTech_;
+    // Casters without an alpha mask only write depth
+    Technique::Technique depthTech_;
+    Technique::Technique maskTech_;
+
+    bool textureArrays_;
 };
 
 }
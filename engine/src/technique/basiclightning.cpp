@@ -73,6 +73,19 @@ void BasicLightning::setMaterialAttributes(const Material::Attributes& attribute
     setUniformValue("gMaterial.shininess", attributes.shininess);
 }
 
+void BasicLightning::setTextureLayers(Material& material)
+{
+    const char* LAYERS[Material::TEXTURE_COUNT] = {
+        "gDiffuseLayer", "gNormalLayer",
+        "gSpecularLayer", "gMaskLayer", "gShininessLayer"
+    };
+
+    for(int i = 0; i < Material::TEXTURE_COUNT; ++i)
+    {
+        setUniformValue(LAYERS[i], material.textureLayer(static_cast<Material::TextureType>(i)));
+    }
+}
+
 void BasicLightning::setDirectionalLight(Graph::Light* light)
 {
     if(light == nullptr)
@@ -118,7 +131,7 @@ void BasicLightning::setDirectionalLightShadowUnit(GLuint shadow)
     setUniformValue("gDirectionalLightShadowMap", shadow);
 }
 
-void BasicLightning::setPointAndSpotLights(const QList<Graph::Light*>& lights)
+void BasicLightning::setPointAndSpotLights(const FrameVector<Graph::Light*>& lights)
 {
     int numSpotLights = 0;
     int numPointLights = 0;
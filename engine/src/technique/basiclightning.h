@@ -8,10 +8,10 @@
 
 #include "technique.h"
 #include "material.h"
+#include "framevector.h"
 
 #include <QMatrix4x4>
 
-#include <QList>
 #include <string>
 
 namespace Engine { 
@@ -34,6 +34,10 @@ public:
     void setWorldView(const QMatrix4x4& vp);
     void setEyeWorldPos(const QVector3D& eyePos);
     void setMaterialAttributes(const Material::Attributes& attributes);
+
+    // Sets the texture array layers of the material's textures.
+    // precondition: shaders are compiled with TEXTURE_ARRAYS
+    void setTextureLayers(Material& material);
     void setHasTangents(bool tangents);
 
     void setSpotLightMVP(size_t index, const QMatrix4x4& mvp);
@@ -43,7 +47,7 @@ public:
     void setDirectionalLightShadowUnit(GLuint shadow);
 
     void setDirectionalLight(Graph::Light* light);
-    void setPointAndSpotLights(const QList<Graph::Light*>& lights);
+    void setPointAndSpotLights(const FrameVector<Graph::Light*>& lights);
 
     void setShadowEnabled(bool value);
 
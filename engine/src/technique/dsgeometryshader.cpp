@@ -36,6 +36,19 @@ void DSGeometryShader::setMaterialAttributes(const Material::Attributes& attrib)
     setUniformValue("material.specular", attrib.specularIntensity);
 }
 
+void DSGeometryShader::setTextureLayers(Material& material)
+{
+    const char* LAYERS[Material::TEXTURE_COUNT] = {
+        "material.diffuseLayer", "material.normalLayer",
+        "material.specularLayer", "material.maskLayer", "material.shininessLayer"
+    };
+
+    for(int i = 0; i < Material::TEXTURE_COUNT; ++i)
+    {
+        setUniformValue(LAYERS[i], material.textureLayer(static_cast<Material::TextureType>(i)));
+    }
+}
+
 void DSGeometryShader::setHasTangentsAndNormals(bool value)
 {
     if(value)
@@ -28,6 +28,10 @@ public:
     void setMaterialAttributes(const Material::Attributes& attrib);
     void setHasTangentsAndNormals(bool value);
 
+    // Sets the texture array layers of the material's textures.
+    // precondition: shaders are compiled with TEXTURE_ARRAYS
+    void setTextureLayers(Material& material);
+
 protected:
     virtual bool init();
 };
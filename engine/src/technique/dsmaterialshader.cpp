@@ -45,6 +45,11 @@ void DSMaterialShader::setDepthRange(float fnear, float ffar)
     setUniformValue("depthScale", ffar - fnear);
 }
 
+void DSMaterialShader::setPerSample(bool perSample)
+{
+    setUniformValue("perSample", static_cast<int>(perSample));
+}
+
 bool DSMaterialShader::init()
 {
     if(gbuffer_ == nullptr)
@@ -40,6 +40,10 @@ public:
 
     void setDepthRange(float fnear, float ffar);
 
+    // Shades every sample of the pixel instead of the first. Enabled by default.
+    // precondition: technique is enabled, shaders are compiled with SAMPLES > 1
+    void setPerSample(bool perSample);
+
 protected:
     virtual bool init();
 
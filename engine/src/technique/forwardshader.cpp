@@ -36,11 +36,22 @@ void ForwardShader::setMaterialAttributes(const Material& material)
     }
 }
 
+void ForwardShader::setTextureLayers(Material& material)
+{
+    setUniformValue("material.diffuseLayer", material.textureLayer(Material::TEXTURE_DIFFUSE));
+    setUniformValue("material.maskLayer", material.textureLayer(Material::TEXTURE_MASK));
+}
+
 void ForwardShader::setDepthTextureUnit(int unit)
 {
     depthUnit_ = unit;
 }
 
+void ForwardShader::setPerSample(bool perSample)
+{
+    setUniformValue("perSample", static_cast<int>(perSample));
+}
+
 bool ForwardShader::init()
 {
     if(!Technique::init())
@@ -49,6 +60,7 @@ bool ForwardShader::init()
     }
 
     setUniformValue("material.diffuseSampler", static_cast<int>(Material::TEXTURE_DIFFUSE));
+    setUniformValue("material.maskSampler", static_cast<int>(Material::TEXTURE_MASK));
     setUniformValue("depth", depthUnit_);
 
     return true;
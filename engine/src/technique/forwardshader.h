@@ -21,8 +21,16 @@ public:
 
     void setMVP(const QMatrix4x4& mvp);
     void setMaterialAttributes(const Material& material);
+
+    // Sets the texture array layers of the material's textures.
+    // precondition: shaders are compiled with TEXTURE_ARRAYS
+    void setTextureLayers(Material& material);
     void setDepthTextureUnit(int unit);
 
+    // Tests every depth sample instead of the first. Enabled by default.
+    // precondition: Technique is enabled
+    void setPerSample(bool perSample);
+
 protected:
     virtual bool init();
 
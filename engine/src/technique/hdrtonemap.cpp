@@ -9,8 +9,8 @@ using namespace Engine;
 using namespace Engine::Technique;
 
 HDRTonemap::HDRTonemap(unsigned int samples, unsigned int bloomLod)
-    : Technique(), inputTextureId_(-1), bloomFactor_(1.0f), exposure_(1.0f),
-    gamma_(2.2f), bright_(1.0f), attributeChanged_(true), samples_(samples), bloomLod_(bloomLod)
+    : Technique(), inputTextureId_(-1), exposureTextureId_(-1), bloomFactor_(1.0f), exposure_(1.0f),
+    gamma_(2.2f), bright_(1.0f), renderScale_(1.0f), gpuExposure_(false), attributeChanged_(true), samples_(samples), bloomLod_(bloomLod)
 {
 }
 
@@ -33,6 +33,8 @@ bool HDRTonemap::enable()
         setUniformValue("exposure", exposure_);
         setUniformValue("gamma", gamma_);
         setUniformValue("bright", bright_);
+        setUniformValue("renderScale", renderScale_);
+        setUniformValue("gpuExposure", static_cast<int>(gpuExposure_));
     }
 
     return true;
@@ -72,6 +74,16 @@ void HDRTonemap::setBloomTexture(int textureId)
     }
 }
 
+void HDRTonemap::setExposureTexture(int textureId)
+{
+    exposureTextureId_ = textureId;
+
+    if(program()->isLinked())
+    {
+        setUniformValue("exposureTexture", exposureTextureId_);
+    }
+}
+
 void HDRTonemap::setBloomFactor(float factor)
 {
     bloomFactor_ = factor;
@@ -96,6 +108,24 @@ void HDRTonemap::setBrightLevel(float bright)
     attributeChanged_ = true;
 }
 
+void HDRTonemap::setRenderScale(float scale)
+{
+    if(renderScale_ != scale)
+    {
+        renderScale_ = scale;
+        attributeChanged_ = true;
+    }
+}
+
+void HDRTonemap::setGpuExposure(bool enable)
+{
+    if(gpuExposure_ != enable)
+    {
+        gpuExposure_ = enable;
+        attributeChanged_ = true;
+    }
+}
+
 bool HDRTonemap::init()
 {
     if(!setUniformValue("inputTexture", inputTextureId_))
@@ -108,5 +138,8 @@ bool HDRTonemap::init()
         return false;
     }
 
+    // Unused exposure sampler still needs a unit of its own
+    setUniformValue("exposureTexture", exposureTextureId_);
+
     return true;
 }
\ No newline at end of file
@@ -25,6 +25,7 @@ public:
 
     void setInputTexture(int textureId);
     void setBloomTexture(int textureId);
+    void setExposureTexture(int textureId);
 
     // Sets shader attributes
     void setBloomFactor(float factor);
@@ -32,17 +33,26 @@ public:
     void setGamma(float gamma);
     void setBrightLevel(float bright);
 
+    // Portion of the input texture which is upscaled to the output.
+    void setRenderScale(float scale);
+
+    // Reads the exposure from the exposure texture instead of the exposure attribute.
+    void setGpuExposure(bool enable);
+
 protected:
     virtual bool init();
 
 private:
     int inputTextureId_;
     int bloomTextureId_;
+    int exposureTextureId_;
 
     float bloomFactor_;
     float exposure_;
     float gamma_;
     float bright_;
+    float renderScale_;
+    bool gpuExposure_;
 
     unsigned int samples_;
     unsigned int bloomLod_;
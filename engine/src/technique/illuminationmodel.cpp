@@ -17,7 +17,12 @@ using namespace Engine;
 using namespace Engine::Technique;
 
 IlluminationModel::IlluminationModel()
-    : DSMaterialShader(), shadowUnit_(0)
+    : DSMaterialShader(), shadowUnit_(0), shadowCubeUnit_(0), type_(Graph::Light::LIGHT_COUNT), shadow_(false)
+{
+}
+
+IlluminationModel::IlluminationModel(Graph::Light::LightType type, bool shadow)
+    : DSMaterialShader(), shadowUnit_(0), shadowCubeUnit_(0), type_(type), shadow_(shadow)
 {
 }
 
@@ -25,6 +30,18 @@ IlluminationModel::~IlluminationModel()
 {
 }
 
+void IlluminationModel::permutationDefines(ShaderData::DefineMap& defines, Graph::Light::LightType type, bool shadow)
+{
+    // Generic model is marked with a negative light type
+    defines.insert("LIGHT_TYPE", type == Graph::Light::LIGHT_COUNT ? -1 : static_cast<int>(type));
+    defines.insert("SHADOW", shadow ? 1 : 0);
+}
+
+bool IlluminationModel::isPermutation() const
+{
+    return type_ != Graph::Light::LIGHT_COUNT;
+}
+
 void IlluminationModel::setQuadExtents(float scale, const QVector3D& center)
 {
     setUniformValue("quadScale", scale);
@@ -33,12 +50,20 @@ void IlluminationModel::setQuadExtents(float scale, const QVector3D& center)
 
 void IlluminationModel::setCamera(const Graph::Camera& camera)
 {
-    setUniformValue("viewProj", camera.worldView());
-    setUniformValue("cameraUp", camera.up());
-    setUniformValue("cameraRight", camera.right());
-
     view_ = camera.view();
-    setUniformValue("viewInverse", view_.inverted());
+
+    // Permutations strip unused uniforms
+    if(type_ != Graph::Light::LIGHT_DIRECTIONAL)
+    {
+        setUniformValue("viewProj", camera.worldView());
+        setUniformValue("cameraUp", camera.up());
+        setUniformValue("cameraRight", camera.right());
+    }
+
+    if(!isPermutation() || shadow_)
+    {
+        setUniformValue("viewInverse", view_.inverted());
+    }
 }
 
 void IlluminationModel::enableSpotLight(const Graph::Light& light, ShadowMap* shadow)
@@ -50,9 +75,14 @@ void IlluminationModel::enableSpotLight(const Graph::Light& light, ShadowMap* sh
     setUniformValue("light.cosOuterAngle", static_cast<float>(qCos(qDegreesToRadians(light.angleOuterCone()))));
     setUniformValue("light.cosInnerAngle", static_cast<float>(qCos(qDegreesToRadians(light.angleInnerCone()))));
 
+    Q_ASSERT(!isPermutation() || (type_ == Graph::Light::LIGHT_SPOT && shadow_ == (shadow != nullptr)));
+
     if(shadow != nullptr)
     {
-        useSubroutine("calculateOutput", "spotLightPassShadow", GL_FRAGMENT_SHADER);
+        if(!isPermutation())
+        {
+            useSubroutine("calculateOutput", "spotLightPassShadow", GL_FRAGMENT_SHADER);
+        }
 
         setUniformValue("lightVP", shadow->lightVP());
         setUniformValue("shadowOffset", QVector2D(1.0 / shadow->size().width(), 1.0 / shadow->size().height()));
@@ -60,22 +90,42 @@ void IlluminationModel::enableSpotLight(const Graph::Light& light, ShadowMap* sh
         shadow->bindTextures(GL_TEXTURE0 + shadowUnit_);
     }
 
-    else
+    else if(!isPermutation())
     {
         useSubroutine("calculateOutput", "spotLightPass", GL_FRAGMENT_SHADER);
     }
 }
 
-void IlluminationModel::enablePointLight(const Graph::Light& light)
+void IlluminationModel::enablePointLight(const Graph::Light& light, ShadowMap* shadow)
 {
-    useSubroutine("calculateOutput", "pointLightPass", GL_FRAGMENT_SHADER);
+    Q_ASSERT(!isPermutation() || (type_ == Graph::Light::LIGHT_POINT && shadow_ == (shadow != nullptr)));
+
+    if(!isPermutation())
+    {
+        useSubroutine("calculateOutput", shadow != nullptr ? "pointLightPassShadow" : "pointLightPass", GL_FRAGMENT_SHADER);
+    }
+
     setPointUniforms(light);
+
+    if(shadow != nullptr)
+    {
+        // Depth terms of the face projection, the depth is computed from the distance along the face axis
+        const QMatrix4x4& projection = shadow->lightVP();
+        setUniformValue("cubeProjection", QVector2D(projection(2, 2), projection(2, 3)));
+
+        shadow->bindTextures(GL_TEXTURE0 + shadowCubeUnit_);
+    }
 }
 
 void IlluminationModel::enableDirectionalLight(const Graph::Light& light)
 {
-    useSubroutine("calculateOutput", "directionalLightPass", GL_FRAGMENT_SHADER);
-    useSubroutine("transformQuad", "fullscreenQuad", GL_VERTEX_SHADER);
+    Q_ASSERT(!isPermutation() || type_ == Graph::Light::LIGHT_DIRECTIONAL);
+
+    if(!isPermutation())
+    {
+        useSubroutine("calculateOutput", "directionalLightPass", GL_FRAGMENT_SHADER);
+        useSubroutine("transformQuad", "fullscreenQuad", GL_VERTEX_SHADER);
+    }
 
     float ambientFactor = 0.0f;
     if(light.diffuseIntensity() > 0.0f)
@@ -95,9 +145,28 @@ bool IlluminationModel::init()
         return false;
     }
 
+    // Bind samplers after last gbuffer unit
+    shadowUnit_ = gbuffer()->textures().count();
+    shadowCubeUnit_ = shadowUnit_ + 1;
+
+    // Permutations don't use subroutines
+    if(isPermutation())
+    {
+        if(!shadow_)
+        {
+            return true;
+        }
+
+        return type_ == Graph::Light::LIGHT_POINT ? setUniformValue("shadowCubeSampler", shadowCubeUnit_)
+                                                  : setUniformValue("shadowSampler", shadowUnit_);
+    }
+
     if(resolveSubroutineLocation("pointLightPass", GL_FRAGMENT_SHADER) == GL_INVALID_INDEX)
         return false;
 
+    if(resolveSubroutineLocation("pointLightPassShadow", GL_FRAGMENT_SHADER) == GL_INVALID_INDEX)
+        return false;
+
     if(resolveSubroutineLocation("spotLightPass", GL_FRAGMENT_SHADER) == GL_INVALID_INDEX)
         return false;
 
@@ -113,16 +182,17 @@ bool IlluminationModel::init()
     if(resolveSubroutineLocation("fullscreenQuad", GL_VERTEX_SHADER) == GL_INVALID_INDEX)
         return false;
 
-    // Bind samplers after last gbuffer unit
-    shadowUnit_ = gbuffer()->textures().count();
-
     setUniformValue("shadowSampler", shadowUnit_);
+    setUniformValue("shadowCubeSampler", shadowCubeUnit_);
     return true;
 }
 
 void IlluminationModel::setPointUniforms(const Graph::Light& spot)
 {
-    useSubroutine( "transformQuad", "screenOrientedQuad", GL_VERTEX_SHADER);
+    if(!isPermutation())
+    {
+        useSubroutine("transformQuad", "screenOrientedQuad", GL_VERTEX_SHADER);
+    }
 
     setUniformValue("light.color", linearColor(spot.color()) * spot.diffuseIntensity());
     setUniformValue("light.position", view_ * spot.position());
@@ -8,11 +8,12 @@
 #define ILLUMINATIONMODEL_H
 
 #include "dsmaterialshader.h"
+#include "graph/light.h"
+#include "shaderdata.h"
 
 namespace Engine {
 
 namespace Graph {
-    class Light;
     class Camera;
 }
 
@@ -23,9 +24,21 @@ namespace Technique {
 class IlluminationModel : public DSMaterialShader
 {
 public:
+    // Constructs a generic model which selects the light pass using subroutines.
     explicit IlluminationModel();
+
+    // Constructs a permutation which is specialised to a single light pass.
+    // The shaders must be compiled using the defines inserted by permutationDefines.
+    IlluminationModel(Graph::Light::LightType type, bool shadow);
     virtual ~IlluminationModel();
 
+    // Inserts the named defines used to compile the shaders of a permutation.
+    // LIGHT_COUNT denotes the generic model.
+    static void permutationDefines(ShaderData::DefineMap& defines, Graph::Light::LightType type, bool shadow);
+
+    // Tells if the model is specialised to a single light pass
+    bool isPermutation() const;
+
     void setCamera(const Graph::Camera& camera);
 
     void setQuadExtents(float scale, const QVector3D& center);
@@ -34,9 +47,9 @@ public:
     // Precondition: Technique is enabled, view matrix is set.
     void enableSpotLight(const Graph::Light& light, ShadowMap* shadow = nullptr);
 
-    // Prepares the technique for rendering point lights.
+    // Prepares the technique for rendering point lights. The shadow map is a CubeShadowMap.
     // Precondition: Technique is enabled, view matrix is set.
-    void enablePointLight(const Graph::Light& light);
+    void enablePointLight(const Graph::Light& light, ShadowMap* shadow = nullptr);
 
     // Prepares the technique for rendering directional lights.
     // Precondition: Technique is enabled, view matrix is set.
@@ -49,6 +62,10 @@ private:
     QMatrix4x4 view_;
     QString lightningModel_;
     int shadowUnit_;
+    int shadowCubeUnit_;
+
+    Graph::Light::LightType type_;
+    bool shadow_;
 
     void setPointUniforms(const Graph::Light& spot);
 };
@@ -0,0 +1,60 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : PermutationCache compiles and caches specialised variants of a technique.
+//             Each permutation is built from the same shader sources using a different set
+//             of named defines, so the compiler can strip unused paths instead of switching
+//             them at runtime with subroutines.
+//
+
+#ifndef PERMUTATIONCACHE_H
+#define PERMUTATIONCACHE_H
+
+#include "shaderdata.h"
+
+#include <QHash>
+#include <QString>
+
+#include <memory>
+#include <functional>
+
+namespace Engine { namespace Technique {
+
+template<typename TechniqueType>
+class PermutationCache
+{
+public:
+    typedef std::shared_ptr<TechniqueType> TechniquePtr;
+
+    // Creates a new technique and adds the shaders compiled with the given defines.
+    typedef std::function<TechniquePtr(const ShaderData::DefineMap& defines)> CreateFunction;
+
+    explicit PermutationCache(const CreateFunction& create = CreateFunction());
+
+    void setCreateFunction(const CreateFunction& create);
+
+    // Returns the permutation matching the define set, creating it if it doesn't exist.
+    // Note that the returned technique's shaders might not be ready to use.
+    // precondition: create function is set
+    TechniqueType* get(const ShaderData::DefineMap& defines);
+
+    // Tells if the permutation has already been created.
+    bool contains(const ShaderData::DefineMap& defines) const;
+
+    // Number of cached permutations
+    int count() const;
+
+    void clear();
+
+private:
+    CreateFunction create_;
+    QHash<QString, TechniquePtr> permutations_;
+
+    PermutationCache(const PermutationCache&);
+    PermutationCache& operator=(const PermutationCache&);
+};
+
+#include "permutationcache.inl"
+
+}}
+
+#endif // PERMUTATIONCACHE_H
@@ -0,0 +1,49 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+template<typename TechniqueType>
+PermutationCache<TechniqueType>::PermutationCache(const CreateFunction& create)
+    : create_(create)
+{
+}
+
+template<typename TechniqueType>
+void PermutationCache<TechniqueType>::setCreateFunction(const CreateFunction& create)
+{
+    create_ = create;
+}
+
+template<typename TechniqueType>
+TechniqueType* PermutationCache<TechniqueType>::get(const ShaderData::DefineMap& defines)
+{
+    const QString key = ShaderData::definesKey(defines);
+
+    auto iter = permutations_.find(key);
+    if(iter == permutations_.end())
+    {
+        Q_ASSERT(create_);
+        iter = permutations_.insert(key, create_(defines));
+    }
+
+    return iter.value().get();
+}
+
+template<typename TechniqueType>
+bool PermutationCache<TechniqueType>::contains(const ShaderData::DefineMap& defines) const
+{
+    return permutations_.contains(ShaderData::definesKey(defines));
+}
+
+template<typename TechniqueType>
+int PermutationCache<TechniqueType>::count() const
+{
+    return permutations_.count();
+}
+
+template<typename TechniqueType>
+void PermutationCache<TechniqueType>::clear()
+{
+    permutations_.clear();
+}
@@ -50,6 +50,11 @@ void Skybox::setDepthTextureUnit(int unit)
     depthUnit_ = unit;
 }
 
+void Skybox::setPerSample(bool perSample)
+{
+    setUniformValue("perSample", static_cast<int>(perSample));
+}
+
 void Skybox::setMVP(const QMatrix4x4& mvp)
 {
     setUniformValue("MVP", mvp);
@@ -39,6 +39,10 @@ public:
     // Sets the texture unit for sampling depth instead of the bound framebuffer
     void setDepthTextureUnit(int unit);
 
+    // Tests every depth sample instead of the first. Enabled by default.
+    // precondition: Technique is enabled, depth texture unit is set
+    void setPerSample(bool perSample);
+
 protected:
     virtual bool init();
 
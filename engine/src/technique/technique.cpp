@@ -24,7 +24,13 @@ bool Technique::enable()
 {
     if(!program_->isLinked())
     {
-        return program_.bind() && init();
+        if(!program_.bind())
+        {
+            return false;
+        }
+
+        GPU_COUNT(PROGRAM_BINDS, 1);
+        return init();
     }
 
     if(!program_->bind())
@@ -32,6 +38,8 @@ bool Technique::enable()
         return false;
     }
 
+    GPU_COUNT(PROGRAM_BINDS, 1);
+
     activateUniformSubroutines();
     return true;
 }
@@ -67,6 +75,28 @@ int Technique::resolveUniformLocation(const QString& name)
     return id;
 }
 
+bool Technique::setUniformValueArray(const QString& name, const Simd::Mat4* values, int count)
+{
+    int location = cachedUniformLocation(name);
+    if(location == -1)
+    {
+        location = resolveUniformLocation(name);
+    }
+
+    if(location == -1)
+    {
+        return false;
+    }
+
+    // Simd::Mat4 is column-major like GL, and the array is contiguous
+    gl->glUniformMatrix4fv(location, count, GL_FALSE, &values[0].m[0][0]);
+
+    GPU_COUNT(UNIFORM_UPLOADS, 1);
+    GPU_COUNT(UNIFORM_BYTES, sizeof(Simd::Mat4) * count);
+
+    return true;
+}
+
 GLuint Technique::resolveSubroutineLocation(const QString& name, GLenum type)
 {
     GLuint id = gl->glGetSubroutineIndex(program()->programId(), type, name.toLatin1());
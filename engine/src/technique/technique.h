@@ -8,12 +8,16 @@
 #define TECHNIQUE_H
 
 #include "shaderprogram.h"
+#include "gpucounters.h"
+#include "simdmath.h"
 
 #include <QString>
 #include <QMap>
 #include <QHash>
 #include <QVector>
 
+#include <type_traits>
+
 namespace Engine { 
     
 class Shader;
@@ -43,6 +47,12 @@ public:
     template<typename T>
     bool setUniformValue(const QString& name, T&& value);
 
+    // Uploads count values to a uniform array starting from its first element.
+    // precondition: Technique is enabled
+    template<typename T>
+    bool setUniformValueArray(const QString& name, const T* values, int count);
+    bool setUniformValueArray(const QString& name, const Simd::Mat4* values, int count);
+
     // A convenience function which binds the cached subroutine name or resolves it
     // before setting the subroutine uniform.
     // precondition: Technique is enabled
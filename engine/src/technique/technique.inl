@@ -22,5 +22,31 @@ bool Technique::setUniformValue(const QString& name, T&& value)
     }
 
     program()->setUniformValue(location, std::forward<T>(value));
+
+    GPU_COUNT(UNIFORM_UPLOADS, 1);
+    GPU_COUNT(UNIFORM_BYTES, sizeof(typename std::decay<T>::type));
+
+    return true;
+}
+
+template<typename T>
+bool Technique::setUniformValueArray(const QString& name, const T* values, int count)
+{
+    int location = cachedUniformLocation(name);
+    if(location == -1)
+    {
+        location = resolveUniformLocation(name);
+    }
+
+    if(location == -1)
+    {
+        return false;
+    }
+
+    program()->setUniformValueArray(location, values, count);
+
+    GPU_COUNT(UNIFORM_UPLOADS, 1);
+    GPU_COUNT(UNIFORM_BYTES, sizeof(T) * count);
+
     return true;
 }
\ No newline at end of file
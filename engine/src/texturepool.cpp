@@ -0,0 +1,233 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "texturepool.h"
+
+#include <QDebug>
+
+using namespace Engine;
+
+TexturePool::TexturePool()
+    : createdTextures_(0), createdBytes_(0)
+{
+}
+
+TexturePool::~TexturePool()
+{
+    release();
+}
+
+void TexturePool::beginAllocation()
+{
+    for(PooledTexture& texture : textures_)
+    {
+        texture.acquired = false;
+    }
+
+    createdTextures_ = 0;
+    createdBytes_ = 0;
+}
+
+GLuint TexturePool::acquire(const TextureDesc& desc)
+{
+    for(PooledTexture& texture : textures_)
+    {
+        if(!texture.acquired && texture.desc == desc)
+        {
+            texture.acquired = true;
+            return texture.texture;
+        }
+    }
+
+    PooledTexture texture;
+    texture.desc = desc;
+    texture.texture = createTexture(desc);
+    texture.acquired = true;
+
+    textures_.push_back(texture);
+
+    ++createdTextures_;
+    createdBytes_ += desc.bytes();
+
+    return texture.texture;
+}
+
+void TexturePool::endAllocation()
+{
+    QVector<PooledTexture> acquired;
+    QVector<GLuint> released;
+
+    for(const PooledTexture& texture : textures_)
+    {
+        if(texture.acquired)
+        {
+            acquired.push_back(texture);
+        }
+
+        else
+        {
+            released.push_back(texture.texture);
+        }
+    }
+
+    if(released.isEmpty())
+    {
+        return;
+    }
+
+    // Framebuffers referencing released textures can't be reused
+    QVector<PooledFramebuffer> framebuffers;
+    for(PooledFramebuffer& framebuffer : framebuffers_)
+    {
+        bool valid = true;
+        for(const Attachment& attachment : framebuffer.attachments)
+        {
+            if(released.contains(attachment.second))
+            {
+                valid = false;
+                break;
+            }
+        }
+
+        if(valid)
+        {
+            framebuffers.push_back(framebuffer);
+        }
+
+        else
+        {
+            gl->glDeleteFramebuffers(1, &framebuffer.fbo);
+        }
+    }
+
+    gl->glDeleteTextures(released.size(), released.data());
+
+    textures_ = acquired;
+    framebuffers_ = framebuffers;
+}
+
+GLuint TexturePool::framebuffer(const QVector<Attachment>& attachments)
+{
+    for(const PooledFramebuffer& framebuffer : framebuffers_)
+    {
+        if(framebuffer.attachments == attachments)
+        {
+            return framebuffer.fbo;
+        }
+    }
+
+    PooledFramebuffer framebuffer;
+    framebuffer.attachments = attachments;
+
+    gl->glGenFramebuffers(1, &framebuffer.fbo);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.fbo);
+
+    QVector<GLenum> drawBuffers;
+    for(const Attachment& attachment : attachments)
+    {
+        gl->glFramebufferTexture(GL_FRAMEBUFFER, attachment.first, attachment.second, 0);
+
+        if(attachment.first >= GL_COLOR_ATTACHMENT0 && attachment.first <= GL_COLOR_ATTACHMENT15)
+        {
+            drawBuffers.push_back(attachment.first);
+        }
+    }
+
+    if(drawBuffers.isEmpty())
+    {
+        gl->glDrawBuffer(GL_NONE);
+    }
+
+    else
+    {
+        gl->glDrawBuffers(drawBuffers.size(), drawBuffers.data());
+    }
+
+    GLenum status = gl->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if(status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        qWarning() << __FUNCTION__ << "Incomplete framebuffer:" << status;
+        gl->glDeleteFramebuffers(1, &framebuffer.fbo);
+
+        return 0;
+    }
+
+    framebuffers_.push_back(framebuffer);
+    return framebuffer.fbo;
+}
+
+void TexturePool::release()
+{
+    for(PooledFramebuffer& framebuffer : framebuffers_)
+    {
+        gl->glDeleteFramebuffers(1, &framebuffer.fbo);
+    }
+
+    for(PooledTexture& texture : textures_)
+    {
+        gl->glDeleteTextures(1, &texture.texture);
+    }
+
+    framebuffers_.clear();
+    textures_.clear();
+}
+
+int TexturePool::createdTextures() const
+{
+    return createdTextures_;
+}
+
+qint64 TexturePool::createdBytes() const
+{
+    return createdBytes_;
+}
+
+qint64 TexturePool::residentBytes() const
+{
+    qint64 bytes = 0;
+    for(const PooledTexture& texture : textures_)
+    {
+        bytes += texture.desc.bytes();
+    }
+
+    return bytes;
+}
+
+int TexturePool::residentTextures() const
+{
+    return textures_.size();
+}
+
+GLuint TexturePool::createTexture(const TextureDesc& desc)
+{
+    GLuint texture = 0;
+    gl->glGenTextures(1, &texture);
+
+    if(desc.samples == 0)
+    {
+        gl->glBindTexture(GL_TEXTURE_2D, texture);
+        gl->glTexStorage2D(GL_TEXTURE_2D, 1, desc.format, desc.width, desc.height);
+
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        gl->glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    else
+    {
+        gl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture);
+        gl->glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, desc.samples, desc.format,
+            desc.width, desc.height, GL_TRUE);
+
+        gl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+    }
+
+    return texture;
+}
@@ -0,0 +1,83 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : TexturePool allocates the physical textures of a compiled FrameGraph.
+//             Textures and framebuffers are kept between allocation rounds, so rebuilding
+//             the graph only allocates the textures whose description has changed.
+//
+
+#ifndef TEXTUREPOOL_H
+#define TEXTUREPOOL_H
+
+#include "common.h"
+#include "framegraph.h"
+
+#include <QVector>
+#include <QPair>
+
+namespace Engine {
+
+class TexturePool
+{
+public:
+    typedef FrameGraph::TextureDesc TextureDesc;
+
+    // Attachment point and the attached texture
+    typedef QPair<GLenum, GLuint> Attachment;
+
+    TexturePool();
+    ~TexturePool();
+
+    // Starts a new allocation round. Textures acquired in the previous round are
+    // reused for equal descriptions.
+    void beginAllocation();
+
+    // Returns a texture which hasn't been acquired in this round.
+    GLuint acquire(const TextureDesc& desc);
+
+    // Deletes textures which weren't acquired in this round, and framebuffers referencing them.
+    void endAllocation();
+
+    // Returns a cached framebuffer with the textures attached. Colour attachments are
+    // enabled as draw buffers in the given order.
+    // postcondition: 0 if the framebuffer is not complete
+    GLuint framebuffer(const QVector<Attachment>& attachments);
+
+    // Deletes all textures and framebuffers.
+    void release();
+
+    // Textures allocated during the last round
+    int createdTextures() const;
+    qint64 createdBytes() const;
+
+    qint64 residentBytes() const;
+    int residentTextures() const;
+
+private:
+    struct PooledTexture
+    {
+        TextureDesc desc;
+        GLuint texture;
+        bool acquired;
+    };
+
+    struct PooledFramebuffer
+    {
+        QVector<Attachment> attachments;
+        GLuint fbo;
+    };
+
+    QVector<PooledTexture> textures_;
+    QVector<PooledFramebuffer> framebuffers_;
+
+    int createdTextures_;
+    qint64 createdBytes_;
+
+    GLuint createTexture(const TextureDesc& desc);
+
+    TexturePool(const TexturePool&);
+    TexturePool& operator=(const TexturePool&);
+};
+
+}
+
+#endif // TEXTUREPOOL_H
@@ -0,0 +1,62 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "transientgbuffer.h"
+#include "gpucounters.h"
+
+#include <algorithm>
+
+using namespace Engine;
+
+TransientGBuffer::TransientGBuffer()
+    : initialised_(false), fbo_(0)
+{
+    std::fill(textures_, textures_ + TEXTURE_COUNT, 0);
+}
+
+TransientGBuffer::~TransientGBuffer()
+{
+}
+
+QList<QString> TransientGBuffer::textures() const
+{
+    QList<QString> textures{ "normalSpec", "diffuseSpec", "depth" };
+    return textures;
+}
+
+bool TransientGBuffer::initialise(unsigned int width, unsigned int height, unsigned int /*samples*/)
+{
+    initialised_ = width > 0 && height > 0;
+    return initialised_;
+}
+
+bool TransientGBuffer::isInitialised() const
+{
+    return initialised_;
+}
+
+void TransientGBuffer::bindFbo()
+{
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GPU_COUNT(FRAMEBUFFER_BINDS, 1);
+}
+
+void TransientGBuffer::bindTextures() const
+{
+    for(int i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        gl->glActiveTexture(GL_TEXTURE0 + i);
+        gl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, textures_[i]);
+    }
+}
+
+void TransientGBuffer::setTargets(GLuint fbo, GLuint normals, GLuint diffuse, GLuint depth)
+{
+    fbo_ = fbo;
+
+    textures_[TEXTURE_NORMALS] = normals;
+    textures_[TEXTURE_DIFFUSE] = diffuse;
+    textures_[TEXTURE_DEPTH] = depth;
+}
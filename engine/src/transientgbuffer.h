@@ -0,0 +1,56 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : GBuffer with the CompactGBuffer layout whose textures are owned by a frame graph.
+//             The geometry pass sets the physical targets before rendering each frame.
+//
+
+#ifndef TRANSIENTGBUFFER_H
+#define TRANSIENTGBUFFER_H
+
+#include "gbuffer.h"
+#include "common.h"
+
+namespace Engine {
+
+class TransientGBuffer : public GBuffer
+{
+public:
+    TransientGBuffer();
+    virtual ~TransientGBuffer();
+
+    enum GBufferTexture { TEXTURE_NORMALS, TEXTURE_DIFFUSE, TEXTURE_DEPTH, TEXTURE_COUNT };
+
+    // Records the size only; the textures are allocated by the frame graph.
+    virtual bool initialise(unsigned int width, unsigned int height, unsigned int samples);
+
+    // Tells if the last initialise -call was successful
+    virtual bool isInitialised() const;
+
+    // Binds the current target FBO for writing
+    // precondition: targets have been set
+    virtual void bindFbo();
+
+    // Binds the current target textures in the order as listed in GBufferTexture.
+    // The texture type is GL_TEXTURE_2D_MULTISAMPLE
+    virtual void bindTextures() const;
+
+    // postcondition: Returns texture names ("normals", "diffuse", "depth"..) in the order of binding.
+    virtual QList<QString> textures() const;
+
+    // Sets the physical textures and the framebuffer they are attached to.
+    // MRTs: GL_COLOR_ATTACHMENT0 -> TEXTURE_NORMALS
+    //       GL_COLOR_ATTACHMENT1 -> TEXTURE_DIFFUSE
+    void setTargets(GLuint fbo, GLuint normals, GLuint diffuse, GLuint depth);
+
+private:
+    bool initialised_;
+    GLuint fbo_;
+    GLuint textures_[TEXTURE_COUNT];
+
+    TransientGBuffer(const TransientGBuffer&);
+    TransientGBuffer& operator=(const TransientGBuffer&);
+};
+
+}
+
+#endif // TRANSIENTGBUFFER_H
@@ -0,0 +1,114 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "viewculler.h"
+
+#include "graph/sceneleaf.h"
+#include "renderqueue.h"
+
+using namespace Engine;
+
+ViewCuller::ViewCuller()
+    : culledViews_(0)
+{
+}
+
+void ViewCuller::addLeaf(Graph::SceneLeaf* leaf, Graph::SceneNode* node, const QMatrix4x4* transformation)
+{
+    const AABB& box = leaf->boundingBox();
+
+    Simd::Vec4 center, extent;
+    Simd::transformBox(Simd::Mat4::fromQt(*transformation), Simd::Vec4::fromQt(box.center(), 1.0f),
+        Simd::Vec4::fromQt(box.extent(), 0.0f), center, extent);
+
+    Leaf entry = { leaf, node, transformation, 0 };
+    leaves_.push_back(entry);
+
+    centers_.push_back(center);
+    extents_.push_back(extent);
+}
+
+int ViewCuller::addView(const QMatrix4x4& viewProj, RenderQueue* queue, SceneObservable::AcceptVisibleLeaf acceptFunc)
+{
+    if(views_.size() >= MAX_VIEWS)
+    {
+        return -1;
+    }
+
+    View view;
+    view.viewProj = Simd::Mat4::fromQt(viewProj);
+    view.queue = queue;
+    view.acceptFunc = acceptFunc;
+
+    views_.push_back(view);
+    return static_cast<int>(views_.size()) - 1;
+}
+
+void ViewCuller::cull()
+{
+    if(culledViews_ == views_.size())
+    {
+        return;
+    }
+
+    // Leaves are visited once for all new views, so the cost of a view is a box test per leaf
+    for(size_t i = 0; i < leaves_.size(); ++i)
+    {
+        Leaf& leaf = leaves_[i];
+
+        for(size_t index = culledViews_; index < views_.size(); ++index)
+        {
+            const View& view = views_[index];
+            if(!Simd::boxInClipSpace(view.viewProj, centers_[i], extents_[i]))
+            {
+                continue;
+            }
+
+            leaf.visibility |= ViewMask(1) << index;
+
+            if(view.queue != nullptr && (view.acceptFunc == nullptr || view.acceptFunc(*leaf.leaf, *leaf.node)))
+            {
+                view.queue->setModelView(leaf.transformation);
+                leaf.leaf->updateRenderList(*view.queue);
+            }
+        }
+    }
+
+    culledViews_ = views_.size();
+}
+
+void ViewCuller::clear()
+{
+    leaves_.clear();
+    centers_.clear();
+    extents_.clear();
+    views_.clear();
+    culledViews_ = 0;
+}
+
+int ViewCuller::leafCount() const
+{
+    return static_cast<int>(leaves_.size());
+}
+
+Graph::SceneLeaf* ViewCuller::leaf(int index) const
+{
+    return leaves_[index].leaf;
+}
+
+Graph::SceneNode* ViewCuller::node(int index) const
+{
+    return leaves_[index].node;
+}
+
+ViewCuller::ViewMask ViewCuller::visibility(int index) const
+{
+    return leaves_[index].visibility;
+}
+
+int ViewCuller::viewCount() const
+{
+    return static_cast<int>(views_.size());
+}
@@ -0,0 +1,90 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : ViewCuller tests the leaves of a frame against several views in a single pass.
+//             The world bounds of a leaf are computed once when it is added, and each view only
+//             adds a box test per leaf. The result is a visibility mask per leaf with a bit per view.
+//             Views added after a cull, eg. the shadow frusta of the lights found visible, are
+//             tested together by the next cull.
+//
+
+#ifndef VIEWCULLER_H
+#define VIEWCULLER_H
+
+#include "scene/sceneobservable.h"
+#include "simdmath.h"
+
+#include <QMatrix4x4>
+#include <vector>
+
+namespace Engine {
+
+namespace Graph {
+    class SceneLeaf;
+    class SceneNode;
+}
+
+class RenderQueue;
+
+class ViewCuller
+{
+public:
+    enum { MAX_VIEWS = 64 };
+    typedef quint64 ViewMask;
+
+    ViewCuller();
+
+    // Adds a leaf under the transformation.
+    // precondition: leaf, node and transformation != nullptr, transformation is valid until
+    //               the views have been culled
+    void addLeaf(Graph::SceneLeaf* leaf, Graph::SceneNode* node, const QMatrix4x4* transformation);
+
+    // Adds a view for the next cull. If queue is not null, the visible leaves are queued to it,
+    // and acceptFunc can reject a leaf by returning false.
+    // Returns the view's bit in the visibility masks, or -1 if MAX_VIEWS views have been added.
+    int addView(const QMatrix4x4& viewProj, RenderQueue* queue, SceneObservable::AcceptVisibleLeaf acceptFunc);
+
+    // Culls the views added since the last cull.
+    void cull();
+
+    // Removes the leaves and views, but keeps the storage.
+    void clear();
+
+    int leafCount() const;
+    Graph::SceneLeaf* leaf(int index) const;
+    Graph::SceneNode* node(int index) const;
+    ViewMask visibility(int index) const;
+
+    int viewCount() const;
+
+private:
+    struct Leaf
+    {
+        Graph::SceneLeaf* leaf;
+        Graph::SceneNode* node;
+        const QMatrix4x4* transformation;
+        ViewMask visibility;
+    };
+
+    struct View
+    {
+        Simd::Mat4 viewProj;
+        RenderQueue* queue;
+        SceneObservable::AcceptVisibleLeaf acceptFunc;
+    };
+
+    std::vector<Leaf> leaves_;
+
+    // World bounds of the leaves, kept apart for the box tests
+    std::vector<Simd::Vec4> centers_;
+    std::vector<Simd::Vec4> extents_;
+
+    std::vector<View> views_;
+    size_t culledViews_;
+
+    ViewCuller(const ViewCuller&);
+    ViewCuller& operator=(const ViewCuller&);
+};
+
+}
+
+#endif // VIEWCULLER_H
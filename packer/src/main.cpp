@@ -0,0 +1,78 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Packs an asset directory into an archive the engine can mount, see AssetArchive.
+//
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QDir>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "assetarchive.h"
+
+using namespace Engine;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Packs the files of an asset directory into a single archive.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("directory", "Asset directory, eg. assets.");
+    parser.addPositionalArgument("archive", "Archive file, eg. assets.pak.");
+
+    QCommandLineOption compressOption("compress", "Stores files compressed when it saves space.");
+    parser.addOption(compressOption);
+
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if(arguments.count() != 2)
+    {
+        parser.showHelp(2);
+    }
+
+    QDir directory(arguments[0]);
+    if(!directory.exists())
+    {
+        qWarning() << "No such directory" << arguments[0];
+        return 2;
+    }
+
+    // The archive isn't packed into itself
+    const QString archive = QFileInfo(arguments[1]).absoluteFilePath();
+
+    QStringList files;
+    qint64 bytes = 0;
+
+    QDirIterator iter(directory.path(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        iter.next();
+        if(iter.fileInfo().absoluteFilePath() != archive)
+        {
+            files << directory.relativeFilePath(iter.filePath());
+            bytes += iter.fileInfo().size();
+        }
+    }
+
+    // Sorted entries keep the archive reproducible
+    files.sort();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(!AssetArchive::write(archive, directory.path(), files, parser.isSet(compressOption)))
+    {
+        return 2;
+    }
+
+    qDebug() << "Packed" << files.count() << "files," << bytes / 1024 << "KB into" << QFileInfo(archive).size() / 1024
+        << "KB in" << timer.elapsed() << "ms";
+
+    return 0;
+}
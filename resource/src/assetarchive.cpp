@@ -0,0 +1,312 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "assetarchive.h"
+
+#include <QVector>
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+
+using namespace Engine;
+
+namespace {
+    const char MAGIC[4] = { 'E', 'P', 'A', 'K' };
+    const quint32 VERSION = 1;
+
+    // Magic, version, entry count and the size of the table of contents
+    const int HEADER_SIZE = 16;
+
+    enum EntryFlags { ENTRY_COMPRESSED = 1 };
+
+    struct StoredEntry
+    {
+        quint64 offset;
+        quint32 size;
+        quint32 flags;
+    };
+
+    // Builds the header and the table of contents. The size only depends on the paths, so the
+    // table can be rewritten in place once the entries have been stored.
+    QByteArray tableOfContents(const QString& root, const QStringList& paths, const QVector<StoredEntry>& entries);
+
+    void appendUInt32(QByteArray& bytes, quint32 value);
+    void appendUInt64(QByteArray& bytes, quint64 value);
+    void appendString(QByteArray& bytes, const QString& string);
+
+    // Reads a value and advances the position, returns false if the value would end past end.
+    bool readUInt32(const uchar*& pos, const uchar* end, quint32& value);
+    bool readUInt64(const uchar*& pos, const uchar* end, quint64& value);
+    bool readString(const uchar*& pos, const uchar* end, QString& string);
+}
+
+AssetArchive::AssetArchive()
+    : mapping_(nullptr)
+{
+}
+
+AssetArchive::~AssetArchive()
+{
+    if(mapping_ != nullptr)
+    {
+        file_.unmap(mapping_);
+    }
+}
+
+bool AssetArchive::open(const QString& fileName)
+{
+    file_.setFileName(fileName);
+    if(!file_.open(QIODevice::ReadOnly))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName << file_.errorString();
+        return false;
+    }
+
+    const qint64 size = file_.size();
+    if(size < HEADER_SIZE)
+    {
+        qWarning() << __FUNCTION__ << "Not an asset archive:" << fileName;
+        return false;
+    }
+
+    mapping_ = file_.map(0, size);
+    if(mapping_ == nullptr)
+    {
+        qWarning() << __FUNCTION__ << "Failed to map" << fileName << file_.errorString();
+        return false;
+    }
+
+    const uchar* end = mapping_ + size;
+    const uchar* pos = mapping_ + sizeof(MAGIC);
+
+    quint32 version = 0;
+    quint32 count = 0;
+    quint32 tocSize = 0;
+
+    if(std::memcmp(mapping_, MAGIC, sizeof(MAGIC)) != 0 || !readUInt32(pos, end, version) || version != VERSION ||
+        !readUInt32(pos, end, count) || !readUInt32(pos, end, tocSize) || tocSize > size - HEADER_SIZE)
+    {
+        qWarning() << __FUNCTION__ << "Not an asset archive or unsupported version:" << fileName;
+        return false;
+    }
+
+    const uchar* tocEnd = pos + tocSize;
+    bool valid = readString(pos, tocEnd, root_);
+
+    for(quint32 i = 0; valid && i < count; ++i)
+    {
+        QString path;
+        quint64 offset = 0;
+        quint32 storedSize = 0;
+        quint32 flags = 0;
+
+        valid = readString(pos, tocEnd, path) && readUInt64(pos, tocEnd, offset) &&
+            readUInt32(pos, tocEnd, storedSize) && readUInt32(pos, tocEnd, flags) &&
+            offset <= static_cast<quint64>(size) && storedSize <= size - offset;
+
+        if(valid)
+        {
+            Entry entry = { mapping_ + offset, static_cast<int>(storedSize), (flags & ENTRY_COMPRESSED) != 0 };
+            entries_.insert(path, entry);
+        }
+    }
+
+    if(!valid)
+    {
+        qWarning() << __FUNCTION__ << "Corrupted table of contents:" << fileName;
+        entries_.clear();
+        return false;
+    }
+
+    return true;
+}
+
+const QString& AssetArchive::root() const
+{
+    return root_;
+}
+
+QStringList AssetArchive::entries() const
+{
+    return entries_.keys();
+}
+
+bool AssetArchive::contains(const QString& path) const
+{
+    return entries_.contains(path);
+}
+
+bool AssetArchive::read(const QString& path, QByteArray& data) const
+{
+    auto result = entries_.find(path);
+    if(result == entries_.end())
+    {
+        return false;
+    }
+
+    if(!result->compressed)
+    {
+        data = QByteArray::fromRawData(reinterpret_cast<const char*>(result->data), result->size);
+        return true;
+    }
+
+    data = qUncompress(result->data, result->size);
+    if(data.isEmpty())
+    {
+        qWarning() << __FUNCTION__ << "Corrupted entry:" << path;
+        return false;
+    }
+
+    return true;
+}
+
+bool AssetArchive::write(const QString& fileName, const QString& directory, const QStringList& files, bool compress)
+{
+    QStringList paths;
+    for(const QString& file : files)
+    {
+        paths << QString(file).replace('\\', '/');
+    }
+
+    QVector<StoredEntry> entries(paths.count());
+
+    QFile output(fileName);
+    if(!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << fileName << output.errorString();
+        return false;
+    }
+
+    // Reserve the table of contents
+    if(output.write(tableOfContents(directory, paths, entries)) < 0)
+    {
+        return false;
+    }
+
+    for(int i = 0; i < paths.count(); ++i)
+    {
+        QFile input(directory + "/" + paths[i]);
+        if(!input.open(QIODevice::ReadOnly))
+        {
+            qWarning() << __FUNCTION__ << "Failed to open" << input.fileName() << input.errorString();
+            return false;
+        }
+
+        QByteArray data = input.readAll();
+        StoredEntry& entry = entries[i];
+        entry.flags = 0;
+
+        if(compress)
+        {
+            QByteArray compressed = qCompress(data);
+            if(compressed.size() < data.size() - data.size() / 8)
+            {
+                data = compressed;
+                entry.flags |= ENTRY_COMPRESSED;
+            }
+        }
+
+        const int padding = static_cast<int>((BLOB_ALIGNMENT - output.pos() % BLOB_ALIGNMENT) % BLOB_ALIGNMENT);
+        entry.offset = output.pos() + padding;
+        entry.size = data.size();
+
+        if(output.write(QByteArray(padding, '\0')) < 0 || output.write(data) != data.size())
+        {
+            qWarning() << __FUNCTION__ << "Failed to write" << fileName << output.errorString();
+            return false;
+        }
+    }
+
+    // Rewrite the table with the offsets
+    if(!output.seek(0) || output.write(tableOfContents(directory, paths, entries)) < 0)
+    {
+        qWarning() << __FUNCTION__ << "Failed to write" << fileName << output.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+namespace {
+    QByteArray tableOfContents(const QString& root, const QStringList& paths, const QVector<StoredEntry>& entries)
+    {
+        QByteArray toc;
+        appendString(toc, root);
+
+        for(int i = 0; i < paths.count(); ++i)
+        {
+            appendString(toc, paths[i]);
+            appendUInt64(toc, entries[i].offset);
+            appendUInt32(toc, entries[i].size);
+            appendUInt32(toc, entries[i].flags);
+        }
+
+        QByteArray header(MAGIC, sizeof(MAGIC));
+        appendUInt32(header, VERSION);
+        appendUInt32(header, paths.count());
+        appendUInt32(header, toc.size());
+
+        return header + toc;
+    }
+
+    void appendUInt32(QByteArray& bytes, quint32 value)
+    {
+        uchar buffer[sizeof(value)];
+        qToLittleEndian(value, buffer);
+        bytes.append(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+    }
+
+    void appendUInt64(QByteArray& bytes, quint64 value)
+    {
+        uchar buffer[sizeof(value)];
+        qToLittleEndian(value, buffer);
+        bytes.append(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+    }
+
+    void appendString(QByteArray& bytes, const QString& string)
+    {
+        QByteArray utf8 = string.toUtf8();
+        appendUInt32(bytes, utf8.size());
+        bytes.append(utf8);
+    }
+
+    bool readUInt32(const uchar*& pos, const uchar* end, quint32& value)
+    {
+        if(end - pos < static_cast<qint64>(sizeof(value)))
+        {
+            return false;
+        }
+
+        value = qFromLittleEndian<quint32>(pos);
+        pos += sizeof(value);
+        return true;
+    }
+
+    bool readUInt64(const uchar*& pos, const uchar* end, quint64& value)
+    {
+        if(end - pos < static_cast<qint64>(sizeof(value)))
+        {
+            return false;
+        }
+
+        value = qFromLittleEndian<quint64>(pos);
+        pos += sizeof(value);
+        return true;
+    }
+
+    bool readString(const uchar*& pos, const uchar* end, QString& string)
+    {
+        quint32 length = 0;
+        if(!readUInt32(pos, end, length) || end - pos < static_cast<qint64>(length))
+        {
+            return false;
+        }
+
+        string = QString::fromUtf8(reinterpret_cast<const char*>(pos), length);
+        pos += length;
+        return true;
+    }
+}
@@ -0,0 +1,68 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : AssetArchive packs an asset directory into a single file: a table of contents
+//             followed by the file contents, each aligned to BLOB_ALIGNMENT bytes. The archive
+//             is memory-mapped once when opened, and entries are read straight from the mapping.
+//             Entries can be stored zlib compressed, those are inflated on every read.
+//
+
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QFile>
+
+namespace Engine {
+
+class AssetArchive
+{
+public:
+    enum { BLOB_ALIGNMENT = 16 };
+
+    AssetArchive();
+    ~AssetArchive();
+
+    // Maps the archive and reads the table of contents.
+    // postcondition: false if the file can't be mapped or isn't a valid archive
+    bool open(const QString& fileName);
+
+    // Directory the archive was built from, as given to the packer. Entry paths are relative to it.
+    const QString& root() const;
+
+    // Paths of the entries relative to the root, with forward slashes.
+    QStringList entries() const;
+
+    bool contains(const QString& path) const;
+
+    // Uncompressed entries reference the mapping without copying, so the data is valid only
+    // as long as the archive is open.
+    // postcondition: false if there's no such entry, or a compressed entry is corrupted
+    bool read(const QString& path, QByteArray& data) const;
+
+    // Packs the files, given relative to the directory, into a new archive. A file is stored
+    // compressed if compress is set and compression saves at least an eighth of its size.
+    static bool write(const QString& fileName, const QString& directory, const QStringList& files, bool compress);
+
+private:
+    struct Entry
+    {
+        const uchar* data;
+        int size;           // Stored size
+        bool compressed;
+    };
+
+    QFile file_;
+    uchar* mapping_;
+    QString root_;
+    QHash<QString, Entry> entries_;
+
+    AssetArchive(const AssetArchive&);
+    AssetArchive& operator=(const AssetArchive&);
+};
+
+}
+
+#endif // ASSETARCHIVE_H
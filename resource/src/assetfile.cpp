@@ -0,0 +1,103 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "assetfile.h"
+#include "assetarchive.h"
+
+#include <QFile>
+#include <QDir>
+#include <QHash>
+#include <QList>
+#include <QDebug>
+
+#include <memory>
+
+using namespace Engine;
+
+namespace {
+    struct Location
+    {
+        const AssetArchive* archive;
+        QString path;       // Entry path in the archive
+    };
+
+    QList<std::shared_ptr<AssetArchive>> archives;
+
+    // Mounted entries by resolved path
+    QHash<QString, Location> index;
+}
+
+QAtomicInt AssetFile::archiveReads_;
+QAtomicInt AssetFile::fileReads_;
+
+bool AssetFile::mount(const QString& fileName, const QString& root)
+{
+    std::shared_ptr<AssetArchive> archive = std::make_shared<AssetArchive>();
+    if(!archive->open(fileName))
+    {
+        return false;
+    }
+
+    const QString directory = root.isEmpty() ? archive->root() : root;
+    for(const QString& entry : archive->entries())
+    {
+        Location location = { archive.get(), entry };
+        index.insert(resolve(directory + "/" + entry), location);
+    }
+
+    archives.push_back(archive);
+
+    qDebug() << __FUNCTION__ << fileName << "at" << directory;
+    return true;
+}
+
+void AssetFile::unmountAll()
+{
+    index.clear();
+    archives.clear();
+}
+
+bool AssetFile::read(const QString& fileName, QByteArray& data)
+{
+    if(!index.isEmpty())
+    {
+        auto result = index.constFind(resolve(fileName));
+        if(result != index.constEnd())
+        {
+            archiveReads_.ref();
+            return result->archive->read(result->path, data);
+        }
+    }
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    fileReads_.ref();
+    data = file.readAll();
+
+    return true;
+}
+
+bool AssetFile::exists(const QString& fileName)
+{
+    return index.contains(resolve(fileName)) || QFile::exists(fileName);
+}
+
+AssetFile::Stats AssetFile::stats()
+{
+    Stats stats = { archiveReads_.load(), fileReads_.load() };
+    return stats;
+}
+
+QString AssetFile::resolve(const QString& fileName)
+{
+    // Asset paths from model files can use either separator, and the file system is
+    // case-insensitive on Windows
+    QString path = QDir::current().absoluteFilePath(QString(fileName).replace('\\', '/'));
+    return QDir::cleanPath(path).toLower();
+}
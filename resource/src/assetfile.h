@@ -0,0 +1,55 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : AssetFile resolves asset paths to the entries of mounted archives, and falls back
+//             to the file system for paths no archive contains. Loaders read through AssetFile,
+//             so packed and loose assets are loaded with the same paths.
+//
+
+#ifndef ASSETFILE_H
+#define ASSETFILE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QAtomicInt>
+
+namespace Engine {
+
+class AssetArchive;
+
+class AssetFile
+{
+public:
+    // The archive's entries are resolved relative to root, or to the directory the archive was
+    // built from if root is empty. Archives mounted later take precedence.
+    // Archives have to be mounted before resources are loaded, and they stay mapped until unmounted.
+    static bool mount(const QString& fileName, const QString& root = QString());
+    static void unmountAll();
+
+    // Reads the whole file. Data of uncompressed archive entries references the mapping.
+    // Thread-safe.
+    static bool read(const QString& fileName, QByteArray& data);
+
+    // Tells if a mounted archive or the file system has the file.
+    static bool exists(const QString& fileName);
+
+    struct Stats
+    {
+        int archiveReads;   // Files read from mounted archives
+        int fileReads;      // Files opened from the file system
+    };
+
+    static Stats stats();
+
+private:
+    static QAtomicInt archiveReads_;
+    static QAtomicInt fileReads_;
+
+    // Key of the path in the archive index
+    static QString resolve(const QString& fileName);
+
+    AssetFile();
+};
+
+}
+
+#endif // ASSETFILE_H
@@ -4,6 +4,7 @@
 //
 
 #include "cubemapresource.h"
+#include "gpucounters.h"
 
 #include <QDebug>
 
@@ -114,6 +115,8 @@ void CubemapResource::uploadCompressed(const DataType& data)
             0,
             static_cast<GLsizei>(tex->size()),
             tex->data());
+
+        GPU_COUNT(TEXTURE_UPLOAD_BYTES, tex->size());
     }
 }
 
@@ -4,6 +4,7 @@
 //
 
 #include "cubemaptexture.h"
+#include "gpucounters.h"
 
 using namespace Engine;
 
@@ -32,6 +33,11 @@ bool CubemapTexture::create(GLenum face, GLint level, GLint internalFormat, GLsi
     gl->glBindTexture(Target, textureId_);
     gl->glTexImage2D(face, level, internalFormat, width, height, border, format, type, data);
 
+    if(data != nullptr)
+    {
+        GPU_COUNT(TEXTURE_UPLOAD_BYTES, GpuCounters::imageBytes(width, height, format, type));
+    }
+
     setDimensions(width, height);
     return true;
 }
\ No newline at end of file
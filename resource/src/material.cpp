@@ -6,28 +6,34 @@
 #include "material.h"
 
 #include "common.h"
-#include "textureloader.h"
 #include "texture2dresource.h"
 #include "binder.h"
 
 #include <QDebug>
 
+#include <gli/gli.hpp>
+
+#include <cstring>
+
 using namespace Engine;
 
 namespace {
-    Material::TexturePtr makeDefault(const QString& fileName, TextureConversion conversion);
+    // Built-in solid textures are generated in memory, so materials never read files on the render thread.
+    enum DefaultTexture { DEFAULT_WHITE, DEFAULT_WHITE_GRAYSCALE, DEFAULT_COUNT };
 
-    Material::TexturePtr fetchDefault(Material::TextureType type, const QString& fileName, TextureConversion conversion);
+    Material::TexturePtr makeDefault(DefaultTexture texture);
+
+    Material::TexturePtr fetchDefault(DefaultTexture texture);
 
     // Returns the default 1x1 texture for the type.
     Material::TexturePtr defaultTexture(Material::TextureType type);
 
     // Static default texture watchers.
-    std::array<std::weak_ptr<Texture2D>, Material::TEXTURE_COUNT> nullTextures;
+    std::array<std::weak_ptr<Texture2D>, DEFAULT_COUNT> nullTextures;
 }
 
 Material::Material()
-    : renderType_(RENDER_OPAQUE)
+    : renderType_(RENDER_OPAQUE), alphaMask_(false)
 {
 }
 
@@ -61,6 +67,17 @@ bool Material::bind()
     return true;
 }
 
+float Material::textureLayer(TextureType type)
+{
+    const TexturePtr& tex = getTexture(type);
+    if(tex == nullptr)
+    {
+        return 0.0f;
+    }
+
+    return static_cast<float>(tex->layer());
+}
+
 const Material::TexturePtr& Material::getTexture(TextureType type)
 {
     TexturePtr& tex = textures_[type];
@@ -78,12 +95,22 @@ bool Material::hasTexture(TextureType type) const
     return textures_[type] != nullptr;
 }
 
+bool Material::hasAlphaMask() const
+{
+    return alphaMask_;
+}
+
 void Material::setTexture(TextureType type, const TexturePtr& texture)
 {
     Q_ASSERT(texture != nullptr);
 
     textures_[type] = texture;
     setTextureOptions(texture);
+
+    if(type == TEXTURE_MASK)
+    {
+        alphaMask_ = true;
+    }
 }
 
 void Material::setShininess(float shininess)
@@ -151,6 +178,16 @@ Material::RenderType Material::renderType() const
     return renderType_;
 }
 
+void Material::setName(const QString& name)
+{
+    name_ = name;
+}
+
+const QString& Material::name() const
+{
+    return name_;
+}
+
 namespace {
     Material::TexturePtr defaultTexture(Material::TextureType type)
     {
@@ -158,31 +195,31 @@ namespace {
 
         if(type == Material::TEXTURE_DIFFUSE)
         {
-            target = fetchDefault(type, RESOURCE_PATH("images/white.png"), TC_RGBA);
+            target = fetchDefault(DEFAULT_WHITE);
         }
 
-        else if(type == Material::TEXTURE_MASK)
+        else if(type == Material::TEXTURE_MASK || type == Material::TEXTURE_SPECULAR ||
+            type == Material::TEXTURE_SHININESS)
         {
-            target = fetchDefault(type, RESOURCE_PATH("images/mask.png"), TC_GRAYSCALE);
-        }
-
-        else if(type == Material::TEXTURE_SPECULAR)
-        {
-            target = fetchDefault(type, RESOURCE_PATH("images/spec.png"), TC_GRAYSCALE);
-        }
-
-        else if(type == Material::TEXTURE_SHININESS)
-        {
-            target = fetchDefault(type, RESOURCE_PATH("images/spec.png"), TC_GRAYSCALE);
+            target = fetchDefault(DEFAULT_WHITE_GRAYSCALE);
         }
 
         return target;
     }
 
-    Material::TexturePtr makeDefault(const QString& fileName, TextureConversion conversion)
+    Material::TexturePtr makeDefault(DefaultTexture texture)
     {
-        std::shared_ptr<Texture2DResource> resource(new Texture2DResource(fileName, conversion));
-        if(resource->load(fileName))
+        gli::format format = texture == DEFAULT_WHITE ? gli::format::RGBA8_UNORM : gli::format::R8_UNORM;
+
+        gli::texture2D* image = new gli::texture2D(1, format, gli::texture2D::dimensions_type(1, 1));
+        std::memset(image->data(), 0xFF, image->size());
+
+        std::shared_ptr<TextureData> data = std::make_shared<TextureData>();
+        data->setTexture(image);
+
+        // Unmanaged resource is initialised immediately
+        std::shared_ptr<Texture2DResource> resource = std::make_shared<Texture2DResource>();
+        if(resource->initialiseFromData(data))
         {
             return resource;
         }
@@ -190,14 +227,14 @@ namespace {
         return nullptr;
     }
 
-    Material::TexturePtr fetchDefault(Material::TextureType type, const QString& fileName, TextureConversion conversion)
+    Material::TexturePtr fetchDefault(DefaultTexture texture)
     {
         Material::TexturePtr target;
 
-        std::weak_ptr<Texture2D>& handle = nullTextures[type];
+        std::weak_ptr<Texture2D>& handle = nullTextures[texture];
         if(handle.expired())
         {
-            target = makeDefault(fileName, conversion);
+            target = makeDefault(texture);
             handle = target;
         }
 
@@ -9,6 +9,7 @@
 #include <array>
 #include <memory>
 #include <QVector3D>
+#include <QString>
 
 namespace Engine {
 
@@ -43,10 +44,18 @@ public:
     // Returns true if a texture has been associated with the given type.
     bool hasTexture(TextureType type) const;
 
+    // Returns true if a mask texture has been set, ie. the material is alpha-tested.
+    // Unlike hasTexture, the default texture returned by getTexture isn't counted.
+    bool hasAlphaMask() const;
+
     // Binds all textures in the same order as in TextureType beginning from GL_TEXTURE0
     // precondition: false if any of the textures can't be bound
     bool bind();
 
+    // Returns the texture array layer of the texture, or 0 if the texture isn't resident in an array.
+    // Shaders compiled with TEXTURE_ARRAYS sample the bound page using the layer.
+    float textureLayer(TextureType type);
+
     void setAmbientColor(const QVector3D& color);
     void setSpecularIntensity(float intensity);
     void setDiffuseColor(const QVector3D& color);
@@ -70,10 +79,16 @@ public:
     void setRenderType(RenderType type);
     RenderType renderType() const;
 
+    // Name of the material in the imported scene. Used in profiling reports.
+    void setName(const QString& name);
+    const QString& name() const;
+
 private:
     std::array<TexturePtr, TEXTURE_COUNT> textures_;
     Attributes attributes_;
     RenderType renderType_;
+    QString name_;
+    bool alphaMask_;
 
     void setTextureOptions(const TexturePtr& texture) const;
 
@@ -0,0 +1,279 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "programbinarycache.h"
+
+#include <QRunnable>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QDebug>
+
+using namespace Engine;
+
+namespace {
+    const quint32 FILE_MAGIC = 0x45504243;  // EPBC
+    const quint32 FILE_VERSION = 1;
+}
+
+class ProgramBinaryCache::WarmTask : public QRunnable
+{
+public:
+    explicit WarmTask(ProgramBinaryCache& cache) : cache_(cache) {}
+
+    virtual void run()
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QDir dir(cache_.directory_);
+        int count = 0;
+
+        for(const QString& fileName : dir.entryList(QStringList() << "*.bin", QDir::Files))
+        {
+            QByteArray key;
+            Binary binary;
+
+            if(!cache_.readFile(dir.filePath(fileName), key, binary))
+            {
+                QFile::remove(dir.filePath(fileName));
+                continue;
+            }
+
+            // Programs linked while warming don't need the binary anymore
+            QMutexLocker lock(&cache_.mutex_);
+            if(!cache_.binaries_.contains(key) && !cache_.used_.contains(key))
+            {
+                cache_.binaries_.insert(key, binary);
+                ++count;
+            }
+        }
+
+        QMutexLocker lock(&cache_.mutex_);
+        cache_.stats_.warmTime = timer.nsecsElapsed();
+
+        qDebug() << "ProgramBinaryCache: Warmed" << count << "binaries in" << cache_.stats_.warmTime * 1e-6 << "ms";
+    }
+
+private:
+    ProgramBinaryCache& cache_;
+};
+
+ProgramBinaryCache::ProgramBinaryCache(const QString& directory)
+    : directory_(directory), supported_(false)
+{
+    // Identify the driver; binaries are not portable between drivers or driver versions
+    driver_ += reinterpret_cast<const char*>(gl->glGetString(GL_VENDOR));
+    driver_ += '|';
+    driver_ += reinterpret_cast<const char*>(gl->glGetString(GL_RENDERER));
+    driver_ += '|';
+    driver_ += reinterpret_cast<const char*>(gl->glGetString(GL_VERSION));
+
+    GLint formats = 0;
+    gl->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    supported_ = formats > 0;
+
+    if(!supported_)
+    {
+        qWarning() << __FUNCTION__ << "Driver doesn't support program binaries.";
+    }
+
+    else if(!QDir().mkpath(directory_))
+    {
+        qWarning() << __FUNCTION__ << "Failed to create cache directory:" << directory_;
+        supported_ = false;
+    }
+
+    threadPool_.setMaxThreadCount(1);
+}
+
+ProgramBinaryCache::~ProgramBinaryCache()
+{
+    threadPool_.waitForDone();
+}
+
+bool ProgramBinaryCache::isSupported() const
+{
+    return supported_;
+}
+
+void ProgramBinaryCache::warm()
+{
+    if(supported_)
+    {
+        threadPool_.start(new WarmTask(*this));
+    }
+}
+
+bool ProgramBinaryCache::load(const QByteArray& key, GLuint program)
+{
+    if(!supported_)
+    {
+        return false;
+    }
+
+    Binary binary;
+    if(!readBinary(key, binary))
+    {
+        return false;
+    }
+
+    gl->glProgramBinary(program, binary.format, binary.data.constData(), binary.data.size());
+
+    GLint status = GL_FALSE;
+    gl->glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+    if(status != GL_TRUE)
+    {
+        // Driver update or a different GPU, fall back to compiling
+        qDebug() << __FUNCTION__ << "Binary rejected by driver:" << key.toHex();
+        removeBinary(key);
+
+        QMutexLocker lock(&mutex_);
+        ++stats_.rejected;
+
+        return false;
+    }
+
+    return true;
+}
+
+bool ProgramBinaryCache::save(const QByteArray& key, GLuint program)
+{
+    if(!supported_)
+    {
+        return false;
+    }
+
+    GLint length = 0;
+    gl->glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if(length <= 0)
+    {
+        return false;
+    }
+
+    Binary binary;
+    binary.data.resize(length);
+    gl->glGetProgramBinary(program, length, nullptr, &binary.format, binary.data.data());
+
+    {
+        QMutexLocker lock(&mutex_);
+        used_.insert(key);
+    }
+
+    // Written to a temporary file which is renamed over the binary on commit
+    QSaveFile file(filePath(key));
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << __FUNCTION__ << "Failed to open" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << FILE_MAGIC << FILE_VERSION << driver_ << key << static_cast<quint32>(binary.format) << binary.data;
+
+    if(stream.status() != QDataStream::Ok || !file.commit())
+    {
+        qWarning() << __FUNCTION__ << "Failed to write" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void ProgramBinaryCache::recordLink(bool fromCache, qint64 nsecs)
+{
+    QMutexLocker lock(&mutex_);
+
+    if(fromCache)
+    {
+        ++stats_.cacheHits;
+    }
+
+    else
+    {
+        ++stats_.compiled;
+    }
+
+    stats_.linkTime += nsecs;
+}
+
+ProgramBinaryCache::Stats ProgramBinaryCache::stats() const
+{
+    QMutexLocker lock(&mutex_);
+    return stats_;
+}
+
+QString ProgramBinaryCache::filePath(const QByteArray& key) const
+{
+    return QDir(directory_).filePath(key.toHex() + ".bin");
+}
+
+bool ProgramBinaryCache::readFile(const QString& fileName, QByteArray& key, Binary& binary) const
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    quint32 magic = 0, version = 0, format = 0;
+    QByteArray driver;
+
+    QDataStream stream(&file);
+    stream >> magic >> version >> driver >> key >> format >> binary.data;
+
+    binary.format = format;
+
+    // Truncated files fail the read, and the blob has to cover the rest of the file
+    return stream.status() == QDataStream::Ok && magic == FILE_MAGIC && version == FILE_VERSION &&
+        driver == driver_ && !binary.data.isEmpty() && file.atEnd();
+}
+
+bool ProgramBinaryCache::readBinary(const QByteArray& key, Binary& binary)
+{
+    {
+        QMutexLocker lock(&mutex_);
+        used_.insert(key);
+
+        auto iter = binaries_.find(key);
+        if(iter != binaries_.end())
+        {
+            binary = iter.value();
+            binaries_.erase(iter);
+
+            return true;
+        }
+    }
+
+    // Not warmed yet
+    QString fileName = filePath(key);
+    if(!QFile::exists(fileName))
+    {
+        return false;
+    }
+
+    QByteArray fileKey;
+    if(!readFile(fileName, fileKey, binary) || fileKey != key)
+    {
+        QFile::remove(fileName);
+        return false;
+    }
+
+    return true;
+}
+
+void ProgramBinaryCache::removeBinary(const QByteArray& key)
+{
+    QFile::remove(filePath(key));
+
+    QMutexLocker lock(&mutex_);
+    binaries_.remove(key);
+}
@@ -0,0 +1,100 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : ProgramBinaryCache stores linked program binaries on disk, so shader programs
+//             don't have to be compiled and linked on every startup. Binaries are keyed by
+//             the preprocessed shader sources and the driver that produced them.
+//
+
+#ifndef PROGRAMBINARYCACHE_H
+#define PROGRAMBINARYCACHE_H
+
+#include "common.h"
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QThreadPool>
+
+namespace Engine {
+
+class ProgramBinaryCache
+{
+public:
+    // Link statistics used to compare cold and warm startups
+    struct Stats
+    {
+        Stats() : cacheHits(0), compiled(0), rejected(0), linkTime(0), warmTime(0) {}
+
+        int cacheHits;      // Programs restored from binaries
+        int compiled;       // Programs compiled from source
+        int rejected;       // Binaries rejected by the driver
+        qint64 linkTime;    // Total time spent linking programs in nanoseconds
+        qint64 warmTime;    // Time spent reading the cache from disk in nanoseconds
+    };
+
+    // The driver is identified from the current context, so binaries produced by
+    // other drivers are never loaded.
+    // precondition: OpenGL context is current
+    explicit ProgramBinaryCache(const QString& directory);
+    ~ProgramBinaryCache();
+
+    // Tells if the driver supports any program binary formats
+    bool isSupported() const;
+
+    // Reads the cached binaries from disk in a background thread. Stale binaries
+    // produced by other drivers are removed.
+    void warm();
+
+    // Uploads the cached binary for the key to the program. Warmed binaries are dropped
+    // from memory once used.
+    // postcondition: true if the binary was found and accepted by the driver,
+    //                rejected binaries are removed from the cache.
+    bool load(const QByteArray& key, GLuint program);
+
+    // Writes the program's binary for the key. The file is replaced atomically, so warming
+    // never reads a partially written binary.
+    // precondition: program is linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+    bool save(const QByteArray& key, GLuint program);
+
+    // Called by ShaderProgram after the program has been linked
+    void recordLink(bool fromCache, qint64 nsecs);
+
+    Stats stats() const;
+
+private:
+    struct Binary
+    {
+        GLenum format;
+        QByteArray data;
+    };
+
+    class WarmTask;
+
+    QString directory_;
+    QByteArray driver_;
+    bool supported_;
+
+    // Warmed binaries waiting to be loaded, and the keys already loaded or saved
+    QHash<QByteArray, Binary> binaries_;
+    QSet<QByteArray> used_;
+    Stats stats_;
+    mutable QMutex mutex_;
+
+    QThreadPool threadPool_;
+
+    QString filePath(const QByteArray& key) const;
+
+    // Reads a binary file, returns false if the file is invalid or belongs to another driver.
+    bool readFile(const QString& fileName, QByteArray& key, Binary& binary) const;
+    bool readBinary(const QByteArray& key, Binary& binary);
+    void removeBinary(const QByteArray& key);
+
+    ProgramBinaryCache(const ProgramBinaryCache&);
+    ProgramBinaryCache& operator=(const ProgramBinaryCache&);
+};
+
+}
+
+#endif // PROGRAMBINARYCACHE_H
@@ -57,6 +57,12 @@ ProxyDespatcher::WeakResourcePtr ProxyDespatcher::findResource(const QString& fi
         weakPtr = result.value();
     }
 
+    // Resources managed by the target are shared instead of loaded again
+    if(weakPtr.expired() && target_ != nullptr)
+    {
+        weakPtr = target_->findShared(fileName);
+    }
+
     return weakPtr;
 }
 
@@ -7,9 +7,12 @@
 #include "resourcedata.h"
 
 #include <QDebug>
+#include <QOpenGLContext>
 
 using namespace Engine;
 
+QAtomicInt ResourceBase::blockingLoads_;
+
 ResourceBase::ResourceBase()
     : despatcher_(nullptr), initialized_(false), released_(true)
 {
@@ -76,6 +79,13 @@ bool ResourceBase::load(const QString& fileName)
         return false;
     }
 
+    // File I/O stalls the frame if the caller is rendering
+    if(QOpenGLContext::currentContext() != nullptr)
+    {
+        blockingLoads_.ref();
+        qWarning() << __FUNCTION__ << "Blocking load on the render thread:" << fileName;
+    }
+
     data_ = createData();
     if(!data_->load(fileName))
     {
@@ -125,6 +135,11 @@ void ResourceBase::release()
     releaseResource();
 }
 
+int ResourceBase::blockingLoads()
+{
+    return blockingLoads_.load();
+}
+
 bool ResourceBase::managed() const
 {
     return despatcher_ != nullptr;
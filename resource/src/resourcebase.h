@@ -9,6 +9,7 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <QAtomicInt>
 
 #include <memory>
 
@@ -29,8 +30,13 @@ public:
     virtual ~ResourceBase();
 
     // Synchronous data loading, returns false if the object is managed
+    // Loads on a thread with a current OpenGL context are counted as blocking the render thread.
     virtual bool load(const QString& fileName);
 
+    // Returns the number of synchronous loads done on the render thread.
+    // Resources used during rendering should be loaded through ResourceDespatcher instead.
+    static int blockingLoads();
+
     // Attemps to initialise the resource from data, or return true if
     // the resource has already been initialised. Returns always true if the resource is not
     // managed.
@@ -99,6 +105,8 @@ private:
     bool initialized_;
     bool released_;     // To prevent reloading
 
+    static QAtomicInt blockingLoads_;
+
     // precondition: data has been set
     bool initialiseResource();
 
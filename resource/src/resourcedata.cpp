@@ -25,4 +25,9 @@ void ResourceData::setDespatcher(ResourceDespatcher* despatcher)
 QStringList ResourceData::queryFilesDebug() const
 {
     return QStringList();
+}
+
+qint64 ResourceData::byteSize() const
+{
+    return 0;
 }
\ No newline at end of file
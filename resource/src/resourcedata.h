@@ -31,6 +31,12 @@ public:
     // Reimplement to provide additional triggers for file watching
     virtual QStringList queryFilesDebug() const;
 
+    // Size of the loaded data in bytes. Data which can initialise more than one resource
+    // reimplements this, so the despatcher can retain it after the resource is released.
+    // The size also approximates the GPU memory of the initialised resource.
+    // Returns 0 by default, which means the data is consumed by initialisation.
+    virtual qint64 byteSize() const;
+
 private:
     ResourceDespatcher* despatcher_;
 
@@ -39,6 +39,10 @@ public:
 
     typedef std::shared_ptr<ResourceBase> ResourcePtr;
 
+    // Returns the managed resource of the file without loading it, or nullptr.
+    // Can be called from loader threads, so that they share the resources instead of loading them again.
+    virtual ResourcePtr findShared(const QString& fileName) { return nullptr; }
+
 public slots:
     // Can be used to move resources between despatchers.
     // The resource is loaded by the target despatcher and ownership is copied.
@@ -7,28 +7,58 @@
 
 #include "resourcedata.h"
 #include "resourcebase.h"
+#include "tracer.h"
+#include "framestatistics.h"
 
 #include <QDebug>
 #include <QThread>
+#include <QElapsedTimer>
 
 using namespace Engine;
 
-ResourceLoader::ResourceLoader(ResourceBase& resource, const QString& fileName, ResourceDespatcher& despatcher, QObject* parent)
-    : QObject(parent), QRunnable(), target_(despatcher), fileName_(fileName)
+ResourceLoader::ResourceLoader(const ResourcePtr& resource, const QString& fileName, ResourceDespatcher& despatcher, QObject* parent)
+    : QObject(parent), QRunnable(), resource_(resource), target_(despatcher), fileName_(fileName),
+      loadStatistic_(nullptr)
 {
-    data_ = resource.createData();
+    data_ = resource->createData();
+}
+
+void ResourceLoader::setLoadStatistic(Statistic* statistic)
+{
+    loadStatistic_ = statistic;
 }
 
 void ResourceLoader::run()
 {
+    if(Tracer::enabled())
+    {
+        Tracer::setThreadName("Resource loader");
+    }
+
+    TRACE_SCOPE("Load resource");
+
     proxy_.setTarget(&target_);
     data_->setDespatcher(&proxy_);
 
     qDebug() << "Loading:" << fileName_;
 
-    if(data_->load(fileName_))
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    bool loaded = data_->load(fileName_);
+
+    if(loadStatistic_ != nullptr)
+    {
+        loadStatistic_->add(loadTimer.nsecsElapsed());
+    }
+
+    if(loaded)
     {
-        emit resourceLoaded(fileName_, data_);
+        // Resource might have been deleted while loading
+        if(!resource_.expired())
+        {
+            emit resourceLoaded(resource_, data_);
+        }
     }
 
     else
@@ -36,4 +66,6 @@ void ResourceLoader::run()
         qWarning() << "Failed to load:" << fileName_;
         data_.reset();
     }
+
+    emit loadFinished();
 }
\ No newline at end of file
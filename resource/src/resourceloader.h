@@ -15,6 +15,8 @@
 #include "resourcedata.h"
 #include "proxydespatcher.h"
 
+class Statistic;
+
 namespace Engine {
 
 class ResourceData;
@@ -26,20 +28,33 @@ class ResourceLoader : public QObject, public QRunnable
 
 public:
     typedef std::shared_ptr<ResourceData> ResourceDataPtr;
+    typedef std::shared_ptr<ResourceBase> ResourcePtr;
+    typedef std::weak_ptr<ResourceBase> WeakResourcePtr;
 
-    explicit ResourceLoader(ResourceBase& resource, const QString& fileName, ResourceDespatcher& despatcher,
+    explicit ResourceLoader(const ResourcePtr& resource, const QString& fileName, ResourceDespatcher& despatcher,
         QObject* parent = nullptr);
 
+    // Records the time spent loading the file in nanoseconds. Set before the loader is started.
+    void setLoadStatistic(Statistic* statistic);
+
     virtual void run();
 
 signals:
-    void resourceLoaded(QString name, ResourceDataPtr data);
+    // The handle is passed instead of the name, since several resources can share the same
+    // file, eg. shader permutations. The handle is weak, so the loader thread never holds the
+    // last reference to a resource and deletes its GL objects without a context.
+    void resourceLoaded(WeakResourcePtr resource, ResourceDataPtr data);
+
+    // Emitted after every load attempt, whether it succeeded or not.
+    void loadFinished();
 
 private:
     ProxyDespatcher proxy_;
     ResourceDataPtr data_;
+    std::weak_ptr<ResourceBase> resource_;
     ResourceDespatcher& target_;
     QString fileName_;
+    Statistic* loadStatistic_;
 };
 
 }
@@ -31,13 +31,10 @@ Shader::~Shader()
 
 bool Shader::initialiseData(const DataType& data)
 {
-    shader_ = new QOpenGLShader(type_);
-    if(!shader_->compileSourceCode(data.data()))
-    {
-        return false;
-    }
-    
-    return true;
+    source_ = data.data();
+    sourceHash_ = data.sourceHash();
+
+    return !source_.isEmpty();
 }
 
 void Shader::releaseResource()
@@ -47,6 +44,31 @@ void Shader::releaseResource()
         delete shader_;
         shader_ = nullptr;
     }
+
+    source_.clear();
+    sourceHash_.clear();
+}
+
+bool Shader::compile()
+{
+    if(shader_ != nullptr)
+    {
+        return shader_->isCompiled();
+    }
+
+    shader_ = new QOpenGLShader(type_);
+    if(!shader_->compileSourceCode(source_))
+    {
+        qWarning() << __FUNCTION__ << "Failed to compile shader:" << name();
+        return false;
+    }
+
+    return true;
+}
+
+const QByteArray& Shader::sourceHash() const
+{
+    return sourceHash_;
 }
 
 QOpenGLShader* Shader::get() const
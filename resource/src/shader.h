@@ -24,9 +24,18 @@ public:
     virtual ~Shader();
 
     // Returns the managed QOpenGLShader object
-    // postcondition: If the resource is not loaded, nullptr is returned
+    // postcondition: If the shader has not been compiled, nullptr is returned
     QOpenGLShader* get() const;
 
+    // Compiles the loaded source, or returns true if the shader has already been compiled.
+    // Compilation is deferred so programs can be restored from ProgramBinaryCache instead.
+    // precondition: resource is ready
+    bool compile();
+
+    // Returns a hash of the preprocessed source, including defines and included files.
+    // precondition: resource is ready
+    const QByteArray& sourceHash() const;
+
     Type type() const;
 
     // Sets the named define values. Name defines must be in format
@@ -41,6 +50,8 @@ protected:
 
 private:
     QOpenGLShader* shader_;
+    QByteArray source_;
+    QByteArray sourceHash_;
     Type type_;
     QStringList additionalFiles_;
     ShaderData::DefineMap defines_;
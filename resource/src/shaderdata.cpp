@@ -4,115 +4,12 @@
 //
 
 #include "shaderdata.h"
+#include "shaderpreprocessor.h"
 
-#include <QDebug>
-#include <QFile>
-#include <QFileInfo>
-#include <QDir>
-
-#include <memory>
+#include <QCryptographicHash>
 
 using namespace Engine;
 
-struct ShaderParser;
-
-struct ParserRule
-{
-    virtual QRegExp& match() = 0;
-
-    // Returns false if the line should be discarded
-    virtual bool parse(QString& line, ShaderParser& parser) = 0;
-};
-
-struct ShaderParser
-{
-    typedef std::shared_ptr<ParserRule> ParserRulePtr;
-    typedef QList<ParserRulePtr> ParserRuleList;
-
-    ShaderParser(QByteArray& result, QStringList& files, const ParserRuleList& rules)
-        : result_(result), additionalFiles_(files), rules_(rules)
-    {
-    }
-
-    QString fileName_;
-    QStringList& additionalFiles_;
-    QByteArray& result_;
-    const ParserRuleList& rules_;
-
-    bool parse(const QString& fileName);
-};
-
-struct IncludeRule : public ParserRule
-{
-    IncludeRule()
-        : rxInclude_("^\\s*#include\\s*\"([^\"\']+)\"\\s*$")
-    {
-    }
-
-    QRegExp rxInclude_;
-
-    virtual QRegExp& match()
-    {
-        return rxInclude_;
-    }
-
-    virtual bool parse(QString& line, ShaderParser& parser)
-    {
-        QString fileRel = rxInclude_.cap(1);
-        QString dir = QFileInfo(parser.fileName_).dir().path();
-
-        if(!dir.isEmpty())
-        {
-            dir += QDir::separator();
-        }
-
-        QByteArray result;
-        if(!parser.parse(dir + fileRel))
-        {
-            return false;
-        }
-
-        line = result;
-        parser.additionalFiles_ << dir + fileRel;
-
-        return true;
-    }
-};
-
-struct DefineRule : public ParserRule
-{
-    DefineRule(const ShaderData::DefineMap& map)
-        : defines_(map), rxDefine_("^\\s*#define\\s*([\\d|\\w]+)\\s*<>\\s*$")
-    {
-    }
-
-    const ShaderData::DefineMap& defines_;
-    QRegExp rxDefine_;
-
-    virtual QRegExp& match()
-    {
-        return rxDefine_;
-    }
-
-    // Returns false if the line should be discarded
-    virtual bool parse(QString& line, ShaderParser& parser)
-    {
-        QString key = rxDefine_.cap(1);
-        auto result = defines_.find(key);
-        if(result != defines_.end())
-        {
-            line = line.replace("<>", result->toString());
-        }
-
-        else
-        {
-            qWarning() << __FUNCTION__ << "Named define" << key << "found, but no matching value exists.";
-        }
-
-        return true;
-    }
-};
-
 ShaderData::ShaderData()
     : ResourceData()
 {
@@ -120,12 +17,18 @@ ShaderData::ShaderData()
 
 bool ShaderData::load(const QString& fileName)
 {
-    ShaderParser::ParserRuleList rules;
-    rules << std::make_shared<DefineRule>(defines_);
-    rules << std::make_shared<IncludeRule>();
+    ShaderPreprocessor preprocessor(defines_);
+    if(!preprocessor.process(fileName, data_))
+    {
+        return false;
+    }
 
-    ShaderParser parser(data_, additionalFiles_, rules);
-    return parser.parse(fileName);
+    // Includes are watched in debug builds, so editing an include reloads only the shaders using it
+    additionalFiles_ = preprocessor.dependencies();
+
+    // Hash in the loader thread so programs can be looked up from the binary cache cheaply
+    sourceHash_ = QCryptographicHash::hash(data_, QCryptographicHash::Sha1);
+    return true;
 }
 
 const QByteArray& ShaderData::data() const
@@ -133,6 +36,11 @@ const QByteArray& ShaderData::data() const
     return data_;
 }
 
+const QByteArray& ShaderData::sourceHash() const
+{
+    return sourceHash_;
+}
+
 QStringList ShaderData::queryFilesDebug() const
 {
     return additionalFiles_;
@@ -143,33 +51,20 @@ void ShaderData::setDefines(const DefineMap& map)
     defines_ = map;
 }
 
-bool ShaderParser::parse(const QString& fileName)
+QString ShaderData::definesKey(const DefineMap& map)
 {
-    fileName_ = fileName;
-
-    QFile file(fileName_);
-    QString line;
+    QString key;
 
-    if(!file.open(QIODevice::ReadOnly))
+    // QMap is ordered by key, so the result doesn't depend on insertion order
+    for(auto it = map.begin(); it != map.end(); ++it)
     {
-        qWarning() << "Failed to open" << fileName_ << file.errorString();
-        return false;
-    }
-    
-    while(!file.atEnd())
-    {
-        line = file.readLine();
-
-        for(const ParserRulePtr& rule : rules_)
+        if(!key.isEmpty())
         {
-            if(rule->match().exactMatch(line) && rule->parse(line, *this))
-            {
-                break;
-            }
+            key += ';';
         }
 
-        result_.append(line);
+        key += it.key() + '=' + it.value().toString();
     }
 
-    return true;
+    return key;
 }
\ No newline at end of file
@@ -23,14 +23,22 @@ public:
 
     const QByteArray& data() const;
 
+    // Returns a hash of the preprocessed source, which covers the defines and included files.
+    const QByteArray& sourceHash() const;
+
     // Reimplement to provide additional triggers for file watching
     virtual QStringList queryFilesDebug() const;
 
     typedef QMap<QString, QVariant> DefineMap;
     void setDefines(const DefineMap& map);
 
+    // Returns a canonical representation of the define set, eg. "LIGHT_TYPE=1;SAMPLES=4".
+    // Equal define sets produce equal keys, which is used to identify shader permutations.
+    static QString definesKey(const DefineMap& map);
+
 private:
     QByteArray data_;
+    QByteArray sourceHash_;
     QStringList additionalFiles_;
     DefineMap defines_;
 };
@@ -0,0 +1,488 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "shaderpreprocessor.h"
+#include "assetfile.h"
+
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+
+#include <cctype>
+
+using namespace Engine;
+
+struct ShaderPreprocessor::ParsedFile
+{
+    enum TokenType { TEXT, INCLUDE, NAMED_DEFINE, IFDEF, IFNDEF, IF, ELIF, ELSE, ENDIF };
+
+    struct Token
+    {
+        TokenType type;
+        QByteArray text;    // Verbatim source; consecutive text lines are merged
+        QString name;       // Include path, define name or #elif expression
+    };
+
+    QVector<Token> tokens;
+};
+
+namespace {
+    const int MAX_INCLUDE_DEPTH = 32;
+
+    struct CacheEntry
+    {
+        QDateTime modified;
+        ShaderPreprocessor::ParsedFilePtr file;
+    };
+
+    QHash<QString, CacheEntry> parsedFiles;
+    QMutex cacheMutex;
+
+    bool isSpace(char c);
+    QByteArray readWord(const QByteArray& line, int& pos);
+
+    // Returns false if the line is not a directive handled by the preprocessor
+    bool parseDirective(const QByteArray& line, int pos, const QString& dir, ShaderPreprocessor::ParsedFile::Token& token);
+
+    void tokenise(const QByteArray& source, const QString& dir, ShaderPreprocessor::ParsedFile& file);
+}
+
+ShaderPreprocessor::ShaderPreprocessor(const ShaderData::DefineMap& defines)
+    : defines_(defines), depth_(0)
+{
+}
+
+bool ShaderPreprocessor::process(const QString& fileName, QByteArray& output)
+{
+    dependencies_.clear();
+    depth_ = 0;
+
+    ParsedFilePtr file = parse(QDir::cleanPath(fileName));
+    if(file == nullptr)
+    {
+        return false;
+    }
+
+    return expand(*file, output);
+}
+
+const QStringList& ShaderPreprocessor::dependencies() const
+{
+    return dependencies_;
+}
+
+void ShaderPreprocessor::clearCache()
+{
+    QMutexLocker lock(&cacheMutex);
+    parsedFiles.clear();
+}
+
+ShaderPreprocessor::ParsedFilePtr ShaderPreprocessor::parse(const QString& fileName)
+{
+    QFileInfo info(fileName);
+    QDateTime modified = info.lastModified();
+
+    {
+        QMutexLocker lock(&cacheMutex);
+
+        auto iter = parsedFiles.find(fileName);
+        if(iter != parsedFiles.end() && iter->modified == modified)
+        {
+            return iter->file;
+        }
+    }
+
+    // Archived files have no modification time, and are parsed once
+    QByteArray source;
+    if(!AssetFile::read(fileName, source))
+    {
+        qWarning() << "Failed to open" << fileName;
+        return nullptr;
+    }
+
+    // Tokens are memoised, so they must not reference the archive mapping
+    source.detach();
+
+    std::shared_ptr<ParsedFile> parsed = std::make_shared<ParsedFile>();
+    tokenise(source, info.path(), *parsed);
+
+    CacheEntry entry;
+    entry.modified = modified;
+    entry.file = parsed;
+
+    QMutexLocker lock(&cacheMutex);
+    parsedFiles.insert(fileName, entry);
+
+    return parsed;
+}
+
+bool ShaderPreprocessor::expand(const ParsedFile& file, QByteArray& output)
+{
+    typedef ParsedFile::Token Token;
+
+    // Conditionals resolved against the define map are stripped. Unresolved conditionals are
+    // passed through, and only tracked to match their #else and #endif.
+    struct Condition
+    {
+        bool resolved;
+        bool active;
+        bool taken;
+    };
+
+    QVector<Condition> conditions;
+    bool active = true;
+
+    auto updateActive = [&conditions, &active]()
+    {
+        active = true;
+        for(const Condition& condition : conditions)
+        {
+            if(condition.resolved && !condition.active)
+            {
+                active = false;
+                break;
+            }
+        }
+    };
+
+    for(const Token& token : file.tokens)
+    {
+        switch(token.type)
+        {
+        case ParsedFile::TEXT:
+            {
+                if(active)
+                {
+                    output.append(token.text);
+                }
+
+                break;
+            }
+
+        case ParsedFile::INCLUDE:
+            {
+                if(!active)
+                {
+                    break;
+                }
+
+                if(depth_ >= MAX_INCLUDE_DEPTH)
+                {
+                    qWarning() << __FUNCTION__ << "Include depth exceeded, recursive include?" << token.name;
+                    return false;
+                }
+
+                ParsedFilePtr included = parse(token.name);
+                if(included == nullptr)
+                {
+                    return false;
+                }
+
+                if(!dependencies_.contains(token.name))
+                {
+                    dependencies_ << token.name;
+                }
+
+                ++depth_;
+                bool result = expand(*included, output);
+                --depth_;
+
+                if(!result)
+                {
+                    return false;
+                }
+
+                // Included file might not end with a newline
+                if(!output.endsWith('\n'))
+                {
+                    output.append('\n');
+                }
+
+                break;
+            }
+
+        case ParsedFile::NAMED_DEFINE:
+            {
+                if(!active)
+                {
+                    break;
+                }
+
+                auto result = defines_.find(token.name);
+                if(result != defines_.end())
+                {
+                    QByteArray line = token.text;
+                    output.append(line.replace("<>", result->toString().toLatin1()));
+                }
+
+                else
+                {
+                    qWarning() << __FUNCTION__ << "Named define" << token.name << "found, but no matching value exists.";
+                    output.append(token.text);
+                }
+
+                break;
+            }
+
+        case ParsedFile::IFDEF:
+        case ParsedFile::IFNDEF:
+            {
+                Condition condition;
+                condition.resolved = defines_.contains(token.name);
+                condition.active = !condition.resolved || token.type == ParsedFile::IFDEF;
+                condition.taken = condition.active;
+
+                if(!condition.resolved && active)
+                {
+                    output.append(token.text);
+                }
+
+                conditions.push_back(condition);
+                updateActive();
+                break;
+            }
+
+        case ParsedFile::IF:
+            {
+                Condition condition = { false, true, true };
+                conditions.push_back(condition);
+
+                if(active)
+                {
+                    output.append(token.text);
+                }
+
+                break;
+            }
+
+        case ParsedFile::ELIF:
+        case ParsedFile::ELSE:
+            {
+                if(conditions.isEmpty())
+                {
+                    qWarning() << __FUNCTION__ << "Unmatched conditional:" << token.text.trimmed();
+                    return false;
+                }
+
+                Condition& top = conditions.back();
+                if(!top.resolved)
+                {
+                    if(active)
+                    {
+                        output.append(token.text);
+                    }
+                }
+
+                else if(top.taken)
+                {
+                    top.active = false;
+                }
+
+                else if(token.type == ParsedFile::ELSE)
+                {
+                    top.active = true;
+                    top.taken = true;
+                }
+
+                // Resolved branch wasn't taken, continue as an unresolved conditional
+                else
+                {
+                    top.resolved = false;
+                    top.active = true;
+                    top.taken = true;
+                    updateActive();
+
+                    if(active)
+                    {
+                        output.append("#if " + token.name.toLatin1() + "\n");
+                    }
+                }
+
+                updateActive();
+                break;
+            }
+
+        case ParsedFile::ENDIF:
+            {
+                if(conditions.isEmpty())
+                {
+                    qWarning() << __FUNCTION__ << "Unmatched conditional:" << token.text.trimmed();
+                    return false;
+                }
+
+                bool resolved = conditions.back().resolved;
+                conditions.pop_back();
+                updateActive();
+
+                if(!resolved && active)
+                {
+                    output.append(token.text);
+                }
+
+                break;
+            }
+        }
+    }
+
+    if(!conditions.isEmpty())
+    {
+        qWarning() << __FUNCTION__ << "Unterminated conditional block.";
+        return false;
+    }
+
+    return true;
+}
+
+namespace {
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    QByteArray readWord(const QByteArray& line, int& pos)
+    {
+        while(pos < line.size() && isSpace(line[pos]))
+        {
+            ++pos;
+        }
+
+        int start = pos;
+        while(pos < line.size() && (isalnum(static_cast<unsigned char>(line[pos])) || line[pos] == '_'))
+        {
+            ++pos;
+        }
+
+        return line.mid(start, pos - start);
+    }
+
+    bool parseDirective(const QByteArray& line, int pos, const QString& dir, ShaderPreprocessor::ParsedFile::Token& token)
+    {
+        typedef ShaderPreprocessor::ParsedFile ParsedFile;
+
+        // Skip '#'
+        ++pos;
+
+        const QByteArray directive = readWord(line, pos);
+        const QByteArray rest = line.mid(pos).trimmed();
+
+        token.text = line;
+
+        if(directive == "include")
+        {
+            if(rest.size() < 2 || rest[0] != '"' || rest[rest.size() - 1] != '"')
+            {
+                return false;
+            }
+
+            QString file = QString::fromLatin1(rest.mid(1, rest.size() - 2));
+
+            token.type = ParsedFile::INCLUDE;
+            token.name = QDir::cleanPath(dir.isEmpty() ? file : dir + '/' + file);
+        }
+
+        else if(directive == "define")
+        {
+            int namePos = 0;
+            QByteArray name = readWord(rest, namePos);
+
+            if(name.isEmpty() || rest.mid(namePos).trimmed() != "<>")
+            {
+                return false;
+            }
+
+            token.type = ParsedFile::NAMED_DEFINE;
+            token.name = QString::fromLatin1(name);
+        }
+
+        else if(directive == "ifdef" || directive == "ifndef")
+        {
+            token.type = directive == "ifdef" ? ParsedFile::IFDEF : ParsedFile::IFNDEF;
+            token.name = QString::fromLatin1(rest);
+        }
+
+        else if(directive == "if")
+        {
+            token.type = ParsedFile::IF;
+        }
+
+        else if(directive == "elif")
+        {
+            token.type = ParsedFile::ELIF;
+            token.name = QString::fromLatin1(rest);
+        }
+
+        else if(directive == "else")
+        {
+            token.type = ParsedFile::ELSE;
+        }
+
+        else if(directive == "endif")
+        {
+            token.type = ParsedFile::ENDIF;
+        }
+
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    void tokenise(const QByteArray& source, const QString& dir, ShaderPreprocessor::ParsedFile& file)
+    {
+        ShaderPreprocessor::ParsedFile::Token text;
+        text.type = ShaderPreprocessor::ParsedFile::TEXT;
+
+        int pos = 0;
+        int textStart = 0;
+
+        while(pos < source.size())
+        {
+            int end = source.indexOf('\n', pos);
+            end = end == -1 ? source.size() : end + 1;
+
+            int first = pos;
+            while(first < end && (source[first] == ' ' || source[first] == '\t'))
+            {
+                ++first;
+            }
+
+            ShaderPreprocessor::ParsedFile::Token token;
+            if(first < end && source[first] == '#' &&
+                parseDirective(source.mid(pos, end - pos), first - pos, dir, token))
+            {
+                // Flush preceding text as a single token
+                if(pos > textStart)
+                {
+                    text.text = source.mid(textStart, pos - textStart);
+                    file.tokens.push_back(text);
+                }
+
+                // Make sure the directive is terminated if it is the last line
+                if(!token.text.endsWith('\n'))
+                {
+                    token.text.append('\n');
+                }
+
+                file.tokens.push_back(token);
+                textStart = end;
+            }
+
+            pos = end;
+        }
+
+        if(pos > textStart)
+        {
+            text.text = source.mid(textStart, pos - textStart);
+            file.tokens.push_back(text);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Single-pass preprocessor for shader sources. Resolves #include directives,
+//             named defines (#define NAME <>) and #ifdef/#ifndef over the DefineMap.
+//             Parsed files are memoised by path and modification time, so shared includes
+//             and shader permutations are read from disk only once.
+//
+
+#ifndef SHADERPREPROCESSOR_H
+#define SHADERPREPROCESSOR_H
+
+#include "shaderdata.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+namespace Engine {
+
+class ShaderPreprocessor
+{
+public:
+    explicit ShaderPreprocessor(const ShaderData::DefineMap& defines);
+
+    // Preprocesses the file and its includes, appending the result to output.
+    // Conditionals over names which are not in the define map are passed to the compiler.
+    // postcondition: true on success
+    bool process(const QString& fileName, QByteArray& output);
+
+    // Returns the files included by the processed file, directly or indirectly.
+    // Includes in inactive conditional blocks are not dependencies.
+    const QStringList& dependencies() const;
+
+    // Clears the memoised files.
+    static void clearCache();
+
+    struct ParsedFile;
+    typedef std::shared_ptr<const ParsedFile> ParsedFilePtr;
+
+private:
+    const ShaderData::DefineMap& defines_;
+    QStringList dependencies_;
+    int depth_;
+
+    // Returns the memoised file, or reads and tokenises it if it has been modified.
+    // Thread-safe. Returns nullptr if the file can't be read.
+    static ParsedFilePtr parse(const QString& fileName);
+
+    bool expand(const ParsedFile& file, QByteArray& output);
+
+    ShaderPreprocessor(const ShaderPreprocessor&);
+    ShaderPreprocessor& operator=(const ShaderPreprocessor&);
+};
+
+}
+
+#endif // SHADERPREPROCESSOR_H
@@ -4,12 +4,18 @@
 //
 
 #include "shaderprogram.h"
+#include "programbinarycache.h"
+#include "common.h"
 
 #include <algorithm>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
 
 using namespace Engine;
 
+ProgramBinaryCache* ShaderProgram::binaryCache_ = nullptr;
+
 ShaderProgram::ShaderProgram(QObject* parent)
     : QObject(parent), program_(nullptr), needsLink_(false)
 {
@@ -25,16 +31,6 @@ bool ShaderProgram::addShader(const Shader::Ptr& shader)
     {
         return false;
     }
-    
-    // If the shader is already compiled, we don't need to wait for signal
-    if(shader->ready() && shader->get()->isCompiled())
-    {
-        if(!program_.addShader(shader->get()))
-        {
-            qDebug() << __FUNCTION__ << "Failed to add shader:" << shader->name();
-            return false;
-        }
-    }
 
     shaders_.push_back(shader);
     needsLink_ = true;
@@ -53,6 +49,11 @@ QOpenGLShaderProgram& ShaderProgram::get()
     return program_;
 }
 
+void ShaderProgram::setBinaryCache(ProgramBinaryCache* cache)
+{
+    binaryCache_ = cache;
+}
+
 void ShaderProgram::shaderReleased(const QString& name)
 {
     // Find shader
@@ -61,14 +62,15 @@ void ShaderProgram::shaderReleased(const QString& name)
 
     Q_ASSERT(iter != shaders_.end());
 
+    // Programs restored from binaries don't have any shaders attached
     QList<QOpenGLShader*> linked = program_.shaders();
     if(linked.count((*iter)->get()) > 0)
     {
         program_.removeShader((*iter)->get());
-        program_.release();
-
-        needsLink_ = true;
     }
+
+    program_.release();
+    needsLink_ = true;
 }
 
 bool ShaderProgram::ready()
@@ -77,11 +79,8 @@ bool ShaderProgram::ready()
     {
         needsLink_ = false;
 
-        if(!program_.link())
+        if(!link())
         {
-            qDebug() << __FUNCTION__ << "Failed to link program:";
-            qDebug() << program_.log();
-
             return false;
         }
     }
@@ -89,6 +88,73 @@ bool ShaderProgram::ready()
     return program_.isLinked();
 }
 
+bool ShaderProgram::link()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Binaries can only be used when the program has no shaders attached
+    program_.removeAllShaders();
+
+    QByteArray key;
+    if(binaryCache_ != nullptr && binaryCache_->isSupported())
+    {
+        key = binaryKey();
+
+        // QOpenGLShaderProgram accepts a program without shaders as linked if the binary was valid
+        if(binaryCache_->load(key, program_.programId()) && program_.link())
+        {
+            binaryCache_->recordLink(true, timer.nsecsElapsed());
+            return true;
+        }
+    }
+
+    for(const Shader::Ptr& shader : shaders_)
+    {
+        if(!shader->compile() || !program_.addShader(shader->get()))
+        {
+            qDebug() << __FUNCTION__ << "Failed to add shader:" << shader->name();
+            return false;
+        }
+    }
+
+    if(!key.isEmpty())
+    {
+        gl->glProgramParameteri(program_.programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    if(!program_.link())
+    {
+        qDebug() << __FUNCTION__ << "Failed to link program:";
+        qDebug() << program_.log();
+
+        return false;
+    }
+
+    if(!key.isEmpty())
+    {
+        binaryCache_->save(key, program_.programId());
+        binaryCache_->recordLink(false, timer.nsecsElapsed());
+    }
+
+    return true;
+}
+
+QByteArray ShaderProgram::binaryKey() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    for(const Shader::Ptr& shader : shaders_)
+    {
+        const int type = shader->type();
+
+        hash.addData(reinterpret_cast<const char*>(&type), sizeof(type));
+        hash.addData(shader->sourceHash());
+    }
+
+    return hash.result();
+}
+
 bool ShaderProgram::bind()
 {
     return ready() && program_.bind();
@@ -101,18 +167,13 @@ bool ShaderProgram::shadersLoaded()
         return false;
     }
 
-    QList<QOpenGLShader*> linked = program_.shaders();
     for(const Shader::Ptr& shader : shaders_)
     {
-        if(shader->ready() && linked.count(shader->get()) < 1)
+        if(!shader->ready())
         {
-            if(!program_.addShader(shader->get()))
-            {
-                qDebug() << "Failed to link shader:" << shader->name();
-                return false;
-            }
+            return false;
         }
     }
 
-    return shaders_.size() == program_.shaders().count();
+    return true;
 }
\ No newline at end of file
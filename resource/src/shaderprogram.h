@@ -14,6 +14,8 @@
 
 namespace Engine {
 
+class ProgramBinaryCache;
+
 class ShaderProgram : public QObject
 {
     Q_OBJECT
@@ -24,8 +26,7 @@ public:
 
     // Adds a new shader to the program
     // precondition: shader != nullptr
-    // postcondition: If the shader is already compiled, it is added immediately to the program,
-    //                otherwise the program linkin is delayed until the resource is ready.
+    // postcondition: The program linking is delayed until all the resources are ready.
     //                Shader ownership is maintained.
     bool addShader(const Shader::Ptr& shader);
 
@@ -38,6 +39,10 @@ public:
     QOpenGLShaderProgram* operator->();
     QOpenGLShaderProgram& get();
 
+    // Sets the cache used to restore linked programs instead of compiling the shaders.
+    // If cache is nullptr, programs are always compiled.
+    static void setBinaryCache(ProgramBinaryCache* cache);
+
 public slots:
     void shaderReleased(const QString& name);
 
@@ -47,9 +52,18 @@ private:
     QOpenGLShaderProgram program_;
     bool needsLink_;
 
-    // Returns true if all the added shaders have been compiled.
+    static ProgramBinaryCache* binaryCache_;
+
+    // Returns true if all the added shaders have been loaded.
     // Returns false if no shaders have been added.
     bool shadersLoaded();
+
+    // Restores the program from the binary cache, or compiles and links the shaders.
+    // precondition: shaders loaded
+    bool link();
+
+    // Hash of the shader sources in the order they were added
+    QByteArray binaryKey() const;
 };
 
 }
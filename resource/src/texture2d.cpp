@@ -4,6 +4,7 @@
 //
 
 #include "texture2d.h"
+#include "gpucounters.h"
 
 #include <QDebug>
 
@@ -32,6 +33,11 @@ bool Texture2D::create(GLint level, GLint internalFormat, GLsizei width, GLsizei
     gl->glBindTexture(Target, textureId_);
     gl->glTexImage2D(Target, level, internalFormat, width, height, border, format, type, data);
 
+    if(data != nullptr)
+    {
+        GPU_COUNT(TEXTURE_UPLOAD_BYTES, GpuCounters::imageBytes(width, height, format, type));
+    }
+
     setDimensions(width, height);
     return true;
 }
@@ -51,4 +57,9 @@ bool Texture2D::createTexStorage(GLint levels, GLint internalFormat, GLsizei wid
 
     setDimensions(width, height);
     return true;
+}
+
+GLint Texture2D::layer() const
+{
+    return 0;
 }
\ No newline at end of file
@@ -23,6 +23,9 @@ public:
     // Allows specifying the mipmap count. Mipmaps have to be created manually using glTexSubImage2D.
     // The texture is left bound if this call succeeds.
     virtual bool createTexStorage(GLint levels, GLint internalFormat, GLsizei width, GLsizei height);
+
+    // Returns the texture array layer holding the texture, or 0 if the texture isn't in an array.
+    virtual GLint layer() const;
 };
 
 }
@@ -4,6 +4,8 @@
 //
 
 #include "texture2dresource.h"
+#include "textureresidency.h"
+#include "gpucounters.h"
 
 #include <QDebug>
 
@@ -11,26 +13,81 @@
 
 using namespace Engine;
 
+TextureResidency* Texture2DResource::residency_ = nullptr;
+
 Texture2DResource::Texture2DResource()
-    : Texture2D(), Resource(), conversion_(TC_RGBA), mipmap_(false)
+    : Texture2D(), Resource(), conversion_(TC_RGBA), mipmap_(false), resident_(nullptr)
 {
 }
 
 Texture2DResource::Texture2DResource(const QString& name, TextureConversion conversion)
-    : Texture2D(), Resource(name), conversion_(conversion), mipmap_(false)
+    : Texture2D(), Resource(name), conversion_(conversion), mipmap_(false), resident_(nullptr)
+{
+}
+
+Texture2DResource::~Texture2DResource()
+{
+    if(resident_ != nullptr)
+    {
+        resident_->release(slot_);
+    }
+}
+
+void Texture2DResource::setResidency(TextureResidency* residency)
 {
+    residency_ = residency;
+}
+
+TextureResidency* Texture2DResource::residency()
+{
+    return residency_;
+}
+
+bool Texture2DResource::resident() const
+{
+    return resident_ != nullptr;
 }
 
 bool Texture2DResource::bind()
 {
-    return ready() && Texture2D::bind();
+    if(!ready())
+    {
+        return false;
+    }
+
+    if(resident_ != nullptr)
+    {
+        return resident_->bindPage(slot_.page);
+    }
+
+    return Texture2D::bind();
+}
+
+GLuint Texture2DResource::handle() const
+{
+    if(resident_ != nullptr)
+    {
+        return resident_->pageHandle(slot_.page);
+    }
+
+    return Texture2D::handle();
+}
+
+GLenum Texture2DResource::type() const
+{
+    return resident_ != nullptr ? GL_TEXTURE_2D_ARRAY : Texture2D::type();
+}
+
+GLint Texture2DResource::layer() const
+{
+    return resident_ != nullptr ? slot_.layer : 0;
 }
 
 void Texture2DResource::texParameteri(GLenum pname, GLint target)
 {
     parametersi_.push_back(qMakePair(pname, target));
 
-    if(ready())
+    if(ready() && resident_ == nullptr)
     {
         Texture2D::texParameteri(pname, target);
     }
@@ -40,7 +97,7 @@ void Texture2DResource::generateMipmap()
 {
     mipmap_ = true;
 
-    if(ready())
+    if(ready() && resident_ == nullptr)
     {
         Texture2D::generateMipmap();
     }
@@ -73,6 +130,15 @@ bool Texture2DResource::initialiseData(const DataType& data)
 {
     const gli::texture2D& texture = *data;
 
+    // Resident textures share the page's storage and sampling parameters
+    if(residency_ != nullptr && residency_->upload(texture, slot_))
+    {
+        resident_ = residency_;
+        setDimensions(data->dimensions().x, data->dimensions().y);
+
+        return true;
+    }
+
     // If we are dealing with a non-compressed texture, just call the default initialiser.
     if(!gli::is_compressed(texture.format()))
     {
@@ -135,6 +201,8 @@ bool Texture2DResource::uploadCompressed(const gli::texture2D& texture)
                 gli::internal_format(texture.format()),
                 static_cast<GLsizei>(texture[level].size()),
                 texture[level].data());
+
+            GPU_COUNT(TEXTURE_UPLOAD_BYTES, texture[level].size());
         }
     }
 
@@ -147,6 +215,8 @@ bool Texture2DResource::uploadCompressed(const gli::texture2D& texture)
             0,
             static_cast<GLsizei>(texture.size()),
             texture.data());
+
+        GPU_COUNT(TEXTURE_UPLOAD_BYTES, texture.size());
     }
 
     return gl->glGetError() == GL_NO_ERROR;
@@ -154,6 +224,12 @@ bool Texture2DResource::uploadCompressed(const gli::texture2D& texture)
 
 void Texture2DResource::releaseResource()
 {
+    if(resident_ != nullptr)
+    {
+        resident_->release(slot_);
+        resident_ = nullptr;
+    }
+
     remove();
 }
 
@@ -199,4 +275,19 @@ gli::texture2D& TextureData::operator*() const
 void TextureData::setConversion(TextureConversion conversion)
 {
     conversion_ = conversion;
+}
+
+qint64 TextureData::byteSize() const
+{
+    return data_ != nullptr ? static_cast<qint64>(data_->size()) : 0;
+}
+
+void TextureData::setTexture(gli::texture2D* texture)
+{
+    Q_ASSERT(texture != nullptr);
+
+    if(data_ != nullptr)
+        delete data_;
+
+    data_ = texture;
 }
\ No newline at end of file
@@ -10,12 +10,15 @@
 #include "resource.h"
 #include "textureloader.h"
 #include "resourcedata.h"
+#include "texturepagepacker.h"
 
 #include <QList>
 #include <QPair>
 
 namespace Engine {
 
+class TextureResidency;
+
 class TextureData : public ResourceData
 {
 public:
@@ -31,6 +34,14 @@ public:
     // If not set, the default TC_RGBA is used.
     void setConversion(TextureConversion conversion);
 
+    // Takes the ownership of texture data generated in memory, so the resource can be
+    // initialised without reading a file.
+    // precondition: texture != nullptr
+    void setTexture(gli::texture2D* texture);
+
+    // Texture data isn't modified by initialisation, so it can be retained.
+    virtual qint64 byteSize() const;
+
 private:
     gli::texture2D* data_;
     TextureConversion conversion_;
@@ -42,6 +53,16 @@ class Texture2DResource : public Texture2D,
 public:
     Texture2DResource();
     Texture2DResource(const QString& name, TextureConversion conversion = TC_RGBA);
+    virtual ~Texture2DResource();
+
+    // Textures loaded from data while the residency is set are uploaded into its texture arrays.
+    // A resident texture binds its page, and ignores texture parameters.
+    // If residency is nullptr, textures are loaded as standalone 2D textures.
+    static void setResidency(TextureResidency* residency);
+    static TextureResidency* residency();
+
+    // Tells if the texture is stored in a texture array page
+    bool resident() const;
 
     virtual void texParameteri(GLenum pname, GLint target);
     virtual void generateMipmap();
@@ -55,6 +76,10 @@ public:
 
     virtual bool bind();
 
+    virtual GLuint handle() const;
+    virtual GLenum type() const;
+    virtual GLint layer() const;
+
 protected:
     virtual ResourceDataPtr createData();
     virtual bool initialiseData(const DataType& data);
@@ -67,6 +92,11 @@ private:
     QList<Parameteri> parametersi_;
     bool mipmap_;
 
+    TextureResidency* resident_;
+    TexturePagePacker::Slot slot_;
+
+    static TextureResidency* residency_;
+
     bool uploadCompressed(const gli::texture2D& texture);
 };
 
@@ -0,0 +1,41 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "texturearray.h"
+
+using namespace Engine;
+
+TextureArray::TextureArray()
+    : Texture(), layers_(0)
+{
+}
+
+TextureArray::~TextureArray()
+{
+}
+
+bool TextureArray::createTexStorage(GLint levels, GLint internalFormat, GLsizei width, GLsizei height, GLsizei layers)
+{
+    if(width < 1 || height < 1 || layers < 1)
+    {
+        return false;
+    }
+
+    remove();
+
+    gl->glGenTextures(1, &textureId_);
+    gl->glBindTexture(Target, textureId_);
+    gl->glTexStorage3D(Target, levels, internalFormat, width, height, layers);
+
+    setDimensions(width, height);
+    layers_ = layers;
+
+    return true;
+}
+
+GLsizei TextureArray::layers() const
+{
+    return layers_;
+}
@@ -0,0 +1,31 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 2D array OpenGL texture.
+//
+
+#ifndef TEXTUREARRAY_H
+#define TEXTUREARRAY_H
+
+#include "texture.h"
+
+namespace Engine {
+
+class TextureArray : public Texture<GL_TEXTURE_2D_ARRAY>
+{
+public:
+    TextureArray();
+    virtual ~TextureArray();
+
+    // Allocates immutable storage for all layers and mipmaps using glTexStorage3D.
+    // The texture is left bound if this call succeeds.
+    bool createTexStorage(GLint levels, GLint internalFormat, GLsizei width, GLsizei height, GLsizei layers);
+
+    GLsizei layers() const;
+
+private:
+    GLsizei layers_;
+};
+
+}
+
+#endif // TEXTUREARRAY_H
@@ -4,10 +4,13 @@
 //
 
 #include "textureloader.h"
+#include "assetfile.h"
 
 #include <QImage>
 #include <QImageReader>
-#include <QFile>
+#include <QBuffer>
+#include <QFileInfo>
+#include <QtEndian>
 #include <QDebug>
 
 #include <gli/gli.hpp>
@@ -15,26 +18,43 @@
 using namespace Engine;
 
 namespace {
-    bool isDDS(const QString& fileName);
-    gli::texture2D* loadDDS(const QString& fileName, TextureConversion conversion);
-    gli::texture2D* loadQImage(const QString& fileName, TextureConversion conversion);
+    // DDS header fields, offsets include the magic
+    const int DDS_HEADER_SIZE = 128;
+    const int DDS_FLAGS = 8;
+    const int DDS_HEIGHT = 12;
+    const int DDS_WIDTH = 16;
+    const int DDS_MIPMAP_COUNT = 28;
+    const int DDS_FOURCC = 84;
+    const quint32 DDSD_MIPMAPCOUNT = 0x20000;
+
+    bool isDDS(const QByteArray& data);
+    gli::texture2D* loadDDS(const QString& fileName, const QByteArray& data, TextureConversion conversion);
+    gli::texture2D* loadQImage(const QString& fileName, QByteArray& data, TextureConversion conversion);
 }
 
 gli::texture2D* Engine::loadTexture(const QString& fileName, TextureConversion conversion)
 {
+    // The file is read once, from a mounted archive or the file system
+    QByteArray data;
+    if(!AssetFile::read(fileName, data))
+    {
+        qDebug() << "Failed to read texture:" << fileName;
+        return nullptr;
+    }
+
     gli::texture2D* texture = nullptr;
 
-    // Note: We only support DXT5 for now
-    if(isDDS(fileName))
+    // Note: We only support DXT compressed textures for now
+    if(isDDS(data))
     {
-        texture = loadDDS(fileName, conversion);
+        texture = loadDDS(fileName, data, conversion);
     }
 
     // QImage is used to support regular uncompressed image formats.
     // The data is copied into a gli::texture2D container to simplify uploading
     else
     {
-        texture = loadQImage(fileName, conversion);
+        texture = loadQImage(fileName, data, conversion);
     }
 
     return texture;
@@ -42,41 +62,87 @@ gli::texture2D* Engine::loadTexture(const QString& fileName, TextureConversion c
 
 namespace {
 
-bool isDDS(const QString& fileName)
+bool isDDS(const QByteArray& data)
 {
-    QFile file(fileName);
-    if(!file.open(QFile::ReadOnly))
-    {
-        return false;
-    }
-
     // Read magic header
-    return std::strncmp(file.read(3), "DDS", 3) == 0;
+    return data.startsWith("DDS ");
 }
 
-gli::texture2D* loadDDS(const QString& fileName, TextureConversion conversion)
+gli::texture2D* loadDDS(const QString& fileName, const QByteArray& data, TextureConversion conversion)
 {
-    const gli::storage storage = gli::load_dds(fileName.toUtf8());
-    gli::format format = storage.format();
+    if(data.size() < DDS_HEADER_SIZE)
+    {
+        qDebug() << "Truncated DDS header:" << fileName;
+        return nullptr;
+    }
+
+    const uchar* header = reinterpret_cast<const uchar*>(data.constData());
+    const quint32 flags = qFromLittleEndian<quint32>(header + DDS_FLAGS);
+    const int width = qFromLittleEndian<quint32>(header + DDS_WIDTH);
+    const int height = qFromLittleEndian<quint32>(header + DDS_HEIGHT);
+    const QByteArray fourCC = data.mid(DDS_FOURCC, 4);
+
+    gli::format format;
+    if(fourCC == "DXT1")
+    {
+        format = conversion == TC_SRGBA ? gli::format::SRGB_ALPHA_DXT1 : gli::format::RGBA_DXT1;
+    }
 
-    if(conversion == TC_SRGBA)
+    else if(fourCC == "DXT3")
     {
-        format = gli::format::SRGB_ALPHA_DXT5;
+        format = conversion == TC_SRGBA ? gli::format::SRGB_ALPHA_DXT3 : gli::format::RGBA_DXT3;
     }
 
-    gli::texture2D* texture = new gli::texture2D(storage, format, 0, 0, 0, 0, 0, storage.levels() - 1);
-    if(texture->empty())
+    else if(fourCC == "DXT5")
     {
-        delete texture;
-        texture = nullptr;
+        format = conversion == TC_SRGBA ? gli::format::SRGB_ALPHA_DXT5 : gli::format::RGBA_DXT5;
+    }
+
+    else
+    {
+        qDebug() << "Unsupported DDS format" << fourCC << "in" << fileName;
+        return nullptr;
+    }
+
+    // Levels stop at 1x1
+    int levels = (flags & DDSD_MIPMAPCOUNT) != 0 ? qMax<int>(1, qFromLittleEndian<quint32>(header + DDS_MIPMAP_COUNT)) : 1;
+    int maxLevels = 1;
+
+    for(int size = qMax(width, height); size > 1; size >>= 1)
+    {
+        ++maxLevels;
+    }
+
+    levels = qMin(levels, maxLevels);
+
+    gli::texture2D* texture = new gli::texture2D(levels, format, gli::texture2D::dimensions_type(width, height));
+
+    // Level data is tightly packed after the header
+    const char* source = data.constData() + DDS_HEADER_SIZE;
+    const char* end = data.constData() + data.size();
+
+    for(int level = 0; level < levels; ++level)
+    {
+        const size_t size = (*texture)[level].size();
+        if(static_cast<size_t>(end - source) < size)
+        {
+            qDebug() << "Truncated DDS data:" << fileName;
+            delete texture;
+            return nullptr;
+        }
+
+        std::memcpy((*texture)[level].data(), source, size);
+        source += size;
     }
 
     return texture;
 }
 
-gli::texture2D* loadQImage(const QString& fileName, TextureConversion conversion)
+gli::texture2D* loadQImage(const QString& fileName, QByteArray& data, TextureConversion conversion)
 {
-    QImageReader reader(fileName);
+    // The suffix is a hint, the format is detected from the data
+    QBuffer buffer(&data);
+    QImageReader reader(&buffer, QFileInfo(fileName).suffix().toLatin1());
     QImage image = reader.read();
 
     if(image.isNull())
@@ -0,0 +1,117 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "texturepagepacker.h"
+
+#include <QtGlobal>
+
+using namespace Engine;
+
+TexturePagePacker::TexturePagePacker(int pageBudget, int maxLayers)
+    : pageBudget_(pageBudget), maxLayers_(maxLayers)
+{
+}
+
+TexturePagePacker::Slot TexturePagePacker::allocate(const Format& format)
+{
+    Q_ASSERT(format.width > 0 && format.height > 0 && format.layerSize > 0);
+
+    Slot slot;
+
+    for(int i = 0; i < pages_.size(); ++i)
+    {
+        Page& page = pages_[i];
+        if(!(page.format == format) || page.usage == page.used.size())
+        {
+            continue;
+        }
+
+        slot.page = i;
+        slot.layer = page.used.indexOf(false);
+        break;
+    }
+
+    if(!slot.valid())
+    {
+        Page page;
+        page.format = format;
+        page.used.fill(false, layersPerPage(format));
+        page.usage = 0;
+
+        pages_.push_back(page);
+
+        slot.page = pages_.size() - 1;
+        slot.layer = 0;
+    }
+
+    Page& page = pages_[slot.page];
+    page.used[slot.layer] = true;
+    ++page.usage;
+
+    return slot;
+}
+
+void TexturePagePacker::release(const Slot& slot)
+{
+    Q_ASSERT(slot.page >= 0 && slot.page < pages_.size());
+
+    Page& page = pages_[slot.page];
+    Q_ASSERT(slot.layer >= 0 && slot.layer < page.used.size() && page.used[slot.layer]);
+
+    page.used[slot.layer] = false;
+    --page.usage;
+}
+
+int TexturePagePacker::pageCount() const
+{
+    return pages_.size();
+}
+
+const TexturePagePacker::Format& TexturePagePacker::pageFormat(int page) const
+{
+    return pages_[page].format;
+}
+
+int TexturePagePacker::pageLayers(int page) const
+{
+    return pages_[page].used.size();
+}
+
+int TexturePagePacker::pageUsage(int page) const
+{
+    return pages_[page].usage;
+}
+
+void TexturePagePacker::clear()
+{
+    pages_.clear();
+}
+
+int TexturePagePacker::layersPerPage(const Format& format) const
+{
+    return qBound(1, pageBudget_ / format.layerSize, maxLayers_);
+}
+
+TexturePagePacker::Format::Format()
+    : internalFormat(0), width(0), height(0), levels(1), layerSize(0)
+{
+}
+
+bool TexturePagePacker::Format::operator==(const Format& other) const
+{
+    // Layer size follows from the other fields
+    return internalFormat == other.internalFormat && width == other.width &&
+        height == other.height && levels == other.levels;
+}
+
+TexturePagePacker::Slot::Slot()
+    : page(-1), layer(-1)
+{
+}
+
+bool TexturePagePacker::Slot::valid() const
+{
+    return page >= 0 && layer >= 0;
+}
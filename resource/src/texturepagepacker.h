@@ -0,0 +1,82 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : Packs textures of matching size and format into layers of texture array pages.
+//             The packer only does the bookkeeping, so it can be used without an OpenGL context.
+//
+
+#ifndef TEXTUREPAGEPACKER_H
+#define TEXTUREPAGEPACKER_H
+
+#include <QVector>
+
+namespace Engine {
+
+class TexturePagePacker
+{
+public:
+    // Layers are allocated only from pages with a matching format.
+    struct Format
+    {
+        unsigned int internalFormat;
+        int width;
+        int height;
+        int levels;
+        int layerSize;      // Bytes used by a single layer, including mipmaps
+
+        Format();
+        bool operator==(const Format& other) const;
+    };
+
+    struct Slot
+    {
+        int page;
+        int layer;
+
+        Slot();
+        bool valid() const;
+    };
+
+    // The number of layers in a page is chosen so that the page fits pageBudget bytes,
+    // but it has always at least one and at most maxLayers layers.
+    TexturePagePacker(int pageBudget, int maxLayers);
+
+    // Allocates the lowest free layer from the first page of the same format.
+    // A new page is appended if all pages of the format are full. Page indices are never reused.
+    // precondition: format.width > 0, format.height > 0, format.layerSize > 0
+    // postcondition: valid slot returned
+    Slot allocate(const Format& format);
+
+    // Frees the layer for reuse.
+    // precondition: slot was allocated from this packer
+    void release(const Slot& slot);
+
+    int pageCount() const;
+    const Format& pageFormat(int page) const;
+
+    // Returns the number of layers in the page
+    int pageLayers(int page) const;
+
+    // Returns the number of allocated layers in the page
+    int pageUsage(int page) const;
+
+    // Clears all pages
+    void clear();
+
+private:
+    struct Page
+    {
+        Format format;
+        QVector<bool> used;
+        int usage;
+    };
+
+    QVector<Page> pages_;
+    int pageBudget_;
+    int maxLayers_;
+
+    int layersPerPage(const Format& format) const;
+};
+
+}
+
+#endif // TEXTUREPAGEPACKER_H
@@ -0,0 +1,209 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : 
+//
+
+#include "textureresidency.h"
+#include "texture2dresource.h"
+#include "gpucounters.h"
+
+#include <QDebug>
+
+#include <gli/gli.hpp>
+
+#include <algorithm>
+
+using namespace Engine;
+
+namespace {
+    // Upper bound for the layer count, so pages of tiny textures don't become unreasonably large
+    const GLint MAX_PAGE_LAYERS = 256;
+
+    int mipmapLevels(int width, int height);
+}
+
+TextureResidency::TextureResidency(int pageBudget)
+    : packer_(pageBudget, MAX_PAGE_LAYERS)
+{
+    GLint maxLayers = 0;
+    gl->glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+    if(maxLayers > 0 && maxLayers < MAX_PAGE_LAYERS)
+    {
+        packer_ = TexturePagePacker(pageBudget, maxLayers);
+    }
+}
+
+TextureResidency::~TextureResidency()
+{
+}
+
+bool TextureResidency::upload(const gli::texture2D& texture, TexturePagePacker::Slot& slot)
+{
+    const bool compressed = gli::is_compressed(texture.format());
+
+    TexturePagePacker::Format format;
+    format.internalFormat = gli::internal_format(texture.format());
+    format.width = static_cast<int>(texture.dimensions().x);
+    format.height = static_cast<int>(texture.dimensions().y);
+
+    // Compressed textures carry their own mipmaps, others are generated on the page
+    if(compressed)
+    {
+        format.levels = static_cast<int>(texture.levels());
+        format.layerSize = static_cast<int>(texture.size());
+    }
+
+    else
+    {
+        format.levels = mipmapLevels(format.width, format.height);
+        format.layerSize = static_cast<int>(texture[0].size() * 4 / 3);
+    }
+
+    slot = packer_.allocate(format);
+    if(!createPage(slot.page))
+    {
+        packer_.release(slot);
+        slot = TexturePagePacker::Slot();
+
+        return false;
+    }
+
+    Page& page = pages_[slot.page];
+    page.texture->bind();
+
+    if(compressed)
+    {
+        for(gli::texture2D::size_type level = 0; level < texture.levels(); ++level)
+        {
+            gl->glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY,
+                static_cast<GLint>(level), 0, 0, slot.layer,
+                static_cast<GLsizei>(texture[level].dimensions().x),
+                static_cast<GLsizei>(texture[level].dimensions().y), 1,
+                format.internalFormat,
+                static_cast<GLsizei>(texture[level].size()),
+                texture[level].data());
+
+            GPU_COUNT(TEXTURE_UPLOAD_BYTES, texture[level].size());
+        }
+    }
+
+    else
+    {
+        gl->glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, slot.layer,
+            format.width, format.height, 1,
+            gli::external_format(texture.format()),
+            gli::type_format(texture.format()),
+            texture.data());
+
+        GPU_COUNT(TEXTURE_UPLOAD_BYTES, texture[0].size());
+
+        page.mipmapsDirty = true;
+    }
+
+    if(gl->glGetError() != GL_NO_ERROR)
+    {
+        packer_.release(slot);
+        slot = TexturePagePacker::Slot();
+
+        return false;
+    }
+
+    return true;
+}
+
+void TextureResidency::release(const TexturePagePacker::Slot& slot)
+{
+    packer_.release(slot);
+}
+
+bool TextureResidency::bindPage(int page)
+{
+    if(pageHandle(page) == 0 || !pages_[page].texture->bind())
+    {
+        return false;
+    }
+
+    // Generate the mipmaps once for all layers uploaded since the last bind
+    if(pages_[page].mipmapsDirty)
+    {
+        pages_[page].texture->generateMipmap();
+        pages_[page].mipmapsDirty = false;
+    }
+
+    return true;
+}
+
+GLuint TextureResidency::pageHandle(int page) const
+{
+    if(page < 0 || page >= pages_.size() || pages_[page].texture == nullptr)
+    {
+        return 0;
+    }
+
+    return pages_[page].texture->handle();
+}
+
+const TexturePagePacker& TextureResidency::packer() const
+{
+    return packer_;
+}
+
+bool TextureResidency::shaderDefines(ShaderData::DefineMap& defines)
+{
+    if(Texture2DResource::residency() == nullptr)
+    {
+        return false;
+    }
+
+    defines.insert("TEXTURE_ARRAYS", 1);
+    return true;
+}
+
+bool TextureResidency::createPage(int page)
+{
+    if(page < pages_.size() && pages_[page].texture != nullptr)
+    {
+        return true;
+    }
+
+    // Page indices follow the packer
+    if(page >= pages_.size())
+    {
+        pages_.resize(packer_.pageCount());
+    }
+
+    const TexturePagePacker::Format& format = packer_.pageFormat(page);
+
+    std::shared_ptr<TextureArray> texture = std::make_shared<TextureArray>();
+    if(!texture->createTexStorage(format.levels, format.internalFormat,
+        format.width, format.height, packer_.pageLayers(page)))
+    {
+        return false;
+    }
+
+    // Sampling state is shared by all layers. Matches the options set by Material.
+    texture->setFiltering(GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR);
+    texture->setWrap(GL_REPEAT, GL_REPEAT);
+    texture->texParameteri(GL_TEXTURE_MAX_LEVEL, format.levels - 1);
+    texture->texParameteri(GL_TEXTURE_MAX_ANISOTROPY_EXT, 16);
+
+    qDebug() << __FUNCTION__ << "Texture page" << page << format.width << "x" << format.height
+             << "layers:" << packer_.pageLayers(page);
+
+    pages_[page].texture = texture;
+    return true;
+}
+
+namespace {
+    int mipmapLevels(int width, int height)
+    {
+        int levels = 1;
+        for(int size = std::max(width, height); size > 1; size /= 2)
+        {
+            ++levels;
+        }
+
+        return levels;
+    }
+}
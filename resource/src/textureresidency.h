@@ -0,0 +1,75 @@
+//
+//  Author   : Matti Määttä
+//  Summary  : TextureResidency places material textures of matching size and format into layers of
+//             GL_TEXTURE_2D_ARRAY pages. Materials sharing a page can be drawn without rebinding textures,
+//             because only the layer index changes between draws.
+//             Shaders sampling resident textures are compiled with TEXTURE_ARRAYS defined.
+//
+
+#ifndef TEXTURERESIDENCY_H
+#define TEXTURERESIDENCY_H
+
+#include "texturepagepacker.h"
+#include "texturearray.h"
+#include "shaderdata.h"
+
+#include <QVector>
+
+#include <memory>
+
+namespace gli {
+    class texture2D;
+}
+
+namespace Engine {
+
+class TextureResidency
+{
+public:
+    // Pages are sized to hold at most pageBudget bytes, unless a single layer is larger.
+    // precondition: OpenGL context is current
+    explicit TextureResidency(int pageBudget = 64 << 20);
+    ~TextureResidency();
+
+    // Copies the texture into a free layer of a page with the same format.
+    // Uncompressed textures get their mipmaps generated when the page is bound.
+    // postcondition: true and the allocated slot returned on success
+    bool upload(const gli::texture2D& texture, TexturePagePacker::Slot& slot);
+
+    // Frees the layer. The page storage is kept for later uploads.
+    void release(const TexturePagePacker::Slot& slot);
+
+    // Binds the page to the active texture unit.
+    // postcondition: false if the page doesn't exist
+    bool bindPage(int page);
+
+    // Returns the page texture handle, or 0 if the page doesn't exist
+    GLuint pageHandle(int page) const;
+
+    const TexturePagePacker& packer() const;
+
+    // Inserts TEXTURE_ARRAYS to defines if material textures are loaded into texture arrays.
+    // postcondition: true if texture arrays are in use
+    static bool shaderDefines(ShaderData::DefineMap& defines);
+
+private:
+    struct Page
+    {
+        Page() : mipmapsDirty(false) {}
+
+        std::shared_ptr<TextureArray> texture;
+        bool mipmapsDirty;
+    };
+
+    TexturePagePacker packer_;
+    QVector<Page> pages_;
+
+    bool createPage(int page);
+
+    TextureResidency(const TextureResidency&);
+    TextureResidency& operator=(const TextureResidency&);
+};
+
+}
+
+#endif // TEXTURERESIDENCY_H
@@ -7,17 +7,24 @@
 
 #include "resource.h"
 #include "resourceloader.h"
+#include "tracer.h"
 
 #include <QFileSystemWatcher>
 #include <QFile>
+#include <QPair>
+#include <QMutexLocker>
 #include <QDebug>
 
+#include <algorithm>
+
 using namespace Engine;
 
 WeakResourceDespatcher::WeakResourceDespatcher(unsigned int threadCount, QObject* parent)
-    : ResourceDespatcher(parent), watcher_(nullptr)
+    : ResourceDespatcher(parent), useCounter_(0), cpuLimit_(0), gpuLimit_(0), watcher_(nullptr),
+    pendingLoads_(0), loadTime_(0), loadStatistic_(nullptr)
 {
     qRegisterMetaType<ResourcePtr>("ResourcePtr");
+    qRegisterMetaType<WeakResourcePtr>("WeakResourcePtr");
     qRegisterMetaType<ResourceDataPtr>("ResourceDataPtr");
 
     threadPool_.setMaxThreadCount(threadCount);
@@ -39,11 +46,20 @@ void WeakResourceDespatcher::clear()
     // Wait for threads to finish.
     threadPool_.waitForDone();
 
+    QMutexLocker lock(&mutex_);
+
+    // Loaders have finished, so the despatcher holds the last references
     resources_.clear();
+    retained_.clear();
+    evicted_.clear();
+
+    cacheStats_.cpuBytes = 0;
+    cacheStats_.gpuBytes = 0;
 }
 
 int WeakResourceDespatcher::numManaged() const
 {
+    QMutexLocker lock(&mutex_);
     int count = 0;
 
     for(auto it = resources_.begin(); it != resources_.end(); ++it)
@@ -55,10 +71,224 @@ int WeakResourceDespatcher::numManaged() const
     return count;
 }
 
+int WeakResourceDespatcher::pendingLoads() const
+{
+    return pendingLoads_;
+}
+
+qint64 WeakResourceDespatcher::loadTime() const
+{
+    return loadTime_;
+}
+
+void WeakResourceDespatcher::setLoadStatistic(Statistic* statistic)
+{
+    loadStatistic_ = statistic;
+}
+
+void WeakResourceDespatcher::setRetainLimits(qint64 cpuBytes, qint64 gpuBytes)
+{
+    QMutexLocker lock(&mutex_);
+
+    cpuLimit_ = cpuBytes;
+    gpuLimit_ = gpuBytes;
+
+    evict();
+}
+
+void WeakResourceDespatcher::trim()
+{
+    QMutexLocker lock(&mutex_);
+    evict();
+}
+
+void WeakResourceDespatcher::evict()
+{
+    // Least recently used first
+    QList<QPair<quint64, QString>> order;
+    qint64 gpuBytes = 0;
+
+    for(auto it = retained_.begin(); it != retained_.end(); ++it)
+    {
+        order.push_back(qMakePair(it->lastUse, it.key()));
+
+        if(unused(*it))
+        {
+            gpuBytes += it->bytes;
+        }
+    }
+
+    std::sort(order.begin(), order.end());
+
+    for(const auto& use : order)
+    {
+        if(cacheStats_.cpuBytes <= cpuLimit_ && gpuBytes <= gpuLimit_)
+        {
+            break;
+        }
+
+        RetainedResource& entry = retained_[use.second];
+
+        if(cacheStats_.cpuBytes > cpuLimit_ && entry.data != nullptr)
+        {
+            entry.data.reset();
+            cacheStats_.cpuBytes -= entry.bytes;
+        }
+
+        // Resources in use don't take memory from the cap; they wouldn't be freed anyway
+        if(gpuBytes > gpuLimit_ && unused(entry))
+        {
+            queueRelease(entry.resource);
+            gpuBytes -= entry.bytes;
+        }
+
+        if(entry.resource == nullptr && entry.data == nullptr)
+        {
+            retained_.remove(use.second);
+        }
+    }
+
+    cacheStats_.gpuBytes = gpuBytes;
+}
+
+void WeakResourceDespatcher::releaseRetained()
+{
+    QMutexLocker lock(&mutex_);
+
+    for(auto it = retained_.begin(); it != retained_.end();)
+    {
+        if(it->resource != nullptr)
+        {
+            queueRelease(it->resource);
+        }
+
+        if(it->data == nullptr)
+        {
+            it = retained_.erase(it);
+        }
+
+        else
+        {
+            ++it;
+        }
+    }
+
+    cacheStats_.gpuBytes = 0;
+
+    releaseQueued();
+}
+
+void WeakResourceDespatcher::releaseEvicted()
+{
+    QMutexLocker lock(&mutex_);
+    releaseQueued();
+}
+
+void WeakResourceDespatcher::queueRelease(ResourcePtr& resource)
+{
+    evicted_.push_back(resource);
+    resource.reset();
+}
+
+void WeakResourceDespatcher::releaseQueued()
+{
+    for(auto it = evicted_.begin(); it != evicted_.end();)
+    {
+        // Still shared, eg. by a loader or by a scene using the resource
+        if(it->use_count() > 1)
+        {
+            ++it;
+        }
+
+        else
+        {
+            it = evicted_.erase(it);
+        }
+    }
+}
+
+WeakResourceDespatcher::CacheStats WeakResourceDespatcher::cacheStats() const
+{
+    QMutexLocker lock(&mutex_);
+    return cacheStats_;
+}
+
+WeakResourceDespatcher::ResourcePtr WeakResourceDespatcher::findShared(const QString& fileName)
+{
+    QMutexLocker lock(&mutex_);
+    ResourcePtr resource;
+
+    auto result = resources_.find(fileName);
+    if(result != resources_.end())
+    {
+        resource = result->lock();
+
+        // Only the retained handle was left, so the request revives the resource
+        auto retained = retained_.find(fileName);
+        if(retained != retained_.end() && retained->resource != nullptr)
+        {
+            if(retained->resource == resource && resource.use_count() == 2)
+            {
+                ++cacheStats_.hits;
+            }
+
+            retained->lastUse = ++useCounter_;
+        }
+    }
+
+    return resource;
+}
+
+bool WeakResourceDespatcher::unused(const RetainedResource& entry)
+{
+    return entry.resource != nullptr && entry.resource.use_count() == 1;
+}
+
+void WeakResourceDespatcher::retain(const ResourcePtr& resource, const ResourceDataPtr& data)
+{
+    QMutexLocker lock(&mutex_);
+
+    const qint64 bytes = data->byteSize();
+    if(bytes == 0 || (cpuLimit_ == 0 && gpuLimit_ == 0))
+    {
+        return;
+    }
+
+    RetainedResource& entry = retained_[resource->name()];
+    if(entry.data != nullptr)
+    {
+        cacheStats_.cpuBytes -= entry.bytes;
+    }
+
+    entry.resource = gpuLimit_ > 0 ? resource : nullptr;
+    entry.data = cpuLimit_ > 0 ? data : nullptr;
+    entry.bytes = bytes;
+    entry.lastUse = ++useCounter_;
+
+    if(entry.data != nullptr)
+    {
+        cacheStats_.cpuBytes += bytes;
+    }
+
+    evict();
+}
+
 void WeakResourceDespatcher::fileChanged(const QString& path)
 {
     qDebug() << __FUNCTION__ << path;
 
+    // Reloaded resources retain their new data
+    QMutexLocker lock(&mutex_);
+
+    auto retained = retained_.find(path);
+    if(retained != retained_.end() && retained->data != nullptr)
+    {
+        cacheStats_.cpuBytes -= retained->bytes;
+        retained->data.reset();
+    }
+
+    lock.unlock();
+
     auto result = watchList_.find(path);
     if(result == watchList_.end())
     {
@@ -110,8 +340,8 @@ void WeakResourceDespatcher::watchResource(const ResourcePtr& resource, const Re
 
         for(WeakResourcePtr& handle : list)
         {
-            ResourcePtr ptr = handle.lock();
-            if(ptr && ptr->name() == resource->name())
+            // Compare handles, since resources with different parameters can share the same file
+            if(handle.lock() == resource)
             {
                 found = true;
                 break;
@@ -127,41 +357,59 @@ void WeakResourceDespatcher::watchResource(const ResourcePtr& resource, const Re
 #endif
 }
 
-void WeakResourceDespatcher::resourceLoaded(QString id, ResourceDataPtr data)
+void WeakResourceDespatcher::loadFinished()
 {
-    auto handle = findResource(id).lock();
-    if(handle == nullptr)
+    if(--pendingLoads_ == 0)
+    {
+        loadTime_ = loadTimer_.elapsed();
+    }
+}
+
+void WeakResourceDespatcher::resourceLoaded(WeakResourcePtr handle, ResourceDataPtr data)
+{
+    TRACE_SCOPE("Initialise resource");
+
+    ResourcePtr resource = handle.lock();
+    if(resource == nullptr)
     {
-        qWarning() << __FUNCTION__ << "Resource loaded but handle is missing:" << id;
         return;
     }
 
     // If the resource should be initialised on next frame, signal despatcher
-    if(handle->initialiseFromData(data))
+    if(resource->initialiseFromData(data))
     {
-        watchResource(handle, data);
+        watchResource(resource, data);
+        retain(resource, data);
     }
 }
 
 WeakResourceDespatcher::WeakResourcePtr WeakResourceDespatcher::findResource(const QString& fileName)
 {
-    WeakResourcePtr weakPtr;
-
-    auto result = resources_.find(fileName);
-    if(result != resources_.end())
-    {
-        weakPtr = result.value();
-    }
-
-    return weakPtr;
+    return findShared(fileName);
 }
 
 void WeakResourceDespatcher::insertResource(const QString& fileName, const ResourcePtr& resource)
 {
+    QMutexLocker lock(&mutex_);
     resources_.insert(fileName, resource);
 
     resource->setDespatcher(this);
-    pushResource(fileName, resource);
+
+    // Retained data skips the file
+    auto retained = retained_.find(fileName);
+    if(retained != retained_.end() && retained->data != nullptr)
+    {
+        ++cacheStats_.hits;
+        retained->lastUse = ++useCounter_;
+
+        pushData(resource, retained->data);
+    }
+
+    else
+    {
+        ++cacheStats_.misses;
+        pushResource(fileName, resource);
+    }
 }
 
 void WeakResourceDespatcher::loadResource(ResourcePtr resource)
@@ -171,10 +419,30 @@ void WeakResourceDespatcher::loadResource(ResourcePtr resource)
 
 void WeakResourceDespatcher::pushResource(const QString& fileName, const ResourcePtr& resource)
 {
-    ResourceLoader* loader = new ResourceLoader(*resource, fileName, *this);
+    ResourceLoader* loader = new ResourceLoader(resource, fileName, *this);
+    loader->setLoadStatistic(loadStatistic_);
 
     connect(loader, &ResourceLoader::resourceLoaded, this, &WeakResourceDespatcher::resourceLoaded);
+    connect(loader, &ResourceLoader::loadFinished, this, &WeakResourceDespatcher::loadFinished);
     loader->setAutoDelete(true);
 
+    if(pendingLoads_++ == 0)
+    {
+        loadTimer_.start();
+    }
+
     threadPool_.start(loader);
+}
+
+void WeakResourceDespatcher::pushData(const ResourcePtr& resource, const ResourceDataPtr& data)
+{
+    if(pendingLoads_++ == 0)
+    {
+        loadTimer_.start();
+    }
+
+    QMetaObject::invokeMethod(this, "resourceLoaded", Qt::QueuedConnection,
+        Q_ARG(WeakResourcePtr, resource), Q_ARG(ResourceDataPtr, data));
+
+    QMetaObject::invokeMethod(this, "loadFinished", Qt::QueuedConnection);
 }
\ No newline at end of file
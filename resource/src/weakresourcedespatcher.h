@@ -5,6 +5,10 @@
 //             allocating multiple instances of the same data.
 //             The despatcher also watches for filesystem changes to allow dynamic resource reloading
 //             during developement.
+//             Resources whose data can be reused are retained after their users release them, up to
+//             a CPU and a GPU memory cap. Switching back to a scene revives the retained resources
+//             instead of loading them from disk again. Retained resources own GL objects, so the
+//             despatcher releases them only on the render thread.
 //
 
 #ifndef WEAKRESOURCEDESPATCHER_H
@@ -13,9 +17,13 @@
 #include "resourcedespatcher.h"
 
 #include <QHash>
+#include <QList>
+#include <QMutex>
 #include <QThreadPool>
+#include <QElapsedTimer>
 
 class QFileSystemWatcher;
+class Statistic;
 
 namespace Engine {
 
@@ -30,41 +38,133 @@ public:
     explicit WeakResourceDespatcher(unsigned int threadCount = 2, QObject* parent = nullptr);
     virtual ~WeakResourceDespatcher();
 
-    // Clears the record; doesn't delete managed objects
+    // Clears the record and the retained resources; doesn't delete managed objects
     virtual void clear();
 
     // Counts managed objects; expensive
     virtual int numManaged() const;
 
+    // Loads queued to the thread pool which haven't finished yet.
+    int pendingLoads() const;
+
+    // Time in milliseconds from the first queued load until no loads were pending.
+    // Measures the latest burst of loads, eg. a scene change.
+    qint64 loadTime() const;
+
+    // Loader threads record the load time of every file into the statistic.
+    // The statistic has to outlive the despatcher.
+    void setLoadStatistic(Statistic* statistic);
+
+    // Caps in bytes for the retained data and for the GPU memory of the retained resources
+    // which are no longer used. Zero disables the tier. Both tiers are disabled by default.
+    void setRetainLimits(qint64 cpuBytes, qint64 gpuBytes);
+
+    // Evicts the least recently used retained resources until the caps are met. Called after
+    // every load; call also after releasing a scene, since its resources become evictable.
+    void trim();
+
+    // Drops the retained GPU objects, eg. after the texture storage has changed.
+    // Resources still in use are not affected, and the retained data is kept.
+    // precondition: called on the render thread
+    void releaseRetained();
+
+    // Releases the evicted resources no other thread holds anymore. Loader threads can
+    // hold a retained resource found by findShared, so evicted resources are queued
+    // instead of deleted, and are kept until the queue has the last reference.
+    // precondition: called on the render thread, eg. once per frame
+    void releaseEvicted();
+
+    struct CacheStats
+    {
+        CacheStats() : hits(0), misses(0), cpuBytes(0), gpuBytes(0) {}
+
+        int hits;           // Requests served from retained resources or data
+        int misses;         // Requests which started a load from disk
+        qint64 cpuBytes;    // Retained data
+        qint64 gpuBytes;    // Retained resources which are no longer used
+    };
+
+    // GPU bytes are updated by trim.
+    CacheStats cacheStats() const;
+
+    // Thread-safe, revives a retained resource like get does.
+    virtual ResourcePtr findShared(const QString& fileName);
+
     typedef std::shared_ptr<ResourceData> ResourceDataPtr;
 
 public slots:
     void fileChanged(const QString& path);
 
-    // Called when the resource needs to be initialised
-    // postcondition: if exists; attempted to initialise
-    void resourceLoaded(QString id, ResourceDataPtr data);
+    // Called when the resource needs to be initialised. Resources released while their
+    // data was loading are skipped.
+    // postcondition: attempted to initialise
+    void resourceLoaded(WeakResourcePtr handle, ResourceDataPtr data);
 
     // Can be used to move resources between despatchers.
     // The resource is loaded by the target despatcher and ownership is copied.
     // Precondition: Resource name must be the file name, otherwise loading will fail.
     virtual void loadResource(ResourcePtr resource);
 
+    // Called when a loader has finished.
+    void loadFinished();
+
 protected:
     virtual WeakResourcePtr findResource(const QString& fileName);
     virtual void insertResource(const QString& fileName, const ResourcePtr& resource);
 
 private:
+    struct RetainedResource
+    {
+        ResourcePtr resource;       // Keeps the GPU objects alive, null once evicted
+        ResourceDataPtr data;       // Null once evicted
+        qint64 bytes;
+        quint64 lastUse;
+    };
+
     QHash<QString, WeakResourcePtr> resources_;
+    QHash<QString, RetainedResource> retained_;
+    QList<ResourcePtr> evicted_;
+    quint64 useCounter_;
+    qint64 cpuLimit_;
+    qint64 gpuLimit_;
+    CacheStats cacheStats_;
+
+    // Guards the records, since loaders look up shared resources
+    mutable QMutex mutex_;
+
     QThreadPool threadPool_;
     QString rootDirectory_;
 
     QFileSystemWatcher* watcher_;
     QHash<QString, QList<WeakResourcePtr>> watchList_;
 
+    int pendingLoads_;
+    QElapsedTimer loadTimer_;
+    qint64 loadTime_;
+    Statistic* loadStatistic_;
+
     void watchResource(const ResourcePtr& resource, const ResourceDataPtr& data);
     void pushResource(const QString& fileName, const ResourcePtr& resource);
 
+    // Initialises the resource from retained data on the next event loop iteration,
+    // like a finished loader would.
+    void pushData(const ResourcePtr& resource, const ResourceDataPtr& data);
+
+    void retain(const ResourcePtr& resource, const ResourceDataPtr& data);
+
+    // precondition: mutex is locked
+    void evict();
+
+    // Moves the handle to the release queue.
+    // precondition: mutex is locked
+    void queueRelease(ResourcePtr& resource);
+
+    // precondition: mutex is locked, called on the render thread
+    void releaseQueued();
+
+    // Unused means that only the despatcher holds the resource.
+    static bool unused(const RetainedResource& entry);
+
     WeakResourceDespatcher(const WeakResourceDespatcher&);
     WeakResourceDespatcher& operator=(const WeakResourceDespatcher&);
 };
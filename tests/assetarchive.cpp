@@ -0,0 +1,145 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "assetarchive.h"
+#include "assetfile.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    void writeFile(const QString& fileName, const QByteArray& data)
+    {
+        QFile file(fileName);
+        Assert::IsTrue(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    // Contents of the packed test directory
+    QStringList writeAssets(const QString& dir)
+    {
+        QDir(dir).mkdir("textures");
+
+        writeFile(dir + "/a.txt", "abc");
+        writeFile(dir + "/textures/b.bin", QByteArray(4096, 'b'));
+        writeFile(dir + "/empty", QByteArray());
+
+        return QStringList() << "a.txt" << "textures/b.bin" << "empty";
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(assetarchive)
+    {
+    public:
+
+        TEST_METHOD(ReadsPackedEntries)
+        {
+            QTemporaryDir dir;
+            const QStringList files = writeAssets(dir.path());
+            const QString fileName = dir.path() + "/assets.pak";
+
+            Assert::IsTrue(AssetArchive::write(fileName, dir.path(), files, false));
+
+            AssetArchive archive;
+            Assert::IsTrue(archive.open(fileName));
+            Assert::IsTrue(archive.root() == dir.path());
+            Assert::AreEqual(3, archive.entries().count());
+            Assert::IsTrue(archive.contains("textures/b.bin"));
+            Assert::IsFalse(archive.contains("missing"));
+
+            QByteArray data;
+            Assert::IsTrue(archive.read("a.txt", data));
+            Assert::IsTrue(data == "abc");
+
+            Assert::IsTrue(archive.read("textures/b.bin", data));
+            Assert::IsTrue(data == QByteArray(4096, 'b'));
+            Assert::AreEqual<quintptr>(0, reinterpret_cast<quintptr>(data.constData()) % AssetArchive::BLOB_ALIGNMENT);
+
+            Assert::IsTrue(archive.read("empty", data));
+            Assert::IsTrue(data.isEmpty());
+
+            Assert::IsFalse(archive.read("missing", data));
+        }
+
+        TEST_METHOD(CompressesOnlyWhenSmaller)
+        {
+            QTemporaryDir dir;
+            const QStringList files = writeAssets(dir.path());
+
+            const QString packed = dir.path() + "/packed.pak";
+            const QString compressed = dir.path() + "/compressed.pak";
+
+            Assert::IsTrue(AssetArchive::write(packed, dir.path(), files, false));
+            Assert::IsTrue(AssetArchive::write(compressed, dir.path(), files, true));
+            Assert::IsTrue(QFile(compressed).size() < QFile(packed).size());
+
+            AssetArchive archive;
+            Assert::IsTrue(archive.open(compressed));
+
+            QByteArray data;
+            Assert::IsTrue(archive.read("textures/b.bin", data));
+            Assert::IsTrue(data == QByteArray(4096, 'b'));
+
+            // Too small to compress
+            Assert::IsTrue(archive.read("a.txt", data));
+            Assert::IsTrue(data == "abc");
+        }
+
+        TEST_METHOD(RejectsCorruptedArchives)
+        {
+            QTemporaryDir dir;
+            const QStringList files = writeAssets(dir.path());
+            const QString fileName = dir.path() + "/assets.pak";
+
+            writeFile(fileName, "EPAK");
+            Assert::IsFalse(AssetArchive().open(fileName));
+
+            Assert::IsTrue(AssetArchive::write(fileName, dir.path(), files, false));
+
+            // Truncate into the last entry
+            QFile file(fileName);
+            Assert::IsTrue(file.resize(file.size() - 1));
+            Assert::IsFalse(AssetArchive().open(fileName));
+        }
+
+        TEST_METHOD(MountedPathsResolveToEntries)
+        {
+            QTemporaryDir dir;
+            const QStringList files = writeAssets(dir.path());
+            const QString fileName = dir.path() + "/assets.pak";
+
+            Assert::IsTrue(AssetArchive::write(fileName, dir.path(), files, false));
+            Assert::IsTrue(QFile::remove(dir.path() + "/a.txt"));
+            writeFile(dir.path() + "/loose.txt", "loose");
+
+            Assert::IsTrue(AssetFile::mount(fileName));
+
+            const AssetFile::Stats before = AssetFile::stats();
+            QByteArray data;
+
+            // Either separator, and paths are case-insensitive
+            Assert::IsTrue(AssetFile::exists(dir.path() + "/a.txt"));
+            Assert::IsTrue(AssetFile::read(dir.path() + "\\textures\\..\\A.txt", data));
+            Assert::IsTrue(data == "abc");
+
+            // Files outside the archive are read from the file system
+            Assert::IsTrue(AssetFile::read(dir.path() + "/loose.txt", data));
+            Assert::IsTrue(data == "loose");
+            Assert::IsFalse(AssetFile::read(dir.path() + "/missing", data));
+
+            const AssetFile::Stats after = AssetFile::stats();
+            Assert::AreEqual(1, after.archiveReads - before.archiveReads);
+            Assert::AreEqual(1, after.fileReads - before.fileReads);
+
+            AssetFile::unmountAll();
+            Assert::IsFalse(AssetFile::exists(dir.path() + "/a.txt"));
+        }
+    };
+}
@@ -0,0 +1,97 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "cubeshadowmap.h"
+#include "shadowstage.h"
+#include "graph/light.h"
+#include "graph/camera.h"
+#include "simdmath.h"
+#include "mathelp.h"
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    bool boxInFace(const CubeShadowMap& map, int face, const QVector3D& center)
+    {
+        return Simd::boxInClipSpace(Simd::Mat4::fromQt(map.faceVP(face)), Simd::Vec4::fromQt(center, 1.0f),
+            Simd::Vec4(0.1f, 0.1f, 0.1f, 0.0f));
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(cubeshadowmap)
+    {
+    public:
+
+        TEST_METHOD(FacesFollowCubemapLayers)
+        {
+            const QVector3D position(1, 2, 3);
+            const QVector3D axes[CubeShadowMap::FACE_COUNT] = { UNIT_X, -UNIT_X, UNIT_Y, -UNIT_Y, UNIT_Z, -UNIT_Z };
+
+            CubeShadowMap map;
+            map.setLight(position, 10.0f);
+
+            for(int face = 0; face < CubeShadowMap::FACE_COUNT; ++face)
+            {
+                for(int axis = 0; axis < CubeShadowMap::FACE_COUNT; ++axis)
+                {
+                    Assert::AreEqual(face == axis, boxInFace(map, face, position + axes[axis] * 5.0f));
+                }
+
+                // Beyond the radius
+                Assert::IsFalse(boxInFace(map, face, position + axes[face] * 11.0f));
+            }
+        }
+
+        TEST_METHOD(DepthFromAxisDistance)
+        {
+            CubeShadowMap map;
+            map.setLight(QVector3D(), 20.0f);
+
+            const QMatrix4x4& projection = map.lightVP();
+            const QVector3D points[] = { QVector3D(0.5f, -1, 4), QVector3D(-7, 3, 2), QVector3D(1, -12, -5) };
+            const int faces[] = { 4, 1, 3 };
+
+            for(int i = 0; i < 3; ++i)
+            {
+                const QVector3D& p = points[i];
+                float z = qMax(qAbs(p.x()), qMax(qAbs(p.y()), qAbs(p.z())));
+
+                // As computed by the lightning shader
+                float depth = -projection(2, 2) + projection(2, 3) / z;
+
+                QVector4D clip = map.faceVP(faces[i]) * QVector4D(p, 1.0f);
+                Assert::AreEqual(clip.z() / clip.w(), depth, 1e-4f);
+            }
+        }
+
+        TEST_METHOD(NearAndLargeLightsHavePriority)
+        {
+            Graph::Camera camera(Graph::Camera::PERSPECTIVE);
+            camera.setPosition(QVector3D());
+
+            Graph::Light light(Graph::Light::LIGHT_POINT);
+            light.setAttenuationQuadratic(1.0f);
+            const float radius = light.cutoffDistance();
+
+            // Within the radius
+            light.setPosition(UNIT_X * radius * 0.5f);
+            Assert::AreEqual(1.0f, ShadowStage::priority(light, camera));
+
+            light.setPosition(UNIT_X * radius * 3.0f);
+            const float distant = ShadowStage::priority(light, camera);
+
+            light.setPosition(UNIT_X * radius * 2.0f);
+            const float closer = ShadowStage::priority(light, camera);
+
+            Assert::IsTrue(closer > distant && distant > 0.0f);
+
+            // Larger lights are seen from further away
+            light.setDiffuseIntensity(4.0f);
+            Assert::IsTrue(ShadowStage::priority(light, camera) > closer);
+        }
+    };
+}
@@ -0,0 +1,143 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "framearena.h"
+#include "framevector.h"
+
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    // Starts a frame whose generation has no memory in use.
+    void beginFreshFrame()
+    {
+        for(int i = 0; i < FrameArena::GENERATIONS; ++i)
+        {
+            FrameArena::endFrame();
+        }
+    }
+
+    quintptr address(void* ptr)
+    {
+        return reinterpret_cast<quintptr>(ptr);
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(framearena)
+    {
+    public:
+
+        TEST_METHOD(AllocationsAreAligned)
+        {
+            beginFreshFrame();
+
+            Assert::IsNotNull(FrameArena::allocate(1, 1));
+            Assert::AreEqual<quintptr>(0, address(FrameArena::allocate(24, 16)) % 16);
+            Assert::IsNotNull(FrameArena::allocate(3, 1));
+            Assert::AreEqual<quintptr>(0, address(FrameArena::allocate(8, 8)) % 8);
+
+            // Larger than a block
+            Assert::IsNotNull(FrameArena::allocate(FrameArena::BLOCK_SIZE * 2));
+        }
+
+        TEST_METHOD(ReusesBlocksOfOlderFrames)
+        {
+            beginFreshFrame();
+
+            for(int frame = 0; frame < FrameArena::GENERATIONS; ++frame)
+            {
+                FrameArena::allocate(FrameArena::BLOCK_SIZE / 2);
+                FrameArena::allocate(FrameArena::BLOCK_SIZE / 2);
+                FrameArena::endFrame();
+            }
+
+            const int blocks = FrameArena::stats().blockAllocations;
+
+            for(int frame = 0; frame < 10; ++frame)
+            {
+                void* first = FrameArena::allocate(FrameArena::BLOCK_SIZE / 2);
+                void* second = FrameArena::allocate(FrameArena::BLOCK_SIZE / 2);
+
+                Assert::IsTrue(first != second);
+                Assert::AreEqual<qint64>(FrameArena::BLOCK_SIZE, FrameArena::stats().frameBytes);
+
+                FrameArena::endFrame();
+            }
+
+            Assert::AreEqual(blocks, FrameArena::stats().blockAllocations);
+        }
+
+        TEST_METHOD(VectorGrowsAndClears)
+        {
+            FrameVector<int> vector;
+            Assert::IsTrue(vector.isEmpty());
+
+            for(int i = 0; i < 100; ++i)
+            {
+                vector.push_back(i);
+            }
+
+            Assert::AreEqual(100, vector.count());
+
+            int expected = 0;
+            for(int value : vector)
+            {
+                Assert::AreEqual(expected++, value);
+            }
+
+            vector.clear();
+            Assert::IsTrue(vector.isEmpty());
+            Assert::IsTrue(vector.begin() == vector.end());
+        }
+
+        TEST_METHOD(VectorExpiresAfterNextFrame)
+        {
+            FrameVector<int> vector;
+            vector.push_back(1);
+            vector.push_back(2);
+
+            // Contents of the previous frame can still be read
+            FrameArena::endFrame();
+            Assert::AreEqual(2, vector.count());
+            Assert::AreEqual(2, vector[1]);
+
+            // Adding moves the contents to the current frame
+            vector.push_back(3);
+            FrameArena::endFrame();
+            Assert::AreEqual(3, vector.count());
+            Assert::AreEqual(1, vector[0]);
+
+            beginFreshFrame();
+            Assert::IsTrue(vector.isEmpty());
+
+            vector.push_back(4);
+            Assert::AreEqual(1, vector.count());
+            Assert::AreEqual(4, vector[0]);
+        }
+
+        TEST_METHOD(ThreadsUseSeparateArenas)
+        {
+            beginFreshFrame();
+
+            void* first = FrameArena::allocate(64);
+
+            void* other = nullptr;
+            std::thread thread([&other] () {
+                other = FrameArena::allocate(64);
+            });
+
+            thread.join();
+
+            // The other thread didn't advance the calling thread's arena
+            void* second = FrameArena::allocate(64);
+
+            Assert::IsNotNull(other);
+            Assert::IsTrue(other != first && other != second);
+            Assert::AreEqual(address(first) + 64, address(second));
+        }
+    };
+}
@@ -0,0 +1,202 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "framegraph.h"
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    FrameGraph::TextureDesc colorDesc()
+    {
+        return FrameGraph::TextureDesc(GL_RGBA16F, 1280, 720, 0);
+    }
+
+    FrameGraph::TextureDesc depthDesc()
+    {
+        return FrameGraph::TextureDesc(GL_DEPTH_COMPONENT32F, 1280, 720, 4);
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(framegraph)
+    {
+    public:
+
+        TEST_METHOD(CullsUnreadPasses)
+        {
+            FrameGraph graph;
+
+            FrameGraph::Pass scene = graph.addPass("Scene");
+            FrameGraph::Resource color = graph.createTexture(scene, "Color", colorDesc());
+
+            // Debug pass output is never consumed
+            FrameGraph::Pass debug = graph.addPass("Debug");
+            graph.read(debug, color);
+            graph.createTexture(debug, "Debug view", colorDesc());
+
+            FrameGraph::Pass present = graph.addPass("Present");
+            graph.read(present, color);
+            graph.setSideEffect(present);
+
+            Assert::IsTrue(graph.compile());
+            Assert::IsTrue(graph.isCulled(debug));
+            Assert::IsFalse(graph.isCulled(scene));
+
+            Assert::AreEqual(2, graph.order().size());
+            Assert::AreEqual(scene, graph.order()[0]);
+            Assert::AreEqual(present, graph.order()[1]);
+            Assert::AreEqual(1, graph.stats().culledPasses);
+        }
+
+        TEST_METHOD(CullsWholeChainWithoutSideEffects)
+        {
+            FrameGraph graph;
+
+            FrameGraph::Pass first = graph.addPass("First");
+            FrameGraph::Resource a = graph.createTexture(first, "A", colorDesc());
+
+            FrameGraph::Pass second = graph.addPass("Second");
+            graph.read(second, a);
+            graph.createTexture(second, "B", colorDesc());
+
+            Assert::IsTrue(graph.compile());
+            Assert::IsTrue(graph.isCulled(first));
+            Assert::IsTrue(graph.isCulled(second));
+            Assert::AreEqual(0, graph.slotCount());
+        }
+
+        TEST_METHOD(AliasesDisjointLifetimes)
+        {
+            FrameGraph graph;
+
+            FrameGraph::Pass p0 = graph.addPass("P0");
+            FrameGraph::Resource a = graph.createTexture(p0, "A", colorDesc());
+
+            FrameGraph::Pass p1 = graph.addPass("P1");
+            graph.read(p1, a);
+            FrameGraph::Resource b = graph.createTexture(p1, "B", colorDesc());
+
+            // A is dead after P1, so C can reuse its memory
+            FrameGraph::Pass p2 = graph.addPass("P2");
+            graph.read(p2, b);
+            FrameGraph::Resource c = graph.createTexture(p2, "C", colorDesc());
+
+            FrameGraph::Pass p3 = graph.addPass("P3");
+            graph.read(p3, c);
+            graph.setSideEffect(p3);
+
+            Assert::IsTrue(graph.compile());
+            Assert::AreEqual(2, graph.slotCount());
+            Assert::AreEqual(graph.physicalSlot(a), graph.physicalSlot(c));
+            Assert::AreNotEqual(graph.physicalSlot(a), graph.physicalSlot(b));
+
+            Assert::AreEqual(3, graph.stats().transientTextures);
+            Assert::AreEqual(3 * colorDesc().bytes(), graph.stats().transientBytes);
+            Assert::AreEqual(2 * colorDesc().bytes(), graph.stats().physicalBytes);
+        }
+
+        TEST_METHOD(OverlappingLifetimesAreNotAliased)
+        {
+            FrameGraph graph;
+
+            FrameGraph::Pass p0 = graph.addPass("P0");
+            FrameGraph::Resource a = graph.createTexture(p0, "A", colorDesc());
+            FrameGraph::Resource b = graph.createTexture(p0, "B", colorDesc());
+
+            FrameGraph::Pass p1 = graph.addPass("P1");
+            graph.read(p1, b);
+            FrameGraph::Resource c = graph.createTexture(p1, "C", colorDesc());
+
+            FrameGraph::Pass p2 = graph.addPass("P2");
+            graph.read(p2, a);
+            graph.read(p2, c);
+            graph.setSideEffect(p2);
+
+            Assert::IsTrue(graph.compile());
+            Assert::AreEqual(3, graph.slotCount());
+            Assert::AreNotEqual(graph.physicalSlot(a), graph.physicalSlot(c));
+        }
+
+        TEST_METHOD(AliasingRequiresMatchingDesc)
+        {
+            FrameGraph graph;
+
+            FrameGraph::Pass p0 = graph.addPass("P0");
+            FrameGraph::Resource depth = graph.createTexture(p0, "Depth", depthDesc());
+
+            FrameGraph::Pass p1 = graph.addPass("P1");
+            graph.read(p1, depth);
+            FrameGraph::Resource color = graph.createTexture(p1, "Color", colorDesc());
+
+            FrameGraph::Pass p2 = graph.addPass("P2");
+            graph.read(p2, color);
+            FrameGraph::Resource depth2 = graph.createTexture(p2, "Depth 2", depthDesc());
+
+            FrameGraph::Pass p3 = graph.addPass("P3");
+            graph.read(p3, depth2);
+            graph.setSideEffect(p3);
+
+            Assert::IsTrue(graph.compile());
+            Assert::AreEqual(2, graph.slotCount());
+            Assert::AreEqual(graph.physicalSlot(depth), graph.physicalSlot(depth2));
+            Assert::IsTrue(graph.slotDesc(graph.physicalSlot(depth)) == depthDesc());
+        }
+
+        TEST_METHOD(ImportedTexturesAreNotPooled)
+        {
+            FrameGraph graph;
+            FrameGraph::Resource shadows = graph.importTexture("Shadows", 42);
+
+            FrameGraph::Pass shadow = graph.addPass("Shadow");
+            graph.write(shadow, shadows, FrameGraph::ATTACH_NONE);
+
+            FrameGraph::Pass light = graph.addPass("Light");
+            graph.read(light, shadows);
+            graph.setSideEffect(light);
+
+            Assert::IsTrue(graph.compile());
+            Assert::IsFalse(graph.isCulled(shadow));
+            Assert::IsTrue(graph.isImported(shadows));
+            Assert::AreEqual(42u, graph.importedTexture(shadows));
+            Assert::AreEqual(-1, graph.physicalSlot(shadows));
+            Assert::AreEqual(0, graph.slotCount());
+        }
+
+        TEST_METHOD(ReadBeforeWriteFails)
+        {
+            FrameGraph graph;
+
+            FrameGraph::Pass p0 = graph.addPass("P0");
+            FrameGraph::Pass p1 = graph.addPass("P1");
+            FrameGraph::Resource a = graph.createTexture(p1, "A", colorDesc());
+
+            graph.read(p0, a);
+            graph.setSideEffect(p1);
+
+            Assert::IsFalse(graph.compile());
+        }
+
+        TEST_METHOD(RecompileAfterClear)
+        {
+            FrameGraph graph;
+
+            FrameGraph::Pass p0 = graph.addPass("P0");
+            graph.createTexture(p0, "A", colorDesc());
+            graph.setSideEffect(p0);
+            Assert::IsTrue(graph.compile());
+            Assert::AreEqual(1, graph.slotCount());
+
+            graph.clear();
+            Assert::AreEqual(0, graph.passCount());
+
+            FrameGraph::Pass p1 = graph.addPass("P1");
+            graph.setSideEffect(p1);
+            Assert::IsTrue(graph.compile());
+            Assert::AreEqual(0, graph.slotCount());
+            Assert::AreEqual(1, graph.stats().passes);
+        }
+    };
+}
@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "gpucounters.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace tests
+{
+    TEST_CLASS(gpucounters)
+    {
+    public:
+
+        TEST_METHOD(SnapshotDifferenceCountsWork)
+        {
+            GpuCounters::Snapshot before = GpuCounters::snapshot();
+
+            GpuCounters::add(GpuCounters::DRAW_CALLS);
+            GpuCounters::add(GpuCounters::PRIMITIVES, 100);
+
+            GpuCounters::Snapshot work = GpuCounters::snapshot() - before;
+
+            Assert::AreEqual(1ull, work[GpuCounters::DRAW_CALLS]);
+            Assert::AreEqual(100ull, work[GpuCounters::PRIMITIVES]);
+            Assert::AreEqual(0ull, work[GpuCounters::PROGRAM_BINDS]);
+        }
+
+        TEST_METHOD(ItemsAreOnlyRecordedWhenTracking)
+        {
+            int key = 0;
+
+            GpuCounters::resetItems();
+            GpuCounters::setItemTracking(false);
+            {
+                GpuCounterItem item(&key, "Ignored");
+                GpuCounters::add(GpuCounters::DRAW_CALLS);
+            }
+
+            Assert::AreEqual(0, GpuCounters::topItems(GpuCounters::DRAW_CALLS, 5).size());
+        }
+
+        TEST_METHOD(TopItemsAreSortedByCounter)
+        {
+            int small = 0;
+            int large = 0;
+
+            GpuCounters::resetItems();
+            GpuCounters::setItemTracking(true);
+
+            for(int frame = 0; frame < 2; ++frame)
+            {
+                {
+                    GpuCounterItem item(&small, "Small");
+                    GpuCounters::add(GpuCounters::PRIMITIVES, 10);
+                }
+
+                {
+                    GpuCounterItem item(&large, "Large");
+                    GpuCounters::add(GpuCounters::PRIMITIVES, 1000);
+                    GpuCounters::add(GpuCounters::DRAW_CALLS);
+                }
+
+                // Work outside items isn't attributed
+                GpuCounters::add(GpuCounters::PRIMITIVES, 5);
+            }
+
+            GpuCounters::setItemTracking(false);
+
+            QList<GpuCounters::Item> items = GpuCounters::topItems(GpuCounters::PRIMITIVES, 5);
+            Assert::AreEqual(2, items.size());
+
+            Assert::IsTrue(items[0].name == "Large");
+            Assert::AreEqual(2000ull, items[0].counts[GpuCounters::PRIMITIVES]);
+            Assert::AreEqual(2ull, items[0].counts[GpuCounters::DRAW_CALLS]);
+
+            Assert::IsTrue(items[1].name == "Small");
+            Assert::AreEqual(20ull, items[1].counts[GpuCounters::PRIMITIVES]);
+
+            Assert::AreEqual(1, GpuCounters::topItems(GpuCounters::PRIMITIVES, 1).size());
+            GpuCounters::resetItems();
+        }
+
+        TEST_METHOD(ImageBytesFromFormatAndType)
+        {
+            Assert::AreEqual(4ull * 4 * 4, GpuCounters::imageBytes(4, 4, GL_RGBA, GL_UNSIGNED_BYTE));
+            Assert::AreEqual(2ull * 2 * 3 * 4, GpuCounters::imageBytes(2, 2, GL_RGB, GL_FLOAT));
+            Assert::AreEqual(0ull, GpuCounters::imageBytes(4, 4, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE));
+        }
+    };
+}
@@ -0,0 +1,155 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "histogram.h"
+#include "framestatistics.h"
+#include "movingaverage.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace tests
+{
+    TEST_CLASS(histogram)
+    {
+    public:
+
+        TEST_METHOD(EmptyHistogramReportsZero)
+        {
+            Histogram histogram;
+
+            Assert::AreEqual(0, histogram.count());
+            Assert::AreEqual(0.0, histogram.mean());
+            Assert::AreEqual(0ll, histogram.percentile(0.5));
+            Assert::AreEqual(0ll, histogram.max());
+        }
+
+        TEST_METHOD(BucketsContainTheirValues)
+        {
+            for(qint64 value = 0; value < (1ll << 40); value = value * 3 / 2 + 1)
+            {
+                int bucket = Histogram::bucketIndex(value);
+
+                Assert::IsTrue(Histogram::bucketLowerBound(bucket) <= value);
+                Assert::IsTrue(value < Histogram::bucketUpperBound(bucket));
+            }
+
+            // Small values are exact
+            Assert::AreEqual(7, Histogram::bucketIndex(7));
+            Assert::AreEqual(Histogram::BUCKET_COUNT - 1, Histogram::bucketIndex(1ll << 62));
+        }
+
+        TEST_METHOD(PercentilesAreWithinBucketPrecision)
+        {
+            Histogram histogram;
+
+            // 1..1000 ms in nanoseconds
+            for(int i = 1; i <= 1000; ++i)
+            {
+                histogram.add(i * 1000000ll);
+            }
+
+            Assert::AreEqual(1000, histogram.count());
+            Assert::AreEqual(500.5e6, histogram.mean(), 1.0);
+            Assert::AreEqual(1000000000ll, histogram.max());
+
+            Assert::AreEqual(500e6, static_cast<double>(histogram.percentile(0.50)), 500e6 / 16);
+            Assert::AreEqual(950e6, static_cast<double>(histogram.percentile(0.95)), 950e6 / 16);
+            Assert::AreEqual(990e6, static_cast<double>(histogram.percentile(0.99)), 990e6 / 16);
+            Assert::AreEqual(1000000000ll, histogram.percentile(1.0));
+        }
+
+        TEST_METHOD(ResetDiscardsSamples)
+        {
+            Histogram histogram;
+            histogram.add(100);
+            histogram.reset();
+
+            Assert::AreEqual(0, histogram.count());
+            Assert::AreEqual(0, histogram.bucketSamples(Histogram::bucketIndex(100)));
+        }
+
+        TEST_METHOD(AddsFromSeveralThreads)
+        {
+            Histogram histogram;
+            const int samples = 10000;
+
+            auto add = [&histogram, samples]
+            {
+                for(int i = 0; i < samples; ++i)
+                {
+                    histogram.add(i);
+                }
+            };
+
+            std::thread first(add);
+            std::thread second(add);
+
+            first.join();
+            second.join();
+
+            Assert::AreEqual(samples * 2, histogram.count());
+            Assert::AreEqual(static_cast<qint64>(samples - 1), histogram.max());
+        }
+
+        TEST_METHOD(MovingAverageKeepsLastSamples)
+        {
+            MovingAverage<qint64, double, 4> average(10);
+            Assert::AreEqual(10.0, average.calcAverage());
+
+            for(int i = 1; i <= 9; ++i)
+            {
+                average << i;
+            }
+
+            // (6 + 7 + 8 + 9) / 4
+            Assert::AreEqual(7.5, average.calcAverage());
+        }
+
+        TEST_METHOD(StatisticsAreSharedByName)
+        {
+            FrameStatistics statistics;
+
+            Statistic* stat = statistics.stat("Frame time", "ms", 1e-6);
+            Assert::IsTrue(stat == statistics.stat("Frame time"));
+            Assert::AreEqual(1, statistics.stats().size());
+
+            stat->add(1000);
+            statistics.resetWindows();
+
+            Assert::AreEqual(0, stat->window().count());
+            Assert::AreEqual(1, stat->total().count());
+        }
+
+        TEST_METHOD(DumpWritesBuckets)
+        {
+            FrameStatistics statistics;
+
+            Statistic* stat = statistics.stat("Frame time", "ms", 1e-6);
+            stat->add(2000000);
+            stat->add(2000000);
+            stat->add(8000000);
+
+            QString fileName = QDir::temp().filePath("statistics_test.json");
+            Assert::IsTrue(statistics.dump(fileName));
+
+            QFile file(fileName);
+            Assert::IsTrue(file.open(QIODevice::ReadOnly));
+
+            QJsonArray stats = QJsonDocument::fromJson(file.readAll()).object()["statistics"].toArray();
+            Assert::AreEqual(1, stats.size());
+
+            QJsonObject object = stats[0].toObject();
+            Assert::AreEqual(3, object["count"].toInt());
+            Assert::AreEqual(8.0, object["max"].toDouble(), 1e-6);
+            Assert::AreEqual(2, object["buckets"].toArray().size());
+        }
+    };
+}
@@ -0,0 +1,207 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "lifegrid.h"
+
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    typedef std::vector<bool> Cells;
+
+    Cells cells(const LifeGrid& grid)
+    {
+        Cells result(grid.width() * grid.height());
+        for(int y = 0; y < grid.height(); ++y)
+        {
+            for(int x = 0; x < grid.width(); ++x)
+            {
+                result[y * grid.width() + x] = grid.cell(x, y);
+            }
+        }
+
+        return result;
+    }
+
+    // Steps the grid one cell at a time on the torus
+    Cells referenceStep(const Cells& current, int width, int height)
+    {
+        Cells next(current.size());
+        for(int y = 0; y < height; ++y)
+        {
+            for(int x = 0; x < width; ++x)
+            {
+                int neighbours = 0;
+                for(int dy = -1; dy <= 1; ++dy)
+                {
+                    for(int dx = -1; dx <= 1; ++dx)
+                    {
+                        if(dx != 0 || dy != 0)
+                        {
+                            neighbours += current[((y + dy + height) % height) * width + (x + dx + width) % width];
+                        }
+                    }
+                }
+
+                const bool alive = current[y * width + x];
+                next[y * width + x] = neighbours == 3 || (alive && neighbours == 2);
+            }
+        }
+
+        return next;
+    }
+
+    // Steps the grid and checks the cells, the flip count and the reported changes against the reference
+    void stepAndCompare(LifeGrid& grid)
+    {
+        const Cells before = cells(grid);
+        const Cells expected = referenceStep(before, grid.width(), grid.height());
+
+        const int flipped = grid.step();
+        const Cells after = cells(grid);
+
+        Assert::IsTrue(after == expected);
+
+        int changes = 0;
+        bool matches = true;
+
+        grid.forEachChange([&] (int x, int y, bool alive)
+        {
+            const int index = y * grid.width() + x;
+            matches = matches && before[index] != alive && after[index] == alive;
+            ++changes;
+        });
+
+        Assert::IsTrue(matches);
+        Assert::AreEqual(flipped, changes);
+
+        int differences = 0;
+        for(size_t i = 0; i < before.size(); ++i)
+        {
+            differences += before[i] != after[i] ? 1 : 0;
+        }
+
+        Assert::AreEqual(differences, flipped);
+    }
+
+    void addGlider(LifeGrid& grid, int x, int y)
+    {
+        const int cells[5][2] = { { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
+        for(const auto& cell : cells)
+        {
+            grid.setCell((x + cell[0]) % grid.width(), (y + cell[1]) % grid.height(), true);
+        }
+    }
+
+    void randomFill(LifeGrid& grid, unsigned int seed)
+    {
+        for(int y = 0; y < grid.height(); ++y)
+        {
+            for(int x = 0; x < grid.width(); ++x)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                grid.setCell(x, y, (seed >> 28) < 5);
+            }
+        }
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(lifegrid)
+    {
+    public:
+
+        TEST_METHOD(BlinkerOscillates)
+        {
+            LifeGrid grid(64, 8);
+            grid.setCell(9, 4, true);
+            grid.setCell(10, 4, true);
+            grid.setCell(11, 4, true);
+
+            Assert::AreEqual(4, grid.step());
+            Assert::IsTrue(grid.cell(10, 3) && grid.cell(10, 4) && grid.cell(10, 5));
+            Assert::IsFalse(grid.cell(9, 4) || grid.cell(11, 4));
+
+            Assert::AreEqual(4, grid.step());
+            Assert::IsTrue(grid.cell(9, 4) && grid.cell(10, 4) && grid.cell(11, 4));
+            Assert::IsFalse(grid.cell(10, 3) || grid.cell(10, 5));
+        }
+
+        TEST_METHOD(GliderCrossesWordEdges)
+        {
+            // Crosses from the first word to the second one
+            LifeGrid grid(128, 16);
+            addGlider(grid, 60, 2);
+
+            for(int generation = 0; generation < 32; ++generation)
+            {
+                stepAndCompare(grid);
+            }
+
+            // A glider moves one cell diagonally every four generations
+            LifeGrid moved(128, 16);
+            addGlider(moved, 68, 10);
+
+            Assert::IsTrue(cells(grid) == cells(moved));
+        }
+
+        TEST_METHOD(GliderWrapsAround)
+        {
+            // Crosses the last word into the first one, and the last row into the first one
+            LifeGrid grid(128, 8);
+            addGlider(grid, 125, 5);
+
+            for(int generation = 0; generation < 16; ++generation)
+            {
+                stepAndCompare(grid);
+            }
+
+            LifeGrid moved(128, 8);
+            addGlider(moved, 129, 9);
+
+            Assert::IsTrue(cells(grid) == cells(moved));
+        }
+
+        TEST_METHOD(SingleWordRowWrapsAround)
+        {
+            // The west and east neighbours of the only word are the word itself
+            LifeGrid grid(64, 64);
+            randomFill(grid, 7);
+
+            for(int generation = 0; generation < 8; ++generation)
+            {
+                stepAndCompare(grid);
+            }
+        }
+
+        TEST_METHOD(RoundedWidthMatchesReference)
+        {
+            // GameOfLife rounds the requested width up to whole words, eg. 100 to 128
+            const int width = (100 + LifeGrid::CELLS_PER_WORD - 1) / LifeGrid::CELLS_PER_WORD * LifeGrid::CELLS_PER_WORD;
+            Assert::AreEqual(128, width);
+
+            LifeGrid grid(width, 37);
+            randomFill(grid, 1);
+
+            for(int generation = 0; generation < 8; ++generation)
+            {
+                stepAndCompare(grid);
+            }
+        }
+
+        TEST_METHOD(BandsMatchReference)
+        {
+            // Large enough to be split into row bands on multi-core machines
+            LifeGrid grid(512, 1031);
+            randomFill(grid, 3);
+
+            for(int generation = 0; generation < 4; ++generation)
+            {
+                stepAndCompare(grid);
+            }
+        }
+    };
+}
@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "resolutioncontroller.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    // GPU bound synthetic frame: cost scales with the rendered pixel count
+    float frameTime(float fullResTime, float scale)
+    {
+        return fullResTime * scale * scale;
+    }
+
+    float runTrace(ResolutionController& controller, float fullResTime, int frames)
+    {
+        for(int i = 0; i < frames; ++i)
+        {
+            controller.update(frameTime(fullResTime, controller.scale()));
+        }
+
+        return controller.scale();
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(resolutioncontroller)
+    {
+    public:
+
+        TEST_METHOD(ConvergesToBudget)
+        {
+            ResolutionController controller(16.0f);
+            float scale = runTrace(controller, 25.0f, 300);
+
+            Assert::AreEqual(std::sqrt(16.0f / 25.0f), scale, 0.02f);
+            Assert::AreEqual(16.0f, frameTime(25.0f, scale), 16.0f * 0.05f);
+        }
+
+        TEST_METHOD(StaysWithinBounds)
+        {
+            ResolutionController controller(16.0f);
+            controller.setBounds(0.5f, 1.0f);
+
+            Assert::AreEqual(0.5f, runTrace(controller, 200.0f, 200));
+            Assert::AreEqual(1.0f, runTrace(controller, 5.0f, 200));
+        }
+
+        TEST_METHOD(RecoversAfterSpike)
+        {
+            ResolutionController controller(16.0f);
+            runTrace(controller, 12.0f, 100);
+            Assert::AreEqual(1.0f, controller.scale());
+
+            // Integral must not wind up at the upper bound while there is headroom
+            controller.update(frameTime(40.0f, controller.scale()));
+            Assert::IsTrue(controller.scale() < 1.0f);
+
+            float lowest = runTrace(controller, 40.0f, 10);
+            Assert::IsTrue(lowest < 0.9f);
+
+            Assert::AreEqual(1.0f, runTrace(controller, 12.0f, 100));
+        }
+
+        TEST_METHOD(NoisyTraceDoesNotHunt)
+        {
+            ResolutionController controller(16.0f);
+            runTrace(controller, 25.0f, 100);
+
+            float lowest = controller.scale();
+            float highest = lowest;
+
+            // Deterministic +-5% noise
+            for(int i = 0; i < 200; ++i)
+            {
+                float noise = 1.0f + 0.05f * std::sin(i * 2.3f);
+                controller.update(frameTime(25.0f, controller.scale()) * noise);
+
+                lowest = std::min(lowest, controller.scale());
+                highest = std::max(highest, controller.scale());
+            }
+
+            Assert::IsTrue(highest - lowest < 0.05f);
+        }
+
+        TEST_METHOD(ResetRestoresMaxScale)
+        {
+            ResolutionController controller(16.0f);
+            controller.setBounds(0.25f, 0.9f);
+            runTrace(controller, 100.0f, 50);
+
+            controller.reset();
+            Assert::AreEqual(0.9f, controller.scale());
+        }
+    };
+}
@@ -40,5 +40,28 @@ namespace tests
             Assert::AreEqual(QVector3D(0, 20.0f, 0), grandChild->worldPosition());
         }
 
+        TEST_METHOD(LocalTransformation)
+        {
+            Graph::SceneNode root;
+            root.move(QVector3D(0, 10.0f, 0));
+
+            Graph::SceneNode* child = root.createChild();
+            child->move(QVector3D(5.0f, 0, 0));
+            root.propagate();
+
+            // Local transformation excludes the parent's
+            Assert::AreEqual(QVector3D(5.0f, 0, 0), child->localTransformation() * QVector3D());
+            Assert::AreEqual(QVector3D(5.0f, 10.0f, 0), child->transformation() * QVector3D());
+
+            // Copied transformations give the same world transformation
+            Graph::SceneNode copy;
+            copy.applyTransformation(root.localTransformation());
+            Graph::SceneNode* copyChild = copy.createChild();
+            copyChild->applyTransformation(child->localTransformation());
+            copy.propagate();
+
+            Assert::AreEqual(child->worldPosition(), copyChild->worldPosition());
+        }
+
     };
 }
\ No newline at end of file
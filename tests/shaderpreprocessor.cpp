@@ -0,0 +1,160 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "shaderpreprocessor.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+
+#include <sstream>
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    void writeFile(const QString& fileName, const QByteArray& data)
+    {
+        QFile file(fileName);
+        Assert::IsTrue(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(shaderpreprocessor)
+    {
+    public:
+
+        TEST_METHOD(NamedDefines)
+        {
+            QTemporaryDir dir;
+            writeFile(dir.path() + "/a.frag", "#version 420\n#define SAMPLES <>\nvoid main() {}\n");
+
+            ShaderData::DefineMap defines;
+            defines.insert("SAMPLES", 4);
+
+            ShaderPreprocessor preprocessor(defines);
+            QByteArray output;
+
+            Assert::IsTrue(preprocessor.process(dir.path() + "/a.frag", output));
+            Assert::IsTrue(output.contains("#define SAMPLES 4\n"));
+            Assert::IsFalse(output.contains("<>"));
+        }
+
+        TEST_METHOD(ConditionalsOverDefines)
+        {
+            QTemporaryDir dir;
+            writeFile(dir.path() + "/a.frag",
+                "#ifdef SHADOW\nshadow\n#else\nnoshadow\n#endif\n"
+                "#ifndef SHADOW\nnotdefined\n#endif\n"
+                "#ifdef OTHER\nother\n#endif\n");
+
+            ShaderData::DefineMap defines;
+            defines.insert("SHADOW", 1);
+
+            ShaderPreprocessor preprocessor(defines);
+            QByteArray output;
+
+            Assert::IsTrue(preprocessor.process(dir.path() + "/a.frag", output));
+            Assert::IsTrue(output.contains("shadow\n"));
+            Assert::IsFalse(output.contains("noshadow"));
+            Assert::IsFalse(output.contains("notdefined"));
+
+            // Names outside the define map are left for the compiler
+            Assert::IsTrue(output.contains("#ifdef OTHER\nother\n#endif\n"));
+        }
+
+        TEST_METHOD(IncludeDependencies)
+        {
+            QTemporaryDir dir;
+            QDir(dir.path()).mkdir("inc");
+
+            writeFile(dir.path() + "/a.frag", "#include \"inc/b.frag\"\n#ifndef NO_C\n#include \"c.frag\"\n#endif\nmain\n");
+            writeFile(dir.path() + "/inc/b.frag", "#include \"d.frag\"\nb");
+            writeFile(dir.path() + "/inc/d.frag", "d\n");
+            writeFile(dir.path() + "/c.frag", "c\n");
+
+            ShaderData::DefineMap defines;
+            defines.insert("NO_C", 1);
+
+            ShaderPreprocessor preprocessor(defines);
+            QByteArray output;
+
+            Assert::IsTrue(preprocessor.process(dir.path() + "/a.frag", output));
+            Assert::AreEqual(std::string("d\nb\nmain\n"), output.toStdString());
+
+            // Nested includes are resolved relative to the including file.
+            // Included files in inactive blocks are not dependencies.
+            const QStringList& deps = preprocessor.dependencies();
+            Assert::AreEqual(2, deps.count());
+            Assert::IsTrue(deps.contains(QDir::cleanPath(dir.path() + "/inc/b.frag")));
+            Assert::IsTrue(deps.contains(QDir::cleanPath(dir.path() + "/inc/d.frag")));
+
+            // Unresolved conditional is left for the compiler, so the include is active
+            ShaderData::DefineMap empty;
+            ShaderPreprocessor passthrough(empty);
+            output.clear();
+
+            Assert::IsTrue(passthrough.process(dir.path() + "/a.frag", output));
+            Assert::AreEqual(std::string("d\nb\n#ifndef NO_C\nc\n#endif\nmain\n"), output.toStdString());
+            Assert::AreEqual(3, passthrough.dependencies().count());
+        }
+
+        TEST_METHOD(Throughput)
+        {
+            // Preprocesses every shader in engine/shaders, with and without the memoised includes.
+            const QDir shaderDir(QFileInfo(__FILE__).dir().filePath("../engine/shaders"));
+            const QStringList files = shaderDir.entryList(QStringList() << "*.vert" << "*.frag", QDir::Files);
+            Assert::IsTrue(files.count() > 0);
+
+            ShaderData::DefineMap defines;
+            defines.insert("SAMPLES", 4);
+            defines.insert("BLOOMLOD", 4);
+            defines.insert("LIGHT_TYPE", -1);
+            defines.insert("SHADOW", 0);
+
+            const int iterations = 100;
+            qint64 bytes = 0;
+
+            QElapsedTimer timer;
+            qint64 coldTime = 0;
+            qint64 warmTime = 0;
+
+            for(int i = 0; i < iterations; ++i)
+            {
+                for(const QString& file : files)
+                {
+                    ShaderPreprocessor::clearCache();
+
+                    ShaderPreprocessor preprocessor(defines);
+                    QByteArray output;
+
+                    timer.start();
+                    Assert::IsTrue(preprocessor.process(shaderDir.filePath(file), output));
+                    coldTime += timer.nsecsElapsed();
+
+                    output.clear();
+
+                    timer.start();
+                    Assert::IsTrue(preprocessor.process(shaderDir.filePath(file), output));
+                    warmTime += timer.nsecsElapsed();
+
+                    bytes += output.size();
+                }
+            }
+
+            std::stringstream ss;
+            ss << "Preprocessed " << files.count() << " shaders x " << iterations << ": "
+               << "cold " << bytes / (coldTime * 1e-9) / (1 << 20) << " MiB/s, "
+               << "memoised " << bytes / (warmTime * 1e-9) / (1 << 20) << " MiB/s";
+
+            Logger::WriteMessage(ss.str().c_str());
+        }
+
+    };
+}
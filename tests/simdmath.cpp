@@ -0,0 +1,133 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <QMatrix4x4>
+#include <QQuaternion>
+
+#include "simdmath.h"
+#include "mathelp.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    void assertEqual(const QMatrix4x4& expected, const QMatrix4x4& actual)
+    {
+        for(int i = 0; i < 16; ++i)
+        {
+            Assert::AreEqual(expected.constData()[i], actual.constData()[i], 1e-4f);
+        }
+    }
+
+    void assertEqual(const QVector3D& expected, const QVector3D& actual)
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            Assert::AreEqual(expected[i], actual[i], 1e-4f);
+        }
+    }
+
+    QMatrix4x4 testTransformation()
+    {
+        QMatrix4x4 matrix;
+        matrix.translate(QVector3D(1.0f, -2.0f, 3.0f));
+        matrix.rotate(30.0f, QVector3D(1.0f, 1.0f, 0.0f).normalized());
+        matrix.scale(QVector3D(2.0f, 0.5f, 1.5f));
+
+        return matrix;
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(simdmath)
+    {
+    public:
+
+        TEST_METHOD(MultiplyMatchesQt)
+        {
+            QMatrix4x4 projection;
+            projection.perspective(45.0f, 1.5f, 0.1f, 100.0f);
+            projection.lookAt(QVector3D(5, 5, 5), QVector3D(0, 0, 0), UNIT_Y);
+
+            const QMatrix4x4 model = testTransformation();
+
+            assertEqual(projection * model, Simd::multiply(projection, model));
+            assertEqual(model, (Simd::Mat4::identity() * Simd::Mat4::fromQt(model)).toQt());
+        }
+
+        TEST_METHOD(AffineMatchesMat4)
+        {
+            const QMatrix4x4 first = testTransformation();
+            QMatrix4x4 second;
+            second.rotate(-60.0f, UNIT_Z);
+            second.translate(QVector3D(0.0f, 4.0f, -1.0f));
+
+            Simd::Affine product = Simd::Affine::fromQt(first) * Simd::Affine::fromQt(second);
+            assertEqual(first * second, product.toQt());
+
+            const Simd::Vec4 point(1.0f, 2.0f, 3.0f, 1.0f);
+            assertEqual(first * QVector3D(1.0f, 2.0f, 3.0f), Simd::Affine::fromQt(first).mapPoint(point).toVector3D());
+        }
+
+        TEST_METHOD(QuaternionToMatrix)
+        {
+            QQuaternion rotation = QQuaternion::fromAxisAndAngle(QVector3D(1.0f, 2.0f, 3.0f).normalized(), 75.0f);
+
+            QMatrix4x4 expected;
+            expected.rotate(rotation);
+
+            // Unnormalized quaternion is normalized first
+            Simd::Quat quat = Simd::Quat::fromQt(rotation * 3.0f).normalized();
+            assertEqual(expected, quat.toMat4().toQt());
+
+            Assert::AreEqual(1.0f, Simd::dot4(Simd::Vec4(quat.v[0], quat.v[1], quat.v[2], quat.v[3]),
+                Simd::Vec4(quat.v[0], quat.v[1], quat.v[2], quat.v[3])), 1e-5f);
+        }
+
+        TEST_METHOD(TransformBoxEnclosesCorners)
+        {
+            const QMatrix4x4 matrix = testTransformation();
+            const QVector3D center(1.0f, 0.0f, -1.0f);
+            const QVector3D extent(0.5f, 2.0f, 1.0f);
+
+            Simd::Vec4 outCenter, outExtent;
+            Simd::transformBox(Simd::Mat4::fromQt(matrix), Simd::Vec4::fromQt(center, 1.0f),
+                Simd::Vec4::fromQt(extent, 0.0f), outCenter, outExtent);
+
+            QVector3D min = matrix * center;
+            QVector3D max = min;
+
+            for(int i = 0; i < 8; ++i)
+            {
+                QVector3D corner(i & 1 ? extent.x() : -extent.x(), i & 2 ? extent.y() : -extent.y(), i & 4 ? extent.z() : -extent.z());
+                QVector3D point = matrix * (center + corner);
+
+                for(int axis = 0; axis < 3; ++axis)
+                {
+                    min[axis] = qMin(min[axis], point[axis]);
+                    max[axis] = qMax(max[axis], point[axis]);
+                }
+            }
+
+            assertEqual(0.5f * (min + max), outCenter.toVector3D());
+            assertEqual(0.5f * (max - min), outExtent.toVector3D());
+        }
+
+        TEST_METHOD(ExtractScaleAndOrientation)
+        {
+            QQuaternion rotation = QQuaternion::fromAxisAndAngle(UNIT_Y, 40.0f);
+
+            QMatrix4x4 matrix;
+            matrix.translate(QVector3D(3.0f, 0.0f, 0.0f));
+            matrix.rotate(rotation);
+            matrix.scale(QVector3D(2.0f, 3.0f, 4.0f));
+
+            assertEqual(QVector3D(2.0f, 3.0f, 4.0f), extractScale(matrix));
+
+            QQuaternion orientation = extractOrientation(matrix);
+            Assert::AreEqual(static_cast<float>(rotation.scalar()), static_cast<float>(orientation.scalar()), 1e-4f);
+            assertEqual(rotation.vector(), orientation.vector());
+        }
+    };
+}
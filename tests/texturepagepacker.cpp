@@ -0,0 +1,123 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "texturepagepacker.h"
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    TexturePagePacker::Format makeFormat(int size, unsigned int internalFormat = 0x8058)
+    {
+        TexturePagePacker::Format format;
+        format.internalFormat = internalFormat;
+        format.width = size;
+        format.height = size;
+        format.levels = 1;
+        format.layerSize = size * size * 4;
+
+        return format;
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(texturepagepacker)
+    {
+    public:
+
+        TEST_METHOD(MatchingFormatsSharePage)
+        {
+            TexturePagePacker packer(1 << 20, 256);
+
+            TexturePagePacker::Slot first = packer.allocate(makeFormat(64));
+            TexturePagePacker::Slot second = packer.allocate(makeFormat(64));
+
+            Assert::AreEqual(1, packer.pageCount());
+            Assert::AreEqual(first.page, second.page);
+            Assert::AreEqual(0, first.layer);
+            Assert::AreEqual(1, second.layer);
+            Assert::AreEqual(2, packer.pageUsage(first.page));
+        }
+
+        TEST_METHOD(DifferentFormatsSeparatePages)
+        {
+            TexturePagePacker packer(1 << 20, 256);
+
+            TexturePagePacker::Slot small = packer.allocate(makeFormat(64));
+            TexturePagePacker::Slot large = packer.allocate(makeFormat(128));
+            TexturePagePacker::Slot gray = packer.allocate(makeFormat(64, 0x8229));
+
+            Assert::AreEqual(3, packer.pageCount());
+            Assert::AreNotEqual(small.page, large.page);
+            Assert::AreNotEqual(small.page, gray.page);
+            Assert::AreEqual(0, large.layer);
+            Assert::AreEqual(0, gray.layer);
+        }
+
+        TEST_METHOD(PageLayersFitBudget)
+        {
+            // 64x64 RGBA layer is 16 KiB
+            TexturePagePacker packer(64 << 10, 256);
+            packer.allocate(makeFormat(64));
+            Assert::AreEqual(4, packer.pageLayers(0));
+
+            // Layer larger than the budget still gets a page
+            packer.allocate(makeFormat(256));
+            Assert::AreEqual(1, packer.pageLayers(1));
+
+            // Layer count is clamped
+            TexturePagePacker clamped(1 << 30, 8);
+            clamped.allocate(makeFormat(4));
+            Assert::AreEqual(8, clamped.pageLayers(0));
+        }
+
+        TEST_METHOD(FullPageAppendsNewPage)
+        {
+            TexturePagePacker packer(2 * 64 * 64 * 4, 256);
+
+            packer.allocate(makeFormat(64));
+            packer.allocate(makeFormat(64));
+            TexturePagePacker::Slot third = packer.allocate(makeFormat(64));
+
+            Assert::AreEqual(2, packer.pageCount());
+            Assert::AreEqual(1, third.page);
+            Assert::AreEqual(0, third.layer);
+        }
+
+        TEST_METHOD(ReleasedLayerIsReused)
+        {
+            TexturePagePacker packer(1 << 20, 256);
+
+            TexturePagePacker::Slot first = packer.allocate(makeFormat(64));
+            TexturePagePacker::Slot second = packer.allocate(makeFormat(64));
+            packer.allocate(makeFormat(64));
+
+            packer.release(second);
+            Assert::AreEqual(2, packer.pageUsage(first.page));
+
+            TexturePagePacker::Slot reused = packer.allocate(makeFormat(64));
+            Assert::AreEqual(second.page, reused.page);
+            Assert::AreEqual(second.layer, reused.layer);
+            Assert::AreEqual(1, packer.pageCount());
+        }
+
+        TEST_METHOD(PageIndicesAreStable)
+        {
+            TexturePagePacker packer(64 * 64 * 4, 256);
+
+            TexturePagePacker::Slot first = packer.allocate(makeFormat(64));
+            packer.allocate(makeFormat(128));
+
+            // Emptying the first page doesn't shift the second
+            packer.release(first);
+            Assert::AreEqual(2, packer.pageCount());
+            Assert::AreEqual(0, packer.pageUsage(0));
+            Assert::AreEqual(128, packer.pageFormat(1).width);
+
+            TexturePagePacker::Slot again = packer.allocate(makeFormat(64));
+            Assert::AreEqual(0, again.page);
+        }
+    };
+}
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "tracer.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    QJsonArray writeTrace()
+    {
+        QString fileName = QDir::temp().filePath("tracer_test.json");
+        Assert::IsTrue(Tracer::writeChromeTrace(fileName));
+
+        QFile file(fileName);
+        Assert::IsTrue(file.open(QIODevice::ReadOnly));
+
+        QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+        Assert::IsTrue(document.isObject());
+
+        return document.object()["traceEvents"].toArray();
+    }
+
+    int countEvents(const QJsonArray& events, const QString& phase, const QString& name = QString())
+    {
+        int count = 0;
+        for(const QJsonValue& value : events)
+        {
+            QJsonObject event = value.toObject();
+            if(event["ph"].toString() == phase && (name.isEmpty() || event["name"].toString() == name))
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    int threadOf(const QJsonArray& events, const QString& name)
+    {
+        for(const QJsonValue& value : events)
+        {
+            QJsonObject event = value.toObject();
+            if(event["name"].toString() == name)
+            {
+                return event["tid"].toInt();
+            }
+        }
+
+        return -1;
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(tracer)
+    {
+    public:
+
+        TEST_METHOD(RecordsNothingWhenNotCapturing)
+        {
+            Tracer::beginCapture();
+            Tracer::endCapture();
+
+            {
+                TRACE_SCOPE("Ignored");
+                TRACE_FRAME();
+            }
+
+            Assert::AreEqual(0, Tracer::capturedEvents());
+            Assert::AreEqual(0, countEvents(writeTrace(), "B"));
+        }
+
+        TEST_METHOD(WritesNestedZonesAndFrames)
+        {
+            Tracer::beginCapture();
+
+            TRACE_FRAME();
+            {
+                TRACE_SCOPE("Outer");
+                TRACE_SCOPE("Inner");
+            }
+
+            Tracer::endCapture();
+
+            QJsonArray events = writeTrace();
+            Assert::AreEqual(1, countEvents(events, "B", "Outer"));
+            Assert::AreEqual(1, countEvents(events, "B", "Inner"));
+            Assert::AreEqual(2, countEvents(events, "E"));
+            Assert::AreEqual(1, countEvents(events, "i", "Frame"));
+            Assert::AreEqual(1, countEvents(events, "M", "thread_name"));
+        }
+
+        TEST_METHOD(ClosesZonesOnlyWhileCapturing)
+        {
+            Tracer::beginCapture();
+            {
+                TRACE_SCOPE("Open");
+                Tracer::endCapture();
+            }
+
+            // Zones still open are closed by the trace viewer
+            QJsonArray events = writeTrace();
+            Assert::AreEqual(1, countEvents(events, "B", "Open"));
+            Assert::AreEqual(0, countEvents(events, "E"));
+        }
+
+        TEST_METHOD(RecordsThreadsOnOwnTracks)
+        {
+            Tracer::beginCapture();
+            {
+                TRACE_SCOPE("Main");
+
+                std::thread worker([]
+                {
+                    TRACE_SCOPE("Worker");
+                });
+
+                worker.join();
+            }
+
+            Tracer::endCapture();
+
+            QJsonArray events = writeTrace();
+            Assert::AreNotEqual(-1, threadOf(events, "Worker"));
+            Assert::AreNotEqual(threadOf(events, "Main"), threadOf(events, "Worker"));
+            Assert::AreEqual(2, countEvents(events, "M", "thread_name"));
+        }
+
+        TEST_METHOD(TrackZonesKeepTimestamps)
+        {
+            Tracer::Track track = Tracer::addTrack("GPU");
+
+            Tracer::beginCapture();
+            Tracer::addZone(track, "Pass", 2000, 5500);
+            Tracer::endCapture();
+
+            QJsonArray events = writeTrace();
+            Assert::AreEqual(1, countEvents(events, "X", "Pass"));
+
+            for(const QJsonValue& value : events)
+            {
+                QJsonObject event = value.toObject();
+                if(event["ph"].toString() == "X")
+                {
+                    // Microseconds
+                    Assert::AreEqual(2.0, event["ts"].toDouble(), 1e-6);
+                    Assert::AreEqual(3.5, event["dur"].toDouble(), 1e-6);
+                }
+            }
+
+            Tracer::releaseTrack(track);
+        }
+
+        TEST_METHOD(FullBufferKeepsNewestEvents)
+        {
+            const int zones = 20000;
+
+            Tracer::beginCapture();
+            for(int i = 0; i < zones; ++i)
+            {
+                TRACE_SCOPE("Zone");
+            }
+
+            Tracer::endCapture();
+
+            int dropped = Tracer::droppedEvents();
+            Assert::IsTrue(dropped > 0);
+            Assert::AreEqual(zones * 2, Tracer::capturedEvents());
+
+            QJsonArray events = writeTrace();
+            Assert::AreEqual(zones * 2 - dropped, countEvents(events, "B") + countEvents(events, "E"));
+        }
+
+        TEST_METHOD(InternedNamesAreShared)
+        {
+            const char* first = Tracer::intern(QString("Lightning pass"));
+            const char* second = Tracer::intern(QString("Lightning") + " pass");
+
+            Assert::IsTrue(first == second);
+            Assert::AreEqual("Lightning pass", first);
+        }
+    };
+}
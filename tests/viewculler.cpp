@@ -0,0 +1,134 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "viewculler.h"
+#include "renderqueue.h"
+#include "graph/sceneleaf.h"
+#include "graph/scenenode.h"
+#include "mathelp.h"
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    // Unit box which counts the render list updates
+    class TestLeaf : public Graph::SceneLeaf
+    {
+    public:
+        TestLeaf() : updates(0)
+        {
+            updateAABB(AABB(QVector3D(-0.5f, -0.5f, -0.5f), QVector3D(0.5f, 0.5f, 0.5f)));
+        }
+
+        virtual void updateRenderList(RenderQueue&)
+        {
+            ++updates;
+        }
+
+        virtual std::shared_ptr<SceneLeaf> cloneImpl() const
+        {
+            return std::make_shared<TestLeaf>();
+        }
+
+        int updates;
+    };
+
+    QMatrix4x4 viewProj(const QVector3D& direction)
+    {
+        QMatrix4x4 matrix;
+        matrix.perspective(45.0f, 1.0f, 0.1f, 100.0f);
+        matrix.lookAt(QVector3D(0, 0, 0), direction, UNIT_Y);
+        return matrix;
+    }
+
+    QMatrix4x4 translation(const QVector3D& position)
+    {
+        QMatrix4x4 matrix;
+        matrix.translate(position);
+        return matrix;
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(viewculler)
+    {
+    public:
+
+        TEST_METHOD(VisibilityMaskPerView)
+        {
+            Graph::SceneNode node;
+            TestLeaf front, back, distant;
+
+            const QMatrix4x4 transformations[] = {
+                translation(UNIT_Z * 10.0f), translation(UNIT_Z * -10.0f), translation(UNIT_Z * 200.0f) };
+
+            ViewCuller culler;
+            culler.addLeaf(&front, &node, &transformations[0]);
+            culler.addLeaf(&back, &node, &transformations[1]);
+            culler.addLeaf(&distant, &node, &transformations[2]);
+
+            Assert::AreEqual(0, culler.addView(viewProj(UNIT_Z), nullptr, nullptr));
+            Assert::AreEqual(1, culler.addView(viewProj(-UNIT_Z), nullptr, nullptr));
+            culler.cull();
+
+            Assert::AreEqual<ViewCuller::ViewMask>(1, culler.visibility(0));
+            Assert::AreEqual<ViewCuller::ViewMask>(2, culler.visibility(1));
+            Assert::AreEqual<ViewCuller::ViewMask>(0, culler.visibility(2));
+
+            // Views without a queue don't update render lists
+            Assert::AreEqual(0, front.updates + back.updates + distant.updates);
+        }
+
+        TEST_METHOD(LaterViewsAreCulledByNextCull)
+        {
+            Graph::SceneNode node;
+            TestLeaf accepted, rejected;
+
+            const QMatrix4x4 transformation = translation(UNIT_Z * 10.0f);
+
+            ViewCuller culler;
+            culler.addLeaf(&accepted, &node, &transformation);
+            culler.addLeaf(&rejected, &node, &transformation);
+
+            culler.addView(viewProj(UNIT_Z), nullptr, nullptr);
+            culler.cull();
+
+            RenderQueue queue;
+            const Graph::SceneLeaf* rejectedLeaf = &rejected;
+
+            Assert::AreEqual(1, culler.addView(viewProj(UNIT_Z), &queue,
+                [rejectedLeaf] (const Graph::SceneLeaf& leaf, const Graph::SceneNode&)
+                {
+                    return &leaf != rejectedLeaf;
+                }
+            ));
+
+            culler.cull();
+
+            // Earlier views are not tested again
+            Assert::AreEqual<ViewCuller::ViewMask>(3, culler.visibility(0));
+            Assert::AreEqual<ViewCuller::ViewMask>(3, culler.visibility(1));
+            Assert::AreEqual(1, accepted.updates);
+            Assert::AreEqual(0, rejected.updates);
+            Assert::IsTrue(queue.modelView() == &transformation);
+
+            culler.clear();
+            Assert::AreEqual(0, culler.leafCount());
+            Assert::AreEqual(0, culler.viewCount());
+        }
+
+        TEST_METHOD(ViewCapacity)
+        {
+            ViewCuller culler;
+
+            for(int i = 0; i < ViewCuller::MAX_VIEWS; ++i)
+            {
+                Assert::AreEqual(i, culler.addView(QMatrix4x4(), nullptr, nullptr));
+            }
+
+            Assert::AreEqual(-1, culler.addView(QMatrix4x4(), nullptr, nullptr));
+        }
+    };
+}
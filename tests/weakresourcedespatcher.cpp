@@ -0,0 +1,177 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "weakresourcedespatcher.h"
+#include "resource.h"
+#include "resourcedata.h"
+
+#include <memory>
+
+using namespace Engine;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    const qint64 RESOURCE_BYTES = 100;
+
+    class FakeData : public ResourceData
+    {
+    public:
+        virtual bool load(const QString& /*fileName*/)
+        {
+            return true;
+        }
+
+        virtual qint64 byteSize() const
+        {
+            return RESOURCE_BYTES;
+        }
+    };
+
+    class FakeResource : public Resource<FakeResource, FakeData>
+    {
+    public:
+        explicit FakeResource(const QString& name) : Resource<FakeResource, FakeData>(name) {}
+
+    protected:
+        virtual bool initialiseData(const FakeData& /*data*/)
+        {
+            return true;
+        }
+
+        virtual void releaseResource()
+        {
+        }
+    };
+
+    typedef std::shared_ptr<ResourceBase> ResourcePtr;
+    typedef std::weak_ptr<ResourceBase> WeakResourcePtr;
+
+    // Initialises and retains the resource like a finished loader would
+    ResourcePtr loaded(WeakResourceDespatcher& despatcher, const QString& name)
+    {
+        ResourcePtr resource = std::make_shared<FakeResource>(name);
+        despatcher.resourceLoaded(resource, std::make_shared<FakeData>());
+
+        return resource;
+    }
+
+    // Requests the resource again, returns true if it was served from the retained data.
+    bool requestHits(WeakResourceDespatcher& despatcher, const QString& name)
+    {
+        const int hits = despatcher.cacheStats().hits;
+        despatcher.loadResource(std::make_shared<FakeResource>(name));
+
+        return despatcher.cacheStats().hits > hits;
+    }
+}
+
+namespace tests
+{
+    TEST_CLASS(weakresourcedespatcher)
+    {
+    public:
+
+        TEST_METHOD(DataCapEvictsLeastRecentlyUsed)
+        {
+            WeakResourceDespatcher despatcher(1);
+            despatcher.setRetainLimits(RESOURCE_BYTES * 5 / 2, 0);
+
+            loaded(despatcher, "a");
+            loaded(despatcher, "b");
+            Assert::AreEqual(RESOURCE_BYTES * 2, despatcher.cacheStats().cpuBytes);
+
+            // Using a makes b the least recently used one
+            Assert::IsTrue(requestHits(despatcher, "a"));
+
+            loaded(despatcher, "c");
+            Assert::AreEqual(RESOURCE_BYTES * 2, despatcher.cacheStats().cpuBytes);
+
+            Assert::IsTrue(requestHits(despatcher, "a"));
+            Assert::IsTrue(requestHits(despatcher, "c"));
+            Assert::IsFalse(requestHits(despatcher, "b"));
+        }
+
+        TEST_METHOD(GpuCapReleasesOnlyUnusedResources)
+        {
+            WeakResourceDespatcher despatcher(1);
+            despatcher.setRetainLimits(0, RESOURCE_BYTES * 5 / 2);
+
+            ResourcePtr a = loaded(despatcher, "a");
+            ResourcePtr b = loaded(despatcher, "b");
+            ResourcePtr c = loaded(despatcher, "c");
+
+            // Resources in use don't count towards the cap
+            despatcher.trim();
+            Assert::AreEqual(qint64(0), despatcher.cacheStats().gpuBytes);
+
+            WeakResourcePtr weakA = a, weakB = b, weakC = c;
+            a.reset();
+            b.reset();
+            c.reset();
+
+            despatcher.trim();
+            Assert::AreEqual(RESOURCE_BYTES * 2, despatcher.cacheStats().gpuBytes);
+
+            // The evicted resource is deleted only by the render thread
+            Assert::IsFalse(weakA.expired());
+
+            despatcher.releaseEvicted();
+            Assert::IsTrue(weakA.expired());
+            Assert::IsFalse(weakB.expired() || weakC.expired());
+        }
+
+        TEST_METHOD(RetainedResourceIsRevived)
+        {
+            WeakResourceDespatcher despatcher(1);
+            despatcher.setRetainLimits(RESOURCE_BYTES * 10, RESOURCE_BYTES * 10);
+
+            ResourcePtr resource = loaded(despatcher, "a");
+            despatcher.loadResource(resource);
+
+            WeakResourcePtr handle = resource;
+            resource.reset();
+
+            despatcher.trim();
+            Assert::AreEqual(RESOURCE_BYTES, despatcher.cacheStats().gpuBytes);
+
+            const int hits = despatcher.cacheStats().hits;
+
+            ResourcePtr revived = despatcher.findShared("a");
+            Assert::IsTrue(revived != nullptr && revived == handle.lock());
+            Assert::AreEqual(hits + 1, despatcher.cacheStats().hits);
+
+            // Used again, so a smaller cap doesn't evict it
+            despatcher.setRetainLimits(RESOURCE_BYTES * 10, 1);
+            despatcher.releaseEvicted();
+            Assert::AreEqual(qint64(0), despatcher.cacheStats().gpuBytes);
+
+            revived.reset();
+            Assert::IsFalse(handle.expired());
+
+            despatcher.trim();
+            despatcher.releaseEvicted();
+            Assert::IsTrue(handle.expired());
+        }
+
+        TEST_METHOD(ReleaseWaitsForOtherThreads)
+        {
+            WeakResourceDespatcher despatcher(1);
+            despatcher.setRetainLimits(0, RESOURCE_BYTES * 10);
+
+            // Stands for a loader thread which found the resource with findShared
+            ResourcePtr loader = loaded(despatcher, "a");
+            WeakResourcePtr handle = loader;
+
+            despatcher.releaseRetained();
+            Assert::IsFalse(handle.expired());
+
+            // The loader drops its reference, the queue still holds the resource
+            loader.reset();
+            Assert::IsFalse(handle.expired());
+
+            despatcher.releaseEvicted();
+            Assert::IsTrue(handle.expired());
+        }
+    };
+}
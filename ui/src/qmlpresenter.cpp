@@ -6,6 +6,12 @@
 #include "qmlpresenter.h"
 
 #include "weakresourcedespatcher.h"
+#include "programbinarycache.h"
+#include "shaderprogram.h"
+#include "texture2dresource.h"
+#include "textureresidency.h"
+#include "binder.h"
+#include "resourcebase.h"
 #include "scene/basicscenemanager.h"
 #include "rendererfactory.h"
 #include "scenefactory.h"
@@ -18,31 +24,69 @@
 #include "technique/hdrtonemap.h"
 #include "effect/hdr.h"
 #include "rendertimewatcher.h"
+#include "framegraphrenderer.h"
+#include "shadowstage.h"
+#include "gputracer.h"
+#include "tracer.h"
+#include "framearena.h"
 
 #include <QOpenGLFRamebufferObject>
 #include <QDebug>
 #include <QThread>
+#include <QStandardPaths>
+#include <QDir>
+#include <future>
 
 using namespace Engine;
 using namespace Engine::Ui;
 
 namespace {
     unsigned int toggleRenderFlag(unsigned int current, unsigned int bits);
+
+    // Frames between percentile reports
+    const int STATISTICS_WINDOW = 120;
+
+    // Materials listed in the top materials report
+    const int TOP_MATERIALS = 5;
+
+    // Default caps of the retained resources in megabytes
+    const int RETAINED_CPU_MEMORY = 512;
+    const int RETAINED_GPU_MEMORY = 256;
+
+    const qint64 MEGABYTE = 1024 * 1024;
 }
 
 QmlPresenter::QmlPresenter(bool profile, QObject* parent)
-    : ScenePresenter(parent), context_(nullptr), sceneFactory_(nullptr), fov_(75.0f), profiling_(profile)
+    : ScenePresenter(parent), context_(nullptr), sceneFactory_(nullptr), fov_(75.0f), profiling_(profile), linkedPrograms_(0), blockingLoads_(0),
+      pendingLoads_(0), retainedCpuMemory_(RETAINED_CPU_MEMORY), retainedGpuMemory_(RETAINED_GPU_MEMORY), fixedTimestep_(0), dynamicResolution_(false), samples_(1), statisticsFrames_(0), counterFrames_(0)
 {
     input_.reset(new InputState);
+
+    // Times are recorded in nanoseconds
+    frameCpuStat_ = frameStats_.stat("Frame CPU time", "ms", 1e-6);
+    renderStat_ = frameStats_.stat("Render CPU time", "ms", 1e-6);
+    updateStat_ = frameStats_.stat("Update time", "ms", 1e-6);
 }
 
 QmlPresenter::~QmlPresenter()
 {
+    endTrace();
+
     renderer_.reset();
     debugRenderer_.reset();
+    gpuTracer_.reset();
 
     sceneController_.reset();
     sceneManager_.reset();
+
+    // Retained textures can be resident, so they are deleted before the residency
+    if(despatcher_ != nullptr)
+    {
+        despatcher_->releaseRetained();
+    }
+
+    ShaderProgram::setBinaryCache(nullptr);
+    Texture2DResource::setResidency(nullptr);
 }
 
 void QmlPresenter::setContext(Engine::Ui::RendererContext* context)
@@ -60,24 +104,88 @@ Engine::Ui::InputEventListener* QmlPresenter::inputListener() const
     return input_.get();
 }
 
+void QmlPresenter::setFixedTimestep(unsigned int msecs)
+{
+    fixedTimestep_ = msecs;
+}
+
+void QmlPresenter::beginTrace(const QString& fileName)
+{
+    if(gpuTracer_ == nullptr || Tracer::enabled())
+    {
+        return;
+    }
+
+    traceFile_ = fileName;
+    Tracer::beginCapture();
+}
+
+void QmlPresenter::endTrace()
+{
+    if(traceFile_.isEmpty())
+    {
+        return;
+    }
+
+    // Resolve the GPU zones of the frames in flight before the capture ends
+    gpuTracer_->flush();
+    Tracer::endCapture();
+
+    if(Tracer::writeChromeTrace(traceFile_))
+    {
+        qDebug() << "Trace written:" << traceFile_ << Tracer::capturedEvents() << "events,"
+                 << Tracer::droppedEvents() << "dropped";
+    }
+
+    traceFile_.clear();
+}
+
+bool QmlPresenter::dumpStatistics(const QString& fileName) const
+{
+    if(!frameStats_.dump(fileName))
+    {
+        return false;
+    }
+
+    qDebug() << "Statistics written:" << fileName;
+    return true;
+}
+
+void QmlPresenter::resetStatistics()
+{
+    frameStats_.reset();
+    statisticsFrames_ = 0;
+
+    GpuCounters::resetItems();
+    counterFrames_ = 0;
+}
+
 void QmlPresenter::renderScene()
 {
+    TRACE_FRAME();
+    gpuTracer_->beginFrame();
+
     updateView();
 
     if(renderer_ == nullptr)
     {
-        unsigned int samples = context_->format().samples();
-        renderer_.reset(rendererFactory_->create(samples));
-        if(!renderer_->setViewport(QRect(QPoint(0, 0), viewSize_), samples))
+        renderer_.reset(rendererFactory_->create(samples_));
+        if(!resizeRenderer(QRect(QPoint(0, 0), viewSize_)))
         {
             qWarning() << "setViewport failed:" << viewSize_;
             return;
         }
 
-        renderer_->setRenderTarget(context_->renderTarget());
         debugRenderer_->setGBuffer(rendererFactory_->gbuffer());
 
-        emit watchValue("MSAA", samples, "");
+        resolution_.reset();
+
+        emit watchValue("MSAA", samples_, "");
+        emit watchValue("Shader permutations", rendererFactory_->shaderPermutations(), "");
+        emit watchValue("Dual filter bloom", rendererFactory_->dualFilterBloom(), "");
+        emit watchValue("Frame graph", rendererFactory_->frameGraph(), "");
+        emit watchValue("Texture arrays", Texture2DResource::residency() != nullptr, "");
+        emit watchValue("Pipelined frames", sceneManager_->pipelined(), "");
     }
 
     if(sceneController_ == nullptr)
@@ -91,13 +199,67 @@ void QmlPresenter::renderScene()
         sceneController_->setManager(sceneManager_.get());
         sceneController_->setFov(fov_);
         sceneController_->setInput(input_.get());
+        sceneController_->setStatistics(&frameStats_);
+
+        // Resources the old scene released and the new one didn't request are evictable now
+        despatcher_->trim();
     }
 
-    // Render last frame
-    render();
+    QElapsedTimer cpuTimer;
+    cpuTimer.start();
+
+    if(sceneManager_->pipelined())
+    {
+        // Calculate next frame on a worker thread while the last frame is submitted.
+        // The captured frame is published after the worker has finished.
+        std::future<void> nextFrame = std::async(std::launch::async, [this]
+        {
+            if(Tracer::enabled())
+            {
+                Tracer::setThreadName("Update thread");
+            }
 
-    // Calculate next frame
-    update();
+            update();
+        });
+        render();
+
+        nextFrame.wait();
+        sceneManager_->swapFrames();
+    }
+
+    else
+    {
+        // Render last frame
+        render();
+
+        // Calculate next frame
+        update();
+    }
+
+    qint64 frameCpuTime = cpuTimer.nsecsElapsed();
+    frameCpuTime_ << frameCpuTime;
+    frameCpuStat_->add(frameCpuTime);
+
+    if(profiling_)
+    {
+        reportProgramCache();
+        reportTextureBinds();
+        reportBlockingLoads();
+        reportSceneStats();
+        reportShadowCosts();
+        reportResourceLoads();
+        reportResourceCache();
+        reportFrameTimes();
+        reportGpuCounters();
+        reportFrameArena();
+        reportStatistics();
+    }
+
+    // Evicted textures are deleted while the context is current
+    despatcher_->releaseEvicted();
+
+    // Render lists of the frame before the rendered one are no longer referenced
+    FrameArena::endFrame();
 
     // Sync OpenGL state
     context_->endFrame();
@@ -118,33 +280,61 @@ void QmlPresenter::initialize()
         return;
     }
 
+    // Restore linked programs from disk instead of compiling them on every startup
+    programCache_.reset(new Engine::ProgramBinaryCache(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/programs"));
+
+    programCache_->warm();
+    ShaderProgram::setBinaryCache(programCache_.get());
+
+    // Render thread is listed first in traces, followed by the GPU
+    Tracer::setThreadName("Render thread");
+
+    gpuTracer_.reset(new Engine::GpuTracer);
+    GpuTracer::setCurrent(gpuTracer_.get());
+
     despatcher_.reset(new Engine::WeakResourceDespatcher(2));
+    despatcher_->setLoadStatistic(frameStats_.stat("Resource load time", "ms", 1e-6));
+    despatcher_->setRetainLimits(retainedCpuMemory_ * MEGABYTE, retainedGpuMemory_ * MEGABYTE);
     if(sceneFactory_ != nullptr)
     {
         sceneFactory_->setDespatcher(despatcher_.get());
     }
 
+    samples_ = qMax(1, context_->format().samples());
     rendererFactory_.reset(new RendererFactory(*despatcher_));
     sceneManager_.reset(new Engine::BasicSceneManager());
 
     debugRenderer_.reset(new Engine::DebugRenderer(despatcher_.get()));
 
+    // Frame times drive the dynamic resolution, so the watcher is needed even without profiling
+    renderTimeWatcher_.reset(new RenderTimeWatcher());
+    renderTimeWatcher_->setStatistics(&frameStats_);
+    rendererFactory_->setRenderTimeWatcher(renderTimeWatcher_.get());
+
+    connect(renderTimeWatcher_.get(), &RenderTimeWatcher::frameTimeUpdated, this, &QmlPresenter::frameTimeUpdated);
+
     if(profiling_)
     {
-        renderTimeWatcher_.reset(new RenderTimeWatcher());
-        rendererFactory_->setRenderTimeWatcher(renderTimeWatcher_.get());
-
         connect(renderTimeWatcher_.get(), &RenderTimeWatcher::timeUpdated, this, &QmlPresenter::watchValue);
+
+        // Draws are attributed to their materials for the top materials report
+        GpuCounters::setItemTracking(true);
     }
 }
 
 void QmlPresenter::render()
 {
+    TRACE_SCOPE("Render");
+
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+
     if(!(debugRenderer_->flags() & Engine::DebugRenderer::DEBUG_WIREFRAME))
     {
         sceneManager_->setRenderer(renderer_.get());
 
-        if(profiling_)
+        if(renderTimeWatcher_ != nullptr)
         {
             renderTimeWatcher_->setTimestamp();
             sceneManager_->renderFrame();
@@ -164,6 +354,106 @@ void QmlPresenter::render()
         sceneManager_->setRenderer(debugRenderer_.get());
         sceneManager_->renderFrame();
     }
+
+    qint64 renderTime = renderTimer.nsecsElapsed();
+    renderTime_ << renderTime;
+    renderStat_->add(renderTime);
+}
+
+void QmlPresenter::reportProgramCache()
+{
+    ProgramBinaryCache::Stats stats = programCache_->stats();
+
+    int linked = stats.cacheHits + stats.compiled;
+    if(linked == linkedPrograms_)
+    {
+        return;
+    }
+
+    linkedPrograms_ = linked;
+
+    emit watchValue("Programs cached", stats.cacheHits, "");
+    emit watchValue("Programs compiled", stats.compiled, "");
+    emit watchValue("Program link time", stats.linkTime * 1e-6, "ms");
+    emit watchValue("Program cache warm time", stats.warmTime * 1e-6, "ms");
+}
+
+void QmlPresenter::reportTextureBinds()
+{
+    // Texture binds are reported with the other API counters
+    emit watchValue("Texture binds skipped", Binder::skipCount(), "");
+}
+
+void QmlPresenter::reportFrameArena()
+{
+    FrameArena::Stats stats = FrameArena::stats();
+
+    emit watchValue("Frame arena", stats.frameBytes / 1024.0, "KB");
+    emit watchValue("Frame arena blocks", stats.blockAllocations, "");
+}
+
+void QmlPresenter::reportBlockingLoads()
+{
+    int loads = ResourceBase::blockingLoads();
+    if(loads == blockingLoads_)
+    {
+        return;
+    }
+
+    blockingLoads_ = loads;
+    emit watchValue("Blocking loads", loads, "");
+}
+
+void QmlPresenter::setTextureArrays(bool value)
+{
+    if(value && textureResidency_ == nullptr)
+    {
+        textureResidency_ = std::make_shared<TextureResidency>();
+    }
+
+    // The residency outlives the resident textures, so it is never deleted before the presenter
+    Texture2DResource::setResidency(value ? textureResidency_.get() : nullptr);
+
+    // Retained textures were uploaded to the old storage, their data is uploaded again
+    despatcher_->releaseRetained();
+
+    // Materials and shaders sampling the textures have to be recreated
+    unsigned int debugFlags = debugRenderer_->flags();
+
+    renderer_.reset();
+    debugRenderer_.reset(new Engine::DebugRenderer(despatcher_.get()));
+    debugRenderer_->setFlags(debugFlags);
+
+    // Sets the debug renderer's viewport
+    oldSize_ = QSize();
+
+    setScene(scene_);
+}
+
+void QmlPresenter::setDynamicResolution(bool value)
+{
+    dynamicResolution_ = value;
+    resolution_.reset();
+
+    if(renderer_ != nullptr)
+    {
+        renderer_->setRenderScale(resolution_.scale());
+    }
+
+    emit watchValue("Render scale", resolution_.scale() * 100, "%");
+}
+
+void QmlPresenter::frameTimeUpdated(qreal time)
+{
+    if(!dynamicResolution_ || renderer_ == nullptr)
+    {
+        return;
+    }
+
+    float scale = resolution_.update(time);
+    renderer_->setRenderScale(scale);
+
+    emit watchValue("Render scale", scale * 100, "%");
 }
 
 void QmlPresenter::updateView()
@@ -178,25 +468,242 @@ void QmlPresenter::updateView()
 
         if(renderer_ != nullptr)
         {
-            renderer_->setViewport(viewport, context_->format().samples());
-            renderer_->setRenderTarget(context_->renderTarget());
+            resizeRenderer(viewport);
         }
         
-        debugRenderer_->setViewport(viewport, context_->format().samples());
+        debugRenderer_->setViewport(viewport, samples_);
         debugRenderer_->setRenderTarget(context_->renderTarget());
     }
 }
 
+bool QmlPresenter::resizeRenderer(const QRect& viewport)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if(!renderer_->setViewport(viewport, samples_))
+    {
+        return false;
+    }
+
+    renderer_->setRenderTarget(context_->renderTarget());
+
+    if(profiling_)
+    {
+        // Wait for the allocations so the driver cost is included
+        gl->glFinish();
+        emit watchValue("Resize time", timer.nsecsElapsed() * 1e-6, "ms");
+
+        reportFrameGraph();
+    }
+
+    return true;
+}
+
+void QmlPresenter::reportFrameGraph()
+{
+    Engine::FrameGraphRenderer* renderer = rendererFactory_->graphRenderer();
+    if(renderer == nullptr)
+    {
+        return;
+    }
+
+    const Engine::FrameGraph::Stats& stats = renderer->graph().stats();
+    const qreal megabyte = 1024.0 * 1024.0;
+
+    // Unaliased size equals the targets allocated by the render stage chain
+    emit watchValue("Render targets", stats.physicalBytes / megabyte, "MB");
+    emit watchValue("Render targets unaliased", stats.transientBytes / megabyte, "MB");
+    emit watchValue("Culled passes", stats.culledPasses, "");
+    emit watchValue("Resize allocations", renderer->pool().createdBytes() / megabyte, "MB");
+}
+
 void QmlPresenter::update()
 {
-    sceneController_->update(frameTimer_.restart());
+    TRACE_SCOPE("Update");
+
+    QElapsedTimer updateTimer;
+    updateTimer.start();
+
+    unsigned int elapsed = frameTimer_.restart();
+    if(fixedTimestep_ > 0)
+    {
+        elapsed = fixedTimestep_;
+    }
+
+    sceneController_->update(elapsed);
     sceneManager_->prepareNextFrame();
+
+    qint64 updateTime = updateTimer.nsecsElapsed();
+    updateTime_ << updateTime;
+    updateStat_->add(updateTime);
+}
+
+void QmlPresenter::reportSceneStats()
+{
+    const BasicSceneManager::Stats& stats = sceneManager_->stats();
+
+    emit watchValue("Visible leaves", stats.visibleLeaves, "");
+    emit watchValue("Culled leaves", stats.leaves - stats.visibleLeaves, "");
+    emit watchValue("Render items", stats.renderItems, "");
+    emit watchValue("Culled views", stats.views, "");
+}
+
+void QmlPresenter::reportShadowCosts()
+{
+    ShadowStage* shadow = rendererFactory_->shadowStage();
+    if(shadow == nullptr)
+    {
+        return;
+    }
+
+    // Lights are named by their shadow map, point light maps are ranked by priority
+    for(const ShadowStage::LightCost& cost : shadow->lightCosts())
+    {
+        const QString type = cost.type == Graph::Light::LIGHT_POINT ? "Point" : "Spot";
+        const QString name = QString("%1 shadow %2").arg(type).arg(cost.slot);
+
+        emit watchValue(name + " CPU time", cost.cpuTime * 1e-6, "ms");
+        emit watchValue(name + " draws", cost.counters[GpuCounters::DRAW_CALLS], "");
+
+        if(cost.gpuTime >= 0)
+        {
+            emit watchValue(name + " GPU time", cost.gpuTime * 1e-6, "ms");
+        }
+    }
+}
+
+void QmlPresenter::reportResourceLoads()
+{
+    int pending = despatcher_->pendingLoads();
+    if(pending == pendingLoads_)
+    {
+        return;
+    }
+
+    pendingLoads_ = pending;
+    emit watchValue("Pending loads", pending, "");
+
+    if(pending == 0)
+    {
+        emit watchValue("Load time", despatcher_->loadTime(), "ms");
+    }
+}
+
+void QmlPresenter::reportResourceCache()
+{
+    WeakResourceDespatcher::CacheStats stats = despatcher_->cacheStats();
+
+    emit watchValue("Resource cache hits", stats.hits, "");
+    emit watchValue("Resource cache misses", stats.misses, "");
+    emit watchValue("Retained CPU memory", static_cast<qreal>(stats.cpuBytes) / MEGABYTE, "MB");
+    emit watchValue("Retained GPU memory", static_cast<qreal>(stats.gpuBytes) / MEGABYTE, "MB");
+}
+
+void QmlPresenter::reportFrameTimes()
+{
+    emit watchValue("Frame CPU time", frameCpuTime_ * 10e-7, "ms");
+    emit watchValue("Render CPU time", renderTime_ * 10e-7, "ms");
+    emit watchValue("Update time", updateTime_ * 10e-7, "ms");
+}
+
+void QmlPresenter::reportStatistics()
+{
+    if(++statisticsFrames_ < STATISTICS_WINDOW)
+    {
+        return;
+    }
+
+    statisticsFrames_ = 0;
+
+    // Statistics without samples in the window keep their last reported percentiles
+    for(const Statistic* stat : frameStats_.stats())
+    {
+        const Histogram& window = stat->window();
+        if(window.count() == 0)
+        {
+            continue;
+        }
+
+        const double scale = stat->scale();
+
+        emit watchValue(stat->name() + " p50", window.percentile(0.50) * scale, stat->unit());
+        emit watchValue(stat->name() + " p95", window.percentile(0.95) * scale, stat->unit());
+        emit watchValue(stat->name() + " p99", window.percentile(0.99) * scale, stat->unit());
+        emit watchValue(stat->name() + " max", window.max() * scale, stat->unit());
+    }
+
+    frameStats_.resetWindows();
+
+    reportTopMaterials();
+}
+
+void QmlPresenter::reportGpuCounters()
+{
+    GpuCounters::Snapshot counters = GpuCounters::snapshot();
+    GpuCounters::Snapshot frame = counters - lastCounters_;
+    lastCounters_ = counters;
+
+    ++counterFrames_;
+
+    for(int i = 0; i < GpuCounters::COUNTER_COUNT; ++i)
+    {
+        GpuCounters::Counter counter = static_cast<GpuCounters::Counter>(i);
+
+        // Sizes are reported in kilobytes
+        if(counter == GpuCounters::UNIFORM_BYTES || counter == GpuCounters::BUFFER_UPLOAD_BYTES ||
+           counter == GpuCounters::TEXTURE_UPLOAD_BYTES)
+        {
+            emit watchValue(GpuCounters::name(counter), frame[counter] / 1024.0, "KB");
+        }
+
+        else
+        {
+            emit watchValue(GpuCounters::name(counter), frame[counter], "");
+        }
+    }
+
+    const QStringList& stages = renderTimeWatcher_->stages();
+    const QVector<GpuCounters::Snapshot>& stageCounters = renderTimeWatcher_->stageCounters();
+
+    for(int i = 0; i < stageCounters.size(); ++i)
+    {
+        const GpuCounters::Snapshot& stage = stageCounters[i];
+
+        emit watchValue(stages[i] + " draw calls", stage[GpuCounters::DRAW_CALLS], "");
+        emit watchValue(stages[i] + " state changes", stage[GpuCounters::PROGRAM_BINDS]
+            + stage[GpuCounters::TEXTURE_BINDS] + stage[GpuCounters::FRAMEBUFFER_BINDS], "");
+    }
+}
+
+void QmlPresenter::reportTopMaterials()
+{
+    if(counterFrames_ == 0)
+    {
+        return;
+    }
+
+    QList<GpuCounters::Item> items = GpuCounters::topItems(GpuCounters::PRIMITIVES, TOP_MATERIALS);
+
+    // The material name is shown as a part of the unit
+    for(int i = 0; i < items.size(); ++i)
+    {
+        const GpuCounters::Item& item = items[i];
+        QString name = item.name.isEmpty() ? "unnamed" : item.name;
+
+        emit watchValue(QString("Top material %1").arg(i + 1),
+            static_cast<double>(item.counts[GpuCounters::PRIMITIVES]) / counterFrames_, "tris " + name);
+    }
 }
 
 void QmlPresenter::setScene(QString scene)
 {
     sceneController_.reset();
     scene_ = scene;
+
+    // Materials of the old scene are deleted, and their addresses may be reused
+    GpuCounters::resetItems();
+    counterFrames_ = 0;
 }
 
 void QmlPresenter::tonemapAttributeChanged(QString name, QVariant value)
@@ -226,6 +733,19 @@ void QmlPresenter::tonemapAttributeChanged(QString name, QVariant value)
         rendererFactory_->tonemap()->setGamma(value.toFloat());
     }
 
+    else if(name == "histogram exposure")
+    {
+        rendererFactory_->setHistogramExposure(value.toBool());
+    }
+
+    else if(name == "dual filter bloom")
+    {
+        rendererFactory_->setDualFilterBloom(value.toBool());
+
+        renderer_.reset();
+        emit clearWatchList();
+    }
+
     else if(name == "exposure")
     {
         float exposure = value.toFloat();
@@ -265,11 +785,99 @@ void QmlPresenter::generalAttributeChanged(QString name, QVariant value)
         emit clearWatchList();
     }
 
+    else if(name == "shader permutations")
+    {
+        rendererFactory_->setShaderPermutations(value.toBool());
+
+        renderer_.reset();
+        emit clearWatchList();
+    }
+
+    else if(name == "texture arrays")
+    {
+        setTextureArrays(value.toBool());
+        emit clearWatchList();
+    }
+
+    else if(name == "msaa")
+    {
+        samples_ = qMax(1, value.toInt());
+
+        renderer_.reset();
+        emit clearWatchList();
+    }
+
+    else if(name == "dynamic resolution")
+    {
+        setDynamicResolution(value.toBool());
+    }
+
+    else if(name == "frame graph")
+    {
+        rendererFactory_->setFrameGraph(value.toBool());
+
+        renderer_.reset();
+        emit clearWatchList();
+    }
+
+    else if(name == "capture trace")
+    {
+        if(value.toBool())
+        {
+            QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+            QDir().mkpath(path);
+
+            beginTrace(path + "/trace.json");
+        }
+
+        else
+        {
+            endTrace();
+        }
+    }
+
+    else if(name == "record statistics")
+    {
+        // Histograms of the recorded frames are written when recording stops
+        if(value.toBool())
+        {
+            resetStatistics();
+        }
+
+        else
+        {
+            QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+            QDir().mkpath(path);
+
+            dumpStatistics(path + "/statistics.json");
+        }
+    }
+
+    else if(name == "pipelined frames")
+    {
+        sceneManager_->setPipelined(value.toBool());
+        emit watchValue("Pipelined frames", value.toBool(), "");
+    }
+
     else if(name == "scene")
     {
         setScene(value.toString());
     }
 
+    else if(name == "retained cpu memory")
+    {
+        // Megabytes, zero disables retaining the loaded data
+        retainedCpuMemory_ = qMax(0, value.toInt());
+        despatcher_->setRetainLimits(retainedCpuMemory_ * MEGABYTE, retainedGpuMemory_ * MEGABYTE);
+    }
+
+    else if(name == "retained gpu memory")
+    {
+        // Megabytes, zero disables retaining the released resources
+        retainedGpuMemory_ = qMax(0, value.toInt());
+        despatcher_->setRetainLimits(retainedCpuMemory_ * MEGABYTE, retainedGpuMemory_ * MEGABYTE);
+    }
+
     else if(name == "fov")
     {
         fov_ = value.toFloat();
@@ -9,6 +9,10 @@
 #define QMLPRESENTER_H
 
 #include "scenepresenter.h"
+#include "resolutioncontroller.h"
+#include "movingaverage.h"
+#include "framestatistics.h"
+#include "gpucounters.h"
 
 #include <memory>
 
@@ -18,10 +22,13 @@
 
 namespace Engine {
 
-class ResourceDespatcher;
+class WeakResourceDespatcher;
+class ProgramBinaryCache;
+class TextureResidency;
 class BasicSceneManager;
 class Renderer;
 class DebugRenderer;
+class GpuTracer;
 
 namespace Ui {
 
@@ -45,6 +52,21 @@ public:
 
     InputEventListener* inputListener() const;
 
+    // Scene updates advance by a fixed time step instead of the measured frame time,
+    // so that runs can be reproduced. Zero restores the measured time.
+    void setFixedTimestep(unsigned int msecs);
+
+    // Records CPU and GPU zones of the following frames until endTrace is called, which writes them
+    // to the file as Chrome trace JSON. Should be called on the render thread between frames.
+    void beginTrace(const QString& fileName);
+    void endTrace();
+
+    // Writes the histograms of the frame, stage and load times recorded since the last reset as JSON.
+    bool dumpStatistics(const QString& fileName) const;
+
+    // Discards the recorded statistics, eg. after warming up.
+    void resetStatistics();
+
 signals:
     // Signals UiController to remove all watched values.
     void clearWatchList();
@@ -68,30 +90,122 @@ public slots:
     void tonemapAttributeChanged(QString name, QVariant value);
     void generalAttributeChanged(QString name, QVariant value);
 
+    // Adjusts the render scale from the measured GPU frame time when dynamic resolution is on.
+    void frameTimeUpdated(qreal time);
+
 private:
     RendererContext* context_;
     SceneFactory* sceneFactory_;
     bool profiling_;
 
+    // Declared before the despatcher, since loader threads record into the statistics
+    FrameStatistics frameStats_;
+    Statistic* frameCpuStat_;
+    Statistic* renderStat_;
+    Statistic* updateStat_;
+    int statisticsFrames_;
+
+    // API counters at the end of the last frame, and frames since the item counters were reset
+    GpuCounters::Snapshot lastCounters_;
+    int counterFrames_;
+
     std::shared_ptr<RendererFactory> rendererFactory_;
-    std::shared_ptr<ResourceDespatcher> despatcher_;
+    std::shared_ptr<WeakResourceDespatcher> despatcher_;
     std::shared_ptr<Renderer> renderer_;
     std::shared_ptr<DebugRenderer> debugRenderer_;
     std::shared_ptr<BasicSceneManager> sceneManager_;
     std::shared_ptr<SceneController> sceneController_;
     std::shared_ptr<InputState> input_;
     std::shared_ptr<RenderTimeWatcher> renderTimeWatcher_;
+    std::shared_ptr<ProgramBinaryCache> programCache_;
+    std::shared_ptr<GpuTracer> gpuTracer_;
+    QString traceFile_;
+    int linkedPrograms_;
+
+    std::shared_ptr<TextureResidency> textureResidency_;
+    int blockingLoads_;
+    int pendingLoads_;
+
+    // Memory caps of the resources retained across scene switches in megabytes
+    int retainedCpuMemory_;
+    int retainedGpuMemory_;
 
     QSize viewSize_;
     QSize oldSize_;
     QString scene_;
     float fov_;
 
+    // Gbuffer samples; the renderer targets are offscreen so this is independent of the context
+    int samples_;
+
     QElapsedTimer frameTimer_;
+    unsigned int fixedTimestep_;
+
+    // Render thread time of a frame, the time spent on submitting the frame and
+    // the time spent on scene update and culling
+    typedef MovingAverage<qint64, double, 30> TimeAverage;
+    TimeAverage frameCpuTime_;
+    TimeAverage renderTime_;
+    TimeAverage updateTime_;
+
+    ResolutionController resolution_;
+    bool dynamicResolution_;
 
     void updateView();
     void update();
     void render();
+
+    // Reports shader program link times so cold and warm startups can be compared.
+    void reportProgramCache();
+
+    // Reports texture binds skipped by the Binder in the last frame.
+    void reportTextureBinds();
+
+    // Sets the renderer viewport and render target. Reports the reallocation time
+    // and render target memory when profiling.
+    bool resizeRenderer(const QRect& viewport);
+
+    // Reports frame graph culling and render target memory with and without aliasing.
+    void reportFrameGraph();
+
+    // Reports transient memory allocated from the frame arena and the arena's heap allocations.
+    // The block count should stop growing after the first frames.
+    void reportFrameArena();
+
+    // Reports resources loaded synchronously on the render thread. Should stay at zero.
+    void reportBlockingLoads();
+
+    // Reports culled and queued scene leaves of the rendered frame.
+    void reportSceneStats();
+
+    // Reports the CPU and GPU time and draws of each shadow casting light's pass.
+    void reportShadowCosts();
+
+    // Reports asynchronous loads in flight, and the load time once they have finished.
+    void reportResourceLoads();
+
+    // Reports the requests served by the retained resources and the memory they hold.
+    void reportResourceCache();
+
+    // Reports the frame's CPU time on the render thread and the scene update time.
+    // With pipelined frames the update overlaps rendering, so the frame time approaches the
+    // longer of the two instead of their sum.
+    void reportFrameTimes();
+
+    // Reports the percentiles of the recorded statistics every STATISTICS_WINDOW frames.
+    void reportStatistics();
+
+    // Reports the API counts of the last frame and of each render stage.
+    void reportGpuCounters();
+
+    // Reports the materials drawing the most primitives per frame since the last reset.
+    void reportTopMaterials();
+
+    // Material textures are loaded into texture arrays when enabled. Reloads the scene.
+    void setTextureArrays(bool value);
+
+    // Restores the full render scale when disabled.
+    void setDynamicResolution(bool value);
 };
 
 }}
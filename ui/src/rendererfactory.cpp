@@ -14,6 +14,7 @@
 #include "technique/skybox.h"
 #include "skyboxstage.h"
 #include "effect/lumaexposure.h"
+#include "effect/histogramexposure.h"
 #include "technique/hdrtonemap.h"
 #include "technique/blurfilter.h"
 #include "resourcedespatcher.h"
@@ -22,6 +23,10 @@
 #include "forwardrenderer.h"
 #include "shadowstage.h"
 #include "spotlightmethod.h"
+#include "pointlightmethod.h"
+#include "framegraphrenderer.h"
+#include "transientgbuffer.h"
+#include "nullrenderer.h"
 
 #include "rendertimewatcher.h"
 
@@ -31,7 +36,9 @@ using namespace Engine;
 using namespace Engine::Ui;
 
 RendererFactory::RendererFactory(ResourceDespatcher& despatcher, RendererType type)
-    : despatcher_(despatcher), type_(type), watcher_(nullptr)
+    : despatcher_(despatcher), type_(type), shaderPermutations_(false), dualFilterBloom_(false),
+    autoExposure_(false), histogramExposure_(false), frameGraph_(false), watcher_(nullptr),
+    graphRenderer_(nullptr), shadowStage_(nullptr)
 {
     // HDR tonemapping
     hdrPostfx_.reset(new Effect::Hdr(&despatcher_, 4));
@@ -63,16 +70,18 @@ Renderer* RendererFactory::create(int samples)
     }
 
     gbuffer_.reset();
+    graphRenderer_ = nullptr;
+    shadowStage_ = nullptr;
     Renderer* renderer = nullptr;
 
     if(type_ == DEFERRED)
     {
-        renderer = createDeferredRenderer(samples);
+        renderer = frameGraph_ ? createDeferredGraph(samples) : createDeferredRenderer(samples);
     }
 
     else if(type_ == FORWARD)
     {
-        renderer = createForwardRenderer(samples);
+        renderer = frameGraph_ ? createForwardGraph(samples) : createForwardRenderer(samples);
     }
 
     if(watcher_ != nullptr && !watcher_->create())
@@ -85,8 +94,10 @@ Renderer* RendererFactory::create(int samples)
 
 void RendererFactory::createTonemapper(int samples)
 {
-    // Tonemap shader
-    tonemap_.reset(new Technique::HDRTonemap(samples, 4));
+    hdrPostfx_->setBloomMethod(dualFilterBloom_ ? Effect::Hdr::BLOOM_DUAL_FILTER : Effect::Hdr::BLOOM_GAUSSIAN);
+
+    // Tonemap shader; dual filter bloom is blended to a single level
+    tonemap_.reset(new Technique::HDRTonemap(samples, dualFilterBloom_ ? 0 : 4));
     tonemap_->addShader(despatcher_.get<Shader>(RESOURCE_PATH("shaders/passthrough.vert"), Shader::Type::Vertex));
 
     Shader::Ptr toneFrag = std::make_shared<Shader>(RESOURCE_PATH("shaders/postprocess.frag"), Shader::Type::Fragment);
@@ -100,11 +111,8 @@ void RendererFactory::createTonemapper(int samples)
     tonemap_->setGamma(2.2f);
 }
 
-Renderer* RendererFactory::createForwardRenderer(int samples)
+SkyboxStage::SkyboxPtr RendererFactory::createSkyboxTechnique(int samples)
 {
-    createTonemapper(samples);
-
-    // Skybox technique
     SkyboxStage::SkyboxPtr sky(new Technique::Skybox(samples));
     sky->addShader(despatcher_.get<Shader>(RESOURCE_PATH("shaders/skybox.vert"), Shader::Type::Vertex));
 
@@ -113,6 +121,15 @@ Renderer* RendererFactory::createForwardRenderer(int samples)
     despatcher_.loadResource(skyFrag);
 
     sky->setBrightness(2.0f);
+    return sky;
+}
+
+Renderer* RendererFactory::createForwardRenderer(int samples)
+{
+    createTonemapper(samples);
+
+    // Skybox technique
+    SkyboxStage::SkyboxPtr sky = createSkyboxTechnique(samples);
 
     // Create multisamples fbo since we renderer directly to "screen"
     QOpenGLFramebufferObjectFormat fboFormat;
@@ -136,7 +153,7 @@ Renderer* RendererFactory::createForwardRenderer(int samples)
     {
         watcher_->addRenderStage("Forward pass", skybox);
         watcher_->addRenderStage("Skybox pass", fxRenderer);
-        watcher_->addNamedStage("Postprocess");
+        watchPostprocess();
     }
 
     return fxRenderer;
@@ -147,43 +164,50 @@ Renderer* RendererFactory::createDeferredRenderer(int samples)
     createTonemapper(samples);
 
     // Skybox technique
-    SkyboxStage::SkyboxPtr sky(new Technique::Skybox(samples));
-    sky->addShader(despatcher_.get<Shader>(RESOURCE_PATH("shaders/skybox.vert"), Shader::Type::Vertex));
-
-    Shader::Ptr skyFrag = std::make_shared<Shader>(RESOURCE_PATH("shaders/skybox.frag"), Shader::Type::Fragment);
-    sky->addShader(skyFrag);
-    despatcher_.loadResource(skyFrag);
-
-    sky->setBrightness(2.0f);
+    SkyboxStage::SkyboxPtr sky = createSkyboxTechnique(samples);
 
     QOpenGLFramebufferObjectFormat fboFormat;
     fboFormat.setInternalTextureFormat(GL_RGBA16F);
-    fboFormat.setAttachment(QOpenGLFramebufferObject::NoAttachment);
     fboFormat.setSamples(1);
 
+    // Lighting classifies multisampled pixels into the stencil
+    fboFormat.setAttachment(samples > 1 ? QOpenGLFramebufferObject::CombinedDepthStencil
+                                        : QOpenGLFramebufferObject::NoAttachment);
+
     // Create gbuffer
     gbuffer_.reset(new CompactGBuffer);
 
     DeferredRenderer* renderer = new DeferredRenderer(gbuffer_, despatcher_, samples);
-    QuadLighting* lightningStage = new QuadLighting(renderer, *gbuffer_, despatcher_, samples);
 
-    ShadowStage* shadow = new ShadowStage(lightningStage);
-    lightningStage->setShadowStage(shadow);
+    // Shadow maps are rendered between the geometry and lightning passes
+    ShadowStage* shadow = new ShadowStage(renderer);
 
     // Enable spot light shadows
     ShadowStage::ShadowMethodPtr spotMethod(new SpotLightMethod(despatcher_));
     shadow->setMethod(Graph::Light::LIGHT_SPOT, spotMethod);
     shadow->createShadowMap(Graph::Light::LIGHT_SPOT, QSize(1024, 1024), 5);
 
+    // Point light shadows are given to the highest priority lights
+    ShadowStage::ShadowMethodPtr pointMethod(new PointLightMethod(despatcher_));
+    shadow->setMethod(Graph::Light::LIGHT_POINT, pointMethod);
+    shadow->createShadowMap(Graph::Light::LIGHT_POINT, QSize(512, 512), 4);
+    shadowStage_ = shadow;
+
+    QuadLighting* lightningStage = new QuadLighting(shadow, *gbuffer_, despatcher_, samples);
+    lightningStage->setShaderPermutations(shaderPermutations_);
+    lightningStage->setShadowStage(shadow);
+
     // Add skybox stage
-    SkyboxStage* skybox = new Engine::SkyboxStage(shadow);
+    SkyboxStage* skybox = new Engine::SkyboxStage(lightningStage);
     skybox->setGBuffer(gbuffer_.get());
     skybox->setSkyboxMesh(Renderable::Primitive<Renderable::Cube>::instance());
     skybox->setSkyboxTechnique(sky);
+    skybox->setSampleClassifier(lightningStage->sampleClassifier());
 
     // Add forward stage
-    ForwardStage* forward = new Engine::ForwardStage(skybox, despatcher_);
+    ForwardStage* forward = new Engine::ForwardStage(skybox, despatcher_, samples);
     forward->setGBuffer(gbuffer_.get());
+    forward->setSampleClassifier(lightningStage->sampleClassifier());
 
     // Add post-process stage
     PostProcess* fxRenderer = new Engine::PostProcess(forward, fboFormat);
@@ -191,17 +215,275 @@ Renderer* RendererFactory::createDeferredRenderer(int samples)
 
     if(watcher_ != nullptr)
     {
-        watcher_->addRenderStage("Geometry pass", lightningStage);
-        watcher_->addRenderStage("Lightning pass", shadow);
-        watcher_->addRenderStage("Shadow pass", skybox);
+        // Stages are listed in the order they signal. Each signal ends the pass of the stage it decorates.
+        watcher_->addRenderStage("Geometry pass", shadow);
+        watcher_->addRenderStage("Shadow pass", lightningStage);
+        watcher_->addRenderStage("Lightning pass", skybox);
         watcher_->addRenderStage("Skybox pass", forward);
         watcher_->addRenderStage("Forward pass", fxRenderer);
-        watcher_->addNamedStage("Postprocess");
+        watchPostprocess();
     }
 
     return fxRenderer;
 }
 
+Renderer* RendererFactory::createForwardGraph(int samples)
+{
+    createTonemapper(samples);
+
+    // Skybox technique
+    SkyboxStage::SkyboxPtr sky = createSkyboxTechnique(samples);
+
+    ForwardRenderer* forward = new ForwardRenderer(despatcher_);
+
+    SkyboxStage* skybox = new Engine::SkyboxStage(new NullRenderer);
+    skybox->setGBuffer(nullptr);
+    skybox->setSkyboxMesh(Renderable::Primitive<Renderable::Cube>::instance());
+    skybox->setSkyboxTechnique(sky);
+
+    FrameGraphRenderer* renderer = new FrameGraphRenderer;
+    renderer->addRenderer(forward);
+    renderer->addRenderer(skybox);
+
+    std::shared_ptr<Effect::Hdr> hdr = hdrPostfx_;
+
+    renderer->setSetupFunction([=](FrameGraph& graph, const QSize& size, unsigned int samples)
+    {
+        // Forward pass renders directly to the multisampled scene target
+        FrameGraph::Pass forwardPass = graph.addPass("Forward pass");
+        FrameGraph::Resource scene = graph.createTexture(forwardPass, "Scene",
+            FrameGraph::TextureDesc(GL_RGBA16F, size.width(), size.height(), samples));
+        FrameGraph::Resource depth = graph.createTexture(forwardPass, "Depth",
+            FrameGraph::TextureDesc(GL_DEPTH_COMPONENT32F, size.width(), size.height(), samples));
+
+        graph.setExecute(forwardPass, [=](const FrameGraph::Context& context)
+        {
+            forward->setRenderTarget(context.framebuffer());
+            forward->render();
+        });
+
+        // Skybox is depth tested against the forward pass
+        FrameGraph::Pass skyboxPass = graph.addPass("Skybox pass");
+        graph.write(skyboxPass, scene);
+        graph.write(skyboxPass, depth);
+
+        graph.setExecute(skyboxPass, [=](const FrameGraph::Context& context)
+        {
+            skybox->setRenderTarget(context.framebuffer());
+            skybox->render();
+        });
+
+        FrameGraph::Pass postprocessPass = graph.addPass("Postprocess");
+        graph.read(postprocessPass, scene);
+        graph.setSideEffect(postprocessPass);
+
+        graph.setPrepare(postprocessPass, [=](const FrameGraph::Context& context)
+        {
+            hdr->setInputTexture(context.texture(scene));
+            hdr->initialize(size.width(), size.height(), samples);
+        });
+
+        graph.setExecute(postprocessPass, [=](const FrameGraph::Context&)
+        {
+            hdr->setOutputFbo(renderer->renderTarget());
+            hdr->setRenderScale(renderer->renderScale());
+            hdr->render();
+        });
+    });
+
+    watchFrameGraph(renderer, QStringList() << "Forward pass" << "Skybox pass");
+
+    graphRenderer_ = renderer;
+    return renderer;
+}
+
+Renderer* RendererFactory::createDeferredGraph(int samples)
+{
+    createTonemapper(samples);
+
+    // Skybox technique
+    SkyboxStage::SkyboxPtr sky = createSkyboxTechnique(samples);
+
+    // GBuffer textures are transient graph resources
+    std::shared_ptr<TransientGBuffer> gbuffer = std::make_shared<TransientGBuffer>();
+    gbuffer_ = gbuffer;
+
+    // Stages are executed one at a time by the graph passes
+    DeferredRenderer* geometry = new DeferredRenderer(gbuffer_, despatcher_, samples);
+    QuadLighting* lightning = new QuadLighting(new NullRenderer, *gbuffer_, despatcher_, samples);
+    lightning->setShaderPermutations(shaderPermutations_);
+
+    ShadowStage* shadow = new ShadowStage(new NullRenderer);
+    lightning->setShadowStage(shadow);
+
+    // Enable spot light shadows
+    ShadowStage::ShadowMethodPtr spotMethod(new SpotLightMethod(despatcher_));
+    shadow->setMethod(Graph::Light::LIGHT_SPOT, spotMethod);
+    shadow->createShadowMap(Graph::Light::LIGHT_SPOT, QSize(1024, 1024), 5);
+
+    // Point light shadows are given to the highest priority lights
+    ShadowStage::ShadowMethodPtr pointMethod(new PointLightMethod(despatcher_));
+    shadow->setMethod(Graph::Light::LIGHT_POINT, pointMethod);
+    shadow->createShadowMap(Graph::Light::LIGHT_POINT, QSize(512, 512), 4);
+    shadowStage_ = shadow;
+
+    SkyboxStage* skybox = new Engine::SkyboxStage(new NullRenderer);
+    skybox->setGBuffer(gbuffer_.get());
+    skybox->setSkyboxMesh(Renderable::Primitive<Renderable::Cube>::instance());
+    skybox->setSkyboxTechnique(sky);
+    skybox->setSampleClassifier(lightning->sampleClassifier());
+
+    ForwardStage* forward = new Engine::ForwardStage(new NullRenderer, despatcher_, samples);
+    forward->setGBuffer(gbuffer_.get());
+    forward->setSampleClassifier(lightning->sampleClassifier());
+
+    FrameGraphRenderer* renderer = new FrameGraphRenderer;
+    renderer->addRenderer(shadow);
+    renderer->addRenderer(geometry);
+    renderer->addRenderer(lightning);
+    renderer->addRenderer(skybox);
+    renderer->addRenderer(forward);
+
+    std::shared_ptr<Effect::Hdr> hdr = hdrPostfx_;
+
+    renderer->setSetupFunction([=](FrameGraph& graph, const QSize& size, unsigned int samples)
+    {
+        // Shadow maps are owned by the shadow stage
+        FrameGraph::Resource shadowMaps = graph.importTexture("Shadow maps", 0);
+
+        FrameGraph::Pass shadowPass = graph.addPass("Shadow pass");
+        graph.write(shadowPass, shadowMaps, FrameGraph::ATTACH_NONE);
+
+        graph.setExecute(shadowPass, [=](const FrameGraph::Context&)
+        {
+            shadow->render();
+        });
+
+        // Geometry pass fills the gbuffer
+        FrameGraph::Pass geometryPass = graph.addPass("Geometry pass");
+        FrameGraph::Resource normals = graph.createTexture(geometryPass, "Normals",
+            FrameGraph::TextureDesc(GL_RGB10_A2, size.width(), size.height(), samples));
+        FrameGraph::Resource diffuse = graph.createTexture(geometryPass, "Diffuse",
+            FrameGraph::TextureDesc(GL_RGBA8, size.width(), size.height(), samples));
+        FrameGraph::Resource depth = graph.createTexture(geometryPass, "Depth",
+            FrameGraph::TextureDesc(GL_DEPTH_COMPONENT32F, size.width(), size.height(), samples));
+
+        graph.setExecute(geometryPass, [=](const FrameGraph::Context& context)
+        {
+            gbuffer->setTargets(context.framebuffer(), context.texture(normals),
+                context.texture(diffuse), context.texture(depth));
+
+            geometry->render();
+        });
+
+        // Lights are accumulated to a single sampled HDR target. Edge pixels are
+        // classified into the stencil when multisampling is used.
+        FrameGraph::Pass lightningPass = graph.addPass("Lightning pass");
+        graph.read(lightningPass, normals);
+        graph.read(lightningPass, diffuse);
+        graph.read(lightningPass, depth);
+        graph.read(lightningPass, shadowMaps);
+
+        FrameGraph::Resource scene = graph.createTexture(lightningPass, "Scene",
+            FrameGraph::TextureDesc(GL_RGBA16F, size.width(), size.height(), 1));
+
+        FrameGraph::Resource sampleClasses = -1;
+        if(samples > 1)
+        {
+            sampleClasses = graph.createTexture(lightningPass, "Sample classes",
+                FrameGraph::TextureDesc(GL_DEPTH24_STENCIL8, size.width(), size.height(), 1),
+                FrameGraph::ATTACH_STENCIL);
+        }
+
+        graph.setExecute(lightningPass, [=](const FrameGraph::Context& context)
+        {
+            lightning->setRenderTarget(context.framebuffer());
+            lightning->render();
+        });
+
+        // Skybox and forward passes test depth against the gbuffer
+        FrameGraph::Pass skyboxPass = graph.addPass("Skybox pass");
+        FrameGraph::Pass forwardPass = graph.addPass("Forward pass");
+
+        for(FrameGraph::Pass pass : { skyboxPass, forwardPass })
+        {
+            graph.read(pass, normals);
+            graph.read(pass, diffuse);
+            graph.read(pass, depth);
+            graph.write(pass, scene);
+
+            if(sampleClasses != -1)
+            {
+                graph.read(pass, sampleClasses);
+                graph.write(pass, sampleClasses, FrameGraph::ATTACH_STENCIL);
+            }
+        }
+
+        graph.setExecute(skyboxPass, [=](const FrameGraph::Context& context)
+        {
+            skybox->setRenderTarget(context.framebuffer());
+            skybox->render();
+        });
+
+        graph.setExecute(forwardPass, [=](const FrameGraph::Context& context)
+        {
+            forward->setRenderTarget(context.framebuffer());
+            forward->render();
+        });
+
+        FrameGraph::Pass postprocessPass = graph.addPass("Postprocess");
+        graph.read(postprocessPass, scene);
+        graph.setSideEffect(postprocessPass);
+
+        graph.setPrepare(postprocessPass, [=](const FrameGraph::Context& context)
+        {
+            hdr->setInputTexture(context.texture(scene));
+            hdr->initialize(size.width(), size.height(), 1);
+        });
+
+        graph.setExecute(postprocessPass, [=](const FrameGraph::Context&)
+        {
+            hdr->setOutputFbo(renderer->renderTarget());
+            hdr->setRenderScale(renderer->renderScale());
+            hdr->render();
+        });
+    });
+
+    watchFrameGraph(renderer, QStringList() << "Shadow pass" << "Geometry pass"
+        << "Lightning pass" << "Skybox pass" << "Forward pass");
+
+    graphRenderer_ = renderer;
+    return renderer;
+}
+
+void RendererFactory::watchFrameGraph(FrameGraphRenderer* renderer, const QStringList& passes)
+{
+    if(watcher_ == nullptr)
+    {
+        return;
+    }
+
+    // Every pass but the postprocess is timed, effect passes are timed separately
+    for(const QString& pass : passes)
+    {
+        watcher_->addNamedStage(pass);
+    }
+
+    watchPostprocess();
+    renderer->addObserver(watcher_);
+}
+
+void RendererFactory::watchPostprocess()
+{
+    // Time each effect pass separately
+    for(const QString& pass : hdrPostfx_->passNames())
+    {
+        watcher_->addNamedStage(pass);
+    }
+
+    hdrPostfx_->addObserver(watcher_);
+}
+
 Engine::Effect::Hdr* RendererFactory::hdr() const
 {
     return hdrPostfx_.get();
@@ -214,7 +496,14 @@ Engine::Technique::HDRTonemap* RendererFactory::tonemap() const
 
 void RendererFactory::setAutoExposure(bool value)
 {
-    if(value)
+    autoExposure_ = value;
+
+    if(value && histogramExposure_)
+    {
+        hdrPostfx_->setExposureFunction(std::make_shared<Effect::HistogramExposure>(&despatcher_));
+    }
+
+    else if(value)
     {
         hdrPostfx_->setExposureFunction(std::make_shared<Effect::LumaExposure>());
     }
@@ -225,7 +514,57 @@ void RendererFactory::setAutoExposure(bool value)
     }
 }
 
+void RendererFactory::setHistogramExposure(bool value)
+{
+    histogramExposure_ = value;
+
+    if(autoExposure_)
+    {
+        setAutoExposure(true);
+    }
+}
+
 void RendererFactory::setRendererType(RendererType type)
 {
     type_ = type;
+}
+
+void RendererFactory::setShaderPermutations(bool value)
+{
+    shaderPermutations_ = value;
+}
+
+bool RendererFactory::shaderPermutations() const
+{
+    return shaderPermutations_;
+}
+
+void RendererFactory::setDualFilterBloom(bool value)
+{
+    dualFilterBloom_ = value;
+}
+
+bool RendererFactory::dualFilterBloom() const
+{
+    return dualFilterBloom_;
+}
+
+void RendererFactory::setFrameGraph(bool value)
+{
+    frameGraph_ = value;
+}
+
+bool RendererFactory::frameGraph() const
+{
+    return frameGraph_;
+}
+
+Engine::FrameGraphRenderer* RendererFactory::graphRenderer() const
+{
+    return graphRenderer_;
+}
+
+Engine::ShadowStage* RendererFactory::shadowStage() const
+{
+    return shadowStage_;
 }
\ No newline at end of file
@@ -8,14 +8,19 @@
 
 #include <memory>
 
+#include <QStringList>
+
 namespace Engine {
 
 class ResourceDespatcher;
 class Renderer;
 class GBuffer;
+class FrameGraphRenderer;
+class ShadowStage;
     
 namespace Technique {
     class HDRTonemap;
+    class Skybox;
 }
 
 namespace Effect {
@@ -43,22 +48,62 @@ public:
 
     void setAutoExposure(bool value);
 
+    // Automatic exposure is adapted from a luminance histogram on the GPU instead of
+    // reading back the average luminance.
+    void setHistogramExposure(bool value);
+
+    // Deferred lightning uses specialised program permutations instead of subroutines.
+    // Takes effect when the renderer is created.
+    void setShaderPermutations(bool value);
+    bool shaderPermutations() const;
+
+    // Bloom is calculated using a dual filter down/up chain instead of gaussian mipmap blur.
+    // Takes effect when the renderer is created.
+    void setDualFilterBloom(bool value);
+    bool dualFilterBloom() const;
+
+    // Passes are declared in a frame graph which allocates the render targets from a
+    // shared pool instead of a chain of render stages. Takes effect when the renderer is created.
+    void setFrameGraph(bool value);
+    bool frameGraph() const;
+
+    // Frame graph of the last created renderer, or nullptr if the frame graph is not used.
+    // The renderer owns the frame graph.
+    FrameGraphRenderer* graphRenderer() const;
+
+    // Shadow stage of the last created renderer, or nullptr if the renderer has no shadows.
+    // The renderer owns the stage.
+    ShadowStage* shadowStage() const;
+
     void setRenderTimeWatcher(RenderTimeWatcher* watcher);
 
 private:
     Engine::ResourceDespatcher& despatcher_;
     RendererType type_;
+    bool shaderPermutations_;
+    bool dualFilterBloom_;
+    bool autoExposure_;
+    bool histogramExposure_;
+    bool frameGraph_;
 
     RenderTimeWatcher* watcher_;
+    FrameGraphRenderer* graphRenderer_;
+    ShadowStage* shadowStage_;
 
     std::shared_ptr<GBuffer> gbuffer_;
     std::shared_ptr<Technique::HDRTonemap> tonemap_;
     std::shared_ptr<Effect::Hdr> hdrPostfx_;
 
     void createTonemapper(int samples);
+    std::shared_ptr<Technique::Skybox> createSkyboxTechnique(int samples);
+    void watchPostprocess();
+    void watchFrameGraph(FrameGraphRenderer* renderer, const QStringList& passes);
 
     Engine::Renderer* createForwardRenderer(int samples);
     Engine::Renderer* createDeferredRenderer(int samples);
+
+    Engine::Renderer* createForwardGraph(int samples);
+    Engine::Renderer* createDeferredGraph(int samples);
 };
 
 }}
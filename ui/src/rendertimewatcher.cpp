@@ -6,13 +6,14 @@
 #include "rendertimewatcher.h"
 
 #include "renderstage.h"
+#include "framestatistics.h"
 
 #include <QOpenGLTimeMonitor>
 
 using namespace Engine::Ui;
 
 RenderTimeWatcher::RenderTimeWatcher()
-    : QObject(), frameCaptured_(true)
+    : QObject(), statistics_(nullptr), frameStat_(nullptr), frameCaptured_(true), boundary_(0)
 {
 }
 
@@ -45,6 +46,17 @@ void RenderTimeWatcher::clearStages()
 {
     stages_.clear();
     averages_.clear();
+    stageStats_.clear();
+    frameStat_ = nullptr;
+
+    boundaries_.clear();
+    stageCounters_.clear();
+    boundary_ = 0;
+}
+
+void RenderTimeWatcher::setStatistics(FrameStatistics* statistics)
+{
+    statistics_ = statistics;
 }
 
 bool RenderTimeWatcher::create()
@@ -56,12 +68,38 @@ bool RenderTimeWatcher::create()
 
     monitor_.setSampleCount(stages_.count() + 1);
     averages_.resize(stages_.count());
+    stageStats_.clear();
+
+    boundaries_.resize(stages_.count() + 1);
+    stageCounters_.fill(GpuCounters::Snapshot(), stages_.count());
+    boundary_ = 0;
+
+    if(statistics_ != nullptr)
+    {
+        for(const QString& stage : stages_)
+        {
+            stageStats_.push_back(statistics_->stat(stage, "ms", 1e-6));
+        }
+
+        frameStat_ = statistics_->stat("GPU frame time", "ms", 1e-6);
+    }
 
     return monitor_.create();
 }
 
 void RenderTimeWatcher::endFrame()
 {
+    // Counters are read on the CPU, so they are available for every frame
+    if(boundary_ == boundaries_.size())
+    {
+        for(int i = 0; i < stageCounters_.size(); ++i)
+        {
+            stageCounters_[i] = boundaries_[i + 1] - boundaries_[i];
+        }
+    }
+
+    boundary_ = 0;
+
     if(frameCaptured_)
     {
         frameCaptured_ = false;
@@ -70,26 +108,66 @@ void RenderTimeWatcher::endFrame()
     if(monitor_.isResultAvailable())
     {
         QVector<GLuint64> intervals = monitor_.waitForIntervals();
+        GLuint64 frameTime = 0;
+
         for(int i = 0; i < intervals.size(); ++i)
         {
             averages_[i] << intervals[i];
+            frameTime += intervals[i];
+
+            if(!stageStats_.isEmpty())
+            {
+                stageStats_[i]->add(intervals[i]);
+            }
 
             double average = averages_[i] * 10e-7;
             emit timeUpdated(stages_[i], average, "ms");
         }
 
+        if(frameStat_ != nullptr)
+        {
+            frameStat_->add(frameTime);
+        }
+
+        emit frameTimeUpdated(frameTime * 10e-7);
+
         monitor_.reset();
         frameCaptured_ = true;
     }
 }
 
+const QStringList& RenderTimeWatcher::stages() const
+{
+    return stages_;
+}
+
+const QVector<GpuCounters::Snapshot>& RenderTimeWatcher::stageCounters() const
+{
+    return stageCounters_;
+}
+
 void RenderTimeWatcher::setTimestamp()
 {
     renderStageFinished();
 }
 
+void RenderTimeWatcher::postfxPassFinished()
+{
+    renderStageFinished();
+}
+
+void RenderTimeWatcher::framePassFinished()
+{
+    renderStageFinished();
+}
+
 void RenderTimeWatcher::renderStageFinished()
 {
+    if(boundary_ < boundaries_.size())
+    {
+        boundaries_[boundary_++] = GpuCounters::snapshot();
+    }
+
     if(frameCaptured_)
     {
         monitor_.recordSample();
@@ -1,6 +1,8 @@
 //
 //  Author   : Matti Määttä
-//  Summary  : Profiles RenderStage rendering times.
+//  Summary  : Profiles RenderStage rendering times. Stage times are averaged for display and
+//             recorded into frame statistics for percentiles when statistics have been set.
+//             GPU API counters are snapshotted at the same stage boundaries every frame.
 //
 
 #ifndef RENDERTIMEWATCHER_H
@@ -12,16 +14,22 @@
 #include <QVector>
 
 #include "movingaverage.h"
+#include "gpucounters.h"
+#include "effect/postfxobserver.h"
+#include "framegraphobserver.h"
 
 #include <QOpenGLTimeMonitor>
 
+class FrameStatistics;
+class Statistic;
+
 namespace Engine {
 
 class RenderStage;
 
 namespace Ui {
 
-class RenderTimeWatcher : public QObject
+class RenderTimeWatcher : public QObject, public Effect::PostfxObserver, public FrameGraphObserver
 {
     Q_OBJECT
 
@@ -29,21 +37,42 @@ public:
     RenderTimeWatcher();
     virtual ~RenderTimeWatcher();
 
+    // Names the interval ending at the stage's finished signal, ie. the work of the stages it decorates.
+    // Stages must be added in the order they signal.
     void addRenderStage(const QString& name, Engine::RenderStage* stage);
+
+    // Names the interval ending at the next recorded timestamp.
     void addNamedStage(const QString& name);
 
     void clearStages();
 
+    // Stage times are recorded in nanoseconds under the stage names, and their sum as
+    // "GPU frame time". Set before create.
+    void setStatistics(FrameStatistics* statistics);
+
     // Called after render stages have been added
     bool create();
 
     void endFrame();
 
+    // API counts of each stage in the last completed frame, in the order the stages were added.
+    const QStringList& stages() const;
+    const QVector<GpuCounters::Snapshot>& stageCounters() const;
+
     void setTimestamp();
 
+    // Records a timestamp between post-processing effect passes.
+    virtual void postfxPassFinished();
+
+    // Records a timestamp between frame graph passes.
+    virtual void framePassFinished();
+
 signals:
     void timeUpdated(QString name, qreal time, QString unit);
 
+    // Emitted with the unfiltered GPU time of the captured frame in milliseconds.
+    void frameTimeUpdated(qreal time);
+
 public slots:
     void renderStageFinished();
 
@@ -55,7 +84,16 @@ private:
     typedef MovingAverage<GLint64, double, 10> AverageType;
     QVector<AverageType> averages_;
 
+    FrameStatistics* statistics_;
+    QVector<Statistic*> stageStats_;
+    Statistic* frameStat_;
+
     bool frameCaptured_;
+
+    // Counters at each stage boundary of the current frame
+    QVector<GpuCounters::Snapshot> boundaries_;
+    int boundary_;
+    QVector<GpuCounters::Snapshot> stageCounters_;
 };
 
 }}
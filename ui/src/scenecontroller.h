@@ -6,6 +6,8 @@
 #ifndef SCENECONTROLLER_H
 #define SCENECONTROLLER_H
 
+class FrameStatistics;
+
 namespace Engine { 
 
 class SceneManager;
@@ -28,6 +30,9 @@ public:
 
     virtual void setManager(SceneManager* manager) = 0;
     virtual void update(unsigned int elapsed) = 0;
+
+    // Scenes can add their own timings to the presenter's statistics.
+    virtual void setStatistics(FrameStatistics*) {}
 };
 
 }};
@@ -12,6 +12,11 @@
 
 using namespace Engine::Ui;
 
+namespace {
+    // Frames between percentile reports
+    const int FRAME_WINDOW = 120;
+}
+
 UiController::UiController(QObject* parent)
     : QObject(parent)
 {
@@ -51,12 +56,26 @@ void UiController::setSceneList(const QStringList& scenes, const QString& curren
 
 void UiController::frameSwapped()
 {
-    frameTime_ << timer_.nsecsElapsed();
+    qint64 frameTime = timer_.nsecsElapsed();
     timer_.restart();
 
+    frameTime_ << frameTime;
+    frameTimes_.add(frameTime);
+
     double frameAverage = frameTime_ * 10e-7;
     watchValue("FPS", 1000.0 / frameAverage, "");
     watchValue("Frame time", frameAverage, "ms");
+
+    // Spikes are hidden by the average, so the tail is reported as well
+    if(frameTimes_.count() >= FRAME_WINDOW)
+    {
+        watchValue("Frame time p50", frameTimes_.percentile(0.50) * 1e-6, "ms");
+        watchValue("Frame time p95", frameTimes_.percentile(0.95) * 1e-6, "ms");
+        watchValue("Frame time p99", frameTimes_.percentile(0.99) * 1e-6, "ms");
+        watchValue("Frame time max", frameTimes_.max() * 1e-6, "ms");
+
+        frameTimes_.reset();
+    }
 }
 
 void UiController::watchValue(QString name, qreal value, QString unit)
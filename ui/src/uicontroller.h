@@ -7,6 +7,7 @@
 #define UICONTROLLER_H
 
 #include "movingaverage.h"
+#include "histogram.h"
 
 #include <QObject>
 #include <QElapsedTimer>
@@ -47,6 +48,9 @@ private:
     QElapsedTimer timer_;
 
     MovingAverage<qint64, double, 10> frameTime_;
+
+    // Swap intervals of the current percentile window
+    Histogram frameTimes_;
 };
 
 }}